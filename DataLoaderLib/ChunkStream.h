@@ -0,0 +1,316 @@
+#ifndef DATA_LOADER_CHUNK_STREAM_H
+#define DATA_LOADER_CHUNK_STREAM_H
+
+#include <vector>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <cstring>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+#include "ColumnStore.h"
+#include "DataLoader.h"
+
+namespace DataLoader
+{
+    /**
+     * A block of consecutive rows of some columns.
+     * Layman: The piece of the table a statistic sees at a time.
+     * Technical: columns[j] holds rows values of the j-th streamed column; validity[j] is
+     * its validity bitmap for these rows (bit 0 of word 0 = the first row of the chunk) or
+     * nullptr when no row is missing. NaN values also count as missing. firstRow is the
+     * position of the first row in the whole dataset.
+     */
+    struct Chunk
+    {
+        size_t firstRow = 0;
+        size_t rows = 0;
+        std::vector<const double *> columns;
+        std::vector<const uint64_t *> validity;
+
+        // Rows [first, first + count) of the chunk; first must be a multiple of 64
+        Chunk slice(size_t first, size_t count) const
+        {
+            Chunk part;
+            part.firstRow = firstRow + first;
+            part.rows = count;
+            for (size_t j = 0; j < columns.size(); ++j)
+            {
+                part.columns.push_back(columns[j] + first);
+                part.validity.push_back(validity[j] ? validity[j] + first / 64 : nullptr);
+            }
+            return part;
+        }
+    };
+
+    struct StreamOptions
+    {
+        explicit StreamOptions(size_t chunkRows = size_t(1) << 18, size_t numThreads = 0)
+            : chunkRows(chunkRows), numThreads(numThreads) {}
+
+        size_t chunkRows;  // rows per chunk (rounded up to a multiple of 64); two chunks are in memory
+        size_t numThreads; // compute threads (0 = hardware concurrency); reading has its own thread
+    };
+
+    // Where the time of a run went; readSeconds + computeSeconds above seconds means overlap
+    struct StreamStats
+    {
+        size_t chunks = 0;
+        size_t rows = 0;
+        double readSeconds = 0.0;    // reader thread: loading chunks (page faults, copies)
+        double computeSeconds = 0.0; // compute threads: processing chunks
+        double waitSeconds = 0.0;    // compute threads idle, waiting for a chunk
+        double seconds = 0.0;        // wall clock of the run
+    };
+
+    namespace detail
+    {
+        inline double secondsSince(std::chrono::steady_clock::time_point start)
+        {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+
+    /**
+     * Streams numeric columns of a column store in chunks, for data larger than memory.
+     * Layman: Runs statistics over a table chunk by chunk, reading the next chunk from disk
+     * while the current one is being processed.
+     * Technical: Double buffering: a reader thread loads chunk k + 1 into one buffer
+     * (touching the mapped file, so the disk reads happen there, and converting Int64
+     * columns to double) while the compute threads process chunk k in the other. Each
+     * chunk is cut into numWorkers() slices of whole 64-row words; slice w of every chunk
+     * goes to worker w, so per-worker state needs no locking and results do not depend on
+     * thread timing. Memory use is two chunks, whatever the size of the store.
+     */
+    class ChunkStream
+    {
+    public:
+        ChunkStream(const ColumnStore &store, const std::vector<size_t> &columns, const StreamOptions &options = StreamOptions())
+            : store_(store), columns_(columns), options_(options)
+        {
+            if (options.chunkRows == 0)
+                throw std::invalid_argument("Chunk size must be positive");
+            for (size_t c : columns)
+                if (store.type(c) == ColumnType::String)
+                    throw std::invalid_argument("Column " + store.name(c) + " is not numeric");
+            chunkRows_ = (options.chunkRows + 63) / 64 * 64;
+            workers_ = options.numThreads ? options.numThreads : std::max<size_t>(1, std::thread::hardware_concurrency());
+        }
+
+        size_t numWorkers() const { return workers_; }
+        size_t numColumns() const { return columns_.size(); }
+        size_t rows() const { return store_.rows(); }
+
+        // Statistics of the last run
+        const StreamStats &stats() const { return stats_; }
+
+        /**
+         * Call fn(slice, worker) for every slice of every chunk, in row order per worker.
+         * Calls for different workers run at the same time. An exception from fn stops the
+         * stream and is rethrown.
+         */
+        template <typename Fn>
+        void run(Fn fn)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            const size_t n = store_.rows(), numChunks = (n + chunkRows_ - 1) / chunkRows_;
+            stats_ = StreamStats();
+            Buffer buffers[2];
+            std::mutex mutex;
+            std::condition_variable changed;
+            size_t loaded = 0, consumed = 0;
+            bool stop = false;
+            std::exception_ptr readError;
+
+            std::thread reader([&]()
+                               {
+                try
+                {
+                    for (size_t k = 0; k < numChunks; ++k)
+                    {
+                        {
+                            std::unique_lock<std::mutex> lock(mutex);
+                            changed.wait(lock, [&] { return stop || k < consumed + 2; });
+                            if (stop)
+                                return;
+                        }
+                        const auto t = std::chrono::steady_clock::now();
+                        load(buffers[k % 2], k * chunkRows_, std::min(chunkRows_, n - k * chunkRows_));
+                        const double seconds = detail::secondsSince(t);
+                        std::lock_guard<std::mutex> lock(mutex);
+                        stats_.readSeconds += seconds;
+                        loaded = k + 1;
+                        changed.notify_all();
+                    }
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    readError = std::current_exception();
+                    changed.notify_all();
+                } });
+
+            std::exception_ptr error;
+            for (size_t k = 0; k < numChunks && !error; ++k)
+            {
+                const auto waitStart = std::chrono::steady_clock::now();
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    changed.wait(lock, [&] { return loaded > k || readError; });
+                    stats_.waitSeconds += detail::secondsSince(waitStart);
+                    if (loaded <= k)
+                    {
+                        error = readError;
+                        break;
+                    }
+                }
+                const auto t = std::chrono::steady_clock::now();
+                const Chunk &chunk = buffers[k % 2].chunk;
+                const size_t sliceRows = (chunk.rows + 64 * workers_ - 1) / (64 * workers_) * 64;
+                std::vector<std::exception_ptr> errors(workers_);
+                detail::parallelFor(workers_, workers_, [&](size_t w)
+                                    {
+                    const size_t first = std::min(chunk.rows, w * sliceRows);
+                    const size_t count = std::min(chunk.rows - first, sliceRows);
+                    if (count == 0)
+                        return;
+                    try
+                    {
+                        fn(chunk.slice(first, count), w);
+                    }
+                    catch (...)
+                    {
+                        errors[w] = std::current_exception();
+                    } });
+                for (const auto &e : errors)
+                    if (e && !error)
+                        error = e;
+                stats_.computeSeconds += detail::secondsSince(t);
+                stats_.chunks += 1;
+                stats_.rows += chunk.rows;
+                std::lock_guard<std::mutex> lock(mutex);
+                consumed = k + 1;
+                changed.notify_all();
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stop = true;
+                changed.notify_all();
+            }
+            reader.join();
+            stats_.seconds = detail::secondsSince(start);
+            if (error)
+                std::rethrow_exception(error);
+        }
+
+    private:
+        struct Buffer
+        {
+            std::vector<std::vector<double>> values;
+            std::vector<std::vector<uint64_t>> validity;
+            Chunk chunk;
+        };
+
+        // Copy rows [first, first + rows) of the columns into the buffer (first is a multiple of 64)
+        void load(Buffer &buffer, size_t first, size_t rows) const
+        {
+            const size_t numColumns = columns_.size();
+            buffer.values.resize(numColumns);
+            buffer.validity.resize(numColumns);
+            buffer.chunk.firstRow = first;
+            buffer.chunk.rows = rows;
+            buffer.chunk.columns.assign(numColumns, nullptr);
+            buffer.chunk.validity.assign(numColumns, nullptr);
+            for (size_t j = 0; j < numColumns; ++j)
+            {
+                const size_t c = columns_[j];
+                std::vector<double> &values = buffer.values[j];
+                values.resize(rows);
+                if (store_.type(c) == ColumnType::Int64)
+                {
+                    const int64_t *source = store_.integers(c).data() + first;
+                    for (size_t i = 0; i < rows; ++i)
+                        values[i] = static_cast<double>(source[i]);
+                }
+                else if (rows > 0)
+                    std::memcpy(values.data(), store_.doubles(c).data() + first, rows * sizeof(double));
+                buffer.chunk.columns[j] = values.data();
+                if (const uint64_t *bits = store_.validity(c))
+                {
+                    buffer.validity[j].assign(bits + first / 64, bits + (first + rows + 63) / 64);
+                    buffer.chunk.validity[j] = buffer.validity[j].data();
+                }
+            }
+        }
+
+        const ColumnStore &store_;
+        std::vector<size_t> columns_;
+        StreamOptions options_;
+        size_t chunkRows_ = 0;
+        size_t workers_ = 1;
+        StreamStats stats_;
+    };
+
+    namespace detail
+    {
+        template <size_t I, typename Tuple>
+        typename std::enable_if<I == std::tuple_size<Tuple>::value>::type updateAll(Tuple &, const Chunk &) {}
+
+        template <size_t I, typename Tuple>
+        typename std::enable_if<(I < std::tuple_size<Tuple>::value)>::type updateAll(Tuple &parts, const Chunk &chunk)
+        {
+            std::get<I>(parts).update(chunk);
+            updateAll<I + 1>(parts, chunk);
+        }
+
+        template <size_t I, typename Tuple>
+        typename std::enable_if<I == std::tuple_size<Tuple>::value>::type mergeAll(Tuple &, const Tuple &) {}
+
+        template <size_t I, typename Tuple>
+        typename std::enable_if<(I < std::tuple_size<Tuple>::value)>::type mergeAll(Tuple &into, const Tuple &from)
+        {
+            std::get<I>(into).merge(std::get<I>(from));
+            mergeAll<I + 1>(into, from);
+        }
+
+        // Each worker updates its own copy of the accumulators; the copies are merged in worker order
+        template <typename Tuple>
+        Tuple accumulateTuple(ChunkStream &stream, const Tuple &init)
+        {
+            std::vector<Tuple> parts(stream.numWorkers(), init);
+            stream.run([&](const Chunk &chunk, size_t worker)
+                       { updateAll<0>(parts[worker], chunk); });
+            for (size_t w = 1; w < parts.size(); ++w)
+                mergeAll<0>(parts[0], parts[w]);
+            return parts[0];
+        }
+    }
+
+    /**
+     * Run an accumulator over the whole stream and return it, ready to finalize().
+     * Accumulators (see ChunkedStatistics.h) follow one protocol: the constructor
+     * initializes an empty state, update(chunk) adds a chunk, merge(other) adds the state
+     * of another accumulator built the same way over other rows, and finalize() returns the
+     * statistic. Pass several accumulators to compute them all in one read of the data; they
+     * come back as a std::tuple in the same order.
+     */
+    template <typename Accumulator>
+    Accumulator accumulate(ChunkStream &stream, const Accumulator &init)
+    {
+        return std::get<0>(detail::accumulateTuple(stream, std::make_tuple(init)));
+    }
+
+    template <typename First, typename Second, typename... Rest>
+    std::tuple<First, Second, Rest...> accumulate(ChunkStream &stream, const First &first, const Second &second,
+                                                  const Rest &...rest)
+    {
+        return detail::accumulateTuple(stream, std::make_tuple(first, second, rest...));
+    }
+}
+
+#endif // DATA_LOADER_CHUNK_STREAM_H
@@ -0,0 +1,634 @@
+#ifndef DATA_LOADER_CHUNKED_STATISTICS_H
+#define DATA_LOADER_CHUNKED_STATISTICS_H
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+#include "ChunkStream.h"
+#include "../ExploratoryDataAnalysisLib/Profile.h"
+#include "../ExploratoryDataAnalysisLib/Correlation.h"
+
+/*
+ * Statistics computed chunk by chunk. Every accumulator follows the same protocol:
+ *   Accumulator a(...);  init: an empty state for the given columns of the chunks
+ *   a.update(chunk);     add a chunk (any number, in any order)
+ *   a.merge(b);          add the state of b, built the same way over other rows
+ *   a.finalize();        the statistic of everything added
+ * Results are exact (up to rounding) whatever the chunking, except for the quantile sketch,
+ * which is exact to its stated precision. Missing values (NaN or a cleared validity bit)
+ * are skipped. Use them with DataLoader::accumulate to stream a column store, or call
+ * update() on chunks of your own.
+ */
+namespace DataLoader
+{
+    namespace detail
+    {
+        // Number of set bits of x
+        inline size_t bitCount(uint64_t x)
+        {
+#if defined(__GNUC__)
+            return static_cast<size_t>(__builtin_popcountll(x));
+#else
+            size_t k = 0;
+            for (; x; x &= x - 1)
+                ++k;
+            return k;
+#endif
+        }
+
+        // Presence words of column j of a chunk (not NaN and validity bit set)
+        inline std::vector<uint64_t> presence(const Chunk &chunk, size_t j)
+        {
+            std::vector<uint64_t> words((chunk.rows + 63) / 64);
+            for (size_t w = 0; w < words.size(); ++w)
+                words[w] = DescriptiveStatistics::detail::presenceWord(chunk.columns[j], 64 * w,
+                                                                       std::min<size_t>(64, chunk.rows - 64 * w), chunk.validity[j]);
+            return words;
+        }
+
+        inline void checkColumn(const Chunk &chunk, size_t j)
+        {
+            if (j >= chunk.columns.size())
+                throw std::invalid_argument("Column index beyond the columns of the chunk");
+        }
+
+        /**
+         * Cholesky factor L (lower, row-major k x k) of a symmetric matrix given by its upper
+         * triangle, in place. Returns false when the matrix is not positive definite to
+         * working precision.
+         */
+        inline bool cholesky(std::vector<double> &a, size_t k)
+        {
+            double largest = 0.0;
+            for (size_t i = 0; i < k; ++i)
+                largest = std::max(largest, a[i * k + i]);
+            for (size_t j = 0; j < k; ++j)
+            {
+                double d = a[j * k + j];
+                for (size_t m = 0; m < j; ++m)
+                    d -= a[j * k + m] * a[j * k + m];
+                if (!(d > 1e-12 * largest))
+                    return false;
+                d = std::sqrt(d);
+                a[j * k + j] = d;
+                for (size_t i = j + 1; i < k; ++i)
+                {
+                    double s = a[j * k + i]; // upper triangle holds the input
+                    for (size_t m = 0; m < j; ++m)
+                        s -= a[i * k + m] * a[j * k + m];
+                    a[i * k + j] = s / d;
+                }
+            }
+            return true;
+        }
+
+        // Solve L y = b in place
+        inline void forwardSubstitute(const std::vector<double> &l, size_t k, std::vector<double> &b)
+        {
+            for (size_t i = 0; i < k; ++i)
+            {
+                for (size_t m = 0; m < i; ++m)
+                    b[i] -= l[i * k + m] * b[m];
+                b[i] /= l[i * k + i];
+            }
+        }
+
+        // Solve L' x = y in place
+        inline void backSubstitute(const std::vector<double> &l, size_t k, std::vector<double> &y)
+        {
+            for (size_t i = k; i-- > 0;)
+            {
+                for (size_t m = i + 1; m < k; ++m)
+                    y[i] -= l[m * k + i] * y[m];
+                y[i] /= l[i * k + i];
+            }
+        }
+    }
+
+    // Count, missing count, mean, variance, shape and range of a column
+    struct MomentsResult
+    {
+        uint64_t count = 0;    // finite values
+        uint64_t missing = 0;
+        uint64_t infinite = 0; // +/-inf, left out of the statistics below, as in EDA::profile
+        double mean, variance, stddev;
+        double skewness, kurtosis; // sample skewness g1 and excess kurtosis g2, as in EDA::profile
+        double min, max;
+    };
+
+    /**
+     * Mean, variance, skewness, kurtosis, min and max of one column.
+     * Layman: The usual summary numbers of a column too large to load.
+     * Technical: Present values are compacted in tiles of 2048 and each tile is reduced
+     * with its own mean before being merged with the pairwise update of Pebay (2008), so
+     * there is no cancellation however large the mean. Infinite values are only counted.
+     */
+    class MomentsAccumulator
+    {
+    public:
+        explicit MomentsAccumulator(size_t column = 0) : column_(column) {}
+
+        void update(const Chunk &chunk)
+        {
+            detail::checkColumn(chunk, column_);
+            const double *x = chunk.columns[column_];
+            const uint64_t *validity = chunk.validity[column_];
+            double tile[2048];
+            size_t used = 0;
+            for (size_t first = 0; first < chunk.rows; first += 64)
+            {
+                const size_t m = std::min<size_t>(64, chunk.rows - first);
+                uint64_t mask = DescriptiveStatistics::detail::presenceWord(x, first, m, validity);
+                missing_ += m - detail::bitCount(mask);
+                for (; mask; mask &= mask - 1)
+                {
+                    const double v = x[first + DescriptiveStatistics::detail::lowestBit(mask)];
+                    if (std::fabs(v) <= std::numeric_limits<double>::max())
+                        tile[used++] = v;
+                    else
+                        ++infinite_;
+                }
+                if (used > 2048 - 64)
+                {
+                    moments_.add(tile, used);
+                    used = 0;
+                }
+            }
+            moments_.add(tile, used);
+        }
+
+        void merge(const MomentsAccumulator &other)
+        {
+            moments_.merge(other.moments_);
+            missing_ += other.missing_;
+            infinite_ += other.infinite_;
+        }
+
+        MomentsResult finalize() const
+        {
+            const EDA::detail::Moments &m = moments_;
+            const double nan = std::numeric_limits<double>::quiet_NaN();
+            MomentsResult result;
+            result.count = static_cast<uint64_t>(m.n);
+            result.missing = missing_;
+            result.infinite = infinite_;
+            result.mean = m.n > 0 ? m.mean : nan;
+            result.variance = m.n > 1 ? m.m2 / (m.n - 1) : nan;
+            result.stddev = std::sqrt(result.variance);
+            result.skewness = m.m2 > 0 ? std::sqrt(m.n) * m.m3 / std::pow(m.m2, 1.5) : nan;
+            result.kurtosis = m.m2 > 0 ? m.n * m.m4 / (m.m2 * m.m2) - 3.0 : nan;
+            result.min = m.n > 0 ? m.min : nan;
+            result.max = m.n > 0 ? m.max : nan;
+            return result;
+        }
+
+    private:
+        size_t column_;
+        uint64_t missing_ = 0;
+        uint64_t infinite_ = 0;
+        EDA::detail::Moments moments_;
+    };
+
+    /**
+     * Quantiles of one column from a mergeable sketch.
+     * Layman: Median and percentiles of a column too large to sort, in a few KB of memory.
+     * Technical: Values go into an EDA::StreamingBoxPlot (log-bucketed histograms); each
+     * percentile is the value of rank floor(p/100 (count - 1)) to within a relative error
+     * of about 10^-significantDigits, and sketches merge exactly. Infinite values rank
+     * below or above every finite value, so only percentiles that fall on them are +/-inf.
+     */
+    class QuantileAccumulator
+    {
+    public:
+        explicit QuantileAccumulator(size_t column = 0,
+                                     const std::vector<double> &percentiles = std::vector<double>{1, 5, 25, 50, 75, 95, 99},
+                                     int significantDigits = 2)
+            : column_(column), percentiles_(percentiles), sketch_(significantDigits)
+        {
+            for (double p : percentiles)
+                if (!(p >= 0.0 && p <= 100.0))
+                    throw std::invalid_argument("Percentiles must be between 0 and 100");
+        }
+
+        void update(const Chunk &chunk)
+        {
+            detail::checkColumn(chunk, column_);
+            const double *x = chunk.columns[column_];
+            for (size_t first = 0; first < chunk.rows; first += 64)
+            {
+                const size_t m = std::min<size_t>(64, chunk.rows - first);
+                uint64_t mask = DescriptiveStatistics::detail::presenceWord(x, first, m, chunk.validity[column_]);
+                missing_ += m - detail::bitCount(mask);
+                for (; mask; mask &= mask - 1)
+                    sketch_.add(x[first + DescriptiveStatistics::detail::lowestBit(mask)]);
+            }
+        }
+
+        void merge(const QuantileAccumulator &other)
+        {
+            sketch_.merge(other.sketch_);
+            missing_ += other.missing_;
+        }
+
+        // The requested percentiles, in order (throws std::logic_error when no value was added)
+        std::vector<double> finalize() const
+        {
+            std::vector<double> values;
+            for (double p : percentiles_)
+                values.push_back(sketch_.percentile(p));
+            return values;
+        }
+
+        const EDA::StreamingBoxPlot &sketch() const { return sketch_; }
+        uint64_t missing() const { return missing_; }
+        uint64_t infinite() const { return sketch_.infinite(); }
+
+    private:
+        size_t column_;
+        std::vector<double> percentiles_;
+        EDA::StreamingBoxPlot sketch_;
+        uint64_t missing_ = 0;
+    };
+
+    /**
+     * Histogram of one column over fixed bin edges.
+     * Layman: Counts per bin for a column too large to load; the bins must be chosen up
+     * front (e.g. from a first pass with MomentsAccumulator or QuantileAccumulator).
+     * Technical: Each chunk is counted by EDA::histogram (reciprocal-multiply binning for
+     * uniform edges, binary search otherwise) and counts are added, so the result equals
+     * EDA::histogram over the whole column.
+     */
+    class HistogramAccumulator
+    {
+    public:
+        HistogramAccumulator(size_t column, const std::vector<double> &edges) : column_(column)
+        {
+            EDA::detail::checkEdges(edges);
+            histogram_.edges = edges;
+            histogram_.counts.assign(edges.size() - 1, 0);
+        }
+
+        void update(const Chunk &chunk)
+        {
+            detail::checkColumn(chunk, column_);
+            if (chunk.rows == 0)
+                return;
+            histogram_.merge(EDA::histogram(chunk.columns[column_], chunk.rows, histogram_.edges, 1, chunk.validity[column_]));
+        }
+
+        void merge(const HistogramAccumulator &other) { histogram_.merge(other.histogram_); }
+
+        EDA::Histogram finalize() const { return histogram_; }
+
+    private:
+        size_t column_;
+        EDA::Histogram histogram_;
+    };
+
+    /**
+     * Pearson correlation matrix of several columns, pairwise-complete.
+     * Layman: How strongly each pair of columns moves together, for tables too large to
+     * load; a row missing in one column still counts for the other pairs.
+     * Technical: Same definition as EDA::correlationMatrix: r_ij over the rows where both
+     * columns are present. For every pair the accumulator keeps the count, the mean and sum
+     * of squared deviations of each column over the pair's rows and the co-moment; a chunk
+     * is centred on its own column means and reduced with the blocked Gram kernel of
+     * EDA::correlationMatrix (of the centred values, plus their presence indicators and
+     * squares when something is missing), then merged with the pairwise update of Chan et
+     * al. O(d^2) memory, independent of the number of rows.
+     */
+    class CorrelationAccumulator
+    {
+    public:
+        explicit CorrelationAccumulator(const std::vector<size_t> &columns)
+            : columns_(columns), d_(columns.size()), count_(d_ * d_, 0.0), mean_(d_ * d_, 0.0), m2_(d_ * d_, 0.0),
+              comoment_(d_ * d_, 0.0)
+        {
+            if (d_ == 0)
+                throw std::invalid_argument("At least one column required");
+        }
+
+        void update(const Chunk &chunk)
+        {
+            for (size_t c : columns_)
+                detail::checkColumn(chunk, c);
+            const size_t n = chunk.rows;
+            if (n == 0)
+                return;
+            const size_t d = d_;
+            // Presence, and the column means the chunk is centred on
+            std::vector<std::vector<uint64_t>> present(d);
+            std::vector<double> shift(d, 0.0), centredSum(d, 0.0);
+            bool complete = true;
+            for (size_t c = 0; c < d; ++c)
+            {
+                const double *x = chunk.columns[columns_[c]];
+                present[c] = detail::presence(chunk, columns_[c]);
+                size_t count = 0;
+                double sum = 0.0;
+                forEachPresent(present[c], [&](size_t i) { sum += x[i]; ++count; });
+                complete = complete && count == n;
+                shift[c] = count ? sum / static_cast<double>(count) : 0.0;
+                forEachPresent(present[c], [&](size_t i) { centredSum[c] += x[i] - shift[c]; });
+            }
+            auto centred = [&](size_t c, size_t i)
+            {
+                const bool valid = (present[c][i >> 6] >> (i & 63)) & 1;
+                return valid ? chunk.columns[columns_[c]][i] - shift[c] : 0.0;
+            };
+
+            // Gram matrix of z (complete chunk) or of [z, m, z^2]
+            const size_t width = complete ? d : 3 * d;
+            auto fill = [&](size_t column, size_t first, size_t rows, double *out)
+            {
+                const size_t c = column % d, part = column / d; // 0: z, 1: m, 2: z^2
+                for (size_t r = 0; r < rows; ++r)
+                {
+                    const size_t i = first + r;
+                    const double z = centred(c, i);
+                    out[r * EDA::detail::panelWidth] =
+                        part == 0 ? z : part == 1 ? static_cast<double>((present[c][i >> 6] >> (i & 63)) & 1) : z * z;
+                }
+            };
+            size_t ldc = 0;
+            const std::vector<double> gram = EDA::detail::chunkedGram(width, n, 1, fill, EDA::detail::upperBlocks(width), ldc);
+            auto g = [&](size_t i, size_t j) { return i <= j ? gram[i * ldc + j] : gram[j * ldc + i]; };
+
+            for (size_t i = 0; i < d; ++i)
+                for (size_t j = i; j < d; ++j)
+                {
+                    double count, sx, sy, sxx, syy;
+                    if (complete)
+                    {
+                        count = static_cast<double>(n);
+                        sx = centredSum[i], sy = centredSum[j];
+                        sxx = g(i, i), syy = g(j, j);
+                    }
+                    else
+                    {
+                        count = g(d + i, d + j);
+                        sx = g(i, d + j), sy = g(j, d + i);
+                        sxx = g(d + j, 2 * d + i), syy = g(d + i, 2 * d + j);
+                    }
+                    if (count == 0)
+                        continue;
+                    combine(i, j, count, shift[i] + sx / count, shift[j] + sy / count, sxx - sx * sx / count,
+                            syy - sy * sy / count, g(i, j) - sx * sy / count);
+                }
+        }
+
+        void merge(const CorrelationAccumulator &other)
+        {
+            if (other.d_ != d_)
+                throw std::invalid_argument("Accumulators have different columns");
+            for (size_t i = 0; i < d_; ++i)
+                for (size_t j = i; j < d_; ++j)
+                    if (other.count_[i * d_ + j] > 0)
+                        combine(i, j, other.count_[i * d_ + j], other.mean_[i * d_ + j], other.mean_[j * d_ + i],
+                                other.m2_[i * d_ + j], other.m2_[j * d_ + i], other.comoment_[i * d_ + j]);
+        }
+
+        // d x d correlation matrix; NaN for pairs with fewer than two rows or a constant column
+        std::vector<std::vector<double>> finalize() const
+        {
+            const double nan = std::numeric_limits<double>::quiet_NaN();
+            std::vector<std::vector<double>> matrix(d_, std::vector<double>(d_));
+            for (size_t i = 0; i < d_; ++i)
+                for (size_t j = i; j < d_; ++j)
+                {
+                    const size_t ij = i * d_ + j, ji = j * d_ + i;
+                    const bool defined = count_[ij] >= 2.0 && m2_[ij] > 0.0 && m2_[ji] > 0.0;
+                    const double r = i == j ? 1.0 : comoment_[ij] / std::sqrt(m2_[ij] * m2_[ji]);
+                    matrix[i][j] = matrix[j][i] = defined ? std::max(-1.0, std::min(1.0, r)) : nan;
+                }
+            return matrix;
+        }
+
+        // d x d sample covariance matrix over the same pairwise-complete rows
+        std::vector<std::vector<double>> covarianceMatrix() const
+        {
+            std::vector<std::vector<double>> matrix(d_, std::vector<double>(d_));
+            for (size_t i = 0; i < d_; ++i)
+                for (size_t j = 0; j < d_; ++j)
+                    matrix[i][j] = count_[i * d_ + j] >= 2.0 ? comoment_[i * d_ + j] / (count_[i * d_ + j] - 1.0)
+                                                             : std::numeric_limits<double>::quiet_NaN();
+            return matrix;
+        }
+
+    private:
+        template <typename Visit>
+        static void forEachPresent(const std::vector<uint64_t> &words, Visit visit)
+        {
+            for (size_t w = 0; w < words.size(); ++w)
+                for (uint64_t mask = words[w]; mask; mask &= mask - 1)
+                    visit(64 * w + DescriptiveStatistics::detail::lowestBit(mask));
+        }
+
+        // Add a set of rows with the given pair statistics to pair (i, j), i <= j
+        void combine(size_t i, size_t j, double nb, double meanI, double meanJ, double m2I, double m2J, double c)
+        {
+            const size_t ij = i * d_ + j, ji = j * d_ + i;
+            const double na = count_[ij], total = na + nb, w = na * nb / total;
+            const double di = meanI - mean_[ij], dj = meanJ - mean_[ji];
+            comoment_[ij] += c + di * dj * w;
+            m2_[ij] += m2I + di * di * w;
+            mean_[ij] += di * nb / total;
+            if (i != j)
+            {
+                comoment_[ji] = comoment_[ij];
+                m2_[ji] += m2J + dj * dj * w;
+                mean_[ji] += dj * nb / total;
+            }
+            count_[ij] = count_[ji] = total;
+        }
+
+        std::vector<size_t> columns_;
+        size_t d_;
+        // Per pair (i, j): row count, mean and squared deviations of column i over the
+        // pair's rows (entry ij; entry ji for column j) and co-moment (symmetric)
+        std::vector<double> count_, mean_, m2_, comoment_;
+    };
+
+    // Ordinary least squares fit with coefficient standard errors
+    struct OLSResult
+    {
+        std::vector<double> coefficients;   // one per predictor
+        double intercept = 0.0;             // 0 without an intercept
+        std::vector<double> standardErrors; // of the coefficients
+        double interceptStandardError = 0.0;
+        double rSquared = 0.0;              // uncentred without an intercept
+        double residualStandardError = 0.0;
+        uint64_t observations = 0;          // rows with every variable present
+    };
+
+    /**
+     * Ordinary least squares from accumulated Gram matrices.
+     * Layman: Fits y = b0 + b1 x1 + ... + bp xp to a table too large to load, reading it
+     * once.
+     * Technical: Uses the rows where the response and every predictor are present. Each
+     * chunk is centred on its own means and its (p + 1) x (p + 1) Gram matrix of [X, y] is
+     * computed with the blocked kernel of EDA::correlationMatrix; chunks merge with the
+     * matrix form of Chan's update, so the accumulated X'X and X'y are centred and free of
+     * cancellation. finalize() solves the normal equations by Cholesky factorization and
+     * throws std::runtime_error when the predictors are collinear.
+     */
+    class OLSAccumulator
+    {
+    public:
+        OLSAccumulator(const std::vector<size_t> &predictors, size_t response, bool intercept = true)
+            : columns_(predictors), p_(predictors.size()), intercept_(intercept),
+              mean_(p_ + 1, 0.0), comoment_((p_ + 1) * (p_ + 1), 0.0)
+        {
+            if (p_ == 0)
+                throw std::invalid_argument("At least one predictor required");
+            columns_.push_back(response);
+        }
+
+        void update(const Chunk &chunk)
+        {
+            for (size_t c : columns_)
+                detail::checkColumn(chunk, c);
+            const size_t n = chunk.rows, k = p_ + 1;
+            if (n == 0)
+                return;
+            // Rows where every variable is present
+            std::vector<uint64_t> complete((n + 63) / 64, ~uint64_t(0));
+            for (size_t c : columns_)
+            {
+                const std::vector<uint64_t> words = detail::presence(chunk, c);
+                for (size_t w = 0; w < complete.size(); ++w)
+                    complete[w] &= words[w];
+            }
+            size_t count = 0;
+            for (uint64_t word : complete)
+                count += detail::bitCount(word);
+            if (count == 0)
+                return;
+            std::vector<double> mean(k, 0.0);
+            for (size_t v = 0; v < k; ++v)
+            {
+                const double *x = chunk.columns[columns_[v]];
+                for (size_t w = 0; w < complete.size(); ++w)
+                    for (uint64_t mask = complete[w]; mask; mask &= mask - 1)
+                        mean[v] += x[64 * w + DescriptiveStatistics::detail::lowestBit(mask)];
+                mean[v] /= static_cast<double>(count);
+            }
+            auto fill = [&](size_t v, size_t first, size_t rows, double *out)
+            {
+                const double *x = chunk.columns[columns_[v]];
+                for (size_t r = 0; r < rows; ++r)
+                {
+                    const size_t i = first + r;
+                    out[r * EDA::detail::panelWidth] = ((complete[i >> 6] >> (i & 63)) & 1) ? x[i] - mean[v] : 0.0;
+                }
+            };
+            size_t ldc = 0;
+            const std::vector<double> gram = EDA::detail::chunkedGram(k, n, 1, fill, EDA::detail::upperBlocks(k), ldc);
+            std::vector<double> comoment(k * k);
+            for (size_t a = 0; a < k; ++a)
+                for (size_t b = a; b < k; ++b)
+                    comoment[a * k + b] = comoment[b * k + a] = gram[a * ldc + b];
+            combine(static_cast<double>(count), mean, comoment);
+        }
+
+        void merge(const OLSAccumulator &other)
+        {
+            if (other.p_ != p_)
+                throw std::invalid_argument("Accumulators have different columns");
+            if (other.n_ > 0)
+                combine(other.n_, other.mean_, other.comoment_);
+        }
+
+        OLSResult finalize() const
+        {
+            const size_t p = p_, k = p + 1;
+            const double n = n_;
+            const double dof = n - static_cast<double>(p) - (intercept_ ? 1.0 : 0.0);
+            if (!(dof > 0))
+                throw std::logic_error("Not enough complete rows for the number of predictors");
+            // Centred (with intercept) or raw cross products of [X, y]
+            std::vector<double> cross(comoment_);
+            if (!intercept_)
+                for (size_t a = 0; a < k; ++a)
+                    for (size_t b = 0; b < k; ++b)
+                        cross[a * k + b] += n * mean_[a] * mean_[b];
+            std::vector<double> l(p * p);
+            for (size_t a = 0; a < p; ++a)
+                for (size_t b = 0; b < p; ++b)
+                    l[a * p + b] = cross[a * k + b];
+            if (!detail::cholesky(l, p))
+                throw std::runtime_error("Predictors are collinear");
+
+            OLSResult result;
+            result.observations = static_cast<uint64_t>(n);
+            std::vector<double> beta(p);
+            for (size_t a = 0; a < p; ++a)
+                beta[a] = cross[a * k + p];
+            detail::forwardSubstitute(l, p, beta);
+            detail::backSubstitute(l, p, beta);
+            result.coefficients = beta;
+
+            const double yy = cross[p * k + p];
+            double explained = 0.0;
+            for (size_t a = 0; a < p; ++a)
+                explained += beta[a] * cross[a * k + p];
+            const double sse = std::max(0.0, yy - explained);
+            const double sigma2 = sse / dof;
+            result.residualStandardError = std::sqrt(sigma2);
+            result.rSquared = yy > 0.0 ? 1.0 - sse / yy : std::numeric_limits<double>::quiet_NaN();
+
+            // Diagonal of (X'X)^-1
+            result.standardErrors.assign(p, 0.0);
+            for (size_t a = 0; a < p; ++a)
+            {
+                std::vector<double> e(p, 0.0);
+                e[a] = 1.0;
+                detail::forwardSubstitute(l, p, e);
+                detail::backSubstitute(l, p, e);
+                result.standardErrors[a] = std::sqrt(sigma2 * e[a]);
+            }
+            if (intercept_)
+            {
+                result.intercept = mean_[p];
+                for (size_t a = 0; a < p; ++a)
+                    result.intercept -= beta[a] * mean_[a];
+                std::vector<double> m(mean_.begin(), mean_.begin() + static_cast<std::ptrdiff_t>(p));
+                detail::forwardSubstitute(l, p, m);
+                double quadratic = 0.0;
+                for (double v : m)
+                    quadratic += v * v;
+                result.interceptStandardError = std::sqrt(sigma2 * (1.0 / n + quadratic));
+            }
+            return result;
+        }
+
+    private:
+        // Add rows with the given count, means and co-moment matrix
+        void combine(double nb, const std::vector<double> &mean, const std::vector<double> &comoment)
+        {
+            const size_t k = p_ + 1;
+            const double total = n_ + nb, w = n_ * nb / total;
+            std::vector<double> delta(k);
+            for (size_t a = 0; a < k; ++a)
+                delta[a] = mean[a] - mean_[a];
+            for (size_t a = 0; a < k; ++a)
+                for (size_t b = 0; b < k; ++b)
+                    comoment_[a * k + b] += comoment[a * k + b] + delta[a] * delta[b] * w;
+            for (size_t a = 0; a < k; ++a)
+                mean_[a] += delta[a] * nb / total;
+            n_ = total;
+        }
+
+        std::vector<size_t> columns_; // predictors, then the response
+        size_t p_;
+        bool intercept_;
+        double n_ = 0.0;
+        std::vector<double> mean_;     // of [X, y] over the complete rows
+        std::vector<double> comoment_; // centred cross products of [X, y]
+    };
+}
+
+#endif // DATA_LOADER_CHUNKED_STATISTICS_H
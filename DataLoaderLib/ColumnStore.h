@@ -0,0 +1,586 @@
+#ifndef DATA_LOADER_COLUMN_STORE_H
+#define DATA_LOADER_COLUMN_STORE_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define DATA_LOADER_MMAP 1
+#endif
+
+namespace DataLoader
+{
+    namespace detail
+    {
+        /**
+         * A whole file in memory.
+         * On POSIX systems the file is memory-mapped: nothing is read up front, the OS pages
+         * data in on first touch and shares it with its file cache, and a created file is
+         * written through the mapping. Elsewhere the file is read into (or written from) a
+         * buffer, with the same interface.
+         */
+        class MappedFile
+        {
+        public:
+            MappedFile() {}
+
+            // Map an existing file read-only
+            static MappedFile openRead(const std::string &path)
+            {
+                MappedFile file;
+#ifdef DATA_LOADER_MMAP
+                const int fd = ::open(path.c_str(), O_RDONLY);
+                if (fd < 0)
+                    throw std::runtime_error("Cannot open " + path);
+                struct stat info;
+                if (::fstat(fd, &info) != 0)
+                {
+                    ::close(fd);
+                    throw std::runtime_error("Cannot read the size of " + path);
+                }
+                file.size_ = static_cast<size_t>(info.st_size);
+                if (file.size_ > 0)
+                {
+                    void *data = ::mmap(nullptr, file.size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (data == MAP_FAILED)
+                    {
+                        ::close(fd);
+                        throw std::runtime_error("Cannot map " + path);
+                    }
+                    file.data_ = static_cast<char *>(data);
+                }
+                ::close(fd);
+#else
+                std::ifstream in(path.c_str(), std::ios::binary);
+                if (!in)
+                    throw std::runtime_error("Cannot open " + path);
+                file.buffer_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+                file.size_ = file.buffer_.size();
+                file.data_ = file.buffer_.empty() ? nullptr : &file.buffer_[0];
+#endif
+                return file;
+            }
+
+            // Create (or truncate) a zero-filled file of the given size, mapped read-write
+            static MappedFile create(const std::string &path, size_t size)
+            {
+                MappedFile file;
+                file.size_ = size;
+                file.path_ = path;
+#ifdef DATA_LOADER_MMAP
+                const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+                if (fd < 0)
+                    throw std::runtime_error("Cannot create " + path);
+                if (::ftruncate(fd, static_cast<off_t>(size)) != 0)
+                {
+                    ::close(fd);
+                    throw std::runtime_error("Cannot resize " + path);
+                }
+                if (size > 0)
+                {
+                    void *data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                    if (data == MAP_FAILED)
+                    {
+                        ::close(fd);
+                        throw std::runtime_error("Cannot map " + path);
+                    }
+                    file.data_ = static_cast<char *>(data);
+                }
+                ::close(fd);
+#else
+                file.buffer_.assign(size, 0);
+                file.data_ = file.buffer_.empty() ? nullptr : &file.buffer_[0];
+                file.writable_ = true;
+#endif
+                return file;
+            }
+
+            MappedFile(MappedFile &&other) { swap(other); }
+
+            MappedFile &operator=(MappedFile &&other)
+            {
+                MappedFile(std::move(other)).swap(*this);
+                return *this;
+            }
+
+            MappedFile(const MappedFile &) = delete;
+            MappedFile &operator=(const MappedFile &) = delete;
+
+            ~MappedFile() { close(); }
+
+            // Unmap (writing a created file out when it is buffered)
+            void close()
+            {
+#ifdef DATA_LOADER_MMAP
+                if (data_)
+                    ::munmap(data_, size_);
+#else
+                if (writable_)
+                {
+                    std::ofstream out(path_.c_str(), std::ios::binary);
+                    out.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+                    writable_ = false;
+                }
+                buffer_.clear();
+#endif
+                data_ = nullptr;
+                size_ = 0;
+            }
+
+            // Hint that the file will be read front to back
+            void adviseSequential() const
+            {
+#ifdef DATA_LOADER_MMAP
+                if (data_)
+                    ::madvise(data_, size_, MADV_SEQUENTIAL);
+#endif
+            }
+
+            const char *data() const { return data_; }
+            char *data() { return data_; }
+            size_t size() const { return size_; }
+
+        private:
+            void swap(MappedFile &other)
+            {
+                std::swap(data_, other.data_);
+                std::swap(size_, other.size_);
+                std::swap(path_, other.path_);
+#ifndef DATA_LOADER_MMAP
+                std::swap(buffer_, other.buffer_);
+                std::swap(writable_, other.writable_);
+#endif
+            }
+
+            char *data_ = nullptr;
+            size_t size_ = 0;
+            std::string path_;
+#ifndef DATA_LOADER_MMAP
+            std::vector<char> buffer_;
+            bool writable_ = false;
+#endif
+        };
+
+        // Little-endian fixed-width integers for the file header and directory
+        inline void putU64(std::vector<char> &out, uint64_t v)
+        {
+            for (int k = 0; k < 8; ++k)
+                out.push_back(static_cast<char>(v >> (8 * k)));
+        }
+
+        inline uint64_t getU64(const char *data, size_t size, size_t &pos)
+        {
+            if (pos > size || size - pos < 8)
+                throw std::runtime_error("Truncated column store");
+            uint64_t v = 0;
+            for (int k = 0; k < 8; ++k)
+                v |= static_cast<uint64_t>(static_cast<unsigned char>(data[pos + k])) << (8 * k);
+            pos += 8;
+            return v;
+        }
+
+        inline size_t align64(size_t x) { return (x + 63) & ~size_t(63); }
+    }
+
+    enum class ColumnType
+    {
+        Float64 = 1, // double, NaN where missing
+        Int64 = 2,   // int64_t, 0 where missing
+        String = 3   // UTF-8 bytes with uint64 offsets, empty where missing
+    };
+
+    /**
+     * Read-only view of a column: a pointer and a length, no copy.
+     * Layman: Lets a column stored on disk be used like an array without loading it.
+     * Technical: Iterable, indexable and convertible to a std::vector (which copies); pass
+     * data() and size() to the pointer-and-length functions of the libraries to avoid the
+     * copy. Valid while the ColumnStore that produced it is alive.
+     */
+    template <typename T>
+    class ColumnView
+    {
+    public:
+        ColumnView(const T *data, size_t size) : data_(data), size_(size) {}
+
+        const T *data() const { return data_; }
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        const T &operator[](size_t i) const { return data_[i]; }
+        const T *begin() const { return data_; }
+        const T *end() const { return data_ + size_; }
+
+        std::vector<T> toVector() const { return std::vector<T>(data_, data_ + size_); }
+
+    private:
+        const T *data_;
+        size_t size_;
+    };
+
+    // Read-only view of a string column: value i is bytes [offsets[i], offsets[i + 1])
+    class StringColumnView
+    {
+    public:
+        StringColumnView(const uint64_t *offsets, const char *bytes, size_t size)
+            : offsets_(offsets), bytes_(bytes), size_(size) {}
+
+        size_t size() const { return size_; }
+        const char *data(size_t i) const { return bytes_ + offsets_[i]; }
+        size_t length(size_t i) const { return static_cast<size_t>(offsets_[i + 1] - offsets_[i]); }
+        std::string operator[](size_t i) const { return std::string(data(i), length(i)); }
+
+        std::vector<std::string> toVector() const
+        {
+            std::vector<std::string> values;
+            values.reserve(size_);
+            for (size_t i = 0; i < size_; ++i)
+                values.push_back((*this)[i]);
+            return values;
+        }
+
+    private:
+        const uint64_t *offsets_;
+        const char *bytes_;
+        size_t size_;
+    };
+
+    namespace detail
+    {
+        // Where one column lives in the file
+        struct ColumnLayout
+        {
+            std::string name;
+            ColumnType type = ColumnType::Float64;
+            bool hasValidity = false;
+            uint64_t dataOffset = 0;     // values, or uint64 string offsets (rows + 1 of them)
+            uint64_t validityOffset = 0; // validity bitmap, if any
+            uint64_t bytesOffset = 0;    // string bytes
+            uint64_t stringBytes = 0;
+        };
+
+        const char magic[8] = {'C', 'O', 'L', 'S', 'T', 'O', 'R', 'E'};
+        const uint64_t formatVersion = 1;
+
+        // Directory bytes of the columns (everything but the offsets, which follow from it)
+        inline std::vector<char> directory(const std::vector<ColumnLayout> &columns, size_t rows)
+        {
+            std::vector<char> out(magic, magic + 8);
+            putU64(out, formatVersion);
+            putU64(out, rows);
+            putU64(out, columns.size());
+            for (const ColumnLayout &c : columns)
+            {
+                putU64(out, c.name.size());
+                out.insert(out.end(), c.name.begin(), c.name.end());
+                putU64(out, static_cast<uint64_t>(c.type) | (c.hasValidity ? 0x100 : 0));
+                putU64(out, c.dataOffset);
+                putU64(out, c.validityOffset);
+                putU64(out, c.bytesOffset);
+                putU64(out, c.stringBytes);
+            }
+            return out;
+        }
+
+        /**
+         * Assign every region a 64-byte aligned offset after the directory and return the
+         * file size. The directory size does not depend on the offsets (they are fixed-width),
+         * so it is measured first.
+         */
+        inline size_t planLayout(std::vector<ColumnLayout> &columns, size_t rows)
+        {
+            size_t offset = align64(directory(columns, rows).size());
+            for (ColumnLayout &c : columns)
+            {
+                c.dataOffset = offset;
+                offset = align64(offset + 8 * (c.type == ColumnType::String ? rows + 1 : rows));
+                if (c.hasValidity)
+                {
+                    c.validityOffset = offset;
+                    offset = align64(offset + 8 * ((rows + 63) / 64));
+                }
+                if (c.type == ColumnType::String)
+                {
+                    c.bytesOffset = offset;
+                    offset = align64(offset + c.stringBytes);
+                }
+            }
+            return offset;
+        }
+    }
+
+    /**
+     * Columnar dataset file, memory-mapped.
+     * Layman: Opens a dataset saved by csvToColumnStore or ColumnStoreWriter instantly,
+     * whatever its size, and hands out its columns without copying them.
+     * Technical: File layout (little-endian): "COLSTORE", then uint64 version, rows and
+     * column count, then per column its name (uint64 length + bytes), type and flags, and
+     * the offsets of its regions; every region starts on a 64-byte boundary. Numeric
+     * columns are plain arrays of rows doubles or int64s; string columns are rows + 1
+     * uint64 offsets into a byte region; a column with missing values has a validity
+     * bitmap in the layout of DescriptiveStatistics::ValidityBitmap (bit i of word i / 64
+     * set when row i is present). Opening maps the file and checks the directory against
+     * the file size; data pages are read by the OS on first use.
+     */
+    class ColumnStore
+    {
+    public:
+        explicit ColumnStore(const std::string &path) : file_(detail::MappedFile::openRead(path))
+        {
+            const char *data = file_.data();
+            const size_t size = file_.size();
+            if (size < 8 || std::memcmp(data, detail::magic, 8) != 0)
+                throw std::runtime_error("Not a column store: " + path);
+            size_t pos = 8;
+            if (detail::getU64(data, size, pos) != detail::formatVersion)
+                throw std::runtime_error("Unsupported column store version: " + path);
+            rows_ = static_cast<size_t>(detail::getU64(data, size, pos));
+            const uint64_t numColumns = detail::getU64(data, size, pos);
+            if (numColumns > size)
+                throw std::runtime_error("Corrupt column store: " + path);
+            for (uint64_t c = 0; c < numColumns; ++c)
+            {
+                detail::ColumnLayout column;
+                const uint64_t nameLength = detail::getU64(data, size, pos);
+                if (nameLength > size - pos)
+                    throw std::runtime_error("Corrupt column store: " + path);
+                column.name.assign(data + pos, static_cast<size_t>(nameLength));
+                pos += static_cast<size_t>(nameLength);
+                const uint64_t typeAndFlags = detail::getU64(data, size, pos);
+                column.type = static_cast<ColumnType>(typeAndFlags & 0xFF);
+                column.hasValidity = (typeAndFlags & 0x100) != 0;
+                column.dataOffset = detail::getU64(data, size, pos);
+                column.validityOffset = detail::getU64(data, size, pos);
+                column.bytesOffset = detail::getU64(data, size, pos);
+                column.stringBytes = detail::getU64(data, size, pos);
+                check(column, size, path);
+                columns_.push_back(column);
+            }
+        }
+
+        size_t rows() const { return rows_; }
+        size_t numColumns() const { return columns_.size(); }
+        const std::string &name(size_t c) const { return columns_.at(c).name; }
+        ColumnType type(size_t c) const { return columns_.at(c).type; }
+
+        std::vector<std::string> names() const
+        {
+            std::vector<std::string> result;
+            for (const auto &c : columns_)
+                result.push_back(c.name);
+            return result;
+        }
+
+        size_t columnIndex(const std::string &name) const
+        {
+            for (size_t c = 0; c < columns_.size(); ++c)
+                if (columns_[c].name == name)
+                    return c;
+            throw std::invalid_argument("No column named " + name);
+        }
+
+        ColumnView<double> doubles(size_t c) const
+        {
+            return ColumnView<double>(reinterpret_cast<const double *>(region(c, ColumnType::Float64)), rows_);
+        }
+
+        ColumnView<int64_t> integers(size_t c) const
+        {
+            return ColumnView<int64_t>(reinterpret_cast<const int64_t *>(region(c, ColumnType::Int64)), rows_);
+        }
+
+        StringColumnView strings(size_t c) const
+        {
+            return StringColumnView(reinterpret_cast<const uint64_t *>(region(c, ColumnType::String)),
+                                    file_.data() + columns_[c].bytesOffset, rows_);
+        }
+
+        ColumnView<double> doubles(const std::string &name) const { return doubles(columnIndex(name)); }
+        ColumnView<int64_t> integers(const std::string &name) const { return integers(columnIndex(name)); }
+        StringColumnView strings(const std::string &name) const { return strings(columnIndex(name)); }
+
+        // Validity bitmap of a column, or nullptr when no value is missing
+        const uint64_t *validity(size_t c) const
+        {
+            const detail::ColumnLayout &column = columns_.at(c);
+            return column.hasValidity ? reinterpret_cast<const uint64_t *>(file_.data() + column.validityOffset) : nullptr;
+        }
+
+        // Data pointers of several columns of the same type, for the table functions
+        // (e.g. EDA::correlationMatrix, EDA::profile)
+        template <typename T>
+        std::vector<const T *> pointers(const std::vector<size_t> &columns) const
+        {
+            std::vector<const T *> result;
+            for (size_t c : columns)
+                result.push_back(reinterpret_cast<const T *>(region(c, typeOf(static_cast<const T *>(nullptr)))));
+            return result;
+        }
+
+        std::vector<const uint64_t *> validity(const std::vector<size_t> &columns) const
+        {
+            std::vector<const uint64_t *> result;
+            for (size_t c : columns)
+                result.push_back(validity(c));
+            return result;
+        }
+
+        // Copy of a numeric column as doubles, NaN where missing, for functions taking a
+        // std::vector<double> per variable (e.g. RegressionAnalysis)
+        std::vector<double> toDoubles(size_t c) const
+        {
+            std::vector<double> values(rows_);
+            const uint64_t *present = validity(c);
+            if (type(c) == ColumnType::Int64)
+            {
+                const int64_t *data = integers(c).data();
+                for (size_t i = 0; i < rows_; ++i)
+                    values[i] = static_cast<double>(data[i]);
+            }
+            else
+                values = doubles(c).toVector();
+            for (size_t i = 0; present && i < rows_; ++i)
+                if (!((present[i >> 6] >> (i & 63)) & 1))
+                    values[i] = std::numeric_limits<double>::quiet_NaN();
+            return values;
+        }
+
+        // Copy of numeric columns with one row per observation, for the functions taking
+        // std::vector<std::vector<T>> rows (MultivariateStatistics); NaN where missing
+        std::vector<std::vector<double>> rowMatrix(const std::vector<size_t> &columns) const
+        {
+            std::vector<std::vector<double>> matrix(rows_, std::vector<double>(columns.size()));
+            for (size_t j = 0; j < columns.size(); ++j)
+            {
+                const std::vector<double> values = toDoubles(columns[j]);
+                for (size_t i = 0; i < rows_; ++i)
+                    matrix[i][j] = values[i];
+            }
+            return matrix;
+        }
+
+    private:
+        static ColumnType typeOf(const double *) { return ColumnType::Float64; }
+        static ColumnType typeOf(const int64_t *) { return ColumnType::Int64; }
+
+        const char *region(size_t c, ColumnType type) const
+        {
+            if (columns_.at(c).type != type)
+                throw std::invalid_argument("Column " + columns_[c].name + " has a different type");
+            return file_.data() + columns_[c].dataOffset;
+        }
+
+        void check(const detail::ColumnLayout &c, size_t size, const std::string &path) const
+        {
+            auto fits = [&](uint64_t offset, uint64_t bytes)
+            { return offset % 8 == 0 && offset <= size && bytes <= size - offset; };
+            const uint64_t rows = rows_;
+            const bool valid =
+                (c.type == ColumnType::Float64 || c.type == ColumnType::Int64 || c.type == ColumnType::String) &&
+                rows <= size / 8 &&
+                fits(c.dataOffset, 8 * (c.type == ColumnType::String ? rows + 1 : rows)) &&
+                (!c.hasValidity || fits(c.validityOffset, 8 * ((rows + 63) / 64))) &&
+                (c.type != ColumnType::String ||
+                 (fits(c.bytesOffset, c.stringBytes) &&
+                  reinterpret_cast<const uint64_t *>(file_.data() + c.dataOffset)[rows] == c.stringBytes));
+            if (!valid)
+                throw std::runtime_error("Corrupt column store: " + path);
+        }
+
+        detail::MappedFile file_;
+        size_t rows_ = 0;
+        std::vector<detail::ColumnLayout> columns_;
+    };
+
+    /**
+     * Write in-memory columns as a column store file.
+     * Layman: Saves columns you already have (vectors of numbers or strings) in the format
+     * ColumnStore opens instantly.
+     * Technical: Columns are referenced, not copied, until write(), which sizes the file,
+     * maps it and copies every column into its aligned region once.
+     */
+    class ColumnStoreWriter
+    {
+    public:
+        explicit ColumnStoreWriter(size_t rows) : rows_(rows) {}
+
+        void addColumn(const std::string &name, const double *values, const uint64_t *validity = nullptr)
+        {
+            add(name, ColumnType::Float64, values, validity);
+        }
+
+        void addColumn(const std::string &name, const int64_t *values, const uint64_t *validity = nullptr)
+        {
+            add(name, ColumnType::Int64, values, validity);
+        }
+
+        void addColumn(const std::string &name, const std::vector<std::string> &values, const uint64_t *validity = nullptr)
+        {
+            if (values.size() != rows_)
+                throw std::invalid_argument("Column " + name + " must have one value per row");
+            add(name, ColumnType::String, &values, validity);
+            for (const std::string &s : values)
+                layouts_.back().stringBytes += s.size();
+        }
+
+        void write(const std::string &path) const
+        {
+            std::vector<detail::ColumnLayout> layouts = layouts_;
+            const size_t size = detail::planLayout(layouts, rows_);
+            const std::vector<char> header = detail::directory(layouts, rows_);
+            detail::MappedFile file = detail::MappedFile::create(path, size);
+            char *out = file.data();
+            std::memcpy(out, header.data(), header.size());
+            for (size_t c = 0; c < layouts.size(); ++c)
+            {
+                const detail::ColumnLayout &layout = layouts[c];
+                if (layout.type == ColumnType::String)
+                {
+                    const auto &values = *static_cast<const std::vector<std::string> *>(sources_[c]);
+                    uint64_t *offsets = reinterpret_cast<uint64_t *>(out + layout.dataOffset);
+                    uint64_t position = 0;
+                    for (size_t i = 0; i < rows_; ++i)
+                    {
+                        offsets[i] = position;
+                        if (!values[i].empty())
+                            std::memcpy(out + layout.bytesOffset + position, values[i].data(), values[i].size());
+                        position += values[i].size();
+                    }
+                    offsets[rows_] = position;
+                }
+                else if (rows_ > 0)
+                    std::memcpy(out + layout.dataOffset, sources_[c], 8 * rows_);
+                if (layout.hasValidity && rows_ > 0)
+                    std::memcpy(out + layout.validityOffset, validity_[c], 8 * ((rows_ + 63) / 64));
+            }
+        }
+
+    private:
+        void add(const std::string &name, ColumnType type, const void *source, const uint64_t *validity)
+        {
+            detail::ColumnLayout layout;
+            layout.name = name;
+            layout.type = type;
+            layout.hasValidity = validity != nullptr;
+            layouts_.push_back(layout);
+            sources_.push_back(source);
+            validity_.push_back(validity);
+        }
+
+        size_t rows_;
+        std::vector<detail::ColumnLayout> layouts_;
+        std::vector<const void *> sources_;
+        std::vector<const uint64_t *> validity_;
+    };
+}
+
+#endif // DATA_LOADER_COLUMN_STORE_H
@@ -0,0 +1,794 @@
+#ifndef DATA_LOADER_H
+#define DATA_LOADER_H
+
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+#include <thread>
+#include "ColumnStore.h"
+#include "../ProbabilityDistributionsLib/Parallel.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace DataLoader
+{
+    /**
+     * How to read a CSV file.
+     * Layman: The separator, whether the first line holds the column names, and which
+     * texts mean "no value".
+     * Technical: Fields may be quoted with the quote character, which is escaped inside
+     * quoted fields by doubling it; quoted fields may contain delimiters and line breaks.
+     * Lines end with \n, \r\n or \r and blank lines are skipped. numThreads = 0 uses every
+     * hardware thread; the file is split into chunks of about chunkBytes (> 0) for them.
+     */
+    struct CsvOptions
+    {
+        explicit CsvOptions(char delimiter = ',', bool hasHeader = true)
+            : delimiter(delimiter), quote('"'), hasHeader(hasHeader), numThreads(0), chunkBytes(size_t(8) << 20),
+              missingTokens({"", "NA", "N/A", "NaN", "nan", "null", "NULL"}) {}
+
+        char delimiter;
+        char quote;
+        bool hasHeader;
+        size_t numThreads;
+        size_t chunkBytes;
+        std::vector<std::string> missingTokens; // fields equal to one of these are missing
+    };
+
+    namespace detail
+    {
+        using ProbabilityDistributions::detail::parallelFor; // rethrows the first exception from fn
+
+        // Index of the lowest set bit of x != 0
+        inline size_t lowestBit(uint64_t x)
+        {
+#if defined(__GNUC__)
+            return static_cast<size_t>(__builtin_ctzll(x));
+#else
+            size_t k = 0;
+            for (; !(x & 1); x >>= 1)
+                ++k;
+            return k;
+#endif
+        }
+
+        /**
+         * Finds the next delimiter, quote or line break.
+         * Compares 64 bytes at a time against the four characters and keeps a bitmask of the
+         * matches, so ordinary field bytes are skipped without a branch each. The comparisons
+         * use AVX2 or SSE2 when the compiler targets them and a scalar loop otherwise.
+         */
+        class StructuralScanner
+        {
+        public:
+            StructuralScanner(const char *end, char delimiter, char quote)
+                : end_(end), delimiter_(delimiter), quote_(quote) {}
+
+            // First structural character at or after p, or end
+            const char *next(const char *p)
+            {
+                if (p >= end_)
+                    return end_;
+                if (!block_ || p < block_ || p - block_ >= 64)
+                    load(p);
+                uint64_t mask = mask_ & (~uint64_t(0) << (p - block_));
+                while (!mask)
+                {
+                    if (end_ - block_ <= 64)
+                        return end_;
+                    load(block_ + 64);
+                    mask = mask_;
+                }
+                return block_ + lowestBit(mask);
+            }
+
+        private:
+            void load(const char *p)
+            {
+                block_ = p;
+                if (end_ - p >= 64)
+                {
+                    mask_ = blockMask(p);
+                    return;
+                }
+                mask_ = 0;
+                for (size_t i = 0; p + i < end_; ++i)
+                    mask_ |= static_cast<uint64_t>(isStructural(p[i])) << i;
+            }
+
+            bool isStructural(char c) const { return c == delimiter_ || c == quote_ || c == '\n' || c == '\r'; }
+
+            uint64_t blockMask(const char *p) const
+            {
+#if defined(__AVX2__)
+                const __m256i d = _mm256_set1_epi8(delimiter_), q = _mm256_set1_epi8(quote_);
+                const __m256i lf = _mm256_set1_epi8('\n'), cr = _mm256_set1_epi8('\r');
+                auto half = [&](const char *s) -> uint64_t
+                {
+                    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s));
+                    const __m256i m = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, d), _mm256_cmpeq_epi8(v, q)),
+                                                      _mm256_or_si256(_mm256_cmpeq_epi8(v, lf), _mm256_cmpeq_epi8(v, cr)));
+                    return static_cast<uint32_t>(_mm256_movemask_epi8(m));
+                };
+                return half(p) | half(p + 32) << 32;
+#elif defined(__SSE2__)
+                const __m128i d = _mm_set1_epi8(delimiter_), q = _mm_set1_epi8(quote_);
+                const __m128i lf = _mm_set1_epi8('\n'), cr = _mm_set1_epi8('\r');
+                uint64_t mask = 0;
+                for (int k = 0; k < 4; ++k)
+                {
+                    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 16 * k));
+                    const __m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, d), _mm_cmpeq_epi8(v, q)),
+                                                   _mm_or_si128(_mm_cmpeq_epi8(v, lf), _mm_cmpeq_epi8(v, cr)));
+                    mask |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(m))) << (16 * k);
+                }
+                return mask;
+#else
+                uint64_t mask = 0;
+                for (size_t i = 0; i < 64; ++i)
+                    mask |= static_cast<uint64_t>(isStructural(p[i])) << i;
+                return mask;
+#endif
+            }
+
+            const char *end_;
+            const char *block_ = nullptr;
+            uint64_t mask_ = 0;
+            char delimiter_, quote_;
+        };
+
+        /**
+         * Split [p, end) into fields and rows, calling handler.field(column, text, length,
+         * escapes) for every field (text without the surrounding quotes; escapes = number of
+         * doubled quotes in it), handler.row(fields) at the end of every row and
+         * handler.error(message) for an unterminated quoted field. Stops after maxRows rows
+         * and returns where it stopped.
+         */
+        template <typename Handler>
+        const char *tokenize(const char *p, const char *end, const CsvOptions &options, Handler &handler,
+                             size_t maxRows = std::numeric_limits<size_t>::max())
+        {
+            const char delimiter = options.delimiter, quote = options.quote;
+            StructuralScanner scanner(end, delimiter, quote);
+            // Quotes inside an unquoted field are ordinary characters
+            auto unquotedEnd = [&](const char *s)
+            {
+                const char *q = scanner.next(s);
+                while (q < end && *q == quote)
+                    q = scanner.next(q + 1);
+                return q;
+            };
+            size_t rows = 0, column = 0;
+            while (p < end && rows < maxRows)
+            {
+                if (column == 0 && (*p == '\n' || *p == '\r'))
+                {
+                    ++p; // blank line
+                    continue;
+                }
+                const char *fieldEnd;
+                if (*p == quote)
+                {
+                    const char *s = p + 1, *q;
+                    size_t escapes = 0;
+                    for (;;)
+                    {
+                        q = static_cast<const char *>(std::memchr(s, quote, static_cast<size_t>(end - s)));
+                        if (!q)
+                        {
+                            handler.error("Unterminated quoted field");
+                            return end;
+                        }
+                        if (q + 1 < end && q[1] == quote)
+                        {
+                            ++escapes;
+                            s = q + 2;
+                            continue;
+                        }
+                        break;
+                    }
+                    handler.field(column, p + 1, static_cast<size_t>(q - p - 1), escapes);
+                    fieldEnd = q + 1;
+                    if (fieldEnd < end && *fieldEnd != delimiter && *fieldEnd != '\n' && *fieldEnd != '\r')
+                        fieldEnd = unquotedEnd(fieldEnd); // text after the closing quote is dropped
+                }
+                else
+                {
+                    fieldEnd = unquotedEnd(p);
+                    handler.field(column, p, static_cast<size_t>(fieldEnd - p), 0);
+                }
+
+                if (fieldEnd < end && *fieldEnd == delimiter)
+                {
+                    ++column;
+                    p = fieldEnd + 1;
+                    if (p == end)
+                        handler.field(column, p, 0, 0); // trailing delimiter on the last line
+                    else
+                        continue;
+                }
+                handler.row(column + 1);
+                ++rows;
+                column = 0;
+                if (fieldEnd == end)
+                    return end;
+                p = fieldEnd + 1;
+                if (*fieldEnd == '\r' && p < end && *p == '\n')
+                    ++p;
+            }
+            return p;
+        }
+
+        // Field text without quote escapes (doubled quotes become one)
+        inline void unescape(const char *s, size_t n, char quote, char *out)
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                *out++ = s[i];
+                if (s[i] == quote)
+                    ++i;
+            }
+        }
+
+        // Exact powers of ten representable in a double
+        inline double exactPowerOfTen(int k)
+        {
+            static const double powers[23] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                              1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+            return powers[k];
+        }
+
+        // End of the run of decimal digits starting at p, eight bytes at a time where possible
+        inline const char *skipDigits(const char *p, const char *end)
+        {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+            for (; end - p >= 8; p += 8)
+            {
+                uint64_t v;
+                std::memcpy(&v, p, 8);
+                // High bit of every byte that is not '0'-'9'; exact for the lowest such byte
+                const uint64_t other = ((v + 0x4646464646464646ULL) | (v - 0x3030303030303030ULL)) & 0x8080808080808080ULL;
+                if (other)
+                    return p + lowestBit(other) / 8;
+            }
+#endif
+            while (p < end && static_cast<unsigned>(*p - '0') < 10)
+                ++p;
+            return p;
+        }
+
+        // 10^k mantissa + the value of the digits in [p, end), eight at a time where possible
+        inline uint64_t accumulateDigits(uint64_t mantissa, const char *p, const char *end)
+        {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+            for (; end - p >= 8; p += 8)
+            {
+                uint64_t v;
+                std::memcpy(&v, p, 8);
+                v -= 0x3030303030303030ULL;
+                v = v * 10 + (v >> 8); // pairs of digits
+                v = (((v & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+                     (((v >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+                mantissa = 100000000 * mantissa + v;
+            }
+#endif
+            for (; p < end; ++p)
+                mantissa = 10 * mantissa + static_cast<unsigned>(*p - '0');
+            return mantissa;
+        }
+
+        // strtod of a field, which is not terminated; kept out of the fast path of parseNumber
+        inline double strtodCopy(const char *s, size_t n)
+        {
+            char buffer[64];
+            if (n >= sizeof(buffer))
+                return std::strtod(std::string(s, n).c_str(), nullptr);
+            std::memcpy(buffer, s, n);
+            buffer[n] = '\0';
+            return std::strtod(buffer, nullptr);
+        }
+
+        enum class NumberKind
+        {
+            None,    // not a number
+            Integer, // fits in an int64_t, written without fraction or exponent
+            Real
+        };
+
+        /**
+         * Parse a decimal number (surrounding spaces allowed), as strtod would round it.
+         * Digits are found and accumulated into a 64-bit integer eight bytes at a time (SWAR
+         * arithmetic on a 64-bit word) where possible. When there are at most 19
+         * significant digits, the mantissa is below 2^53 and the decimal exponent is within
+         * +-22, both the mantissa and the power of ten are exact doubles and one IEEE
+         * multiplication or division gives the correctly rounded result (Clinger's fast
+         * path); other numbers, rare in practice, go to strtod. Integers of up to 19 digits
+         * are returned exactly. "inf" and "infinity" in any case are accepted.
+         */
+        inline NumberKind parseNumber(const char *p, const char *end, int64_t &integer, double &real)
+        {
+            while (p < end && (*p == ' ' || *p == '\t'))
+                ++p;
+            while (end > p && (end[-1] == ' ' || end[-1] == '\t'))
+                --end;
+            const char *const start = p;
+            bool negative = false;
+            if (p < end && (*p == '-' || *p == '+'))
+                negative = *p++ == '-';
+
+            // Leading zeros are not significant; every digit after them is
+            const char *const digitsStart = p;
+            while (p < end && *p == '0')
+                ++p;
+            const char *const integerStart = p;
+            p = skipDigits(p, end);
+            const char *const integerEnd = p;
+            const char *fractionStart = p, *fractionEnd = p;
+            bool integral = true;
+            if (p < end && *p == '.')
+            {
+                integral = false;
+                fractionStart = ++p;
+                p = fractionEnd = skipDigits(p, end);
+            }
+            const bool digits = integerEnd > digitsStart || fractionEnd > fractionStart;
+            const char *significantStart = fractionStart;
+            if (integerEnd == integerStart)
+                while (significantStart < fractionEnd && *significantStart == '0')
+                    ++significantStart;
+            const size_t significant = static_cast<size_t>((integerEnd - integerStart) + (fractionEnd - significantStart));
+            const bool truncated = significant > 19;
+            uint64_t mantissa = 0;
+            int exponent = -static_cast<int>(std::min<ptrdiff_t>(fractionEnd - fractionStart, 100000));
+            if (!truncated)
+            {
+                mantissa = accumulateDigits(0, integerStart, integerEnd);
+                mantissa = accumulateDigits(mantissa, significantStart, fractionEnd);
+            }
+            if (!digits)
+            {
+                // inf / infinity
+                const size_t n = static_cast<size_t>(end - p);
+                auto matches = [&](const char *word)
+                {
+                    for (size_t i = 0; i < n; ++i)
+                        if ((p[i] | 0x20) != word[i])
+                            return false;
+                    return true;
+                };
+                if ((n == 3 && matches("inf")) || (n == 8 && matches("infinity")))
+                {
+                    real = negative ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+                    return NumberKind::Real;
+                }
+                return NumberKind::None;
+            }
+            if (p < end && (*p == 'e' || *p == 'E'))
+            {
+                integral = false;
+                ++p;
+                bool negativeExponent = false;
+                if (p < end && (*p == '-' || *p == '+'))
+                    negativeExponent = *p++ == '-';
+                if (p == end || static_cast<unsigned>(*p - '0') >= 10)
+                    return NumberKind::None;
+                int e = 0;
+                for (; p < end && static_cast<unsigned>(*p - '0') < 10; ++p)
+                    if (e < 100000)
+                        e = 10 * e + (*p - '0');
+                exponent += negativeExponent ? -e : e;
+            }
+            if (p != end)
+                return NumberKind::None;
+
+            const uint64_t int64Limit = uint64_t(std::numeric_limits<int64_t>::max()) + (negative ? 1 : 0);
+            if (integral && !truncated && mantissa <= int64Limit)
+            {
+                integer = negative ? static_cast<int64_t>(0 - mantissa) : static_cast<int64_t>(mantissa);
+                return NumberKind::Integer;
+            }
+            if (!truncated && mantissa <= (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22)
+            {
+                double value = static_cast<double>(mantissa);
+                value = exponent < 0 ? value / exactPowerOfTen(-exponent) : value * exactPowerOfTen(exponent);
+                real = negative ? -value : value;
+                return NumberKind::Real;
+            }
+            if (mantissa == 0 && !truncated)
+            {
+                real = negative ? -0.0 : 0.0;
+                return NumberKind::Real;
+            }
+            real = strtodCopy(start, static_cast<size_t>(end - start));
+            return NumberKind::Real;
+        }
+
+        // Column type inferred so far; a column takes the widest kind of its present fields
+        enum Kind : unsigned char
+        {
+            KindEmpty,
+            KindInt64,
+            KindFloat64,
+            KindString
+        };
+
+        class MissingTokens
+        {
+        public:
+            explicit MissingTokens(const std::vector<std::string> &tokens) : tokens_(tokens)
+            {
+                for (const auto &t : tokens_)
+                    longest_ = std::max(longest_, t.size());
+            }
+
+            bool contains(const char *s, size_t n) const
+            {
+                if (n > longest_)
+                    return false;
+                for (const auto &t : tokens_)
+                    if (t.size() == n && std::memcmp(t.data(), s, n) == 0)
+                        return true;
+                return false;
+            }
+
+        private:
+            std::vector<std::string> tokens_;
+            size_t longest_ = 0;
+        };
+
+        // Pass 1 over a chunk: row count, and per column its kind, missing count and string bytes
+        struct ChunkSurvey
+        {
+            explicit ChunkSurvey(size_t columns, const MissingTokens &missingTokens)
+                : kinds(columns, KindEmpty), missing(columns, 0), stringBytes(columns, 0), missingTokens(&missingTokens) {}
+
+            void field(size_t column, const char *s, size_t n, size_t escapes)
+            {
+                if (column >= kinds.size())
+                {
+                    error("Row has more fields than the header");
+                    return;
+                }
+                if (missingTokens->contains(s, n))
+                {
+                    ++missing[column];
+                    return;
+                }
+                stringBytes[column] += n - escapes;
+                if (kinds[column] == KindString)
+                    return;
+                int64_t integer;
+                double real;
+                const NumberKind kind = escapes ? NumberKind::None : parseNumber(s, s + n, integer, real);
+                const unsigned char k = kind == NumberKind::Integer ? KindInt64 : kind == NumberKind::Real ? KindFloat64 : KindString;
+                kinds[column] = std::max(kinds[column], k);
+            }
+
+            void row(size_t fields)
+            {
+                for (size_t c = fields; c < kinds.size(); ++c)
+                    ++missing[c];
+                ++rows;
+            }
+
+            void error(const char *message)
+            {
+                if (errorMessage.empty())
+                {
+                    errorMessage = message;
+                    errorRow = rows;
+                }
+            }
+
+            size_t rows = 0;
+            std::vector<unsigned char> kinds;
+            std::vector<uint64_t> missing, stringBytes;
+            const MissingTokens *missingTokens;
+            std::string errorMessage;
+            size_t errorRow = 0;
+        };
+
+        // Where pass 2 writes one column
+        struct ColumnTarget
+        {
+            ColumnType type;
+            char *values;       // doubles, int64s or string offsets
+            uint64_t *validity; // nullptr when the column has no missing value
+            char *bytes;        // string bytes
+            uint64_t cursor;    // next string byte
+            uint64_t bits;      // presence bits of the current validity word
+        };
+
+        // A validity word shared with a neighbouring chunk, OR-ed in after the pass
+        struct PartialWord
+        {
+            size_t column;
+            size_t word;
+            uint64_t bits;
+        };
+
+        // Pass 2 over a chunk: parse every field and write it at its global row
+        struct ChunkWriter
+        {
+            ChunkWriter(std::vector<ColumnTarget> targets, size_t firstRow, size_t endRow, char quote,
+                        const MissingTokens &missingTokens)
+                : targets(std::move(targets)), firstRow(firstRow), endRow(endRow), row_(firstRow),
+                  word_(firstRow >> 6), quote(quote), missingTokens(&missingTokens) {}
+
+            void field(size_t column, const char *s, size_t n, size_t escapes)
+            {
+                if (column >= targets.size())
+                    return;
+                ColumnTarget &t = targets[column];
+                if (missingTokens->contains(s, n))
+                {
+                    store(t, nullptr, 0, 0);
+                    return;
+                }
+                store(t, s, n, escapes);
+                if (t.validity)
+                    t.bits |= uint64_t(1) << (row_ & 63);
+            }
+
+            void row(size_t fields)
+            {
+                for (size_t c = fields; c < targets.size(); ++c)
+                    store(targets[c], nullptr, 0, 0);
+                ++row_;
+                if ((row_ >> 6) != word_ || row_ == endRow)
+                    flush();
+            }
+
+            void error(const char *) {}
+
+            void store(ColumnTarget &t, const char *s, size_t n, size_t escapes)
+            {
+                int64_t integer = 0;
+                double real = std::numeric_limits<double>::quiet_NaN();
+                switch (t.type)
+                {
+                case ColumnType::Float64:
+                    if (s && parseNumber(s, s + n, integer, real) == NumberKind::Integer)
+                        real = static_cast<double>(integer);
+                    reinterpret_cast<double *>(t.values)[row_] = real;
+                    break;
+                case ColumnType::Int64:
+                    if (s)
+                        parseNumber(s, s + n, integer, real);
+                    reinterpret_cast<int64_t *>(t.values)[row_] = integer;
+                    break;
+                case ColumnType::String:
+                    reinterpret_cast<uint64_t *>(t.values)[row_] = t.cursor;
+                    if (escapes)
+                        unescape(s, n, quote, t.bytes + t.cursor);
+                    else if (n)
+                        std::memcpy(t.bytes + t.cursor, s, n);
+                    t.cursor += n - escapes;
+                    break;
+                }
+            }
+
+            // Write the finished validity word, unless a neighbouring chunk shares it
+            void flush()
+            {
+                const bool shared = word_ * 64 < firstRow || word_ * 64 + 64 > endRow;
+                for (size_t c = 0; c < targets.size(); ++c)
+                {
+                    ColumnTarget &t = targets[c];
+                    if (!t.validity)
+                        continue;
+                    if (shared)
+                        partialWords.push_back(PartialWord{c, word_, t.bits});
+                    else
+                        t.validity[word_] = t.bits;
+                    t.bits = 0;
+                }
+                word_ = row_ >> 6;
+            }
+
+            std::vector<ColumnTarget> targets;
+            size_t firstRow, endRow;
+            size_t row_, word_;
+            char quote;
+            const MissingTokens *missingTokens;
+            std::vector<PartialWord> partialWords;
+        };
+
+        // Collects the first row (the header)
+        struct RowCollector
+        {
+            void field(size_t, const char *s, size_t n, size_t escapes)
+            {
+                std::string text(n - escapes, '\0');
+                if (n)
+                    unescape(s, n, quote, &text[0]);
+                fields.push_back(text);
+            }
+            void row(size_t) {}
+            void error(const char *message) { errorMessage = message; }
+
+            char quote;
+            std::vector<std::string> fields;
+            std::string errorMessage;
+        };
+
+        /**
+         * Chunk starts, and the end: one every chunkBytes, each moved to just after the next
+         * line break outside quotes (a single chunk when there is one thread). Whether a split point is inside quotes follows from the parity of
+         * the quotes before it, counted in parallel, so the file is never scanned serially.
+         */
+        inline std::vector<const char *> chunkStarts(const char *begin, const char *end, const CsvOptions &options)
+        {
+            const size_t threads = options.numThreads ? options.numThreads : std::thread::hardware_concurrency();
+            if (threads <= 1)
+                return std::vector<const char *>{begin, end}; // one thread reads the file in one piece
+            const size_t size = static_cast<size_t>(end - begin);
+            const size_t pieces = std::max<size_t>(1, (size + options.chunkBytes - 1) / options.chunkBytes);
+            const size_t step = (size + pieces - 1) / pieces;
+            std::vector<size_t> quotes(pieces, 0);
+            parallelFor(pieces, options.numThreads, [&](size_t k)
+                        {
+                const char *first = begin + std::min(size, k * step), *last = begin + std::min(size, (k + 1) * step);
+                quotes[k] = static_cast<size_t>(std::count(first, last, options.quote)); });
+
+            std::vector<const char *> starts(1, begin);
+            size_t quotesBefore = 0;
+            for (size_t k = 1; k < pieces; ++k)
+            {
+                quotesBefore += quotes[k - 1];
+                const char *p = begin + std::min(size, k * step);
+                bool quoted = quotesBefore % 2 == 1;
+                if (p <= starts.back())
+                {
+                    p = starts.back(); // the previous start already passed this point, at a row boundary
+                    quoted = false;
+                }
+                for (; p < end; ++p)
+                {
+                    if (*p == options.quote)
+                        quoted = !quoted;
+                    else if (*p == '\n' && !quoted)
+                        break;
+                }
+                starts.push_back(std::min(p + 1, end));
+            }
+            starts.push_back(end);
+            return starts;
+        }
+    }
+
+    /**
+     * Convert a CSV file into a column store file and open it.
+     * Layman: Turns a large CSV file into a binary file whose columns open instantly and
+     * can be handed to every library without parsing again.
+     * Technical: The CSV file is memory-mapped and split into chunks at row boundaries
+     * (see detail::chunkStarts). Two parallel passes run over the chunks: the first counts
+     * rows and infers each column's type (Int64 when every present field is an integer,
+     * else Float64 when every one is a number, else String), missing values and string
+     * sizes; the output file is then sized and mapped, and the second pass parses every
+     * field again and writes it straight to its final place. Memory use is independent of
+     * the file size. Fields are split by a 64-byte SIMD scan for structural characters and
+     * numbers are parsed by detail::parseNumber. Missing fields (one of the missing tokens,
+     * or absent at the end of a short row) get a validity bit of 0 and NaN, 0 or an empty
+     * string as value. Throws std::runtime_error, with the row number, for rows with more
+     * fields than the header and for an unterminated quoted field. Quotes inside unquoted
+     * fields are taken literally but, as in other parallel readers, can mislead the chunk
+     * splitter; use numThreads = 1 (one chunk) for such files.
+     */
+    inline ColumnStore csvToColumnStore(const std::string &csvPath, const std::string &storePath,
+                                        const CsvOptions &options = CsvOptions())
+    {
+        if (options.delimiter == options.quote || options.delimiter == '\n' || options.delimiter == '\r')
+            throw std::invalid_argument("Delimiter must differ from the quote and line breaks");
+        if (options.chunkBytes == 0)
+            throw std::invalid_argument("Chunk size must be positive");
+        detail::MappedFile csv = detail::MappedFile::openRead(csvPath);
+        csv.adviseSequential();
+        const char *begin = csv.data(), *end = csv.data() + csv.size();
+        if (end - begin >= 3 && std::memcmp(begin, "\xEF\xBB\xBF", 3) == 0)
+            begin += 3; // UTF-8 byte order mark
+
+        // Header (or the first row, for the column count)
+        detail::RowCollector first;
+        first.quote = options.quote;
+        const char *body = detail::tokenize(begin, end, options, first, 1);
+        if (!first.errorMessage.empty())
+            throw std::runtime_error(first.errorMessage + " in the first row of " + csvPath);
+        if (first.fields.empty())
+            throw std::runtime_error("CSV file is empty: " + csvPath);
+        std::vector<std::string> names = first.fields;
+        if (!options.hasHeader)
+        {
+            for (size_t c = 0; c < names.size(); ++c)
+                names[c] = "column" + std::to_string(c + 1);
+            body = begin;
+        }
+        const size_t numColumns = names.size();
+        const detail::MissingTokens missingTokens(options.missingTokens);
+
+        // Pass 1: types, missing values, sizes
+        const std::vector<const char *> starts = detail::chunkStarts(body, end, options);
+        const size_t chunks = starts.size() - 1;
+        std::vector<detail::ChunkSurvey> surveys(chunks, detail::ChunkSurvey(numColumns, missingTokens));
+        detail::parallelFor(chunks, options.numThreads, [&](size_t k)
+                            { detail::tokenize(starts[k], starts[k + 1], options, surveys[k]); });
+
+        std::vector<size_t> firstRow(chunks + 1, 0);
+        for (size_t k = 0; k < chunks; ++k)
+        {
+            if (!surveys[k].errorMessage.empty())
+                throw std::runtime_error(surveys[k].errorMessage + " (row " +
+                                         std::to_string(firstRow[k] + surveys[k].errorRow + 1) + " of " + csvPath + ")");
+            firstRow[k + 1] = firstRow[k] + surveys[k].rows;
+        }
+        const size_t rows = firstRow[chunks];
+
+        std::vector<detail::ColumnLayout> layouts(numColumns);
+        for (size_t c = 0; c < numColumns; ++c)
+        {
+            unsigned char kind = detail::KindEmpty;
+            uint64_t missing = 0;
+            for (const auto &s : surveys)
+            {
+                kind = std::max(kind, s.kinds[c]);
+                missing += s.missing[c];
+            }
+            layouts[c].name = names[c];
+            layouts[c].type = kind == detail::KindInt64 ? ColumnType::Int64 : kind == detail::KindString ? ColumnType::String
+                                                                                                          : ColumnType::Float64;
+            layouts[c].hasValidity = missing > 0;
+            if (layouts[c].type == ColumnType::String)
+                for (const auto &s : surveys)
+                    layouts[c].stringBytes += s.stringBytes[c];
+        }
+
+        // Pass 2: write every value in place
+        {
+            const size_t size = detail::planLayout(layouts, rows);
+            const std::vector<char> header = detail::directory(layouts, rows);
+            detail::MappedFile store = detail::MappedFile::create(storePath, size);
+            char *out = store.data();
+            std::memcpy(out, header.data(), header.size());
+
+            std::vector<std::vector<detail::PartialWord>> partialWords(chunks);
+            std::vector<uint64_t> stringStart(numColumns, 0);
+            std::vector<std::vector<detail::ColumnTarget>> targets(chunks, std::vector<detail::ColumnTarget>(numColumns));
+            for (size_t k = 0; k < chunks; ++k)
+                for (size_t c = 0; c < numColumns; ++c)
+                {
+                    const detail::ColumnLayout &layout = layouts[c];
+                    targets[k][c] = detail::ColumnTarget{layout.type, out + layout.dataOffset,
+                                                         layout.hasValidity ? reinterpret_cast<uint64_t *>(out + layout.validityOffset) : nullptr,
+                                                         out + layout.bytesOffset, stringStart[c], 0};
+                    if (layout.type == ColumnType::String)
+                        stringStart[c] += surveys[k].stringBytes[c];
+                }
+            detail::parallelFor(chunks, options.numThreads, [&](size_t k)
+                                {
+                detail::ChunkWriter writer(std::move(targets[k]), firstRow[k], firstRow[k + 1], options.quote, missingTokens);
+                detail::tokenize(starts[k], starts[k + 1], options, writer);
+                partialWords[k] = std::move(writer.partialWords); });
+
+            for (const auto &words : partialWords)
+                for (const detail::PartialWord &w : words)
+                    reinterpret_cast<uint64_t *>(out + layouts[w.column].validityOffset)[w.word] |= w.bits;
+            for (size_t c = 0; c < numColumns; ++c)
+                if (layouts[c].type == ColumnType::String)
+                    reinterpret_cast<uint64_t *>(out + layouts[c].dataOffset)[rows] = layouts[c].stringBytes;
+        }
+        return ColumnStore(storePath);
+    }
+}
+
+#endif // DATA_LOADER_H
@@ -0,0 +1,107 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cmath>
+#include "DataLoader.h"
+#include "ColumnStore.h"
+#include "ChunkedStatistics.h"
+#include "../DescriptiveStatisticsLib/MissingValues.h"
+#include "../ExploratoryDataAnalysisLib/Correlation.h"
+#include "../ExploratoryDataAnalysisLib/Profile.h"
+#include "../InferentialStatisticsLib/Bootstrap.h"
+#include "../MultivariateStatisticsLib/MultivariateStatistics.h"
+#include "../ProbabilityDistributionsLib/ProbabilityDistributions.h"
+#include "../RegressionAnalysisLib/RegressionAnalysis.h"
+#include "../TimeSeriesAnalysisLib/TimeSeriesAnalysis.h"
+
+int main()
+{
+    try
+    {
+        // A small sensor log; real inputs are the same code on multi-GB files
+        {
+            std::ofstream csv("sensors.csv");
+            csv << "minute,temperature,humidity,pressure,site\n";
+            for (int i = 0; i < 240; ++i)
+            {
+                const double temperature = 20.0 + 3.0 * std::sin(i / 20.0) + 0.1 * (i % 7);
+                csv << i << "," << temperature << ",";
+                if (i % 17 != 0)
+                    csv << 40.0 + 0.5 * temperature + (i % 5);
+                else
+                    csv << "NA";
+                csv << "," << 1013.0 - 0.2 * temperature << "," << (i % 3 == 0 ? "\"North, roof\"" : "South") << "\n";
+            }
+        }
+
+        // Parse once into the columnar format, then open it without parsing
+        DataLoader::csvToColumnStore("sensors.csv", "sensors.cols");
+        DataLoader::ColumnStore store("sensors.cols");
+        std::cout << "Rows: " << store.rows() << ", columns:";
+        for (size_t c = 0; c < store.numColumns(); ++c)
+            std::cout << " " << store.name(c)
+                      << (store.type(c) == DataLoader::ColumnType::Int64 ? " (int64)" : store.type(c) == DataLoader::ColumnType::Float64 ? " (float64)"
+                                                                                                                                         : " (string)");
+        std::cout << std::endl;
+
+        DataLoader::ColumnView<double> temperature = store.doubles("temperature");
+        DataLoader::ColumnView<double> humidity = store.doubles("humidity");
+        const uint64_t *humidityValid = store.validity(store.columnIndex("humidity"));
+        std::cout << "Site of row 0: " << store.strings("site")[0] << std::endl;
+
+        // Pointer-and-length functions read the mapped columns directly
+        DescriptiveStatistics::ColumnSummary summary = DescriptiveStatistics::summarize(humidity.data(), humidity.size(), humidityValid);
+        std::cout << "Humidity: " << summary.count << " present, " << summary.missing << " missing, mean " << summary.mean << std::endl;
+
+        const std::vector<size_t> numeric = {store.columnIndex("temperature"), store.columnIndex("humidity"), store.columnIndex("pressure")};
+        std::vector<std::vector<double>> corr = EDA::correlationMatrix(store.pointers<double>(numeric), store.rows(),
+                                                                       EDA::CorrelationMethod::Pearson, 0, store.validity(numeric));
+        std::cout << "Correlation temperature-humidity: " << corr[0][1] << std::endl;
+
+        EDA::ProfileOptions profileOptions;
+        profileOptions.validity = store.validity(numeric);
+        EDA::ProfileReport report = EDA::profile(store.pointers<double>(numeric), store.rows(),
+                                                 std::vector<std::string>{"temperature", "humidity", "pressure"}, profileOptions);
+        std::cout << "Profiled " << report.columns.size() << " columns, temperature median "
+                  << report.columns[0].quantiles[3] << std::endl;
+
+        InferentialStatistics::BootstrapResult boot = InferentialStatistics::bootstrap(
+            temperature.data(), temperature.size(), InferentialStatistics::SampleMean(), InferentialStatistics::ResamplingOptions(2000));
+        std::cout << "Mean temperature 95% CI: [" << boot.lower << ", " << boot.upper << "]" << std::endl;
+
+        ProbabilityDistributions::NormalDistribution normal(20.0, 2.0);
+        std::cout << "Normal(20, 2) log-likelihood: " << normal.logLikelihood(temperature.data(), temperature.size()) << std::endl;
+
+        // Functions taking vectors get a copy of the columns they need
+        std::vector<double> smoothed = TimeSeriesAnalysis::movingAverage(temperature.toVector(), 12);
+        std::cout << "Last hourly moving average: " << smoothed.back() << std::endl;
+
+        std::vector<std::vector<double>> rows = store.rowMatrix({store.columnIndex("temperature"), store.columnIndex("pressure")});
+        std::vector<std::vector<double>> cov = MultivariateStatistics::covarianceMatrix(rows);
+        std::cout << "Var(temperature): " << cov[0][0] << std::endl;
+
+        std::vector<std::vector<double>> X = {store.toDoubles(store.columnIndex("minute"))};
+        std::pair<std::vector<double>, double> fit = RegressionAnalysis::multipleLinearRegression(X, temperature.toVector());
+        std::cout << "Temperature trend per minute: " << fit.first[0] << std::endl;
+
+        // Out-of-core: stream the columns in chunks (the next one is read while this one is
+        // processed) and compute several statistics in a single pass
+        DataLoader::ChunkStream stream(store, numeric, DataLoader::StreamOptions(64, 2));
+        auto streamed = DataLoader::accumulate(stream, DataLoader::MomentsAccumulator(1), DataLoader::QuantileAccumulator(0),
+                                               DataLoader::CorrelationAccumulator({0, 1, 2}), DataLoader::OLSAccumulator({0}, 2));
+        DataLoader::MomentsResult moments = std::get<0>(streamed).finalize();
+        std::cout << "Streamed humidity: " << moments.count << " present, mean " << moments.mean << ", sd " << moments.stddev << std::endl;
+        std::cout << "Streamed temperature median: " << std::get<1>(streamed).finalize()[3] << std::endl;
+        std::cout << "Streamed correlation temperature-humidity: " << std::get<2>(streamed).finalize()[0][1] << std::endl;
+        DataLoader::OLSResult ols = std::get<3>(streamed).finalize();
+        std::cout << "Streamed pressure ~ temperature: slope " << ols.coefficients[0] << " (SE " << ols.standardErrors[0]
+                  << "), R^2 " << ols.rSquared << ", " << stream.stats().chunks << " chunks" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+    }
+
+    return 0;
+}
@@ -50,7 +50,9 @@ namespace DescriptiveStatistics
     /**
      * Calculate the mode(s) of the data.
      * Layman: The number(s) that appear most frequently in your data.
-     * Technical: The value(s) with the highest frequency count.
+     * Technical: The value(s) with the highest frequency count. Exact, so memory grows with
+     * the number of distinct values; for very large categorical columns use the fixed-memory
+     * EDA::heavyHitters and EDA::distinctCount (ExploratoryDataAnalysisLib/Sketches.h).
      */
     template <typename T>
     std::vector<T> mode(const std::vector<T> &data)
@@ -0,0 +1,426 @@
+#ifndef DESCRIPTIVE_MISSING_VALUES_H
+#define DESCRIPTIVE_MISSING_VALUES_H
+
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include "../ProbabilityDistributionsLib/Parallel.h"
+
+namespace DescriptiveStatistics
+{
+    /**
+     * Validity bitmap of a column.
+     * Layman: One bit per row saying whether the row holds a value or is missing.
+     * Technical: Arrow layout: bit i % 64 of word i / 64 is set when row i is present.
+     * Kernels take the words as a const uint64_t * (nullptr = every row present), so
+     * bitmaps produced by other columnar tools can be passed without conversion.
+     */
+    class ValidityBitmap
+    {
+    public:
+        explicit ValidityBitmap(size_t n = 0, bool present = true)
+            : words_((n + 63) / 64, present ? ~uint64_t(0) : 0), size_(n)
+        {
+            if (present && n % 64)
+                words_.back() = (uint64_t(1) << (n % 64)) - 1;
+        }
+
+        void set(size_t i, bool present)
+        {
+            const uint64_t bit = uint64_t(1) << (i & 63);
+            words_[i >> 6] = present ? words_[i >> 6] | bit : words_[i >> 6] & ~bit;
+        }
+
+        bool present(size_t i) const { return (words_[i >> 6] >> (i & 63)) & 1; }
+        size_t size() const { return size_; }
+        const uint64_t *data() const { return words_.data(); }
+
+    private:
+        std::vector<uint64_t> words_;
+        size_t size_;
+    };
+
+    /**
+     * Statistics of the present values of a column, with its missingness report.
+     * A value is missing when it is NaN or its validity bit is clear. variance is the
+     * sample variance (NaN with fewer than two values); mean, min and max are NaN when no
+     * value is present.
+     */
+    struct ColumnSummary
+    {
+        size_t count = 0;   // present values
+        size_t missing = 0; // NaN or masked values
+        size_t missingRuns = 0;       // maximal runs of consecutive missing rows
+        size_t longestMissingRun = 0; // length of the longest such run (the largest gap)
+        double mean = std::numeric_limits<double>::quiet_NaN();
+        double variance = std::numeric_limits<double>::quiet_NaN();
+        double min = std::numeric_limits<double>::quiet_NaN();
+        double max = std::numeric_limits<double>::quiet_NaN();
+
+        double missingFraction() const
+        {
+            return count + missing ? static_cast<double>(missing) / static_cast<double>(count + missing) : 0.0;
+        }
+    };
+
+    namespace detail
+    {
+        // Validity bits of rows [first, first + m), m <= 64, starting at bit 0
+        inline uint64_t validityWord(const uint64_t *validity, size_t first, size_t m)
+        {
+            const size_t shift = first & 63;
+            uint64_t bits = validity[first >> 6] >> shift;
+            if (shift && m > 64 - shift)
+                bits |= validity[(first >> 6) + 1] << (64 - shift);
+            return bits;
+        }
+
+        // Presence mask of rows [first, first + m): validity bit set and not NaN
+        template <typename T>
+        uint64_t presenceWord(const T *x, size_t first, size_t m, const uint64_t *validity)
+        {
+            uint64_t mask = validity ? validityWord(validity, first, m) : ~uint64_t(0);
+            for (size_t j = 0; j < m; ++j)
+                mask &= ~(static_cast<uint64_t>(!(x[first + j] == x[first + j])) << j);
+            return m == 64 ? mask : mask & ((uint64_t(1) << m) - 1);
+        }
+
+        // Index of the lowest set bit of x != 0
+        inline size_t lowestBit(uint64_t x)
+        {
+#if defined(__GNUC__)
+            return static_cast<size_t>(__builtin_ctzll(x));
+#else
+            size_t k = 0;
+            for (; !(x & 1); x >>= 1)
+                ++k;
+            return k;
+#endif
+        }
+
+        // Tracks runs of missing rows across presence words, visiting each run once
+        struct GapTracker
+        {
+            size_t runs = 0, longest = 0, current = 0;
+
+            void add(uint64_t mask, size_t m)
+            {
+                const uint64_t full = m == 64 ? ~uint64_t(0) : (uint64_t(1) << m) - 1;
+                uint64_t missing = ~mask & full;
+                size_t end = 0; // one past the last missing row seen in this word
+                while (missing)
+                {
+                    const size_t start = lowestBit(missing);
+                    if (start > end)
+                        current = 0; // present rows in between
+                    const uint64_t run = ~(missing >> start);
+                    const size_t length = run ? lowestBit(run) : 64 - start;
+                    runs += current == 0;
+                    current += length;
+                    longest = std::max(longest, current);
+                    end = start + length;
+                    missing = end < 64 ? missing & (~uint64_t(0) << end) : 0;
+                }
+                if (end < m)
+                    current = 0;
+            }
+        };
+    }
+
+    /**
+     * Summary statistics and missingness of a column in two vectorized passes, no copy.
+     * Layman: Mean, variance, min and max of the values that are there, and how many
+     * values are missing and in how many gaps, without filtering the data first.
+     * Technical: The first pass works on 64-row words: a branch-free loop builds the
+     * presence mask (not NaN and validity bit set) and feeds eight independent lanes of
+     * count, sum, min and max, where missing values contribute 0 and +/-inf through a
+     * select; the gap counter jumps from one run of missing rows to the next. The second
+     * pass sums squared deviations from the mean the same way (two-pass variance, as in
+     * variance()).
+     * @param validity Optional validity bitmap (nullptr = only NaN is missing)
+     */
+    template <typename T>
+    ColumnSummary summarize(const T *data, size_t n, const uint64_t *validity = nullptr)
+    {
+        const size_t lanes = 8;
+        const double inf = std::numeric_limits<double>::infinity();
+        double sum[lanes] = {}, counts[lanes] = {}, lo[lanes], hi[lanes], sq[lanes] = {};
+        for (size_t l = 0; l < lanes; ++l)
+        {
+            lo[l] = inf;
+            hi[l] = -inf;
+        }
+        std::vector<uint64_t> masks((n + 63) / 64);
+        detail::GapTracker gaps;
+        for (size_t w = 0; w < masks.size(); ++w)
+        {
+            const size_t first = w * 64, m = std::min<size_t>(64, n - first);
+            const uint64_t mask = detail::presenceWord(data, first, m, validity);
+            masks[w] = mask;
+            gaps.add(mask, m);
+            const T *x = data + first;
+            for (size_t j0 = 0; j0 < m; j0 += lanes)
+            {
+                const size_t k = std::min(lanes, m - j0);
+                for (size_t l = 0; l < k; ++l)
+                {
+                    const double d = static_cast<double>(x[j0 + l]);
+                    const bool present = (mask >> (j0 + l)) & 1;
+                    const double low = present ? d : inf, high = present ? d : -inf;
+                    sum[l] += present ? d : 0.0;
+                    counts[l] += present ? 1.0 : 0.0;
+                    lo[l] = low < lo[l] ? low : lo[l];
+                    hi[l] = high > hi[l] ? high : hi[l];
+                }
+            }
+        }
+
+        ColumnSummary s;
+        double total = 0.0, count = 0.0;
+        double min = inf, max = -inf;
+        for (size_t l = 0; l < lanes; ++l)
+        {
+            count += counts[l];
+            total += sum[l];
+            min = std::min(min, lo[l]);
+            max = std::max(max, hi[l]);
+        }
+        s.count = static_cast<size_t>(count);
+        s.missing = n - s.count;
+        s.missingRuns = gaps.runs;
+        s.longestMissingRun = gaps.longest;
+        if (s.count == 0)
+            return s;
+        s.mean = total / count;
+        s.min = min;
+        s.max = max;
+
+        for (size_t w = 0; w < masks.size(); ++w)
+        {
+            const size_t first = w * 64, m = std::min<size_t>(64, n - first);
+            const T *x = data + first;
+            for (size_t j0 = 0; j0 < m; j0 += lanes)
+            {
+                const size_t k = std::min(lanes, m - j0);
+                for (size_t l = 0; l < k; ++l)
+                {
+                    const double dev = static_cast<double>(x[j0 + l]) - s.mean;
+                    sq[l] += (masks[w] >> (j0 + l)) & 1 ? dev * dev : 0.0;
+                }
+            }
+        }
+        if (s.count > 1)
+        {
+            double ssd = 0.0;
+            for (size_t j = 0; j < lanes; ++j)
+                ssd += sq[j];
+            s.variance = ssd / static_cast<double>(s.count - 1);
+        }
+        return s;
+    }
+
+    template <typename T>
+    ColumnSummary summarize(const std::vector<T> &data, const uint64_t *validity = nullptr)
+    {
+        return summarize(data.data(), data.size(), validity);
+    }
+
+    /**
+     * Summaries and missingness reports of many columns in parallel.
+     * Layman: summarize() for every column of a table at once.
+     * Technical: Columns are handed out to threads (numThreads = 0: hardware concurrency); an
+     * exception from any column is rethrown once every thread has joined.
+     * @param validity One bitmap per column (nullptr entries allowed), or empty for none
+     */
+    template <typename T>
+    std::vector<ColumnSummary> summarizeColumns(const std::vector<const T *> &columns, size_t n,
+                                                const std::vector<const uint64_t *> &validity = std::vector<const uint64_t *>(),
+                                                size_t numThreads = 0)
+    {
+        if (!validity.empty() && validity.size() != columns.size())
+            throw std::invalid_argument("One validity bitmap per column required");
+        std::vector<ColumnSummary> result(columns.size());
+        ProbabilityDistributions::detail::parallelFor(columns.size(), numThreads, [&](size_t c)
+                                                      { result[c] = summarize(columns[c], n, validity.empty() ? nullptr : validity[c]); });
+        return result;
+    }
+
+    template <typename T>
+    std::vector<ColumnSummary> summarizeColumns(const std::vector<std::vector<T>> &columns, size_t numThreads = 0)
+    {
+        std::vector<const T *> pointers;
+        for (const auto &column : columns)
+        {
+            if (column.size() != columns[0].size())
+                throw std::invalid_argument("All columns must be the same size");
+            pointers.push_back(column.data());
+        }
+        return summarizeColumns(pointers, columns.empty() ? 0 : columns[0].size(), std::vector<const uint64_t *>(),
+                                numThreads);
+    }
+
+    // Print one line per column: present and missing counts, missing share, gaps and the largest gap
+    inline void printMissingnessReport(const std::vector<ColumnSummary> &summaries,
+                                       const std::vector<std::string> &labels, std::ostream &out = std::cout)
+    {
+        if (labels.size() != summaries.size())
+            throw std::invalid_argument("One label per column required");
+        const std::ios::fmtflags flags = out.flags();
+        const std::streamsize precision = out.precision();
+        out << std::left << std::setw(16) << "Column" << std::right << std::setw(12) << "Present" << std::setw(12)
+            << "Missing" << std::setw(10) << "Missing%" << std::setw(8) << "Gaps" << std::setw(12) << "Largest" << '\n';
+        for (size_t c = 0; c < summaries.size(); ++c)
+        {
+            const ColumnSummary &s = summaries[c];
+            out << std::left << std::setw(16) << labels[c].substr(0, 15) << std::right << std::setw(12) << s.count
+                << std::setw(12) << s.missing << std::setw(10) << std::fixed << std::setprecision(2)
+                << 100.0 * s.missingFraction() << std::setw(8) << s.missingRuns << std::setw(12)
+                << s.longestMissingRun << '\n';
+        }
+        out.flush();
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+    namespace detail
+    {
+        inline const ColumnSummary &requirePresent(const ColumnSummary &s, size_t minimum)
+        {
+            if (s.count < minimum)
+                throw std::invalid_argument(minimum > 1 ? "At least two present values required"
+                                                        : "No present values");
+            return s;
+        }
+    }
+
+    /**
+     * Mean of the present values.
+     * Layman: The average, ignoring missing entries.
+     * Technical: See summarize(); NaN and masked values are skipped inside the loop.
+     */
+    template <typename T>
+    double nanMean(const T *data, size_t n, const uint64_t *validity = nullptr)
+    {
+        return detail::requirePresent(summarize(data, n, validity), 1).mean;
+    }
+
+    template <typename T>
+    double nanMean(const std::vector<T> &data)
+    {
+        return nanMean(data.data(), data.size());
+    }
+
+    // Sample variance of the present values (see summarize)
+    template <typename T>
+    double nanVariance(const T *data, size_t n, const uint64_t *validity = nullptr)
+    {
+        return detail::requirePresent(summarize(data, n, validity), 2).variance;
+    }
+
+    template <typename T>
+    double nanVariance(const std::vector<T> &data)
+    {
+        return nanVariance(data.data(), data.size());
+    }
+
+    template <typename T>
+    double nanStandardDeviation(const T *data, size_t n, const uint64_t *validity = nullptr)
+    {
+        return std::sqrt(nanVariance(data, n, validity));
+    }
+
+    template <typename T>
+    double nanStandardDeviation(const std::vector<T> &data)
+    {
+        return nanStandardDeviation(data.data(), data.size());
+    }
+
+    // Smallest present value
+    template <typename T>
+    double nanMinimum(const T *data, size_t n, const uint64_t *validity = nullptr)
+    {
+        return detail::requirePresent(summarize(data, n, validity), 1).min;
+    }
+
+    template <typename T>
+    double nanMinimum(const std::vector<T> &data)
+    {
+        return nanMinimum(data.data(), data.size());
+    }
+
+    // Largest present value
+    template <typename T>
+    double nanMaximum(const T *data, size_t n, const uint64_t *validity = nullptr)
+    {
+        return detail::requirePresent(summarize(data, n, validity), 1).max;
+    }
+
+    template <typename T>
+    double nanMaximum(const std::vector<T> &data)
+    {
+        return nanMaximum(data.data(), data.size());
+    }
+
+    /**
+     * Percentile of the present values.
+     * Layman: percentile(), ignoring missing entries.
+     * Technical: Same linear interpolation as percentile(), but the present values are
+     * gathered into one scratch buffer (the only copy) and the two order statistics
+     * involved are found by selection, O(n) expected instead of a full sort.
+     * @param p Percentile (0-100)
+     */
+    template <typename T>
+    double nanPercentile(const T *data, size_t n, double p, const uint64_t *validity = nullptr)
+    {
+        if (p < 0.0 || p > 100.0)
+            throw std::invalid_argument("Percentile must be between 0 and 100");
+        std::vector<T> values;
+        values.reserve(n);
+        for (size_t first = 0; first < n; first += 64)
+        {
+            const size_t m = std::min<size_t>(64, n - first);
+            const uint64_t mask = detail::presenceWord(data, first, m, validity);
+            for (size_t j = 0; j < m; ++j)
+                if ((mask >> j) & 1)
+                    values.push_back(data[first + j]);
+        }
+        if (values.empty())
+            throw std::invalid_argument("No present values");
+        const double pos = (p / 100.0) * (values.size() - 1);
+        const size_t idx = static_cast<size_t>(pos);
+        const double frac = pos - idx;
+        std::nth_element(values.begin(), values.begin() + idx, values.end());
+        const double lower = static_cast<double>(values[idx]);
+        if (idx + 1 >= values.size())
+            return lower;
+        const double upper = static_cast<double>(*std::min_element(values.begin() + idx + 1, values.end()));
+        return lower * (1 - frac) + upper * frac;
+    }
+
+    template <typename T>
+    double nanPercentile(const std::vector<T> &data, double p)
+    {
+        return nanPercentile(data.data(), data.size(), p);
+    }
+
+    // Median of the present values (see nanPercentile)
+    template <typename T>
+    double nanMedian(const T *data, size_t n, const uint64_t *validity = nullptr)
+    {
+        return nanPercentile(data, n, 50.0, validity);
+    }
+
+    template <typename T>
+    double nanMedian(const std::vector<T> &data)
+    {
+        return nanMedian(data.data(), data.size());
+    }
+}
+
+#endif // DESCRIPTIVE_MISSING_VALUES_H
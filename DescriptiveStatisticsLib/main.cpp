@@ -1,6 +1,7 @@
 #include <iostream>
 #include <vector>
 #include "DescriptiveStatistics.h"
+#include "MissingValues.h"
 #include "../matplotlib-cpp/matplotlibcpp.h"
 #include <cmath>
 
@@ -65,6 +66,18 @@ int main()
     std::cout << "50th Percentile (Q2): " << DescriptiveStatistics::quartile(dataDouble, 2) << std::endl;
     std::cout << "75th Percentile (Q3): " << DescriptiveStatistics::quartile(dataDouble, 3) << std::endl;
 
+    // Missing values: NaN readings and rows masked out by a validity bitmap are skipped
+    std::vector<double> readings = {21.5, NAN, 22.1, 23.4, NAN, NAN, 22.8, 99.0};
+    DescriptiveStatistics::ValidityBitmap valid(readings.size());
+    valid.set(7, false); // known-bad sensor reading
+    DescriptiveStatistics::ColumnSummary summary = DescriptiveStatistics::summarize(readings, valid.data());
+    std::cout << "Present: " << summary.count << ", mean " << summary.mean << ", std dev "
+              << std::sqrt(summary.variance) << std::endl;
+    std::cout << "NaN-skipping median: " << DescriptiveStatistics::nanMedian(readings) << std::endl;
+    DescriptiveStatistics::printMissingnessReport({summary}, {"temperature"});
+
+    std::cout << std::endl;
+
     // Visualization of Descriptive Statistics
     namespace plt = matplotlibcpp;
 
@@ -0,0 +1,726 @@
+#ifndef EDA_CORRELATION_H
+#define EDA_CORRELATION_H
+
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include "Histogram.h"
+
+namespace EDA
+{
+    enum class CorrelationMethod
+    {
+        Pearson,  // linear association
+        Spearman, // Pearson correlation of the ranks (monotonic association)
+        Kendall   // tau-b: concordant minus discordant pairs, adjusted for ties
+    };
+
+    namespace detail
+    {
+        // Columns are packed in panels of 8, row-interleaved: column c, row r of a chunk of
+        // `rows` rows lives at panels[(c / 8) * rows * 8 + r * 8 + c % 8]
+        const size_t panelWidth = 8;
+
+        // c[p][q] += sum over r of a[r][p] b[r][q] for 4 columns of one panel (a) and the
+        // 8 columns of another (b). The 32 accumulators stay in registers and every row is
+        // one broadcast per a column and one contiguous 8-wide load of b, so the compiler
+        // vectorizes the q loop without reassociating any sum.
+        inline void gramKernel(const double *a, const double *b, size_t rows, double *c, size_t ldc)
+        {
+            double acc[4][8] = {};
+            for (size_t r = 0; r < rows; ++r)
+            {
+                const double *ar = a + r * panelWidth;
+                const double *br = b + r * panelWidth;
+                for (size_t p = 0; p < 4; ++p)
+                {
+                    const double x = ar[p];
+                    for (size_t q = 0; q < 8; ++q)
+                        acc[p][q] += x * br[q];
+                }
+            }
+            for (size_t p = 0; p < 4; ++p)
+                for (size_t q = 0; q < 8; ++q)
+                    c[p * ldc + q] += acc[p][q];
+        }
+
+        // Output blocks are 64 x 64 columns (8 panels)
+        const size_t blockPanels = 8;
+
+        // Every block (i, j), i <= j, of the upper triangle of a Gram matrix
+        inline std::vector<std::pair<size_t, size_t>> upperBlocks(size_t numColumns)
+        {
+            const size_t numBlocks = (numColumns + blockPanels * panelWidth - 1) / (blockPanels * panelWidth);
+            std::vector<std::pair<size_t, size_t>> blocks;
+            for (size_t i = 0; i < numBlocks; ++i)
+                for (size_t j = i; j < numBlocks; ++j)
+                    blocks.push_back(std::make_pair(i, j));
+            return blocks;
+        }
+
+        /**
+         * Add Z'Z of a packed chunk to the given output blocks of gram (ldc x ldc, ldc =
+         * panels * 8; blocks on the diagonal are filled on and above it).
+         * Blocked for cache: output blocks of 64 x 64 columns are independent tasks run in
+         * parallel; within a task, slices of 256 rows keep the 64 a columns in L2 while each
+         * 8-column b panel slice (16 KB) is reused from L1 by all 16 micro-kernels.
+         */
+        inline void accumulateGram(const double *panels, size_t numPanels, size_t rows, double *gram,
+                                   const std::vector<std::pair<size_t, size_t>> &tasks, size_t numThreads)
+        {
+            const size_t slice = 256;
+            const size_t ldc = numPanels * panelWidth;
+            auto multiplyBlock = [&](size_t t)
+            {
+                const size_t ib = tasks[t].first, jb = tasks[t].second;
+                const size_t iEnd = std::min(numPanels, (ib + 1) * blockPanels);
+                const size_t jEnd = std::min(numPanels, (jb + 1) * blockPanels);
+                for (size_t r0 = 0; r0 < rows; r0 += slice)
+                {
+                    const size_t len = std::min(slice, rows - r0);
+                    for (size_t jp = jb * blockPanels; jp < jEnd; ++jp)
+                    {
+                        const double *b = panels + jp * rows * panelWidth + r0 * panelWidth;
+                        for (size_t ip = ib * blockPanels; ip < iEnd && ip <= jp; ++ip)
+                        {
+                            const double *a = panels + ip * rows * panelWidth + r0 * panelWidth;
+                            for (size_t half = 0; half < 2; ++half)
+                                gramKernel(a + 4 * half, b, len, gram + (ip * panelWidth + 4 * half) * ldc + jp * panelWidth, ldc);
+                        }
+                    }
+                }
+            };
+            parallelFor(tasks.size(), numThreads, multiplyBlock);
+        }
+
+        /**
+         * Gram matrix Z'Z of an n x numColumns matrix built chunk by chunk.
+         * fill(c, first, rows, out) writes rows [first, first + rows) of column c to
+         * out[0], out[panelWidth], ...; each chunk of rows is packed once (panels in
+         * parallel) and the blocks of its Gram matrix listed in tasks (see upperBlocks) are
+         * added by accumulateGram. Returns a ldc x ldc matrix, ldc = numColumns rounded up
+         * to panelWidth, filled in those blocks.
+         */
+        template <typename Fill>
+        std::vector<double> chunkedGram(size_t numColumns, size_t n, size_t numThreads, Fill fill,
+                                        const std::vector<std::pair<size_t, size_t>> &tasks, size_t &ldc)
+        {
+            const size_t numPanels = (numColumns + panelWidth - 1) / panelWidth;
+            ldc = numPanels * panelWidth;
+            // About 32 MB of panels per chunk, in whole 256-row slices
+            const size_t chunkRows = std::min(n, std::max<size_t>(256, (size_t(1) << 22) / ldc / 256 * 256));
+            std::vector<double> panels(numPanels * chunkRows * panelWidth);
+            std::vector<double> gram(ldc * ldc, 0.0);
+            for (size_t first = 0; first < n; first += chunkRows)
+            {
+                const size_t rows = std::min(chunkRows, n - first);
+                auto packPanel = [&](size_t k)
+                {
+                    double *panel = panels.data() + k * rows * panelWidth;
+                    for (size_t q = 0; q < panelWidth; ++q)
+                    {
+                        const size_t c = k * panelWidth + q;
+                        if (c < numColumns)
+                            fill(c, first, rows, panel + q);
+                        else
+                            for (size_t r = 0; r < rows; ++r)
+                                panel[r * panelWidth + q] = 0.0; // padding column
+                    }
+                };
+                parallelFor(numPanels, numThreads, packPanel);
+                accumulateGram(panels.data(), numPanels, rows, gram.data(), tasks, numThreads);
+            }
+            return gram;
+        }
+
+        // Rows present in each column: not NaN and validity bit set (see DescriptiveStatistics::ValidityBitmap)
+        struct Presence
+        {
+            std::vector<std::vector<uint64_t>> words; // per column; empty when every row is present
+            size_t columnsWithMissing = 0;
+
+            const uint64_t *column(size_t c) const { return words[c].empty() ? nullptr : words[c].data(); }
+            bool present(size_t c, size_t row) const
+            {
+                return words[c].empty() || ((words[c][row >> 6] >> (row & 63)) & 1);
+            }
+        };
+
+        template <typename T>
+        Presence presence(const std::vector<const T *> &columns, size_t n,
+                          const std::vector<const uint64_t *> &validity, size_t numThreads)
+        {
+            Presence result;
+            result.words.resize(columns.size());
+            auto scanColumn = [&](size_t c)
+            {
+                const uint64_t *bits = columnValidity(validity, c);
+                std::vector<uint64_t> words((n + 63) / 64);
+                bool complete = true;
+                for (size_t w = 0; w < words.size(); ++w)
+                {
+                    const size_t m = std::min<size_t>(64, n - w * 64);
+                    words[w] = DescriptiveStatistics::detail::presenceWord(columns[c], w * 64, m, bits);
+                    complete = complete && words[w] == (m == 64 ? ~uint64_t(0) : (uint64_t(1) << m) - 1);
+                }
+                if (!complete)
+                    result.words[c].swap(words);
+            };
+            parallelFor(columns.size(), numThreads, scanColumn);
+            for (const auto &words : result.words)
+                result.columnsWithMissing += !words.empty();
+            return result;
+        }
+
+        // Mean and 1 / ||x - mean|| of the present values of every column (0 for constant columns)
+        template <typename T>
+        void columnScales(const std::vector<const T *> &columns, size_t n, const Presence &present, size_t numThreads,
+                          std::vector<double> &means, std::vector<double> &scales)
+        {
+            means.assign(columns.size(), 0.0);
+            scales.assign(columns.size(), 0.0);
+            auto columnMoments = [&](size_t c)
+            {
+                const T *x = columns[c];
+                const uint64_t *bits = present.column(c);
+                double sum = 0.0, count = 0.0;
+                for (size_t i = 0; i < n; ++i)
+                {
+                    const bool valid = !bits || ((bits[i >> 6] >> (i & 63)) & 1);
+                    sum += valid ? static_cast<double>(x[i]) : 0.0;
+                    count += valid ? 1.0 : 0.0;
+                }
+                if (count < 2.0)
+                    return;
+                const double mean = sum / count;
+                double ssd = 0.0;
+                for (size_t i = 0; i < n; ++i)
+                {
+                    const bool valid = !bits || ((bits[i >> 6] >> (i & 63)) & 1);
+                    const double dev = static_cast<double>(x[i]) - mean;
+                    ssd += valid ? dev * dev : 0.0;
+                }
+                means[c] = mean;
+                scales[c] = ssd > 0.0 ? 1.0 / std::sqrt(ssd) : 0.0;
+            };
+            parallelFor(columns.size(), numThreads, columnMoments);
+        }
+
+        /**
+         * Pearson correlation matrix of columns of n values.
+         * Means and norms come from a two-pass scan per column; each chunk of rows is then
+         * standardized exactly once, z = (x - mean) / ||x - mean||, and the chunk's Gram
+         * matrix is accumulated, so r_ij = sum z_i z_j with no per-pair passes. Constant
+         * columns give NaN.
+         */
+        template <typename T>
+        std::vector<std::vector<double>> pearsonMatrix(const std::vector<const T *> &columns, size_t n,
+                                                       size_t numThreads)
+        {
+            const size_t d = columns.size();
+            std::vector<double> means, scales;
+            Presence complete;
+            complete.words.resize(d);
+            columnScales(columns, n, complete, numThreads, means, scales);
+            auto standardize = [&](size_t c, size_t first, size_t rows, double *out)
+            {
+                const T *x = columns[c] + first;
+                const double mean = means[c], scale = scales[c];
+                for (size_t r = 0; r < rows; ++r)
+                    out[r * panelWidth] = (static_cast<double>(x[r]) - mean) * scale;
+            };
+            size_t ldc = 0;
+            const std::vector<double> gram = chunkedGram(d, n, numThreads, standardize, upperBlocks(d), ldc);
+
+            const double nan = std::numeric_limits<double>::quiet_NaN();
+            std::vector<std::vector<double>> matrix(d, std::vector<double>(d));
+            for (size_t i = 0; i < d; ++i)
+                for (size_t j = i; j < d; ++j)
+                {
+                    const double r = scales[i] > 0.0 && scales[j] > 0.0
+                                         ? (i == j ? 1.0 : std::max(-1.0, std::min(1.0, gram[i * ldc + j])))
+                                         : nan;
+                    matrix[i][j] = matrix[j][i] = r;
+                }
+            return matrix;
+        }
+
+        /**
+         * Pairwise-complete Pearson correlation matrix: r_ij over the rows where both
+         * columns are present.
+         * Each column is standardized once over its own present values and packed three
+         * times: z (0 where missing), the presence indicator m and z^2, each group padded to
+         * whole output blocks. Four blocks of the Gram matrix of these columns hold, for
+         * every pair, the count sum m_i m_j, the sums sum z_i m_j and sum z_i^2 m_j over the
+         * pair's rows, and sum z_i z_j, from which
+         * r_ij = (S_xy - S_x S_y / n) / sqrt((S_xx - S_x^2 / n)(S_yy - S_y^2 / n)).
+         * About 6x the work of the complete-data kernel, with no per-pair passes.
+         */
+        template <typename T>
+        std::vector<std::vector<double>> pairwisePearsonMatrix(const std::vector<const T *> &columns, size_t n,
+                                                               const Presence &present, size_t numThreads)
+        {
+            const size_t d = columns.size();
+            std::vector<double> means, scales;
+            columnScales(columns, n, present, numThreads, means, scales);
+            const size_t groupBlocks = (d + blockPanels * panelWidth - 1) / (blockPanels * panelWidth);
+            const size_t group = groupBlocks * blockPanels * panelWidth;
+            auto pack = [&](size_t column, size_t first, size_t rows, double *out)
+            {
+                const size_t c = column % group, part = column / group; // 0: z, 1: m, 2: z^2
+                if (c >= d)
+                {
+                    for (size_t r = 0; r < rows; ++r)
+                        out[r * panelWidth] = 0.0;
+                    return;
+                }
+                const T *x = columns[c];
+                const uint64_t *bits = present.column(c);
+                const double mean = means[c], scale = scales[c];
+                for (size_t r = 0; r < rows; ++r)
+                {
+                    const size_t i = first + r;
+                    const bool valid = !bits || ((bits[i >> 6] >> (i & 63)) & 1);
+                    const double z = valid ? (static_cast<double>(x[i]) - mean) * scale : 0.0;
+                    out[r * panelWidth] = part == 0 ? z : part == 1 ? (valid ? 1.0 : 0.0) : z * z;
+                }
+            };
+            // Only the blocks z'z, z'm, m'm and m'(z^2) are needed
+            std::vector<std::pair<size_t, size_t>> tasks;
+            for (const auto &block : upperBlocks(3 * group))
+            {
+                const size_t gi = block.first / groupBlocks, gj = block.second / groupBlocks;
+                if (gi <= 1 && gj - gi <= 1)
+                    tasks.push_back(block);
+            }
+            size_t ldc = 0;
+            const std::vector<double> gram = chunkedGram(3 * group, n, numThreads, pack, tasks, ldc);
+            auto g = [&](size_t i, size_t j) { return gram[i * ldc + j]; };
+
+            const double nan = std::numeric_limits<double>::quiet_NaN();
+            std::vector<std::vector<double>> matrix(d, std::vector<double>(d));
+            for (size_t i = 0; i < d; ++i)
+            {
+                matrix[i][i] = scales[i] > 0.0 ? 1.0 : nan;
+                for (size_t j = i + 1; j < d; ++j)
+                {
+                    const double count = g(group + i, group + j);
+                    const double sx = g(i, group + j), sy = g(j, group + i);
+                    const double sxx = g(group + j, 2 * group + i), syy = g(group + i, 2 * group + j);
+                    const double vx = sxx - sx * sx / count, vy = syy - sy * sy / count;
+                    // A column constant over the pair's rows leaves only rounding noise in its variance
+                    const bool defined = count >= 2.0 && vx > 1e-12 * sxx && vy > 1e-12 * syy;
+                    const double r = (g(i, j) - sx * sy / count) / std::sqrt(vx * vy);
+                    matrix[i][j] = matrix[j][i] = defined ? std::max(-1.0, std::min(1.0, r)) : nan;
+                }
+            }
+            return matrix;
+        }
+
+        // Ranks 1..n with ties given their average rank
+        template <typename T>
+        void averageRanks(const T *x, size_t n, double *ranks)
+        {
+            std::vector<size_t> order(n);
+            for (size_t i = 0; i < n; ++i)
+                order[i] = i;
+            std::sort(order.begin(), order.end(), [x](size_t a, size_t b) { return x[a] < x[b]; });
+            for (size_t i = 0; i < n;)
+            {
+                size_t j = i + 1;
+                while (j < n && !(x[order[i]] < x[order[j]]))
+                    ++j;
+                const double rank = 0.5 * static_cast<double>(i + j + 1); // average of i + 1 .. j
+                for (size_t k = i; k < j; ++k)
+                    ranks[order[k]] = rank;
+                i = j;
+            }
+        }
+
+        // The present rows of a column in sorted order, and dense ranks (equal values share a rank)
+        struct SortedColumn
+        {
+            std::vector<uint32_t> order;
+            std::vector<uint32_t> rank; // by row; 0 for missing rows
+            size_t distinct = 0;
+        };
+
+        template <typename T>
+        SortedColumn sortedColumn(const T *x, size_t n, const uint64_t *present)
+        {
+            if (n > std::numeric_limits<uint32_t>::max())
+                throw std::invalid_argument("Rank correlations support at most 2^32 - 1 rows");
+            SortedColumn column;
+            column.rank.assign(n, 0);
+            for (size_t i = 0; i < n; ++i)
+                if (!present || ((present[i >> 6] >> (i & 63)) & 1))
+                    column.order.push_back(static_cast<uint32_t>(i));
+            std::sort(column.order.begin(), column.order.end(), [x](uint32_t a, uint32_t b) { return x[a] < x[b]; });
+            for (size_t k = 0; k < column.order.size(); ++k)
+            {
+                if (k == 0 || x[column.order[k - 1]] < x[column.order[k]])
+                    ++column.distinct;
+                column.rank[column.order[k]] = static_cast<uint32_t>(column.distinct - 1);
+            }
+            return column;
+        }
+
+        // Number of pairs i < j with y[i] > y[j], by bottom-up merge sort; y ends up sorted
+        inline uint64_t countInversions(std::vector<uint32_t> &y, std::vector<uint32_t> &buffer)
+        {
+            const size_t n = y.size();
+            buffer.resize(n);
+            uint64_t inversions = 0;
+            for (size_t width = 1; width < n; width *= 2)
+            {
+                for (size_t lo = 0; lo < n; lo += 2 * width)
+                {
+                    const size_t mid = std::min(lo + width, n), hi = std::min(lo + 2 * width, n);
+                    size_t i = lo, j = mid, k = lo;
+                    while (i < mid && j < hi)
+                    {
+                        if (y[i] <= y[j])
+                            buffer[k++] = y[i++];
+                        else
+                        {
+                            inversions += mid - i;
+                            buffer[k++] = y[j++];
+                        }
+                    }
+                    while (i < mid)
+                        buffer[k++] = y[i++];
+                    while (j < hi)
+                        buffer[k++] = y[j++];
+                }
+                y.swap(buffer);
+            }
+            return inversions;
+        }
+
+        // Sum of t (t - 1) / 2 over the runs of equal values of a sorted range
+        inline double tiedPairs(const uint32_t *first, const uint32_t *last)
+        {
+            double ties = 0.0;
+            while (first != last)
+            {
+                const uint32_t *run = first + 1;
+                while (run != last && *run == *first)
+                    ++run;
+                const double t = static_cast<double>(run - first);
+                ties += 0.5 * t * (t - 1.0);
+                first = run;
+            }
+            return ties;
+        }
+
+        /**
+         * Kendall tau-b of two sorted columns in O(n log n) (Knight's algorithm).
+         * Walks the rows in x order, skipping rows missing from y (yPresent, nullptr = none),
+         * sorts the y ranks within each run of tied x to count pairs tied in both and in x,
+         * and counts discordant pairs as the swaps a merge sort of the y ranks needs:
+         *   tau_b = (P - ties_x - ties_y + ties_xy - 2 swaps) / sqrt((P - ties_x)(P - ties_y)),
+         * P = m (m - 1) / 2 over the m rows present in both. scratch and buffer are reused
+         * between calls.
+         */
+        inline double kendallTauB(const SortedColumn &x, const SortedColumn &y, const uint64_t *yPresent,
+                                  std::vector<uint32_t> &scratch, std::vector<uint32_t> &buffer)
+        {
+            scratch.clear();
+            double xTies = 0.0, jointTies = 0.0;
+            size_t groupStart = 0;
+            uint32_t groupRank = 0;
+            for (uint32_t row : x.order)
+            {
+                if (yPresent && !((yPresent[row >> 6] >> (row & 63)) & 1))
+                    continue;
+                if (scratch.empty() || x.rank[row] != groupRank)
+                {
+                    std::sort(scratch.begin() + groupStart, scratch.end());
+                    const double t = static_cast<double>(scratch.size() - groupStart);
+                    xTies += 0.5 * t * (t - 1.0);
+                    jointTies += tiedPairs(scratch.data() + groupStart, scratch.data() + scratch.size());
+                    groupStart = scratch.size();
+                    groupRank = x.rank[row];
+                }
+                scratch.push_back(y.rank[row]);
+            }
+            std::sort(scratch.begin() + groupStart, scratch.end());
+            const double t = static_cast<double>(scratch.size() - groupStart);
+            xTies += 0.5 * t * (t - 1.0);
+            jointTies += tiedPairs(scratch.data() + groupStart, scratch.data() + scratch.size());
+
+            const double m = static_cast<double>(scratch.size());
+            const double pairs = 0.5 * m * (m - 1.0);
+            const double swaps = static_cast<double>(countInversions(scratch, buffer));
+            const double yTies = tiedPairs(scratch.data(), scratch.data() + scratch.size());
+            const double denominator = std::sqrt((pairs - xTies) * (pairs - yTies));
+            if (!(denominator > 0.0))
+                return std::numeric_limits<double>::quiet_NaN();
+            const double tau = (pairs - xTies - yTies + jointTies - 2.0 * swaps) / denominator;
+            return std::max(-1.0, std::min(1.0, tau));
+        }
+
+        /**
+         * Spearman correlation of two sorted columns over the rows present in both.
+         * Ranks are recomputed on the common rows in O(m) from the sorted orders (ties get
+         * average ranks), then correlated; the mean rank is (m + 1) / 2 exactly.
+         */
+        inline double pairwiseSpearman(const SortedColumn &x, const SortedColumn &y, const Presence &present,
+                                       size_t a, size_t b, std::vector<double> &xRanks, std::vector<double> &yRanks,
+                                       std::vector<uint32_t> &rows)
+        {
+            auto rankCommon = [&](const SortedColumn &column, size_t other, std::vector<double> &ranks, bool collect)
+            {
+                size_t kept = 0, groupStart = 0;
+                uint32_t groupRank = 0;
+                std::vector<uint32_t> group;
+                auto closeGroup = [&]()
+                {
+                    const double rank = 0.5 * static_cast<double>(groupStart + kept + 1);
+                    for (uint32_t r : group)
+                        ranks[r] = rank;
+                    group.clear();
+                    groupStart = kept;
+                };
+                for (uint32_t row : column.order)
+                {
+                    if (!present.present(other, row))
+                        continue;
+                    if (kept > groupStart && column.rank[row] != groupRank)
+                        closeGroup();
+                    groupRank = column.rank[row];
+                    group.push_back(row);
+                    if (collect)
+                        rows.push_back(row);
+                    ++kept;
+                }
+                closeGroup();
+                return kept;
+            };
+            rows.clear();
+            const size_t m = rankCommon(x, b, xRanks, true);
+            rankCommon(y, a, yRanks, false);
+            const double mean = 0.5 * static_cast<double>(m + 1);
+            double sxy = 0.0, sxx = 0.0, syy = 0.0;
+            for (uint32_t row : rows)
+            {
+                const double dx = xRanks[row] - mean, dy = yRanks[row] - mean;
+                sxy += dx * dy;
+                sxx += dx * dx;
+                syy += dy * dy;
+            }
+            if (m < 2 || !(sxx > 0.0) || !(syy > 0.0))
+                return std::numeric_limits<double>::quiet_NaN();
+            return std::max(-1.0, std::min(1.0, sxy / std::sqrt(sxx * syy)));
+        }
+
+        template <typename T>
+        std::vector<SortedColumn> sortedColumns(const std::vector<const T *> &columns, size_t n,
+                                                const Presence &present, size_t numThreads)
+        {
+            std::vector<SortedColumn> sorted(columns.size());
+            auto sortColumn = [&](size_t c)
+            {
+                sorted[c] = sortedColumn(columns[c], n, present.column(c));
+            };
+            parallelFor(columns.size(), numThreads, sortColumn);
+            return sorted;
+        }
+
+        template <typename T>
+        std::vector<std::vector<double>> kendallMatrix(const std::vector<const T *> &columns, size_t n,
+                                                       const Presence &present, size_t numThreads)
+        {
+            const size_t d = columns.size();
+            const std::vector<SortedColumn> sorted = sortedColumns(columns, n, present, numThreads);
+            std::vector<std::vector<double>> matrix(d, std::vector<double>(d));
+            auto rowPairs = [&](size_t a)
+            {
+                std::vector<uint32_t> scratch, buffer;
+                matrix[a][a] = sorted[a].distinct > 1 ? 1.0 : std::numeric_limits<double>::quiet_NaN();
+                for (size_t b = a + 1; b < d; ++b)
+                    matrix[a][b] = kendallTauB(sorted[a], sorted[b], present.column(b), scratch, buffer);
+            };
+            parallelFor(d, numThreads, rowPairs);
+            for (size_t a = 0; a < d; ++a)
+                for (size_t b = 0; b < a; ++b)
+                    matrix[a][b] = matrix[b][a];
+            return matrix;
+        }
+
+        /**
+         * Spearman correlation matrix. Each column is ranked once and the ranks go through
+         * the Pearson kernel; with missing values that result stands for the pairs of
+         * complete columns, and every pair involving a column with missing values is
+         * re-ranked on its common rows (pairwiseSpearman), pairs in parallel.
+         */
+        template <typename T>
+        std::vector<std::vector<double>> spearmanMatrix(const std::vector<const T *> &columns, size_t n,
+                                                        const Presence &present, size_t numThreads)
+        {
+            const size_t d = columns.size();
+            std::vector<std::vector<double>> ranks(d, std::vector<double>(n, 0.0));
+            std::vector<SortedColumn> sorted;
+            if (present.columnsWithMissing == 0)
+            {
+                auto rankColumn = [&](size_t c)
+                {
+                    averageRanks(columns[c], n, ranks[c].data());
+                };
+                parallelFor(d, numThreads, rankColumn);
+            }
+            else
+            {
+                sorted = sortedColumns(columns, n, present, numThreads);
+                auto rankColumn = [&](size_t c)
+                {
+                    const std::vector<uint32_t> &order = sorted[c].order;
+                    for (size_t i = 0; i < order.size();)
+                    {
+                        size_t j = i + 1;
+                        while (j < order.size() && sorted[c].rank[order[j]] == sorted[c].rank[order[i]])
+                            ++j;
+                        for (size_t k = i; k < j; ++k)
+                            ranks[c][order[k]] = 0.5 * static_cast<double>(i + j + 1);
+                        i = j;
+                    }
+                };
+                parallelFor(d, numThreads, rankColumn);
+            }
+            std::vector<const double *> pointers;
+            for (const auto &column : ranks)
+                pointers.push_back(column.data());
+            std::vector<std::vector<double>> matrix = pearsonMatrix(pointers, n, numThreads);
+            if (present.columnsWithMissing == 0)
+                return matrix;
+
+            auto rowPairs = [&](size_t a)
+            {
+                std::vector<double> xRanks(n), yRanks(n);
+                std::vector<uint32_t> rows;
+                for (size_t b = a; b < d; ++b)
+                    if (present.column(a) || present.column(b))
+                    {
+                        matrix[a][b] = a == b ? (sorted[a].distinct > 1 ? 1.0 : std::numeric_limits<double>::quiet_NaN())
+                                              : pairwiseSpearman(sorted[a], sorted[b], present, a, b, xRanks, yRanks, rows);
+                        matrix[b][a] = matrix[a][b];
+                    }
+            };
+            parallelFor(d, numThreads, rowPairs);
+            return matrix;
+        }
+    }
+
+    /**
+     * Correlation matrix of many columns.
+     * Layman: How strongly every pair of columns moves together, in one call. Missing
+     * values (NaN, or rows masked out by a validity bitmap) are skipped pair by pair.
+     * Technical: Pearson standardizes each column once and accumulates the Gram matrix of
+     * the standardized data with a blocked, multithreaded kernel (O(n d^2 / 2) multiply-adds,
+     * symmetric half computed once). Spearman ranks each column once (ties get average
+     * ranks, one copy of the data) and runs the Pearson kernel on the ranks. Kendall tau-b
+     * sorts each column once and computes each pair in O(n log n) with a merge sort, pairs
+     * in parallel. With missing values every coefficient is pairwise-complete (computed on
+     * the rows present in both columns): Pearson packs the data with presence indicators so
+     * one Gram matrix still yields every pair, Spearman re-ranks the pairs that involve a
+     * column with missing values, and Kendall skips the missing rows while merging.
+     * Columns with no variation (over the rows considered) give NaN.
+     * @param columns Pointers to the columns, each holding n values
+     * @param numThreads Worker count (0 = hardware concurrency)
+     * @param validity Optional validity bitmap per column (see DescriptiveStatistics::ValidityBitmap)
+     * @return d x d symmetric matrix
+     */
+    template <typename T>
+    std::vector<std::vector<double>> correlationMatrix(const std::vector<const T *> &columns, size_t n,
+                                                       CorrelationMethod method = CorrelationMethod::Pearson,
+                                                       size_t numThreads = 0,
+                                                       const std::vector<const uint64_t *> &validity = std::vector<const uint64_t *>())
+    {
+        if (n < 2)
+            throw std::invalid_argument("At least two rows required");
+        detail::checkValidity(validity, columns.size());
+        const detail::Presence present = detail::presence(columns, n, validity, numThreads);
+        if (method == CorrelationMethod::Kendall)
+            return detail::kendallMatrix(columns, n, present, numThreads);
+        if (method == CorrelationMethod::Spearman)
+            return detail::spearmanMatrix(columns, n, present, numThreads);
+        if (present.columnsWithMissing > 0)
+            return detail::pairwisePearsonMatrix(columns, n, present, numThreads);
+        return detail::pearsonMatrix(columns, n, numThreads);
+    }
+
+    template <typename T>
+    std::vector<std::vector<double>> correlationMatrix(const std::vector<std::vector<T>> &columns,
+                                                       CorrelationMethod method = CorrelationMethod::Pearson,
+                                                       size_t numThreads = 0)
+    {
+        std::vector<const T *> pointers;
+        for (const auto &column : columns)
+        {
+            if (column.size() != columns[0].size())
+                throw std::invalid_argument("All columns must be the same size");
+            pointers.push_back(column.data());
+        }
+        return correlationMatrix(pointers, columns.empty() ? 0 : columns[0].size(), method, numThreads);
+    }
+
+    /**
+     * Spearman rank correlation of two variables.
+     * Layman: Whether y tends to rise (or fall) with x, in any shape, not just a line.
+     * Technical: Pearson correlation of the average ranks, over the pairs with both values present.
+     */
+    template <typename T>
+    double spearmanCorrelation(const std::vector<T> &x, const std::vector<T> &y)
+    {
+        if (x.size() != y.size() || x.size() < 2)
+            throw std::invalid_argument("Vectors must be of same length, at least 2");
+        return correlationMatrix(std::vector<const T *>{x.data(), y.data()}, x.size(), CorrelationMethod::Spearman, 1)[0][1];
+    }
+
+    /**
+     * Kendall rank correlation (tau-b) of two variables.
+     * Layman: The share of pairs of points ordered the same way by x and y, minus the share
+     * ordered the opposite way, corrected for ties.
+     * Technical: Knight's O(n log n) algorithm, over the pairs with both values present.
+     */
+    template <typename T>
+    double kendallTau(const std::vector<T> &x, const std::vector<T> &y)
+    {
+        if (x.size() != y.size() || x.size() < 2)
+            throw std::invalid_argument("Vectors must be of same length, at least 2");
+        return correlationMatrix(std::vector<const T *>{x.data(), y.data()}, x.size(), CorrelationMethod::Kendall, 1)[0][1];
+    }
+
+    // Print a correlation matrix as a labelled text table (2 decimals, labels cut to 7 characters)
+    inline void printCorrelationMatrix(const std::vector<std::vector<double>> &matrix,
+                                       const std::vector<std::string> &labels, std::ostream &out = std::cout)
+    {
+        if (labels.size() != matrix.size())
+            throw std::invalid_argument("One label per variable required");
+        const std::ios::fmtflags flags = out.flags();
+        const std::streamsize precision = out.precision();
+        out << "Correlation Heatmap:" << '\n';
+        out << std::setw(7) << " " << " ";
+        for (const auto &label : labels)
+            out << std::setw(7) << label.substr(0, 7) << " ";
+        out << '\n';
+        for (size_t i = 0; i < matrix.size(); ++i)
+        {
+            out << std::setw(7) << labels[i].substr(0, 7) << " ";
+            for (size_t j = 0; j < matrix[i].size(); ++j)
+                out << std::setw(7) << std::fixed << std::setprecision(2) << matrix[i][j] << " ";
+            out << '\n';
+        }
+        out.flush();
+        out.flags(flags);
+        out.precision(precision);
+    }
+}
+
+#endif // EDA_CORRELATION_H
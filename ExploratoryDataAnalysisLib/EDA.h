@@ -13,13 +13,19 @@
 #include <numeric>
 #include <cmath>
 #include <stdexcept>
+#include "Histogram.h"
+#include "Outliers.h"
+#include "Correlation.h"
+#include "VisualAggregation.h"
 
 namespace EDA
 {
     /**
      * Calculate histogram bins and counts.
      * Layman: Group data into bins and count how many fall into each.
-     * Technical: Compute bin edges and frequency counts for histogram.
+     * Technical: Compute bin edges and frequency counts for histogram. Equal-width bins
+     * between min and max, computed in double so integer data works too; NaN values are
+     * skipped. See Histogram.h for fixed edges, log or quantile bins and many columns.
      */
     template <typename T>
     void histogram(const std::vector<T> &data, int bins, std::vector<T> &binEdges, std::vector<int> &counts)
@@ -29,67 +35,44 @@ namespace EDA
         if (data.empty())
             throw std::invalid_argument("Data vector is empty");
 
-        T minVal = *std::min_element(data.begin(), data.end());
-        T maxVal = *std::max_element(data.begin(), data.end());
-        T binWidth = (maxVal - minVal) / bins;
-
+        const Histogram result = histogram(data.data(), data.size(), HistogramOptions(static_cast<size_t>(bins)));
         binEdges.resize(bins + 1);
-        counts.assign(bins, 0);
-
+        counts.resize(bins);
         for (int i = 0; i <= bins; ++i)
-        {
-            binEdges[i] = minVal + i * binWidth;
-        }
-
-        for (const auto &val : data)
-        {
-            int binIndex = std::min(static_cast<int>((val - minVal) / binWidth), bins - 1);
-            counts[binIndex]++;
-        }
+            binEdges[i] = static_cast<T>(result.edges[i]);
+        for (int i = 0; i < bins; ++i)
+            counts[i] = static_cast<int>(result.counts[i]);
     }
 
     // Calculate box plot statistics: min, Q1, median, Q3, max
+    // (quartiles by selection on the by-value copy, no sort; NaN values are skipped)
     template <typename T>
     void boxPlotStats(std::vector<T> data, T &min, T &q1, T &median, T &q3, T &max)
     {
+        data.erase(std::remove_if(data.begin(), data.end(), [](const T &v) { return v != v; }), data.end());
         if (data.empty())
             throw std::invalid_argument("Data vector is empty");
-
-        std::sort(data.begin(), data.end());
-        min = data.front();
-        max = data.back();
-
-        auto medianCalc = [](const std::vector<T> &v) -> T
-        {
-            size_t n = v.size();
-            if (n % 2 == 0)
-                return (v[n / 2 - 1] + v[n / 2]) / 2;
-            else
-                return v[n / 2];
-        };
-
-        median = medianCalc(data);
-
-        std::vector<T> lower(data.begin(), data.begin() + data.size() / 2);
-        std::vector<T> upper;
-        if (data.size() % 2 == 0)
-            upper = std::vector<T>(data.begin() + data.size() / 2, data.end());
-        else
-            upper = std::vector<T>(data.begin() + data.size() / 2 + 1, data.end());
-
-        q1 = medianCalc(lower);
-        q3 = medianCalc(upper);
+        boxPlotStatsInPlace(data.data(), data.size(), min, q1, median, q3, max);
     }
 
     // Calculate Pearson correlation coefficient between two variables
+    // (pairs where either value is NaN are skipped)
     template <typename T>
     double correlation(const std::vector<T> &x, const std::vector<T> &y)
     {
         if (x.size() != y.size() || x.empty())
             throw std::invalid_argument("Vectors must be of same non-zero length");
 
-        double meanX = std::accumulate(x.begin(), x.end(), 0.0) / x.size();
-        double meanY = std::accumulate(y.begin(), y.end(), 0.0) / y.size();
+        double sumX = 0.0, sumY = 0.0, count = 0.0;
+        for (size_t i = 0; i < x.size(); ++i)
+        {
+            const bool complete = x[i] == x[i] && y[i] == y[i];
+            sumX += complete ? static_cast<double>(x[i]) : 0.0;
+            sumY += complete ? static_cast<double>(y[i]) : 0.0;
+            count += complete ? 1.0 : 0.0;
+        }
+        double meanX = sumX / count;
+        double meanY = sumY / count;
 
         double numerator = 0.0;
         double denomX = 0.0;
@@ -97,59 +80,62 @@ namespace EDA
 
         for (size_t i = 0; i < x.size(); ++i)
         {
+            if (!(x[i] == x[i] && y[i] == y[i]))
+                continue;
             numerator += (x[i] - meanX) * (y[i] - meanY);
             denomX += (x[i] - meanX) * (x[i] - meanX);
             denomY += (y[i] - meanY) * (y[i] - meanY);
         }
 
         double denominator = std::sqrt(denomX * denomY);
-        if (denominator == 0)
+        if (denominator == 0 || count == 0)
             throw std::runtime_error("Division by zero in correlation calculation");
 
         return numerator / denominator;
     }
 
     // Detect outliers using IQR method
+    // (one scratch copy for the quartiles; see outlierIndices in Outliers.h for row indices)
     template <typename T>
     std::vector<T> detectOutliers(const std::vector<T> &data)
     {
         if (data.empty())
             throw std::invalid_argument("Data vector is empty");
 
-        std::vector<T> sortedData = data;
-        std::sort(sortedData.begin(), sortedData.end());
-
-        T q1, q3, median, min, max;
-        boxPlotStats(sortedData, min, q1, median, q3, max);
-
-        T iqr = q3 - q1;
-        T lowerBound = q1 - 1.5 * iqr;
-        T upperBound = q3 + 1.5 * iqr;
-
+        const IQRFences fences = iqrFences(data);
         std::vector<T> outliers;
-        for (const auto &val : data)
-        {
-            if (val < lowerBound || val > upperBound)
-                outliers.push_back(val);
-        }
+        for (size_t i : outlierIndices(data.data(), data.size(), fences))
+            outliers.push_back(data[i]);
         return outliers;
     }
 
     // Simple scatter plot (prints x,y pairs)
+    // (buffered, one write per 64 KB; above maxPoints a uniform random sample of maxPoints pairs
+    // is printed, 0 = all; see VisualAggregation.h for density grids and line downsampling)
     template <typename T>
-    void scatterPlot(const std::vector<T> &x, const std::vector<T> &y)
+    void scatterPlot(const std::vector<T> &x, const std::vector<T> &y, size_t maxPoints = 10000,
+                     std::ostream &out = std::cout)
     {
         if (x.size() != y.size())
             throw std::invalid_argument("Vectors must be of same length");
 
-        std::cout << "Scatter Plot (x, y):" << std::endl;
-        for (size_t i = 0; i < x.size(); ++i)
+        BufferedWriter writer(out);
+        writer << "Scatter Plot (x, y):\n";
+        if (maxPoints == 0 || x.size() <= maxPoints)
         {
-            std::cout << "(" << x[i] << ", " << y[i] << ")" << std::endl;
+            for (size_t i = 0; i < x.size(); ++i)
+                writer << "(" << x[i] << ", " << y[i] << ")\n";
+            return;
         }
+        writer << "(uniform sample of " << maxPoints << " of " << x.size() << " points)\n";
+        for (size_t i : sampleIndices(x.size(), maxPoints))
+            writer << "(" << x[i] << ", " << y[i] << ")\n";
     }
+
+    // Generate a textual heatmap of the correlation matrix of a dataset (columns as variables)
     template <typename T>
-    void correlationHeatmap(const std::vector<std::vector<T>> &data, const std::vector<std::string> &labels)
+    void correlationHeatmap(const std::vector<std::vector<T>> &data, const std::vector<std::string> &labels,
+                            CorrelationMethod method = CorrelationMethod::Pearson)
     {
         if (data.empty())
         {
@@ -157,7 +143,6 @@ namespace EDA
             return;
         }
 
-        size_t nVars = data.size();
         for (const auto &col : data)
         {
             if (col.size() != data[0].size())
@@ -167,92 +152,8 @@ namespace EDA
             }
         }
 
-        // Compute correlation matrix
-        std::vector<std::vector<double>> corrMatrix(nVars, std::vector<double>(nVars, 0.0));
-        for (size_t i = 0; i < nVars; ++i)
-        {
-            for (size_t j = 0; j < nVars; ++j)
-            {
-                if (i == j)
-                    corrMatrix[i][j] = 1.0;
-                else
-                    corrMatrix[i][j] = correlation(data[i], data[j]);
-            }
-        }
-
-        // Print heatmap header
-        std::cout << "Correlation Heatmap:" << std::endl;
-        std::cout << std::setw(7) << " " << " ";
-        for (const auto &label : labels)
-        {
-            std::cout << std::setw(7) << label.substr(0, 7) << " ";
-        }
-        std::cout << std::endl;
-
-        // Print heatmap rows
-        for (size_t i = 0; i < nVars; ++i)
-        {
-            std::cout << std::setw(7) << labels[i].substr(0, 7) << " ";
-            for (size_t j = 0; j < nVars; ++j)
-            {
-                std::cout << std::setw(7) << std::fixed << std::setprecision(2) << corrMatrix[i][j] << " ";
-            }
-            std::cout << std::endl;
-        }
+        printCorrelationMatrix(correlationMatrix(data, method), labels);
     }
 }
 
-// Generate a textual heatmap of correlation matrix for given dataset (columns as variables)
-template <typename T>
-void correlationHeatmap(const std::vector<std::vector<T>> &data, const std::vector<std::string> &labels)
-{
-    if (data.empty())
-    {
-        std::cout << "Empty dataset." << std::endl;
-        return;
-    }
-
-    size_t nVars = data.size();
-    for (const auto &col : data)
-    {
-        if (col.size() != data[0].size())
-        {
-            std::cout << "Inconsistent column sizes." << std::endl;
-            return;
-        }
-    }
-
-    // Compute correlation matrix
-    std::vector<std::vector<double>> corrMatrix(nVars, std::vector<double>(nVars, 0.0));
-    for (size_t i = 0; i < nVars; ++i)
-    {
-        for (size_t j = 0; j < nVars; ++j)
-        {
-            if (i == j)
-                corrMatrix[i][j] = 1.0;
-            else
-                corrMatrix[i][j] = correlation(data[i], data[j]);
-        }
-    }
-
-    // Print heatmap header
-    std::cout << "Correlation Heatmap:" << std::endl;
-    std::cout << "       ";
-    for (const auto &label : labels)
-    {
-        std::cout << label.substr(0, 7) << " ";
-    }
-    std::cout << std::endl;
-
-    // Print heatmap rows
-    for (size_t i = 0; i < nVars; ++i)
-    {
-        std::cout << labels[i].substr(0, 7) << " ";
-        for (size_t j = 0; j < nVars; ++j)
-        {
-            std::cout << std::fixed << std::setprecision(2) << corrMatrix[i][j] << " ";
-        }
-        std::cout << std::endl;
-    }
-}
 #endif // EDA_H
@@ -0,0 +1,618 @@
+#ifndef EDA_HISTOGRAM_H
+#define EDA_HISTOGRAM_H
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+#include <thread>
+#include "../ProbabilityDistributionsLib/ProbabilityDistributions.h"
+#include "../ProbabilityDistributionsLib/Parallel.h"
+#include "../ProbabilityDistributionsLib/Samplers.h"
+#include "../DescriptiveStatisticsLib/MissingValues.h"
+
+namespace EDA
+{
+    // How histogram bin edges are placed over the data range
+    enum class BinScale
+    {
+        Linear,  // equal widths between min and max
+        Log,     // equal widths in log(x) between the smallest positive value and max
+        Quantile // edges at quantiles of the data, so bins hold roughly equal counts
+    };
+
+    struct HistogramOptions
+    {
+        size_t bins;
+        BinScale scale;
+        size_t numThreads; // 0 = hardware concurrency
+        // Optional validity bitmap per column (see DescriptiveStatistics::ValidityBitmap); rows
+        // whose bit is clear count as missing. Empty = only NaN is missing.
+        std::vector<const uint64_t *> validity;
+
+        explicit HistogramOptions(size_t bins = 64, BinScale scale = BinScale::Linear)
+            : bins(bins), scale(scale), numThreads(0) {}
+    };
+
+    /**
+     * Histogram counts over fixed bin edges.
+     * Layman: How many values fall into each bin, plus how many fell outside all bins or
+     * were missing (NaN).
+     * Technical: Bin i is [edges[i], edges[i + 1]) except the last, which also includes
+     * edges.back(). Values below edges.front() count as underflow, above edges.back() as
+     * overflow, and NaN (or rows masked out by a validity bitmap) as missing.
+     */
+    struct Histogram
+    {
+        std::vector<double> edges;
+        std::vector<uint64_t> counts;
+        uint64_t underflow = 0;
+        uint64_t overflow = 0;
+        uint64_t missing = 0;
+
+        // Number of values inside the bins
+        uint64_t total() const
+        {
+            uint64_t sum = 0;
+            for (uint64_t c : counts)
+                sum += c;
+            return sum;
+        }
+
+        // Add the counts of a histogram with identical edges (e.g. one built on another chunk)
+        void merge(const Histogram &other)
+        {
+            if (other.edges != edges)
+                throw std::invalid_argument("Histograms must have identical bin edges");
+            for (size_t i = 0; i < counts.size(); ++i)
+                counts[i] += other.counts[i];
+            underflow += other.underflow;
+            overflow += other.overflow;
+            missing += other.missing;
+        }
+    };
+
+    namespace detail
+    {
+        using ProbabilityDistributions::detail::parallelFor; // rethrows the first exception from fn
+
+        // Row blocks per column: one per thread, but never fewer than minRows rows per block
+        inline size_t rowBlocks(size_t n, size_t numThreads, size_t minRows = 65536)
+        {
+            if (numThreads == 0)
+                numThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+            return std::max<size_t>(1, std::min(numThreads, n / minRows));
+        }
+
+        /**
+         * Value -> slot mapping for the binning kernel.
+         * Slots are 0 = underflow, 1..bins = bins, bins + 1 = overflow, bins + 2 = missing.
+         * Uniform and LogUniform edges get a slot estimate from one multiply by the reciprocal
+         * bin width (of x or of log x) in a branch-free loop the compiler vectorizes; estimates
+         * within tolerance of a bin boundary are then checked against the two neighbouring
+         * edges, so rounding never puts a value in the wrong bin. The tolerance bounds the
+         * rounding error of the edges and of the estimate, which grows with the magnitude of
+         * the values relative to the bin width; ranges too narrow for a one-bin correction fall
+         * back to a binary search, as do all other edges.
+         */
+        struct BinMap
+        {
+            enum Kind
+            {
+                Uniform,
+                LogUniform,
+                Search
+            };
+
+            Kind kind;
+            const double *edges;
+            size_t bins;
+            double origin; // edges[0], or log(edges[0]) for LogUniform
+            double scale;  // reciprocal bin width (in log space for LogUniform)
+            double tolerance; // distance from a bin boundary, in bins, below which the edges decide
+
+            BinMap(const std::vector<double> &e, Kind k)
+                : kind(k), edges(e.data()), bins(e.size() - 1), origin(0.0), scale(0.0), tolerance(0.0)
+            {
+                double magnitude = 0.0; // largest |value| (|log value| + 1 for LogUniform) the estimate sees
+                if (kind == Uniform)
+                {
+                    origin = e.front();
+                    scale = bins / (e.back() - e.front());
+                    magnitude = std::max(std::fabs(e.front()), std::fabs(e.back()));
+                }
+                else if (kind == LogUniform)
+                {
+                    origin = std::log(e.front());
+                    scale = bins / (std::log(e.back()) - origin);
+                    magnitude = std::max(std::fabs(origin), std::fabs(std::log(e.back()))) + 1.0;
+                }
+                // 2e-9 covers uniform edges accepted by classifyEdges; the rest is a few ulps of
+                // the edges and of fastLog, in bins
+                tolerance = 2e-9 + 32.0 * std::numeric_limits<double>::epsilon() * (magnitude * scale + bins);
+                if (tolerance > 0.25)
+                    kind = Search;
+            }
+        };
+
+        inline void checkEdges(const std::vector<double> &edges)
+        {
+            if (edges.size() < 2)
+                throw std::invalid_argument("At least two bin edges required");
+            for (size_t i = 1; i < edges.size(); ++i)
+                if (!(edges[i] > edges[i - 1]))
+                    throw std::invalid_argument("Bin edges must be finite and strictly increasing");
+            if (!std::isfinite(edges.front()) || !std::isfinite(edges.back()))
+                throw std::invalid_argument("Bin edges must be finite and strictly increasing");
+        }
+
+        // Uniform edges are recognised so that fixed edges also get the reciprocal kernel
+        inline BinMap::Kind classifyEdges(const std::vector<double> &edges)
+        {
+            const size_t bins = edges.size() - 1;
+            const double width = (edges.back() - edges.front()) / bins;
+            for (size_t i = 1; i < bins; ++i)
+                if (std::fabs(edges[i] - (edges.front() + i * width)) > 1e-9 * width)
+                    return BinMap::Search;
+            return BinMap::Uniform;
+        }
+
+        // Validity bitmaps are optional: none at all, or one (possibly nullptr) per column
+        inline void checkValidity(const std::vector<const uint64_t *> &validity, size_t numColumns)
+        {
+            if (!validity.empty() && validity.size() != numColumns)
+                throw std::invalid_argument("One validity bitmap per column required");
+        }
+
+        inline const uint64_t *columnValidity(const std::vector<const uint64_t *> &validity, size_t column)
+        {
+            return validity.empty() ? nullptr : validity[column];
+        }
+
+        /**
+         * Add the slot counts of x[0..n) to slots[0..bins + 3).
+         * Values are processed in tiles: a vectorizable pass computes the slot estimates of
+         * the tile and flags the few that land within map.tolerance of a bin boundary, then a scalar
+         * pass re-checks only the flagged ones against the edges and increments one of four
+         * interleaved count arrays, so runs of equal slots do not serialize on one counter.
+         * Rows whose validity bit (row firstRow + i) is clear go to the missing slot.
+         */
+        template <typename T>
+        void countSlots(const T *x, size_t n, const BinMap &map, uint64_t *slots, const uint64_t *validity = nullptr,
+                        size_t firstRow = 0)
+        {
+            const size_t tile = 256;
+            const int32_t recheck = 1 << 30;
+            const size_t bins = map.bins;
+            const size_t numSlots = bins + 3;
+            const double top = static_cast<double>(bins + 1);
+            const double missingSlot = static_cast<double>(bins + 2);
+            const double origin = map.origin, scale = map.scale, tolerance = map.tolerance;
+            const double *edges = map.edges;
+            std::vector<uint64_t> lanes(4 * numSlots, 0);
+            int32_t slot[tile];
+            for (size_t start = 0; start < n; start += tile)
+            {
+                const T *v = x + start;
+                const size_t m = std::min(tile, n - start);
+                if (map.kind == BinMap::Search)
+                {
+                    // Branch-free upper bound over the left edges, which also closes the last
+                    // bin on the right
+                    for (size_t i = 0; i < m; ++i)
+                    {
+                        const double d = static_cast<double>(v[i]);
+                        const double *base = edges;
+                        for (size_t len = bins; len > 1; len -= len / 2)
+                            base = base[len / 2] <= d ? base + len / 2 : base;
+                        size_t s = static_cast<size_t>(base - edges) + (*base <= d ? 1 : 0);
+                        s = d > edges[bins] ? bins + 1 : s;
+                        slot[i] = static_cast<int32_t>(d == d ? s : bins + 2);
+                    }
+                }
+                else if (map.kind == BinMap::Uniform)
+                {
+                    for (size_t i = 0; i < m; ++i)
+                    {
+                        const double d = static_cast<double>(v[i]);
+                        double t = (d - origin) * scale + 1.0;
+                        t = t >= 0.0 ? t : 0.0; // also maps NaN to 0
+                        t = t <= top ? t : top;
+                        t = d == d ? t : missingSlot;
+                        const int32_t s = static_cast<int32_t>(t);
+                        const double frac = t - s;
+                        slot[i] = (frac < tolerance || frac > 1.0 - tolerance) ? s + recheck : s;
+                    }
+                }
+                else
+                {
+                    for (size_t i = 0; i < m; ++i)
+                    {
+                        const double d = static_cast<double>(v[i]);
+                        double t = (ProbabilityDistributions::detail::fastLog(d) - origin) * scale + 1.0;
+                        t = d > 0.0 ? t : 0.0; // log(0) = -inf and log(x < 0) = NaN are underflow
+                        t = t >= 0.0 ? t : 0.0;
+                        t = t <= top ? t : top;
+                        t = d == d ? t : missingSlot;
+                        const int32_t s = static_cast<int32_t>(t);
+                        const double frac = t - s;
+                        slot[i] = (frac < tolerance || frac > 1.0 - tolerance) ? s + recheck : s;
+                    }
+                }
+                if (validity)
+                {
+                    for (size_t i0 = 0; i0 < m; i0 += 64)
+                    {
+                        const size_t k = std::min<size_t>(64, m - i0);
+                        const uint64_t bits = DescriptiveStatistics::detail::validityWord(validity, firstRow + start + i0, k);
+                        for (size_t j = 0; j < k; ++j)
+                            slot[i0 + j] = (bits >> j) & 1 ? slot[i0 + j] : static_cast<int32_t>(bins + 2);
+                    }
+                }
+
+                for (size_t i = 0; i < m; ++i)
+                {
+                    size_t s = static_cast<size_t>(slot[i]);
+                    if (s >= static_cast<size_t>(recheck))
+                    {
+                        s -= recheck;
+                        const double d = static_cast<double>(v[i]);
+                        if (s <= bins + 1)
+                        {
+                            if (s > 0 && d < edges[s - 1])
+                                --s;
+                            else if (s <= bins && d >= edges[s])
+                                ++s;
+                            if (s == bins + 1 && d == edges[bins])
+                                s = bins; // the last bin is closed on the right
+                        }
+                    }
+                    ++lanes[(i & 3) * numSlots + s];
+                }
+            }
+            for (size_t s = 0; s < numSlots; ++s)
+                slots[s] += lanes[s] + lanes[numSlots + s] + lanes[2 * numSlots + s] + lanes[3 * numSlots + s];
+        }
+
+        // Smallest, largest and smallest positive finite value, from a branch-free reduction
+        struct ValueRange
+        {
+            double min = std::numeric_limits<double>::infinity();
+            double max = -std::numeric_limits<double>::infinity();
+            double minPositive = std::numeric_limits<double>::infinity();
+
+            void merge(const ValueRange &other)
+            {
+                min = std::min(min, other.min);
+                max = std::max(max, other.max);
+                minPositive = std::min(minPositive, other.minPositive);
+            }
+        };
+
+        // Eight independent accumulators per bound, so the compiler can keep them in vector lanes.
+        // Rows masked out by the validity bitmap (row firstRow + i) are read as NaN; NaN and
+        // +-infinity compare false against the bounds and are skipped.
+        template <typename T>
+        ValueRange valueRange(const T *x, size_t n, const uint64_t *validity = nullptr, size_t firstRow = 0)
+        {
+            const size_t lanes = 8;
+            const double inf = std::numeric_limits<double>::infinity();
+            double lo[lanes], hi[lanes], pos[lanes];
+            for (size_t j = 0; j < lanes; ++j)
+            {
+                lo[j] = pos[j] = inf;
+                hi[j] = -inf;
+            }
+            size_t i = 0;
+            for (; validity && i < n; i += 64)
+            {
+                const size_t k = std::min<size_t>(64, n - i);
+                const uint64_t bits = DescriptiveStatistics::detail::validityWord(validity, firstRow + i, k);
+                for (size_t j = 0; j < k; ++j)
+                {
+                    const double d = (bits >> j) & 1 ? static_cast<double>(x[i + j]) : std::numeric_limits<double>::quiet_NaN();
+                    const double p = d > 0.0 && d < inf ? d : inf;
+                    lo[j % lanes] = d < lo[j % lanes] && d > -inf ? d : lo[j % lanes];
+                    hi[j % lanes] = d > hi[j % lanes] && d < inf ? d : hi[j % lanes];
+                    pos[j % lanes] = p < pos[j % lanes] ? p : pos[j % lanes];
+                }
+            }
+            for (; i + lanes <= n; i += lanes)
+            {
+                for (size_t j = 0; j < lanes; ++j)
+                {
+                    const double d = static_cast<double>(x[i + j]);
+                    const double p = d > 0.0 && d < inf ? d : inf;
+                    lo[j] = d < lo[j] && d > -inf ? d : lo[j];
+                    hi[j] = d > hi[j] && d < inf ? d : hi[j];
+                    pos[j] = p < pos[j] ? p : pos[j];
+                }
+            }
+            for (; i < n; ++i)
+            {
+                const double d = static_cast<double>(x[i]);
+                const double p = d > 0.0 && d < inf ? d : inf;
+                lo[0] = d < lo[0] && d > -inf ? d : lo[0];
+                hi[0] = d > hi[0] && d < inf ? d : hi[0];
+                pos[0] = p < pos[0] ? p : pos[0];
+            }
+            ValueRange r;
+            for (size_t j = 0; j < lanes; ++j)
+            {
+                r.min = std::min(r.min, lo[j]);
+                r.max = std::max(r.max, hi[j]);
+                r.minPositive = std::min(r.minPositive, pos[j]);
+            }
+            return r;
+        }
+
+        // Rearrange [first, last) so that first[r] holds the value of rank r for every r in
+        // ranks[lo, hi) (sorted, relative to first); O(n log(hi - lo)).
+        template <typename T>
+        void multiSelect(T *first, T *last, const size_t *ranks, size_t lo, size_t hi, size_t offset)
+        {
+            if (lo >= hi || first >= last)
+                return;
+            const size_t mid = lo + (hi - lo) / 2;
+            T *nth = first + (ranks[mid] - offset);
+            std::nth_element(first, nth, last);
+            multiSelect(first, nth, ranks, lo, mid, offset);
+            multiSelect(nth + 1, last, ranks, mid + 1, hi, ranks[mid] + 1);
+        }
+
+        /**
+         * Quantile edges of one column.
+         * Inner edges are the values of rank round(i (m - 1) / bins) among m present values:
+         * all of them for columns up to sampleSize values, otherwise a uniform random sample
+         * (with replacement, fixed seed) of sampleSize values, which puts every bin within a
+         * few percent of n / bins values. The outer edges are the exact min and max. Repeated
+         * edges (heavy ties) are dropped, so there may be fewer than bins bins.
+         */
+        template <typename T>
+        std::vector<double> quantileEdges(const T *x, size_t n, size_t bins, const ValueRange &range,
+                                          const uint64_t *validity = nullptr, size_t sampleSize = size_t(1) << 20)
+        {
+            const double nan = std::numeric_limits<double>::quiet_NaN();
+            if (!(range.min <= range.max))
+                return std::vector<double>{0.0, 1.0};
+            if (range.min == range.max)
+                return std::vector<double>{range.min - 0.5, range.max + 0.5};
+            std::vector<double> values;
+            values.reserve(std::min(n, sampleSize));
+            if (n <= sampleSize)
+            {
+                for (size_t i = 0; i < n; ++i)
+                    values.push_back(!validity || ((validity[i >> 6] >> (i & 63)) & 1) ? static_cast<double>(x[i]) : nan);
+            }
+            else
+            {
+                ProbabilityDistributions::Xoshiro256 rng(42);
+                for (size_t i = 0; i < sampleSize; ++i)
+                {
+                    const size_t r = rng() % n;
+                    values.push_back(!validity || ((validity[r >> 6] >> (r & 63)) & 1) ? static_cast<double>(x[r]) : nan);
+                }
+            }
+            values.erase(std::remove_if(values.begin(), values.end(), [](double d) { return d != d; }), values.end());
+            const size_t m = values.size();
+            std::vector<size_t> ranks;
+            for (size_t i = 1; i < bins && m > 0; ++i)
+                ranks.push_back(static_cast<size_t>(std::llround(static_cast<double>(i) * (m - 1) / bins)));
+            ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+            multiSelect(values.data(), values.data() + m, ranks.data(), 0, ranks.size(), 0);
+            std::vector<double> edges(1, range.min);
+            for (size_t r : ranks)
+                if (values[r] > edges.back() && values[r] < range.max)
+                    edges.push_back(values[r]);
+            edges.push_back(range.max);
+            return edges;
+        }
+
+        // Edges for the Linear and Log scales from the value range of a column
+        inline std::vector<double> scaledEdges(const ValueRange &range, size_t bins, BinScale scale)
+        {
+            std::vector<double> edges(bins + 1);
+            if (scale == BinScale::Log)
+            {
+                double lo = range.minPositive, hi = range.max;
+                if (!(lo <= hi))
+                    lo = hi = 1.0; // no positive values
+                if (lo == hi)
+                {
+                    lo *= 0.5;
+                    hi *= 2.0;
+                }
+                const double logLo = std::log(lo), step = (std::log(hi) - logLo) / bins;
+                for (size_t i = 0; i <= bins; ++i)
+                    edges[i] = std::exp(logLo + i * step);
+                edges[0] = lo;
+                edges[bins] = hi;
+            }
+            else
+            {
+                double lo = range.min, hi = range.max;
+                if (!(lo <= hi))
+                    lo = hi = 0.0; // no values
+                if (lo == hi)
+                {
+                    lo -= 0.5;
+                    hi += 0.5;
+                }
+                for (size_t i = 0; i <= bins; ++i)
+                    edges[i] = lo + (hi - lo) * (static_cast<double>(i) / bins);
+                edges[bins] = hi;
+            }
+            return edges;
+        }
+
+        // Count every column over its edges; blocks of rows of all columns run in parallel and
+        // each block counts privately, merged at the end
+        template <typename T>
+        std::vector<Histogram> countColumns(const std::vector<const T *> &columns, size_t n,
+                                            std::vector<std::vector<double>> edges,
+                                            const std::vector<BinMap::Kind> &kinds, size_t numThreads,
+                                            const std::vector<const uint64_t *> &validity)
+        {
+            const size_t numColumns = columns.size();
+            checkValidity(validity, numColumns);
+            const size_t blocks = rowBlocks(n, numThreads);
+            std::vector<Histogram> result(numColumns);
+            std::vector<BinMap> maps;
+            std::vector<size_t> offsets(numColumns + 1, 0);
+            for (size_t c = 0; c < numColumns; ++c)
+            {
+                result[c].edges = std::move(edges[c]);
+                maps.push_back(BinMap(result[c].edges, kinds[c]));
+                offsets[c + 1] = offsets[c] + result[c].edges.size() + 2;
+            }
+            std::vector<std::vector<uint64_t>> partial(blocks, std::vector<uint64_t>(offsets[numColumns], 0));
+            auto countBlock = [&](size_t item)
+            {
+                const size_t c = item / blocks, b = item % blocks;
+                const size_t first = b * n / blocks, last = (b + 1) * n / blocks;
+                countSlots(columns[c] + first, last - first, maps[c], partial[b].data() + offsets[c],
+                           columnValidity(validity, c), first);
+            };
+            parallelFor(numColumns * blocks, numThreads, countBlock);
+
+            for (size_t c = 0; c < numColumns; ++c)
+            {
+                const size_t bins = maps[c].bins;
+                std::vector<uint64_t> slots(bins + 3, 0);
+                for (size_t b = 0; b < blocks; ++b)
+                    for (size_t s = 0; s < bins + 3; ++s)
+                        slots[s] += partial[b][offsets[c] + s];
+                result[c].underflow = slots[0];
+                result[c].counts.assign(slots.begin() + 1, slots.begin() + 1 + bins);
+                result[c].overflow = slots[bins + 1];
+                result[c].missing = slots[bins + 2];
+            }
+            return result;
+        }
+    }
+
+    /**
+     * Histograms of many columns over the same fixed bin edges, in one parallel sweep.
+     * Layman: Count how many values of each column fall into each of the given bins.
+     * Technical: Uniformly spaced edges use the reciprocal-multiply kernel, other edges a
+     * binary search; every (column, row block) pair counts privately and the counts are
+     * merged at the end. No pass over the data is needed to find its range.
+     * @param columns Pointers to the columns, each holding n values
+     * @param edges Strictly increasing bin edges (bins + 1 values)
+     * @param numThreads Worker count (0 = hardware concurrency)
+     * @param validity Optional validity bitmap per column (masked rows count as missing)
+     */
+    template <typename T>
+    std::vector<Histogram> histograms(const std::vector<const T *> &columns, size_t n, const std::vector<double> &edges,
+                                      size_t numThreads = 0,
+                                      const std::vector<const uint64_t *> &validity = std::vector<const uint64_t *>())
+    {
+        detail::checkEdges(edges);
+        return detail::countColumns(columns, n, std::vector<std::vector<double>>(columns.size(), edges),
+                                    std::vector<detail::BinMap::Kind>(columns.size(), detail::classifyEdges(edges)),
+                                    numThreads, validity);
+    }
+
+    /**
+     * Histograms of many columns with edges derived from each column's data.
+     * Layman: Histogram every column of a table at once, with linear, logarithmic or
+     * equal-count (quantile) bins.
+     * Technical: Edges need each column's range, found by one branch-free min/max pass
+     * over all columns in parallel, followed by the binning sweep. Log edges start at the
+     * smallest positive value; zeros and negative values count as underflow. Quantile edges
+     * come from a multi-quantile selection (O(m log bins)) on at most 2^20 values per column
+     * (see detail::quantileEdges) and are binned by a branch-free binary search. NaN values
+     * and rows masked out by options.validity are counted as missing and ignored otherwise;
+     * the range covers finite values only, so -inf and +inf count as underflow and overflow.
+     * @param columns Pointers to the columns, each holding n values
+     */
+    template <typename T>
+    std::vector<Histogram> histograms(const std::vector<const T *> &columns, size_t n,
+                                      const HistogramOptions &options = HistogramOptions())
+    {
+        if (options.bins == 0)
+            throw std::invalid_argument("Number of bins must be positive");
+        const size_t numColumns = columns.size();
+        detail::checkValidity(options.validity, numColumns);
+        std::vector<std::vector<double>> edges(numColumns);
+        std::vector<detail::BinMap::Kind> kinds(numColumns);
+        const size_t blocks = detail::rowBlocks(n, options.numThreads);
+        std::vector<detail::ValueRange> ranges(numColumns * blocks);
+        auto scanBlock = [&](size_t item)
+        {
+            const size_t c = item / blocks, b = item % blocks;
+            const size_t first = b * n / blocks, last = (b + 1) * n / blocks;
+            ranges[item] = detail::valueRange(columns[c] + first, last - first,
+                                              detail::columnValidity(options.validity, c), first);
+        };
+        detail::parallelFor(numColumns * blocks, options.numThreads, scanBlock);
+        for (size_t c = 0; c < numColumns; ++c)
+            for (size_t b = 1; b < blocks; ++b)
+                ranges[c * blocks].merge(ranges[c * blocks + b]);
+
+        if (options.scale == BinScale::Quantile)
+        {
+            auto selectEdges = [&](size_t c)
+            {
+                edges[c] = detail::quantileEdges(columns[c], n, options.bins, ranges[c * blocks],
+                                                 detail::columnValidity(options.validity, c));
+            };
+            detail::parallelFor(numColumns, options.numThreads, selectEdges);
+            std::fill(kinds.begin(), kinds.end(), detail::BinMap::Search);
+        }
+        else
+        {
+            for (size_t c = 0; c < numColumns; ++c)
+                edges[c] = detail::scaledEdges(ranges[c * blocks], options.bins, options.scale);
+            std::fill(kinds.begin(), kinds.end(),
+                      options.scale == BinScale::Log ? detail::BinMap::LogUniform : detail::BinMap::Uniform);
+        }
+        return detail::countColumns(columns, n, std::move(edges), kinds, options.numThreads, options.validity);
+    }
+
+    template <typename T>
+    std::vector<Histogram> histograms(const std::vector<std::vector<T>> &columns,
+                                      const HistogramOptions &options = HistogramOptions())
+    {
+        std::vector<const T *> pointers;
+        for (const auto &column : columns)
+        {
+            if (column.size() != columns[0].size())
+                throw std::invalid_argument("All columns must be the same size");
+            pointers.push_back(column.data());
+        }
+        return histograms(pointers, columns.empty() ? 0 : columns[0].size(), options);
+    }
+
+    // Histogram of one column with edges derived from the data (see histograms)
+    template <typename T>
+    Histogram histogram(const T *data, size_t n, const HistogramOptions &options = HistogramOptions())
+    {
+        return histograms(std::vector<const T *>(1, data), n, options)[0];
+    }
+
+    template <typename T>
+    Histogram histogram(const std::vector<T> &data, const HistogramOptions &options = HistogramOptions())
+    {
+        return histogram(data.data(), data.size(), options);
+    }
+
+    // Histogram of one column over fixed bin edges (see histograms)
+    template <typename T>
+    Histogram histogram(const T *data, size_t n, const std::vector<double> &edges, size_t numThreads = 0,
+                        const uint64_t *validity = nullptr)
+    {
+        return histograms(std::vector<const T *>(1, data), n, edges, numThreads,
+                          validity ? std::vector<const uint64_t *>(1, validity) : std::vector<const uint64_t *>())[0];
+    }
+
+    template <typename T>
+    Histogram histogram(const std::vector<T> &data, const std::vector<double> &edges, size_t numThreads = 0)
+    {
+        return histogram(data.data(), data.size(), edges, numThreads);
+    }
+}
+
+#endif // EDA_HISTOGRAM_H
@@ -0,0 +1,465 @@
+#ifndef EDA_LATENCY_HISTOGRAM_H
+#define EDA_LATENCY_HISTOGRAM_H
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <functional>
+
+namespace EDA
+{
+    namespace detail
+    {
+        // Little-endian LEB128 varints and raw doubles for the compact binary encodings
+        inline void putVarint(std::vector<uint8_t> &out, uint64_t v)
+        {
+            while (v >= 0x80)
+            {
+                out.push_back(static_cast<uint8_t>(v | 0x80));
+                v >>= 7;
+            }
+            out.push_back(static_cast<uint8_t>(v));
+        }
+
+        inline uint64_t getVarint(const uint8_t *data, size_t size, size_t &pos)
+        {
+            uint64_t v = 0;
+            for (int shift = 0; shift < 64; shift += 7)
+            {
+                if (pos >= size)
+                    break;
+                const uint8_t b = data[pos++];
+                v |= static_cast<uint64_t>(b & 0x7F) << shift;
+                if (!(b & 0x80))
+                    return v;
+            }
+            throw std::invalid_argument("Truncated or corrupt encoding");
+        }
+
+        inline void putDouble(std::vector<uint8_t> &out, double x)
+        {
+            uint64_t bits;
+            std::memcpy(&bits, &x, sizeof x);
+            for (int k = 0; k < 8; ++k)
+                out.push_back(static_cast<uint8_t>(bits >> (8 * k)));
+        }
+
+        inline double getDouble(const uint8_t *data, size_t size, size_t &pos)
+        {
+            if (size - pos < 8)
+                throw std::invalid_argument("Truncated or corrupt encoding");
+            uint64_t bits = 0;
+            for (int k = 0; k < 8; ++k)
+                bits |= static_cast<uint64_t>(data[pos++]) << (8 * k);
+            double x;
+            std::memcpy(&x, &bits, sizeof x);
+            return x;
+        }
+    }
+
+    /**
+     * Mergeable log-linear histogram for latencies and other non-negative measurements.
+     * Layman: Records values one at a time in constant time and answers percentile and
+     * "what fraction is below x" questions to a fixed relative precision, without knowing
+     * the range of the values up front.
+     * Technical: HDR-style layout. Every power-of-two range [2^e, 2^(e+1)) is split into
+     * 2^precisionBits equal buckets, so a bucket spans at most 2^-precisionBits of its values
+     * (significantDigits = 2 gives 7 bits, under 0.8%). The bucket index of x is the top
+     * 11 + precisionBits bits of its IEEE representation (exponent and leading mantissa
+     * bits), one shift instead of a log. Counts live in a dense window of buckets that grows
+     * as needed; zero and subnormal values share a zero bucket. Count, sum, min and max are
+     * exact.
+     */
+    class LatencyHistogram
+    {
+    public:
+        explicit LatencyHistogram(int significantDigits = 2)
+        {
+            if (significantDigits < 1 || significantDigits > 5)
+                throw std::invalid_argument("Significant digits must be between 1 and 5");
+            precisionBits_ = static_cast<int>(std::ceil(significantDigits * 3.3219280948873623)); // log2(10)
+        }
+
+        void record(double x) { recordCount(x, 1); }
+
+        // Record count occurrences of x
+        void recordCount(double x, uint64_t count)
+        {
+            if (!(x >= 0.0 && x <= std::numeric_limits<double>::max()))
+                throw std::invalid_argument("Value must be finite and non-negative");
+            if (count == 0)
+                return;
+            if (x < std::numeric_limits<double>::min())
+                zeroCount_ += count;
+            else
+            {
+                const int64_t i = index(x);
+                if (counts_.empty() || i < offset_ || i >= offset_ + static_cast<int64_t>(counts_.size()))
+                    cover(i, i);
+                counts_[static_cast<size_t>(i - offset_)] += count;
+            }
+            count_ += count;
+            sum_ += x * static_cast<double>(count);
+            min_ = std::min(min_, x);
+            max_ = std::max(max_, x);
+        }
+
+        void record(const double *x, size_t n)
+        {
+            for (size_t i = 0; i < n; ++i)
+                recordCount(x[i], 1);
+        }
+
+        void record(const std::vector<double> &x) { record(x.data(), x.size()); }
+
+        void merge(const LatencyHistogram &other)
+        {
+            if (other.precisionBits_ != precisionBits_)
+                throw std::invalid_argument("Histograms must have the same precision");
+            if (!other.counts_.empty())
+            {
+                cover(other.offset_, other.offset_ + static_cast<int64_t>(other.counts_.size()) - 1);
+                uint64_t *dst = counts_.data() + (other.offset_ - offset_);
+                for (size_t k = 0; k < other.counts_.size(); ++k)
+                    dst[k] += other.counts_[k];
+            }
+            zeroCount_ += other.zeroCount_;
+            count_ += other.count_;
+            sum_ += other.sum_;
+            min_ = std::min(min_, other.min_);
+            max_ = std::max(max_, other.max_);
+        }
+
+        /**
+         * Value at a percentile.
+         * Layman: The value below which p percent of the recorded values fall.
+         * Technical: The midpoint of the bucket holding the value of rank floor(p / 100 (count - 1)),
+         * clamped to [min, max]; within half a bucket (2^-(precisionBits + 1) relative) of the
+         * exact order statistic. O(buckets).
+         * @param p Percentile (0-100)
+         */
+        double percentile(double p) const
+        {
+            if (count_ == 0)
+                throw std::logic_error("Histogram is empty");
+            if (p < 0.0 || p > 100.0)
+                throw std::invalid_argument("Percentile must be between 0 and 100");
+            return valueAtRank(static_cast<uint64_t>(std::floor(p / 100.0 * static_cast<double>(count_ - 1))));
+        }
+
+        // Value of the given rank (0 = smallest) to within half a bucket, clamped to [min, max]
+        double valueAtRank(uint64_t rank) const
+        {
+            if (rank >= count_)
+                throw std::invalid_argument("Rank out of range");
+            uint64_t seen = zeroCount_;
+            if (seen > rank)
+                return min_;
+            for (size_t k = 0; k < counts_.size(); ++k)
+            {
+                seen += counts_[k];
+                if (seen > rank)
+                {
+                    const int64_t i = offset_ + static_cast<int64_t>(k);
+                    const double mid = 0.5 * (lowerBound(i) + lowerBound(i + 1));
+                    return std::min(std::max(mid, min_), max_);
+                }
+            }
+            return max_;
+        }
+
+        /**
+         * Cumulative distribution function.
+         * Layman: Fraction of the recorded values that are at most x.
+         * Technical: Whole buckets up to the one holding x, plus the linearly interpolated
+         * part of that bucket; exact at bucket boundaries and outside [min, max].
+         */
+        double cdf(double x) const
+        {
+            if (count_ == 0)
+                throw std::logic_error("Histogram is empty");
+            if (x < min_)
+                return 0.0;
+            if (x >= max_)
+                return 1.0;
+            double below = static_cast<double>(zeroCount_);
+            if (x >= std::numeric_limits<double>::min() && !counts_.empty())
+            {
+                const int64_t i = index(x);
+                const int64_t last = std::min(i, offset_ + static_cast<int64_t>(counts_.size()));
+                for (int64_t j = offset_; j < last; ++j)
+                    below += static_cast<double>(counts_[static_cast<size_t>(j - offset_)]);
+                if (i >= offset_ && i < offset_ + static_cast<int64_t>(counts_.size()))
+                {
+                    const double lo = lowerBound(i), hi = lowerBound(i + 1);
+                    below += static_cast<double>(counts_[static_cast<size_t>(i - offset_)]) * (x - lo) / (hi - lo);
+                }
+            }
+            return below / static_cast<double>(count_);
+        }
+
+        uint64_t count() const { return count_; }
+        double sum() const { return sum_; }
+        double mean() const { return count_ ? sum_ / static_cast<double>(count_) : std::numeric_limits<double>::quiet_NaN(); }
+        double min() const { return count_ ? min_ : std::numeric_limits<double>::quiet_NaN(); }
+        double max() const { return count_ ? max_ : std::numeric_limits<double>::quiet_NaN(); }
+        int precisionBits() const { return precisionBits_; }
+
+        void clear()
+        {
+            counts_.clear();
+            offset_ = 0;
+            zeroCount_ = count_ = 0;
+            sum_ = 0.0;
+            min_ = std::numeric_limits<double>::infinity();
+            max_ = -std::numeric_limits<double>::infinity();
+        }
+
+        /**
+         * Compact binary encoding.
+         * Layout (little-endian): "EDAH", version byte, precision bits byte, then LEB128
+         * varints for count and zero count, the raw bits of sum, min and max, then the first
+         * non-empty bucket index, the number of entries and the entries themselves: a
+         * positive zigzag varint is a bucket count, a negative one a run of empty buckets.
+         * A few bytes per non-empty bucket whatever the counts.
+         */
+        std::vector<uint8_t> serialize() const
+        {
+            std::vector<uint8_t> out = {'E', 'D', 'A', 'H', 1, static_cast<uint8_t>(precisionBits_)};
+            detail::putVarint(out, count_);
+            detail::putVarint(out, zeroCount_);
+            detail::putDouble(out, sum_);
+            detail::putDouble(out, min_);
+            detail::putDouble(out, max_);
+            size_t first = 0, last = counts_.size();
+            while (first < last && counts_[first] == 0)
+                ++first;
+            while (last > first && counts_[last - 1] == 0)
+                --last;
+            std::vector<int64_t> entries;
+            for (size_t k = first; k < last;)
+            {
+                if (counts_[k] != 0)
+                {
+                    entries.push_back(static_cast<int64_t>(counts_[k]));
+                    ++k;
+                    continue;
+                }
+                size_t run = 0;
+                while (counts_[k] == 0)
+                {
+                    ++run;
+                    ++k;
+                }
+                entries.push_back(-static_cast<int64_t>(run));
+            }
+            detail::putVarint(out, first < last ? static_cast<uint64_t>(offset_) + first : 0);
+            detail::putVarint(out, entries.size());
+            for (int64_t e : entries)
+                detail::putVarint(out, (static_cast<uint64_t>(e) << 1) ^ static_cast<uint64_t>(e >> 63)); // zigzag
+            return out;
+        }
+
+        static LatencyHistogram deserialize(const uint8_t *data, size_t size)
+        {
+            size_t pos = 6;
+            if (size < pos || std::memcmp(data, "EDAH", 4) != 0 || data[4] != 1)
+                throw std::invalid_argument("Not a serialized LatencyHistogram");
+            LatencyHistogram h;
+            h.precisionBits_ = data[5];
+            if (h.precisionBits_ < 4 || h.precisionBits_ > 17)
+                throw std::invalid_argument("Corrupt histogram encoding");
+            h.count_ = detail::getVarint(data, size, pos);
+            h.zeroCount_ = detail::getVarint(data, size, pos);
+            h.sum_ = detail::getDouble(data, size, pos);
+            h.min_ = detail::getDouble(data, size, pos);
+            h.max_ = detail::getDouble(data, size, pos);
+            const uint64_t first = detail::getVarint(data, size, pos);
+            const uint64_t numEntries = detail::getVarint(data, size, pos);
+            if (numEntries > size - pos ||
+                (numEntries > 0 && (first < static_cast<uint64_t>(h.index(std::numeric_limits<double>::min())) ||
+                                    first > static_cast<uint64_t>(h.index(std::numeric_limits<double>::max())))))
+                throw std::invalid_argument("Corrupt histogram encoding");
+            h.offset_ = static_cast<int64_t>(first);
+            // Runs may not extend past the last finite bucket, so hostile input cannot force a
+            // larger allocation than the precision and exponent range allow.
+            const uint64_t maxBuckets = static_cast<uint64_t>(h.index(std::numeric_limits<double>::max()) + 1 - h.offset_);
+            uint64_t total = h.zeroCount_;
+            for (uint64_t e = 0; e < numEntries; ++e)
+            {
+                const uint64_t z = detail::getVarint(data, size, pos);
+                const int64_t v = static_cast<int64_t>(z >> 1) ^ -static_cast<int64_t>(z & 1);
+                const uint64_t run = v > 0 ? 1 : static_cast<uint64_t>(-(v + 1)) + 1;
+                if (v == 0 || run > maxBuckets - h.counts_.size())
+                    throw std::invalid_argument("Corrupt histogram encoding");
+                if (v > 0)
+                {
+                    h.counts_.push_back(static_cast<uint64_t>(v));
+                    total += static_cast<uint64_t>(v);
+                }
+                else
+                    h.counts_.resize(h.counts_.size() + static_cast<size_t>(run), 0);
+            }
+            if (total != h.count_ || pos != size)
+                throw std::invalid_argument("Corrupt histogram encoding");
+            return h;
+        }
+
+        static LatencyHistogram deserialize(const std::vector<uint8_t> &bytes)
+        {
+            return deserialize(bytes.data(), bytes.size());
+        }
+
+    private:
+        int64_t index(double x) const
+        {
+            uint64_t bits;
+            std::memcpy(&bits, &x, sizeof x);
+            return static_cast<int64_t>(bits >> (52 - precisionBits_));
+        }
+
+        // Smallest value of bucket i
+        double lowerBound(int64_t i) const
+        {
+            const uint64_t bits = static_cast<uint64_t>(i) << (52 - precisionBits_);
+            double x;
+            std::memcpy(&x, &bits, sizeof x);
+            return x;
+        }
+
+        // Grow the bucket window to include [lo, hi], at least doubling it so growth is amortized O(1)
+        void cover(int64_t lo, int64_t hi)
+        {
+            if (counts_.empty())
+            {
+                counts_.assign(static_cast<size_t>(hi - lo + 1), 0);
+                offset_ = lo;
+                return;
+            }
+            const int64_t size = static_cast<int64_t>(counts_.size());
+            const int64_t minIndex = index(std::numeric_limits<double>::min());
+            const int64_t maxIndex = index(std::numeric_limits<double>::max());
+            if (lo < offset_)
+            {
+                const int64_t newOffset = std::max(minIndex, std::min(lo, offset_ - size));
+                counts_.insert(counts_.begin(), static_cast<size_t>(offset_ - newOffset), 0);
+                offset_ = newOffset;
+            }
+            if (hi >= offset_ + static_cast<int64_t>(counts_.size()))
+            {
+                const int64_t newEnd = std::min(maxIndex + 1, std::max(hi + 1, offset_ + 2 * static_cast<int64_t>(counts_.size())));
+                counts_.resize(static_cast<size_t>(newEnd - offset_), 0);
+            }
+        }
+
+        int precisionBits_;
+        std::vector<uint64_t> counts_; // buckets [offset_, offset_ + counts_.size())
+        int64_t offset_ = 0;
+        uint64_t zeroCount_ = 0;
+        uint64_t count_ = 0;
+        double sum_ = 0.0;
+        double min_ = std::numeric_limits<double>::infinity();
+        double max_ = -std::numeric_limits<double>::infinity();
+    };
+
+    /**
+     * LatencyHistogram that many threads can record into at once.
+     * Layman: A shared latency histogram where recording threads do not wait for each other.
+     * Technical: Recording goes to one of several shards picked by a hash of the thread
+     * id, each a LatencyHistogram behind its own mutex on its own cache lines, so threads only
+     * meet when two of them share a shard (as many shards as hardware threads by default).
+     * snapshot() merges the shards, locking one at a time.
+     */
+    class ConcurrentLatencyHistogram
+    {
+    public:
+        explicit ConcurrentLatencyHistogram(int significantDigits = 2, size_t numShards = 0)
+        {
+            if (numShards == 0)
+                numShards = std::max<size_t>(1, std::thread::hardware_concurrency());
+            for (size_t s = 0; s < numShards; ++s)
+                shards_.emplace_back(new Shard(significantDigits));
+        }
+
+        void record(double x)
+        {
+            Shard &shard = *shards_[std::hash<std::thread::id>()(std::this_thread::get_id()) % shards_.size()];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.histogram.record(x);
+        }
+
+        // Record a batch under a single lock
+        void record(const double *x, size_t n)
+        {
+            Shard &shard = *shards_[std::hash<std::thread::id>()(std::this_thread::get_id()) % shards_.size()];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.histogram.record(x, n);
+        }
+
+        // Merged copy of all shards
+        LatencyHistogram snapshot() const
+        {
+            LatencyHistogram merged(1);
+            bool first = true;
+            for (const auto &shard : shards_)
+            {
+                std::lock_guard<std::mutex> lock(shard->mutex);
+                if (first)
+                    merged = shard->histogram;
+                else
+                    merged.merge(shard->histogram);
+                first = false;
+            }
+            return merged;
+        }
+
+        void clear()
+        {
+            for (auto &shard : shards_)
+            {
+                std::lock_guard<std::mutex> lock(shard->mutex);
+                shard->histogram.clear();
+            }
+        }
+
+    private:
+        struct Shard
+        {
+            explicit Shard(int significantDigits) : histogram(significantDigits) {}
+
+            mutable std::mutex mutex;
+            LatencyHistogram histogram;
+            char padding[64]; // keeps neighbouring shards off each other's cache lines
+        };
+
+        std::vector<std::unique_ptr<Shard>> shards_;
+    };
+
+    /**
+     * Box plot statistics from a LatencyHistogram.
+     * Layman: Min, quartiles and max of live data recorded in a histogram, with no copy or
+     * sort of the values.
+     * Technical: Exact min and max; quartiles and median to within the histogram's relative
+     * precision (rank-based, so they can differ slightly from the hinges of the vector
+     * boxPlotStats on small samples).
+     */
+    inline void boxPlotStats(const LatencyHistogram &h, double &min, double &q1, double &median, double &q3, double &max)
+    {
+        if (h.count() == 0)
+            throw std::invalid_argument("Histogram is empty");
+        min = h.min();
+        q1 = h.percentile(25.0);
+        median = h.percentile(50.0);
+        q3 = h.percentile(75.0);
+        max = h.max();
+    }
+}
+
+#endif // EDA_LATENCY_HISTOGRAM_H
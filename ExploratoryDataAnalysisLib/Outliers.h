@@ -0,0 +1,303 @@
+#ifndef EDA_OUTLIERS_H
+#define EDA_OUTLIERS_H
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+#include "Histogram.h"
+#include "LatencyHistogram.h"
+
+namespace EDA
+{
+    // Tukey fences: values below lower or above upper are outliers
+    struct IQRFences
+    {
+        double lower;
+        double upper;
+    };
+
+    /**
+     * Box plot statistics in place, without sorting.
+     * Layman: Min, quartiles and max of a buffer you own, using no extra memory.
+     * Technical: Same definitions as boxPlotStats (quartiles are the medians of the lower
+     * and upper halves, excluding the median for odd sizes), but the at most six order
+     * statistics involved are found by multi-quantile selection (nth_element) in O(n)
+     * expected time. The buffer is permuted. NaN values are not allowed here.
+     */
+    template <typename T>
+    void boxPlotStatsInPlace(T *data, size_t n, T &min, T &q1, T &median, T &q3, T &max)
+    {
+        if (n == 0)
+            throw std::invalid_argument("Data vector is empty");
+        const auto extremes = std::minmax_element(data, data + n);
+        min = *extremes.first;
+        max = *extremes.second;
+
+        // Ranks of the median of [first, first + size), one or two of them
+        const size_t half = n / 2, upperStart = n - half;
+        const size_t starts[3] = {0, 0, upperStart};
+        const size_t sizes[3] = {n, half, half};
+        std::vector<size_t> ranks;
+        for (int k = 0; k < 3; ++k)
+        {
+            if (sizes[k] == 0)
+                continue;
+            if (sizes[k] % 2 == 0)
+                ranks.push_back(starts[k] + sizes[k] / 2 - 1);
+            ranks.push_back(starts[k] + sizes[k] / 2);
+        }
+        std::sort(ranks.begin(), ranks.end());
+        ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+        detail::multiSelect(data, data + n, ranks.data(), 0, ranks.size(), 0);
+
+        auto medianOf = [&](size_t start, size_t size) -> T
+        {
+            if (size % 2 == 0)
+                return (data[start + size / 2 - 1] + data[start + size / 2]) / 2;
+            return data[start + size / 2];
+        };
+        median = medianOf(0, n);
+        q1 = half > 0 ? medianOf(0, half) : median;
+        q3 = half > 0 ? medianOf(upperStart, half) : median;
+    }
+
+    namespace detail
+    {
+        // Copy of the present values (not NaN, validity bit set), the one scratch buffer selection needs
+        template <typename T>
+        std::vector<T> validValues(const T *data, size_t n, const uint64_t *validity = nullptr)
+        {
+            std::vector<T> values;
+            values.reserve(n);
+            for (size_t first = 0; first < n; first += 64)
+            {
+                const size_t m = std::min<size_t>(64, n - first);
+                const uint64_t mask = DescriptiveStatistics::detail::presenceWord(data, first, m, validity);
+                for (size_t j = 0; j < m; ++j)
+                    if ((mask >> j) & 1)
+                        values.push_back(data[first + j]);
+            }
+            return values;
+        }
+
+        inline IQRFences fencesFromQuartiles(double q1, double q3, double k)
+        {
+            if (!(k >= 0))
+                throw std::invalid_argument("Fence multiplier must be non-negative");
+            const double iqr = q3 - q1;
+            return IQRFences{q1 - k * iqr, q3 + k * iqr};
+        }
+    }
+
+    /**
+     * Exact Tukey fences Q1 - k IQR and Q3 + k IQR.
+     * Layman: The range outside of which a value counts as an outlier (k = 1.5 is the
+     * classic box plot whisker rule, k = 3 flags only extreme values).
+     * Technical: Quartiles as in boxPlotStats, by selection on one scratch copy of the
+     * present values (NaN and rows masked out by the optional validity bitmap are
+     * skipped); O(n) expected time.
+     */
+    template <typename T>
+    IQRFences iqrFences(const T *data, size_t n, double k = 1.5, const uint64_t *validity = nullptr)
+    {
+        std::vector<T> values = detail::validValues(data, n, validity);
+        T min, q1, median, q3, max;
+        boxPlotStatsInPlace(values.data(), values.size(), min, q1, median, q3, max);
+        return detail::fencesFromQuartiles(static_cast<double>(q1), static_cast<double>(q3), k);
+    }
+
+    template <typename T>
+    IQRFences iqrFences(const std::vector<T> &data, double k = 1.5)
+    {
+        return iqrFences(data.data(), data.size(), k);
+    }
+
+    /**
+     * Indices of the values outside the fences.
+     * Layman: Which rows are outliers, given the fences.
+     * Technical: One read-only scan; NaN values and rows masked out by the optional
+     * validity bitmap (bit i for data[i]) are never outliers. firstIndex is added to every
+     * index, so chunks of a larger dataset report global row numbers.
+     */
+    template <typename T>
+    std::vector<size_t> outlierIndices(const T *data, size_t n, const IQRFences &fences, size_t firstIndex = 0,
+                                       const uint64_t *validity = nullptr)
+    {
+        std::vector<size_t> indices;
+        for (size_t i = 0; i < n; ++i)
+        {
+            const double v = static_cast<double>(data[i]);
+            if ((v < fences.lower || v > fences.upper) && (!validity || ((validity[i >> 6] >> (i & 63)) & 1)))
+                indices.push_back(firstIndex + i);
+        }
+        return indices;
+    }
+
+    // Indices of the IQR outliers of the data, using exact fences (see iqrFences)
+    template <typename T>
+    std::vector<size_t> outlierIndices(const T *data, size_t n, double k = 1.5, const uint64_t *validity = nullptr)
+    {
+        return outlierIndices(data, n, iqrFences(data, n, k, validity), 0, validity);
+    }
+
+    template <typename T>
+    std::vector<size_t> outlierIndices(const std::vector<T> &data, double k = 1.5)
+    {
+        return outlierIndices(data.data(), data.size(), k);
+    }
+
+    /**
+     * Box plot statistics and outlier fences for data streamed in chunks.
+     * Layman: Feed values in any number of chunks (for data that does not fit in memory)
+     * and get approximate quartiles and outlier fences at any time.
+     * Technical: Values go into two LatencyHistograms (non-negative values and the negated
+     * negative ones), so memory depends on the dynamic range of the data, not on its size,
+     * and sketches of different chunks or threads merge exactly. Quartiles are the values of
+     * rank floor(q (count - 1)) to within half a bucket (2^-(precisionBits + 1) relative);
+     * min, max and count are exact. NaN values are counted as missing and skipped. Infinite
+     * values are counted separately and rank below (-inf) or above (+inf) every finite
+     * value, so percentiles that fall on them, min and max return +/-inf. For outliers in
+     * data on disk, stream it once to build the sketch, then once more through
+     * outlierIndices with the fences.
+     */
+    class StreamingBoxPlot
+    {
+    public:
+        explicit StreamingBoxPlot(int significantDigits = 2) : positive_(significantDigits), negative_(significantDigits) {}
+
+        void add(double x)
+        {
+            if (x >= 0.0 && x <= std::numeric_limits<double>::max())
+                positive_.record(x);
+            else if (x < 0.0 && x >= -std::numeric_limits<double>::max())
+                negative_.record(-x);
+            else if (x > 0.0)
+                ++positiveInfinite_;
+            else if (x < 0.0)
+                ++negativeInfinite_;
+            else
+                ++missing_;
+        }
+
+        void add(const double *x, size_t n)
+        {
+            for (size_t i = 0; i < n; ++i)
+                add(x[i]);
+        }
+
+        void add(const std::vector<double> &x) { add(x.data(), x.size()); }
+
+        void merge(const StreamingBoxPlot &other)
+        {
+            positive_.merge(other.positive_);
+            negative_.merge(other.negative_);
+            positiveInfinite_ += other.positiveInfinite_;
+            negativeInfinite_ += other.negativeInfinite_;
+            missing_ += other.missing_;
+        }
+
+        // Values added, infinite ones included
+        uint64_t count() const { return positive_.count() + negative_.count() + infinite(); }
+        uint64_t infinite() const { return positiveInfinite_ + negativeInfinite_; }
+        uint64_t missing() const { return missing_; }
+
+        // Value at a percentile (0-100), to within the relative precision
+        double percentile(double p) const
+        {
+            if (count() == 0)
+                throw std::logic_error("No values added");
+            if (p < 0.0 || p > 100.0)
+                throw std::invalid_argument("Percentile must be between 0 and 100");
+            const double inf = std::numeric_limits<double>::infinity();
+            uint64_t rank = static_cast<uint64_t>(std::floor(p / 100.0 * static_cast<double>(count() - 1)));
+            if (rank < negativeInfinite_)
+                return -inf;
+            rank -= negativeInfinite_;
+            const uint64_t negatives = negative_.count();
+            if (rank < negatives)
+                return -negative_.valueAtRank(negatives - 1 - rank);
+            rank -= negatives;
+            return rank < positive_.count() ? positive_.valueAtRank(rank) : inf;
+        }
+
+        // Fraction of the values that are at most x, interpolated within buckets
+        double cdf(double x) const
+        {
+            if (count() == 0)
+                throw std::logic_error("No values added");
+            const double inf = std::numeric_limits<double>::infinity();
+            if (x == inf)
+                return 1.0;
+            const double negatives = static_cast<double>(negative_.count());
+            double below = static_cast<double>(negativeInfinite_);
+            if (x < 0.0 && x > -inf)
+                below += negative_.count() ? negatives * (1.0 - negative_.cdf(-x)) : 0.0;
+            else if (x >= 0.0)
+                below += negatives + (positive_.count() ? static_cast<double>(positive_.count()) * positive_.cdf(x) : 0.0);
+            return below / static_cast<double>(count());
+        }
+
+        double min() const
+        {
+            if (negativeInfinite_)
+                return -std::numeric_limits<double>::infinity();
+            if (negative_.count())
+                return -negative_.max();
+            if (positive_.count() || !positiveInfinite_)
+                return positive_.min(); // NaN when empty
+            return std::numeric_limits<double>::infinity();
+        }
+
+        double max() const
+        {
+            if (positiveInfinite_)
+                return std::numeric_limits<double>::infinity();
+            if (positive_.count())
+                return positive_.max();
+            if (negative_.count() || !negativeInfinite_)
+                return -negative_.min(); // NaN when empty
+            return -std::numeric_limits<double>::infinity();
+        }
+
+        void clear()
+        {
+            positive_.clear();
+            negative_.clear();
+            positiveInfinite_ = negativeInfinite_ = 0;
+            missing_ = 0;
+        }
+
+    private:
+        LatencyHistogram positive_;
+        LatencyHistogram negative_;
+        uint64_t positiveInfinite_ = 0;
+        uint64_t negativeInfinite_ = 0;
+        uint64_t missing_ = 0;
+    };
+
+    // Approximate box plot statistics of streamed data (see StreamingBoxPlot)
+    inline void boxPlotStats(const StreamingBoxPlot &sketch, double &min, double &q1, double &median, double &q3,
+                             double &max)
+    {
+        if (sketch.count() == 0)
+            throw std::invalid_argument("No values added");
+        min = sketch.min();
+        q1 = sketch.percentile(25.0);
+        median = sketch.percentile(50.0);
+        q3 = sketch.percentile(75.0);
+        max = sketch.max();
+    }
+
+    // Approximate Tukey fences of streamed data (see StreamingBoxPlot)
+    inline IQRFences iqrFences(const StreamingBoxPlot &sketch, double k = 1.5)
+    {
+        if (sketch.count() == 0)
+            throw std::invalid_argument("No values added");
+        return detail::fencesFromQuartiles(sketch.percentile(25.0), sketch.percentile(75.0), k);
+    }
+}
+
+#endif // EDA_OUTLIERS_H
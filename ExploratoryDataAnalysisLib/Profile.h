@@ -0,0 +1,594 @@
+#ifndef EDA_PROFILE_H
+#define EDA_PROFILE_H
+
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <chrono>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+#include <algorithm>
+#include "Histogram.h"
+#include "LatencyHistogram.h"
+#include "Outliers.h"
+#include "Sketches.h"
+
+namespace EDA
+{
+    struct ProfileOptions
+    {
+        size_t histogramBins;
+        size_t topK;              // most frequent values reported per column (0 = none)
+        int significantDigits;    // relative precision of the quantile sketch
+        int hllPrecision;         // HyperLogLog registers = 2^hllPrecision
+        size_t numThreads;        // 0 = hardware concurrency
+        std::vector<double> percentiles;
+        // Optional validity bitmap per column (see DescriptiveStatistics::ValidityBitmap); rows
+        // whose bit is clear count as missing. Empty = only NaN is missing.
+        std::vector<const uint64_t *> validity;
+
+        explicit ProfileOptions(size_t histogramBins = 20, size_t topK = 10)
+            : histogramBins(histogramBins), topK(topK), significantDigits(2), hllPrecision(12), numThreads(0),
+              percentiles{1, 5, 25, 50, 75, 95, 99} {}
+    };
+
+    struct ColumnProfile
+    {
+        std::string name;
+        uint64_t count = 0;    // present finite values
+        uint64_t missing = 0;  // NaN or masked out
+        uint64_t infinite = 0; // +/-inf, left out of every statistic below (histogram underflow / overflow)
+        double mean = 0, variance = 0, stddev = 0;
+        double skewness = 0, kurtosis = 0; // sample skewness g1 and excess kurtosis g2
+        double min = 0, max = 0;
+        std::vector<double> quantiles; // at ProfileReport::percentiles
+        Histogram histogram;
+        double distinct = 0; // HyperLogLog estimate of the number of distinct values
+        std::vector<HeavyHitter<double>> topValues;
+    };
+
+    // Wall-clock seconds of a pipeline stage; "scan.*" entries are the seconds spent in each
+    // kernel of the scan, summed over threads
+    struct StageTiming
+    {
+        std::string stage;
+        double seconds;
+    };
+
+    namespace detail
+    {
+        inline void putString(std::vector<uint8_t> &out, const std::string &s)
+        {
+            putVarint(out, s.size());
+            out.insert(out.end(), s.begin(), s.end());
+        }
+
+        inline std::string getString(const uint8_t *data, size_t size, size_t &pos)
+        {
+            const uint64_t length = getVarint(data, size, pos);
+            if (length > size - pos)
+                throw std::invalid_argument("Truncated or corrupt encoding");
+            const std::string s(reinterpret_cast<const char *>(data + pos), static_cast<size_t>(length));
+            pos += static_cast<size_t>(length);
+            return s;
+        }
+
+        // Element count read from an encoding, bounded by the bytes left so corrupt input cannot allocate
+        inline size_t getCount(const uint8_t *data, size_t size, size_t &pos)
+        {
+            const uint64_t count = getVarint(data, size, pos);
+            if (count > size - pos)
+                throw std::invalid_argument("Truncated or corrupt encoding");
+            return static_cast<size_t>(count);
+        }
+
+        inline void jsonNumber(std::ostream &out, double x)
+        {
+            if (std::isfinite(x))
+                out << x;
+            else
+                out << "null";
+        }
+
+        inline void jsonString(std::ostream &out, const std::string &s)
+        {
+            out << '"';
+            for (unsigned char c : s)
+            {
+                if (c == '"' || c == '\\')
+                    out << '\\' << c;
+                else if (c < 0x20)
+                    out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c)
+                        << std::dec << std::setfill(' ');
+                else
+                    out << c;
+            }
+            out << '"';
+        }
+
+        inline void jsonArray(std::ostream &out, const std::vector<double> &values)
+        {
+            out << '[';
+            for (size_t i = 0; i < values.size(); ++i)
+            {
+                if (i)
+                    out << ',';
+                jsonNumber(out, values[i]);
+            }
+            out << ']';
+        }
+
+        // Count, mean and central moment sums M2..M4 of a set of values, mergeable (Pebay 2008)
+        struct Moments
+        {
+            double n = 0, mean = 0, m2 = 0, m3 = 0, m4 = 0;
+            double min = std::numeric_limits<double>::infinity();
+            double max = -std::numeric_limits<double>::infinity();
+
+            // Two passes over a buffer that is in cache: the mean, then the deviations
+            void add(const double *x, size_t count)
+            {
+                if (count == 0)
+                    return;
+                Moments b;
+                double sum = 0.0;
+                for (size_t i = 0; i < count; ++i)
+                    sum += x[i];
+                b.n = static_cast<double>(count);
+                b.mean = sum / b.n;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    const double d = x[i] - b.mean, d2 = d * d;
+                    b.m2 += d2;
+                    b.m3 += d2 * d;
+                    b.m4 += d2 * d2;
+                    b.min = std::min(b.min, x[i]);
+                    b.max = std::max(b.max, x[i]);
+                }
+                merge(b);
+            }
+
+            void merge(const Moments &b)
+            {
+                if (b.n == 0)
+                    return;
+                if (n == 0)
+                {
+                    *this = b;
+                    return;
+                }
+                const double na = n, nb = b.n, total = na + nb;
+                const double delta = b.mean - mean, d2 = delta * delta;
+                m4 += b.m4 + d2 * d2 * na * nb * (na * na - na * nb + nb * nb) / (total * total * total) +
+                      6.0 * d2 * (na * na * b.m2 + nb * nb * m2) / (total * total) +
+                      4.0 * delta * (na * b.m3 - nb * m3) / total;
+                m3 += b.m3 + d2 * delta * na * nb * (na - nb) / (total * total) + 3.0 * delta * (na * b.m2 - nb * m2) / total;
+                m2 += b.m2 + d2 * na * nb / total;
+                mean += delta * nb / total;
+                n = total;
+                min = std::min(min, b.min);
+                max = std::max(max, b.max);
+            }
+        };
+
+        // Everything the scan accumulates for one column over one row block
+        struct ColumnScan
+        {
+            uint64_t missing = 0;
+            uint64_t negativeInfinite = 0, positiveInfinite = 0;
+            Moments moments;
+            StreamingBoxPlot sketch;
+            HyperLogLog distinct;
+            SpaceSaving<double> frequent;
+            double seconds[4] = {0, 0, 0, 0}; // moments, quantiles, distinct, top values
+
+            explicit ColumnScan(const ProfileOptions &options)
+                : sketch(options.significantDigits), distinct(options.hllPrecision),
+                  frequent(std::max<size_t>(64, 8 * options.topK)) {}
+
+            void merge(const ColumnScan &other)
+            {
+                missing += other.missing;
+                negativeInfinite += other.negativeInfinite;
+                positiveInfinite += other.positiveInfinite;
+                moments.merge(other.moments);
+                sketch.merge(other.sketch);
+                distinct.merge(other.distinct);
+                frequent.merge(other.frequent);
+                for (int k = 0; k < 4; ++k)
+                    seconds[k] += other.seconds[k];
+            }
+        };
+
+        inline double secondsSince(std::chrono::steady_clock::time_point start)
+        {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        /**
+         * Feed rows [first, last) of one column to every accumulator.
+         * Rows go through in tiles: the present values of a tile (by the NaN test and the
+         * validity bitmap, one 64-row word at a time) are packed into a small buffer that
+         * stays in L1, and each kernel then makes its passes over that buffer, so the column
+         * is read from memory once however many statistics are collected. Infinite values
+         * are only counted.
+         */
+        template <typename T>
+        void scanColumn(const T *x, size_t first, size_t last, const uint64_t *validity, size_t topK, ColumnScan &scan)
+        {
+            const size_t tileRows = 2048;
+            std::vector<double> tile(tileRows);
+            std::vector<uint64_t> hashes(tileRows);
+            for (size_t start = first; start < last; start += tileRows)
+            {
+                const size_t rows = std::min(tileRows, last - start);
+                auto clock = std::chrono::steady_clock::now();
+                size_t count = 0;
+                const uint64_t infiniteBefore = scan.negativeInfinite + scan.positiveInfinite;
+                for (size_t word = 0; word < rows; word += 64)
+                {
+                    const size_t m = std::min<size_t>(64, rows - word);
+                    uint64_t mask = DescriptiveStatistics::detail::presenceWord(x, start + word, m, validity);
+                    for (; mask; mask &= mask - 1)
+                    {
+                        const double v = static_cast<double>(x[start + word + DescriptiveStatistics::detail::lowestBit(mask)]);
+                        if (std::fabs(v) <= std::numeric_limits<double>::max())
+                            tile[count++] = v;
+                        else if (v > 0)
+                            ++scan.positiveInfinite;
+                        else
+                            ++scan.negativeInfinite;
+                    }
+                }
+                scan.missing += rows - count - (scan.negativeInfinite + scan.positiveInfinite - infiniteBefore);
+                scan.moments.add(tile.data(), count);
+                auto now = std::chrono::steady_clock::now();
+                scan.seconds[0] += std::chrono::duration<double>(now - clock).count();
+
+                clock = now;
+                scan.sketch.add(tile.data(), count);
+                now = std::chrono::steady_clock::now();
+                scan.seconds[1] += std::chrono::duration<double>(now - clock).count();
+
+                clock = now;
+                // One batch of hashes serves both the distinct count and the top values
+                hashValues(tile.data(), count, hashes.data());
+                for (size_t i = 0; i < count; ++i)
+                    scan.distinct.addHash(hashes[i]);
+                now = std::chrono::steady_clock::now();
+                scan.seconds[2] += std::chrono::duration<double>(now - clock).count();
+
+                if (topK == 0)
+                    continue;
+                clock = now;
+                // Runs of equal values (sorted or categorical columns) cost one update
+                for (size_t i = 0; i < count;)
+                {
+                    size_t j = i + 1;
+                    while (j < count && tile[j] == tile[i])
+                        ++j;
+                    scan.frequent.addHashed(tile[i] == 0.0 ? 0.0 : tile[i], hashes[i], j - i);
+                    i = j;
+                }
+                scan.seconds[3] += secondsSince(clock);
+            }
+        }
+
+        // Turn the merged accumulators of a column into its profile
+        inline void finalizeColumn(const ColumnScan &scan, const ProfileOptions &options, ColumnProfile &column)
+        {
+            const Moments &m = scan.moments;
+            const double nan = std::numeric_limits<double>::quiet_NaN();
+            column.count = static_cast<uint64_t>(m.n);
+            column.infinite = scan.negativeInfinite + scan.positiveInfinite;
+            column.missing = scan.missing;
+            column.histogram.missing = scan.missing;
+            column.histogram.underflow = scan.negativeInfinite;
+            column.histogram.overflow = scan.positiveInfinite;
+            if (column.count == 0)
+            {
+                column.mean = column.variance = column.stddev = column.skewness = column.kurtosis = nan;
+                column.min = column.max = nan;
+                column.quantiles.assign(options.percentiles.size(), nan);
+                return;
+            }
+            column.mean = m.mean;
+            column.variance = m.n > 1 ? m.m2 / (m.n - 1) : nan;
+            column.stddev = std::sqrt(column.variance);
+            column.skewness = m.m2 > 0 ? std::sqrt(m.n) * m.m3 / std::pow(m.m2, 1.5) : nan;
+            column.kurtosis = m.m2 > 0 ? m.n * m.m4 / (m.m2 * m.m2) - 3.0 : nan;
+            column.min = m.min;
+            column.max = m.max;
+            for (double p : options.percentiles)
+                column.quantiles.push_back(scan.sketch.percentile(p));
+            column.distinct = std::min(scan.distinct.estimate(), m.n);
+            column.topValues = scan.frequent.top(options.topK);
+
+            // Equal-width bins over the exact range; counts come from the sketch's CDF just
+            // below each inner edge, rounded cumulatively so they always add up to the count
+            const size_t bins = options.histogramBins;
+            double lo = m.min, hi = m.max;
+            if (lo == hi)
+            {
+                lo -= 0.5;
+                hi += 0.5;
+            }
+            Histogram &h = column.histogram;
+            h.edges.resize(bins + 1);
+            for (size_t i = 0; i <= bins; ++i)
+                h.edges[i] = lo + (hi - lo) * (static_cast<double>(i) / bins);
+            h.edges[bins] = hi;
+            h.counts.assign(bins, 0);
+            uint64_t below = 0;
+            for (size_t i = 0; i < bins; ++i)
+            {
+                uint64_t upTo = column.count;
+                if (i + 1 < bins)
+                    upTo = std::max(below, std::min(column.count, static_cast<uint64_t>(std::llround(
+                                                                      m.n * scan.sketch.cdf(std::nextafter(h.edges[i + 1], lo))))));
+                h.counts[i] = upTo - below;
+                below = upTo;
+            }
+        }
+    }
+
+    /**
+     * Result of profile(): one ColumnProfile per column plus stage timings.
+     * toJSON gives a human- and tool-readable report; serialize gives a compact binary
+     * encoding ("EDAP", version byte, then LEB128 varints for counts and raw little-endian
+     * doubles) that deserialize reads back exactly.
+     */
+    struct ProfileReport
+    {
+        uint64_t rows = 0;
+        std::vector<double> percentiles;
+        std::vector<ColumnProfile> columns;
+        std::vector<StageTiming> timings;
+
+        std::string toJSON() const
+        {
+            std::ostringstream out;
+            out << std::setprecision(12);
+            out << "{\"rows\":" << rows << ",\"percentiles\":";
+            detail::jsonArray(out, percentiles);
+            out << ",\"columns\":[";
+            for (size_t c = 0; c < columns.size(); ++c)
+            {
+                const ColumnProfile &col = columns[c];
+                out << (c ? "," : "") << "{\"name\":";
+                detail::jsonString(out, col.name);
+                out << ",\"count\":" << col.count << ",\"missing\":" << col.missing << ",\"infinite\":" << col.infinite;
+                const char *names[] = {"mean", "variance", "stddev", "skewness", "kurtosis", "min", "max", "distinct"};
+                const double values[] = {col.mean, col.variance, col.stddev, col.skewness, col.kurtosis,
+                                         col.min, col.max, col.distinct};
+                for (int k = 0; k < 8; ++k)
+                {
+                    out << ",\"" << names[k] << "\":";
+                    detail::jsonNumber(out, values[k]);
+                }
+                out << ",\"quantiles\":";
+                detail::jsonArray(out, col.quantiles);
+                out << ",\"histogram\":{\"edges\":";
+                detail::jsonArray(out, col.histogram.edges);
+                out << ",\"counts\":[";
+                for (size_t i = 0; i < col.histogram.counts.size(); ++i)
+                    out << (i ? "," : "") << col.histogram.counts[i];
+                out << "]},\"topValues\":[";
+                for (size_t i = 0; i < col.topValues.size(); ++i)
+                {
+                    out << (i ? "," : "") << "{\"value\":";
+                    detail::jsonNumber(out, col.topValues[i].value);
+                    out << ",\"count\":" << col.topValues[i].count << ",\"error\":" << col.topValues[i].error << "}";
+                }
+                out << "]}";
+            }
+            out << "],\"timings\":{";
+            for (size_t i = 0; i < timings.size(); ++i)
+            {
+                out << (i ? "," : "");
+                detail::jsonString(out, timings[i].stage);
+                out << ':';
+                detail::jsonNumber(out, timings[i].seconds);
+            }
+            out << "}}";
+            return out.str();
+        }
+
+        std::vector<uint8_t> serialize() const
+        {
+            std::vector<uint8_t> out = {'E', 'D', 'A', 'P', 1};
+            detail::putVarint(out, rows);
+            detail::putVarint(out, percentiles.size());
+            for (double p : percentiles)
+                detail::putDouble(out, p);
+            detail::putVarint(out, columns.size());
+            for (const ColumnProfile &col : columns)
+            {
+                detail::putString(out, col.name);
+                detail::putVarint(out, col.count);
+                detail::putVarint(out, col.missing);
+                detail::putVarint(out, col.histogram.underflow);
+                detail::putVarint(out, col.histogram.overflow);
+                for (double x : {col.mean, col.variance, col.stddev, col.skewness, col.kurtosis, col.min, col.max, col.distinct})
+                    detail::putDouble(out, x);
+                for (double q : col.quantiles)
+                    detail::putDouble(out, q);
+                detail::putVarint(out, col.histogram.counts.size());
+                if (!col.histogram.counts.empty())
+                    for (double e : col.histogram.edges)
+                        detail::putDouble(out, e);
+                for (uint64_t k : col.histogram.counts)
+                    detail::putVarint(out, k);
+                detail::putVarint(out, col.topValues.size());
+                for (const auto &v : col.topValues)
+                {
+                    detail::putDouble(out, v.value);
+                    detail::putVarint(out, v.count);
+                    detail::putVarint(out, v.error);
+                }
+            }
+            detail::putVarint(out, timings.size());
+            for (const StageTiming &t : timings)
+            {
+                detail::putString(out, t.stage);
+                detail::putDouble(out, t.seconds);
+            }
+            return out;
+        }
+
+        static ProfileReport deserialize(const uint8_t *data, size_t size)
+        {
+            size_t pos = 5;
+            if (size < pos || std::memcmp(data, "EDAP", 4) != 0 || data[4] != 1)
+                throw std::invalid_argument("Not a serialized ProfileReport");
+            ProfileReport report;
+            report.rows = detail::getVarint(data, size, pos);
+            report.percentiles.resize(detail::getCount(data, size, pos));
+            for (double &p : report.percentiles)
+                p = detail::getDouble(data, size, pos);
+            report.columns.resize(detail::getCount(data, size, pos));
+            for (ColumnProfile &col : report.columns)
+            {
+                col.name = detail::getString(data, size, pos);
+                col.count = detail::getVarint(data, size, pos);
+                col.missing = col.histogram.missing = detail::getVarint(data, size, pos);
+                col.histogram.underflow = detail::getVarint(data, size, pos);
+                col.histogram.overflow = detail::getVarint(data, size, pos);
+                col.infinite = col.histogram.underflow + col.histogram.overflow;
+                for (double *x : {&col.mean, &col.variance, &col.stddev, &col.skewness, &col.kurtosis, &col.min, &col.max,
+                                  &col.distinct})
+                    *x = detail::getDouble(data, size, pos);
+                col.quantiles.resize(report.percentiles.size());
+                for (double &q : col.quantiles)
+                    q = detail::getDouble(data, size, pos);
+                const size_t bins = detail::getCount(data, size, pos);
+                col.histogram.counts.resize(bins);
+                col.histogram.edges.resize(bins ? bins + 1 : 0);
+                for (double &e : col.histogram.edges)
+                    e = detail::getDouble(data, size, pos);
+                for (uint64_t &k : col.histogram.counts)
+                    k = detail::getVarint(data, size, pos);
+                col.topValues.resize(detail::getCount(data, size, pos));
+                for (auto &v : col.topValues)
+                {
+                    v.value = detail::getDouble(data, size, pos);
+                    v.count = detail::getVarint(data, size, pos);
+                    v.error = detail::getVarint(data, size, pos);
+                }
+            }
+            report.timings.resize(detail::getCount(data, size, pos));
+            for (StageTiming &t : report.timings)
+            {
+                t.stage = detail::getString(data, size, pos);
+                t.seconds = detail::getDouble(data, size, pos);
+            }
+            if (pos != size)
+                throw std::invalid_argument("Corrupt profile encoding");
+            return report;
+        }
+
+        static ProfileReport deserialize(const std::vector<uint8_t> &bytes)
+        {
+            return deserialize(bytes.data(), bytes.size());
+        }
+    };
+
+    /**
+     * Profile a table in one parallel scan.
+     * Layman: Everything you usually look at first in a new table (counts, missing values,
+     * mean and spread, shape, quantiles, a histogram, how many distinct values and which
+     * values are most common) for every column, reading the data only once.
+     * Technical: Columns are split into row blocks (as in histograms) and every column x
+     * block task feeds one pass over its rows to all accumulators at once: mergeable
+     * moments up to the fourth, a StreamingBoxPlot quantile sketch, a HyperLogLog sketch
+     * and a SpaceSaving top-k sketch. Block results are then merged per column and
+     * finalized. Quantiles are within the sketch's relative precision (significantDigits);
+     * the histogram has equal-width bins over the exact range with counts from the sketch's
+     * CDF (a second pass for exact counts would double the I/O); distinct counts have about
+     * 1.04 / sqrt(2^hllPrecision) relative error; top values report count bounds. Moments,
+     * min, max, count and missing are exact. Infinite values are counted (infinite, and
+     * histogram underflow / overflow) but kept out of every other statistic. Timings cover
+     * the scan, merge and finalize stages and the time spent in each scan kernel.
+     * @param columns Pointers to the columns, each holding n values
+     * @param names Column names for the report (empty = "column 0", "column 1", ...)
+     */
+    template <typename T>
+    ProfileReport profile(const std::vector<const T *> &columns, size_t n, const std::vector<std::string> &names = std::vector<std::string>(),
+                          const ProfileOptions &options = ProfileOptions())
+    {
+        if (!names.empty() && names.size() != columns.size())
+            throw std::invalid_argument("One name per column required");
+        if (options.histogramBins == 0)
+            throw std::invalid_argument("Number of bins must be positive");
+        for (double p : options.percentiles)
+            if (!(p >= 0.0 && p <= 100.0))
+                throw std::invalid_argument("Percentile must be between 0 and 100");
+        detail::checkValidity(options.validity, columns.size());
+
+        const size_t numColumns = columns.size();
+        const size_t blocks = detail::rowBlocks(n, options.numThreads);
+        ProfileReport report;
+        report.rows = n;
+        report.percentiles = options.percentiles;
+        report.columns.resize(numColumns);
+
+        auto clock = std::chrono::steady_clock::now();
+        std::vector<detail::ColumnScan> scans(numColumns * blocks, detail::ColumnScan(options));
+        auto scanBlock = [&](size_t item)
+        {
+            const size_t c = item / blocks, b = item % blocks;
+            detail::scanColumn(columns[c], n * b / blocks, n * (b + 1) / blocks, detail::columnValidity(options.validity, c),
+                               options.topK, scans[item]);
+        };
+        detail::parallelFor(numColumns * blocks, options.numThreads, scanBlock);
+        report.timings.push_back(StageTiming{"scan", detail::secondsSince(clock)});
+
+        clock = std::chrono::steady_clock::now();
+        auto mergeColumn = [&](size_t c)
+        {
+            for (size_t b = 1; b < blocks; ++b)
+                scans[c * blocks].merge(scans[c * blocks + b]);
+        };
+        detail::parallelFor(numColumns, options.numThreads, mergeColumn);
+        report.timings.push_back(StageTiming{"merge", detail::secondsSince(clock)});
+
+        clock = std::chrono::steady_clock::now();
+        auto finalizeColumn = [&](size_t c)
+        {
+            report.columns[c].name = names.empty() ? "column " + std::to_string(c) : names[c];
+            detail::finalizeColumn(scans[c * blocks], options, report.columns[c]);
+        };
+        detail::parallelFor(numColumns, options.numThreads, finalizeColumn);
+        report.timings.push_back(StageTiming{"finalize", detail::secondsSince(clock)});
+
+        const char *kernels[] = {"scan.moments", "scan.quantiles", "scan.distinct", "scan.topValues"};
+        for (int k = 0; k < 4; ++k)
+        {
+            double seconds = 0.0;
+            for (size_t c = 0; c < numColumns; ++c)
+                seconds += scans[c * blocks].seconds[k];
+            report.timings.push_back(StageTiming{kernels[k], seconds});
+        }
+        return report;
+    }
+
+    template <typename T>
+    ProfileReport profile(const std::vector<std::vector<T>> &columns, const std::vector<std::string> &names = std::vector<std::string>(),
+                          const ProfileOptions &options = ProfileOptions())
+    {
+        std::vector<const T *> pointers;
+        for (const auto &column : columns)
+        {
+            if (column.size() != columns[0].size())
+                throw std::invalid_argument("All columns must be the same size");
+            pointers.push_back(column.data());
+        }
+        return profile(pointers, columns.empty() ? 0 : columns[0].size(), names, options);
+    }
+}
+
+#endif // EDA_PROFILE_H
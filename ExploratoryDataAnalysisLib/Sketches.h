@@ -0,0 +1,572 @@
+#ifndef EDA_SKETCHES_H
+#define EDA_SKETCHES_H
+
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+#include <type_traits>
+#include "Histogram.h"
+
+namespace EDA
+{
+    namespace detail
+    {
+        // splitmix64 finalizer: every input bit affects every output bit
+        inline uint64_t mix64(uint64_t x)
+        {
+            x += 0x9E3779B97F4A7C15ULL;
+            x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+            return x ^ (x >> 31);
+        }
+
+        // Number of leading zero bits of x != 0
+        inline int leadingZeros(uint64_t x)
+        {
+#if defined(__GNUC__)
+            return __builtin_clzll(x);
+#else
+            int k = 0;
+            for (; !(x >> 63); x <<= 1)
+                ++k;
+            return k;
+#endif
+        }
+    }
+
+    // 64-bit hash of a value for the sketches; -0.0 hashes like 0.0 so equal values agree
+    inline uint64_t hashValue(double x)
+    {
+        const double value = x == 0.0 ? 0.0 : x;
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof bits);
+        return detail::mix64(bits);
+    }
+
+    inline uint64_t hashValue(float x) { return hashValue(static_cast<double>(x)); }
+
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value, uint64_t>::type hashValue(T x)
+    {
+        return detail::mix64(static_cast<uint64_t>(x));
+    }
+
+    // FNV-1a over the bytes, then mixed
+    inline uint64_t hashValue(const std::string &s)
+    {
+        uint64_t h = 0xCBF29CE484222325ULL;
+        for (unsigned char c : s)
+            h = (h ^ c) * 0x100000001B3ULL;
+        return detail::mix64(h);
+    }
+
+    // Hashes of x[0..n) into out. For numbers this is a branch-free loop the compiler
+    // vectorizes (8 hashes per instruction with AVX-512), several times faster than one
+    // hashValue call at a time.
+    template <typename T>
+    void hashValues(const T *x, size_t n, uint64_t *out)
+    {
+        for (size_t i = 0; i < n; ++i)
+            out[i] = hashValue(x[i]);
+    }
+
+    namespace detail
+    {
+        // Values per batch of hashes: the batch stays in L1 between hashing and the updates
+        const size_t hashBatch = 256;
+
+        /**
+         * Build a sketch of x[0..n) with one private sketch per row block, merged at the end.
+         * Blocks are filled in parallel through the sketch's batch add(const T *, size_t),
+         * so threads never share state; the result equals a sequential build for HyperLogLog
+         * and Count-Min and satisfies the same bounds for SpaceSaving.
+         */
+        template <typename Sketch, typename T>
+        Sketch parallelSketch(const T *x, size_t n, size_t numThreads, const Sketch &empty)
+        {
+            const size_t blocks = rowBlocks(n, numThreads);
+            std::vector<Sketch> parts(blocks, empty);
+            auto fillBlock = [&](size_t b)
+            {
+                const size_t first = n * b / blocks, last = n * (b + 1) / blocks;
+                parts[b].add(x + first, last - first);
+            };
+            parallelFor(blocks, numThreads, fillBlock);
+            for (size_t b = 1; b < blocks; ++b)
+                parts[0].merge(parts[b]);
+            return parts[0];
+        }
+    }
+
+    /**
+     * HyperLogLog distinct-count sketch.
+     * Layman: Estimates how many different values a column holds using a few KB of memory,
+     * however many values it has.
+     * Technical: 2^precision one-byte registers; a value's 64-bit hash picks a register by
+     * its top bits and stores the largest count of leading zeros (+1) seen in the rest.
+     * The estimate is the bias-corrected harmonic mean of 2^-register, with linear
+     * counting for small cardinalities; relative standard error 1.04 / sqrt(2^precision)
+     * (1.6% at the default 12). Sketches with equal precision merge by register-wise max,
+     * so partial sketches of chunks or threads combine exactly.
+     */
+    class HyperLogLog
+    {
+    public:
+        explicit HyperLogLog(int precision = 12) : precision_(precision)
+        {
+            if (precision < 4 || precision > 18)
+                throw std::invalid_argument("HyperLogLog precision must be between 4 and 18");
+            registers_.assign(size_t(1) << precision, 0);
+        }
+
+        void addHash(uint64_t hash)
+        {
+            const size_t index = static_cast<size_t>(hash >> (64 - precision_));
+            // A sentinel bit below the remaining bits bounds the rank at 64 - precision + 1
+            const uint64_t rest = (hash << precision_) | (uint64_t(1) << (precision_ - 1));
+            const uint8_t rank = static_cast<uint8_t>(detail::leadingZeros(rest) + 1);
+            registers_[index] = std::max(registers_[index], rank);
+        }
+
+        template <typename T>
+        void add(const T &value)
+        {
+            addHash(hashValue(value));
+        }
+
+        // Add x[0..n) with batched hashing; missing values (x != x, i.e. NaN) are skipped
+        template <typename T>
+        void add(const T *x, size_t n)
+        {
+            uint64_t hashes[detail::hashBatch];
+            for (size_t first = 0; first < n; first += detail::hashBatch)
+            {
+                const size_t m = std::min(detail::hashBatch, n - first);
+                hashValues(x + first, m, hashes);
+                for (size_t i = 0; i < m; ++i)
+                    if (x[first + i] == x[first + i])
+                        addHash(hashes[i]);
+            }
+        }
+
+        void merge(const HyperLogLog &other)
+        {
+            if (other.precision_ != precision_)
+                throw std::invalid_argument("HyperLogLog sketches must have the same precision");
+            for (size_t i = 0; i < registers_.size(); ++i)
+                registers_[i] = std::max(registers_[i], other.registers_[i]);
+        }
+
+        double estimate() const
+        {
+            const double m = static_cast<double>(registers_.size());
+            double sum = 0.0;
+            size_t zeros = 0;
+            for (uint8_t r : registers_)
+            {
+                sum += std::ldexp(1.0, -static_cast<int>(r));
+                zeros += r == 0;
+            }
+            const double alpha = registers_.size() == 16 ? 0.673
+                                 : registers_.size() == 32 ? 0.697
+                                 : registers_.size() == 64 ? 0.709
+                                                           : 0.7213 / (1.0 + 1.079 / m);
+            const double raw = alpha * m * m / sum;
+            if (raw <= 2.5 * m && zeros > 0)
+                return m * std::log(m / static_cast<double>(zeros)); // linear counting
+            return raw;
+        }
+
+        int precision() const { return precision_; }
+        const std::vector<uint8_t> &registers() const { return registers_; }
+
+        void clear() { std::fill(registers_.begin(), registers_.end(), 0); }
+
+    private:
+        int precision_;
+        std::vector<uint8_t> registers_;
+    };
+
+    // A frequent value with its estimated count; the true count is in [count - error, count]
+    template <typename T>
+    struct HeavyHitter
+    {
+        T value;
+        uint64_t count;
+        uint64_t error;
+    };
+
+    /**
+     * SpaceSaving heavy-hitters sketch.
+     * Layman: Tracks the most frequent values of a stream in fixed memory, with counts that
+     * are never too low and too high by at most total / capacity.
+     * Technical: Keeps capacity counters. A tracked value increments its counter; an
+     * untracked one replaces the value of a smallest counter c and gets c + 1, with error c.
+     * Counters are flat arrays found through an open-addressing hash index sized once, so
+     * updates never allocate. Counts only grow, so the counters holding the minimum are
+     * collected by one scan and used up before the next scan: amortized O(1) per update, with
+     * no heap to keep ordered. Every value with true frequency above total / capacity is
+     * guaranteed to be tracked. Sketches merge by adding matching counters (a value missing
+     * from a full sketch gets that sketch's minimum as count and error) and keeping the
+     * largest capacity counters, which preserves the guarantee.
+     */
+    template <typename T>
+    class SpaceSaving
+    {
+    public:
+        explicit SpaceSaving(size_t capacity = 64) : capacity_(capacity)
+        {
+            if (capacity == 0 || capacity >= (size_t(1) << 28))
+                throw std::invalid_argument("SpaceSaving capacity must be positive and below 2^28");
+            // A sparse index keeps probe runs short; misses (the common case on
+            // high-cardinality data) then cost about one probe
+            size_t slots = 8;
+            while (slots < 8 * capacity)
+                slots *= 2;
+            index_.assign(slots, empty);
+            values_.reserve(capacity);
+            counts_.reserve(capacity);
+            errors_.reserve(capacity);
+            hashes_.reserve(capacity);
+        }
+
+        void add(const T &value, uint64_t count = 1) { addHashed(value, hashValue(value), count); }
+
+        // Add x[0..n) with batched hashing; runs of equal values cost one update and missing
+        // values (x != x, i.e. NaN) are skipped
+        void add(const T *x, size_t n)
+        {
+            uint64_t hashes[detail::hashBatch];
+            for (size_t first = 0; first < n; first += detail::hashBatch)
+            {
+                const size_t m = std::min(detail::hashBatch, n - first);
+                hashValues(x + first, m, hashes);
+                for (size_t i = 0; i < m;)
+                {
+                    size_t j = i + 1;
+                    while (j < m && x[first + j] == x[first + i])
+                        ++j;
+                    if (x[first + i] == x[first + i])
+                        addHashed(x[first + i], hashes[i], j - i);
+                    i = j;
+                }
+            }
+        }
+
+        // Add a value whose hashValue is already known
+        void addHashed(const T &value, uint64_t hash, uint64_t count = 1)
+        {
+            if (count == 0)
+                return;
+            total_ += count;
+            const size_t slot = find(value, hash);
+            if (index_[slot] != empty)
+            {
+                counts_[index_[slot]] += count;
+                return;
+            }
+            if (values_.size() < capacity_)
+            {
+                index_[slot] = static_cast<uint32_t>(values_.size());
+                values_.push_back(value);
+                counts_.push_back(count);
+                errors_.push_back(0);
+                hashes_.push_back(hash);
+                return;
+            }
+            const size_t evicted = popMinimum();
+            erase(evicted);
+            values_[evicted] = value;
+            hashes_[evicted] = hash;
+            errors_[evicted] = counts_[evicted];
+            counts_[evicted] += count;
+            index_[find(value, hash)] = static_cast<uint32_t>(evicted);
+        }
+
+        void merge(const SpaceSaving &other)
+        {
+            const uint64_t ownMin = values_.size() < capacity_ ? 0 : minCount();
+            const uint64_t otherMin = other.values_.size() < other.capacity_ ? 0 : other.minCount();
+            std::vector<HeavyHitter<T>> all;
+            for (size_t i = 0; i < values_.size(); ++i)
+                all.push_back(HeavyHitter<T>{values_[i], counts_[i] + otherMin, errors_[i] + otherMin});
+            for (size_t i = 0; i < other.values_.size(); ++i)
+            {
+                const size_t slot = find(other.values_[i], other.hashes_[i]);
+                if (index_[slot] == empty)
+                    all.push_back(HeavyHitter<T>{other.values_[i], other.counts_[i] + ownMin, other.errors_[i] + ownMin});
+                else
+                {
+                    all[index_[slot]].count += other.counts_[i] - otherMin;
+                    all[index_[slot]].error += other.errors_[i] - otherMin;
+                }
+            }
+            const uint64_t total = total_ + other.total_;
+            std::sort(all.begin(), all.end(), [](const HeavyHitter<T> &a, const HeavyHitter<T> &b)
+                      { return a.count > b.count; });
+            if (all.size() > capacity_)
+                all.resize(capacity_);
+            clear();
+            for (const auto &c : all)
+            {
+                const uint64_t hash = hashValue(c.value);
+                index_[find(c.value, hash)] = static_cast<uint32_t>(values_.size());
+                values_.push_back(c.value);
+                counts_.push_back(c.count);
+                errors_.push_back(c.error);
+                hashes_.push_back(hash);
+            }
+            total_ = total;
+        }
+
+        // The k values with the largest counts, most frequent first
+        std::vector<HeavyHitter<T>> top(size_t k) const
+        {
+            std::vector<HeavyHitter<T>> result;
+            for (size_t i = 0; i < values_.size(); ++i)
+                result.push_back(HeavyHitter<T>{values_[i], counts_[i], errors_[i]});
+            std::sort(result.begin(), result.end(), [](const HeavyHitter<T> &a, const HeavyHitter<T> &b)
+                      { return a.count > b.count; });
+            if (result.size() > k)
+                result.resize(k);
+            return result;
+        }
+
+        uint64_t total() const { return total_; }
+        size_t capacity() const { return capacity_; }
+
+        void clear()
+        {
+            values_.clear();
+            counts_.clear();
+            errors_.clear();
+            hashes_.clear();
+            minimum_.clear();
+            std::fill(index_.begin(), index_.end(), empty);
+            total_ = 0;
+        }
+
+    private:
+        static const uint32_t empty = ~uint32_t(0);
+
+        uint64_t minCount() const { return counts_.empty() ? 0 : *std::min_element(counts_.begin(), counts_.end()); }
+
+        // A counter holding the minimum count. Counters leave the list when they grow, and
+        // when it runs dry one scan collects every counter at the new minimum.
+        size_t popMinimum()
+        {
+            while (!minimum_.empty())
+            {
+                const size_t i = minimum_.back();
+                minimum_.pop_back();
+                if (counts_[i] == minCount_)
+                    return i;
+            }
+            minCount_ = minCount();
+            for (size_t i = counts_.size(); i-- > 0;)
+                if (counts_[i] == minCount_)
+                    minimum_.push_back(i);
+            const size_t i = minimum_.back();
+            minimum_.pop_back();
+            return i;
+        }
+
+        // Index slot holding value, or the empty slot where it would go (linear probing)
+        size_t find(const T &value, uint64_t hash) const
+        {
+            const size_t mask = index_.size() - 1;
+            size_t slot = static_cast<size_t>(hash) & mask;
+            while (index_[slot] != empty && !(hashes_[index_[slot]] == hash && values_[index_[slot]] == value))
+                slot = (slot + 1) & mask;
+            return slot;
+        }
+
+        // Remove counter i from the index, shifting later entries of its probe run back
+        void erase(size_t i)
+        {
+            const size_t mask = index_.size() - 1;
+            size_t hole = find(values_[i], hashes_[i]);
+            index_[hole] = empty;
+            for (size_t slot = (hole + 1) & mask; index_[slot] != empty; slot = (slot + 1) & mask)
+            {
+                const size_t home = static_cast<size_t>(hashes_[index_[slot]]) & mask;
+                if (((slot - home) & mask) >= ((slot - hole) & mask))
+                {
+                    index_[hole] = index_[slot];
+                    index_[slot] = empty;
+                    hole = slot;
+                }
+            }
+        }
+
+        size_t capacity_;
+        std::vector<T> values_;
+        std::vector<uint64_t> counts_;
+        std::vector<uint64_t> errors_;
+        std::vector<uint64_t> hashes_;
+        std::vector<uint32_t> index_; // open-addressing table of counter slots
+        std::vector<size_t> minimum_; // counters that held minCount_ when last scanned
+        uint64_t minCount_ = 0;
+        uint64_t total_ = 0;
+    };
+
+    template <typename T>
+    const uint32_t SpaceSaving<T>::empty;
+
+    /**
+     * Count-Min frequency sketch.
+     * Layman: Answers "how often did this value occur?" for any value, in fixed memory,
+     * never underestimating and overestimating by a small share of the total.
+     * Technical: depth rows of width counters (width rounded up to a power of two). A value
+     * increments one counter per row, at h1 + i h2 for row i, where h1 and h2 are the two
+     * halves of its 64-bit hash; its estimate is the smallest of those counters. With
+     * probability at least 1 - e^-depth the overestimate is at most e / width of the total.
+     * Sketches with equal dimensions merge by adding counters, exactly.
+     */
+    class CountMinSketch
+    {
+    public:
+        explicit CountMinSketch(size_t width = 2048, size_t depth = 4) : depth_(depth)
+        {
+            if (width == 0 || width > (size_t(1) << 32) || depth == 0 || depth > 32)
+                throw std::invalid_argument("Count-Min width must be in [1, 2^32] and depth in [1, 32]");
+            width_ = 1;
+            while (width_ < width)
+                width_ *= 2;
+            counts_.assign(width_ * depth_, 0);
+        }
+
+        void addHash(uint64_t hash, uint64_t count = 1)
+        {
+            const uint64_t h1 = hash & 0xFFFFFFFFULL, h2 = (hash >> 32) | 1;
+            for (size_t i = 0; i < depth_; ++i)
+                counts_[i * width_ + ((h1 + i * h2) & (width_ - 1))] += count;
+            total_ += count;
+        }
+
+        template <typename T>
+        void add(const T &value, uint64_t count = 1)
+        {
+            addHash(hashValue(value), count);
+        }
+
+        // Add x[0..n) with batched hashing; missing values (x != x, i.e. NaN) are skipped
+        template <typename T>
+        void add(const T *x, size_t n)
+        {
+            uint64_t hashes[detail::hashBatch];
+            for (size_t first = 0; first < n; first += detail::hashBatch)
+            {
+                const size_t m = std::min(detail::hashBatch, n - first);
+                hashValues(x + first, m, hashes);
+                for (size_t i = 0; i < m; ++i)
+                    if (x[first + i] == x[first + i])
+                        addHash(hashes[i]);
+            }
+        }
+
+        uint64_t estimateHash(uint64_t hash) const
+        {
+            const uint64_t h1 = hash & 0xFFFFFFFFULL, h2 = (hash >> 32) | 1;
+            uint64_t estimate = std::numeric_limits<uint64_t>::max();
+            for (size_t i = 0; i < depth_; ++i)
+                estimate = std::min(estimate, counts_[i * width_ + ((h1 + i * h2) & (width_ - 1))]);
+            return estimate;
+        }
+
+        // Upper bound on how often value was added (exact unless it collides in every row)
+        template <typename T>
+        uint64_t estimate(const T &value) const
+        {
+            return estimateHash(hashValue(value));
+        }
+
+        void merge(const CountMinSketch &other)
+        {
+            if (other.width_ != width_ || other.depth_ != depth_)
+                throw std::invalid_argument("Count-Min sketches must have the same dimensions");
+            for (size_t i = 0; i < counts_.size(); ++i)
+                counts_[i] += other.counts_[i];
+            total_ += other.total_;
+        }
+
+        uint64_t total() const { return total_; }
+        size_t width() const { return width_; }
+        size_t depth() const { return depth_; }
+
+        void clear()
+        {
+            std::fill(counts_.begin(), counts_.end(), 0);
+            total_ = 0;
+        }
+
+    private:
+        size_t width_;
+        size_t depth_;
+        std::vector<uint64_t> counts_;
+        uint64_t total_ = 0;
+    };
+
+    /**
+     * Approximate number of distinct values.
+     * Layman: How many different categories a column has, for columns too large to count
+     * exactly, in 2^precision bytes of memory.
+     * Technical: HyperLogLog over per-block sketches built in parallel and merged (the
+     * merge is exact, so the result does not depend on the thread count); relative
+     * standard error about 1.04 / sqrt(2^precision). Missing values (NaN) are skipped.
+     */
+    template <typename T>
+    double distinctCount(const T *x, size_t n, int precision = 12, size_t numThreads = 0)
+    {
+        return detail::parallelSketch(x, n, numThreads, HyperLogLog(precision)).estimate();
+    }
+
+    template <typename T>
+    double distinctCount(const std::vector<T> &x, int precision = 12, size_t numThreads = 0)
+    {
+        return distinctCount(x.data(), x.size(), precision, numThreads);
+    }
+
+    /**
+     * Approximate most frequent values.
+     * Layman: The k most common categories of a column with their counts, without holding
+     * a count for every category (the exact way DescriptiveStatistics::mode does).
+     * Technical: SpaceSaving with capacity counters (default max(64, 8k)) per row block,
+     * built in parallel and merged. Each count is an upper bound and count - error a lower
+     * bound; every value occurring more than n / capacity times is reported if it ranks in
+     * the top k. Missing values (NaN) are skipped.
+     */
+    template <typename T>
+    std::vector<HeavyHitter<T>> heavyHitters(const T *x, size_t n, size_t k, size_t capacity = 0, size_t numThreads = 0)
+    {
+        if (capacity == 0)
+            capacity = std::max<size_t>(64, 8 * k);
+        return detail::parallelSketch(x, n, numThreads, SpaceSaving<T>(capacity)).top(k);
+    }
+
+    template <typename T>
+    std::vector<HeavyHitter<T>> heavyHitters(const std::vector<T> &x, size_t k, size_t capacity = 0, size_t numThreads = 0)
+    {
+        return heavyHitters(x.data(), x.size(), k, capacity, numThreads);
+    }
+
+    // Count-Min sketch of x[0..n), built in parallel from per-block sketches (see CountMinSketch)
+    template <typename T>
+    CountMinSketch countMinSketch(const T *x, size_t n, size_t width = 2048, size_t depth = 4, size_t numThreads = 0)
+    {
+        return detail::parallelSketch(x, n, numThreads, CountMinSketch(width, depth));
+    }
+
+    template <typename T>
+    CountMinSketch countMinSketch(const std::vector<T> &x, size_t width = 2048, size_t depth = 4, size_t numThreads = 0)
+    {
+        return countMinSketch(x.data(), x.size(), width, depth, numThreads);
+    }
+}
+
+#endif // EDA_SKETCHES_H
@@ -0,0 +1,558 @@
+#ifndef EDA_VISUAL_AGGREGATION_H
+#define EDA_VISUAL_AGGREGATION_H
+
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <type_traits>
+#include "Histogram.h"
+
+namespace EDA
+{
+    /**
+     * Buffered text output.
+     * Layman: Collects output in memory and writes it in large pieces, instead of pushing
+     * every line to the terminal or file separately.
+     * Technical: Text accumulates in a string buffer that is written to the stream when it
+     * passes capacity bytes and on flush() or destruction; the stream itself is flushed
+     * only then. Numbers are formatted like a default std::ostream (%g with 6 significant
+     * digits for floating point), through snprintf instead of the locale-aware stream
+     * machinery.
+     */
+    class BufferedWriter
+    {
+    public:
+        explicit BufferedWriter(std::ostream &out, size_t capacity = 1 << 16) : out_(out), capacity_(capacity)
+        {
+            buffer_.reserve(capacity + 64);
+        }
+
+        ~BufferedWriter() { flush(); }
+
+        BufferedWriter &operator<<(const std::string &s) { return write(s.data(), s.size()); }
+        BufferedWriter &operator<<(const char *s) { return write(s, std::char_traits<char>::length(s)); }
+        BufferedWriter &operator<<(char c) { return write(&c, 1); }
+
+        template <typename T>
+        typename std::enable_if<std::is_floating_point<T>::value, BufferedWriter &>::type operator<<(T x)
+        {
+            char text[32];
+            const int length = std::snprintf(text, sizeof text, "%g", static_cast<double>(x));
+            return write(text, static_cast<size_t>(length));
+        }
+
+        template <typename T>
+        typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, char>::value, BufferedWriter &>::type
+        operator<<(T x)
+        {
+            char text[32];
+            const int length = std::is_signed<T>::value
+                                   ? std::snprintf(text, sizeof text, "%lld", static_cast<long long>(x))
+                                   : std::snprintf(text, sizeof text, "%llu", static_cast<unsigned long long>(x));
+            return write(text, static_cast<size_t>(length));
+        }
+
+        BufferedWriter &write(const char *data, size_t size)
+        {
+            buffer_.append(data, size);
+            if (buffer_.size() >= capacity_)
+                drain();
+            return *this;
+        }
+
+        void flush()
+        {
+            drain();
+            out_.flush();
+        }
+
+    private:
+        void drain()
+        {
+            out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+            buffer_.clear();
+        }
+
+        std::ostream &out_;
+        size_t capacity_;
+        std::string buffer_;
+    };
+
+    /**
+     * Reservoir sampler.
+     * Layman: Keeps a fair random sample of fixed size from a stream of any length, for
+     * example 10,000 points to draw out of 50 million.
+     * Technical: Algorithm L (Li 1994): after the reservoir is full, the gap to the next
+     * replaced item is drawn from its geometric-like distribution, so a stream of n items
+     * costs O(k (1 + log(n / k))) random draws and only the chosen items are touched; every
+     * k-subset of the items seen is equally likely. addRows(n, valueAt) offers the next n
+     * rows of a stream and calls valueAt(i) only for the rows i it keeps, so the sample can
+     * hold whole records (e.g. (x, y) pairs) of data that arrives in chunks.
+     */
+    template <typename T>
+    class ReservoirSampler
+    {
+    public:
+        explicit ReservoirSampler(size_t capacity, uint64_t seed = 0x5EED5EED5EED5EEDULL) : capacity_(capacity), rng_(seed)
+        {
+            if (capacity == 0)
+                throw std::invalid_argument("Reservoir capacity must be positive");
+            sample_.reserve(capacity);
+        }
+
+        template <typename Func>
+        void addRows(size_t n, Func valueAt)
+        {
+            size_t i = 0;
+            for (; i < n && sample_.size() < capacity_; ++i, ++seen_)
+            {
+                sample_.push_back(valueAt(i));
+                if (sample_.size() == capacity_)
+                {
+                    weight_ = std::exp(std::log(uniform()) / static_cast<double>(capacity_));
+                    next_ = seen_ + 1 + skip();
+                }
+            }
+            // next_ is the stream position of the next row to keep
+            while (i < n)
+            {
+                if (next_ - seen_ >= n - i)
+                {
+                    seen_ += n - i;
+                    return;
+                }
+                i += static_cast<size_t>(next_ - seen_);
+                seen_ = next_;
+                sample_[static_cast<size_t>(rng_() % capacity_)] = valueAt(i);
+                weight_ *= std::exp(std::log(uniform()) / static_cast<double>(capacity_));
+                next_ = seen_ + 1 + skip();
+                ++i;
+                ++seen_;
+            }
+        }
+
+        void add(const T &value)
+        {
+            addRows(1, [&](size_t) { return value; });
+        }
+
+        void add(const T *x, size_t n)
+        {
+            addRows(n, [&](size_t i) { return x[i]; });
+        }
+
+        const std::vector<T> &sample() const { return sample_; }
+        uint64_t seen() const { return seen_; }
+
+    private:
+        double uniform() { return ProbabilityDistributions::detail::unitIntervalOpen(rng_()); }
+
+        // Rows passed over before the next kept one
+        uint64_t skip()
+        {
+            const double gap = std::floor(std::log(uniform()) / std::log1p(-weight_));
+            return gap < 9.0e18 ? static_cast<uint64_t>(gap) : static_cast<uint64_t>(9.0e18);
+        }
+
+        size_t capacity_;
+        ProbabilityDistributions::Xoshiro256 rng_;
+        std::vector<T> sample_;
+        uint64_t seen_ = 0;
+        uint64_t next_ = 0;
+        double weight_ = 0.0;
+    };
+
+    // k row indices of [0, n) drawn uniformly without replacement, in increasing order (all rows if k >= n)
+    inline std::vector<size_t> sampleIndices(size_t n, size_t k, uint64_t seed = 0x5EED5EED5EED5EEDULL)
+    {
+        std::vector<size_t> indices;
+        if (k >= n)
+        {
+            for (size_t i = 0; i < n; ++i)
+                indices.push_back(i);
+            return indices;
+        }
+        if (k == 0)
+            return indices;
+        ReservoirSampler<size_t> sampler(k, seed);
+        sampler.addRows(n, [](size_t i) { return i; });
+        indices = sampler.sample();
+        std::sort(indices.begin(), indices.end());
+        return indices;
+    }
+
+    /**
+     * Largest-Triangle-Three-Buckets downsampling of a line series.
+     * Layman: Picks a few hundred or thousand points of a long series that still draw the
+     * same line, keeping peaks and dips that plain every-k-th-point thinning would lose.
+     * Technical: The first and last points with finite coordinates are kept; the points
+     * between them are split into threshold - 2 equal buckets, and from each bucket the point
+     * forming the largest triangle with the previously kept point and the average of the
+     * next bucket is kept (Steinarsson 2013). One O(n) pass; x should be increasing. Points
+     * with a NaN or infinite coordinate are never kept (unless threshold >= n).
+     * @return Indices of the kept points, increasing; all indices if threshold >= n
+     */
+    template <typename T>
+    std::vector<size_t> lttb(const T *x, const T *y, size_t n, size_t threshold)
+    {
+        std::vector<size_t> kept;
+        if (threshold >= n)
+        {
+            for (size_t i = 0; i < n; ++i)
+                kept.push_back(i);
+            return kept;
+        }
+        if (threshold < 3)
+            throw std::invalid_argument("LTTB threshold must be at least 3");
+
+        auto finite = [&](size_t i)
+        { return std::isfinite(static_cast<double>(x[i])) && std::isfinite(static_cast<double>(y[i])); };
+        size_t head = 0, tail = n - 1; // the anchors: first and last finite points
+        while (head < n && !finite(head))
+            ++head;
+        if (head == n)
+            return kept;
+        while (!finite(tail))
+            --tail;
+        if (threshold >= tail - head + 1)
+        {
+            for (size_t i = head; i <= tail; ++i)
+                if (finite(i))
+                    kept.push_back(i);
+            return kept;
+        }
+
+        const double every = static_cast<double>(tail - head - 1) / static_cast<double>(threshold - 2);
+        auto bucketStart = [&](size_t b) { return head + 1 + static_cast<size_t>(std::floor(b * every)); };
+        kept.push_back(head);
+        size_t previous = head;
+        for (size_t b = 0; b + 2 < threshold; ++b)
+        {
+            const size_t first = bucketStart(b), last = std::min(bucketStart(b + 1), tail);
+
+            // Average of the next bucket (the last anchor for the final bucket)
+            const size_t nextFirst = last, nextLast = b + 3 < threshold ? std::min(bucketStart(b + 2), tail) : tail + 1;
+            double avgX = 0.0, avgY = 0.0, count = 0.0;
+            for (size_t i = nextFirst; i < nextLast; ++i)
+            {
+                if (finite(i))
+                {
+                    avgX += static_cast<double>(x[i]);
+                    avgY += static_cast<double>(y[i]);
+                    count += 1.0;
+                }
+            }
+            if (count > 0)
+            {
+                avgX /= count;
+                avgY /= count;
+            }
+
+            const double px = static_cast<double>(x[previous]), py = static_cast<double>(y[previous]);
+            double best = -1.0;
+            size_t chosen = n;
+            for (size_t i = first; i < last; ++i)
+            {
+                // Twice the triangle area; non-finite for a non-finite point, which is skipped
+                const double area = std::abs((px - avgX) * (static_cast<double>(y[i]) - py) -
+                                             (px - static_cast<double>(x[i])) * (avgY - py));
+                if (area > best && area <= std::numeric_limits<double>::max())
+                {
+                    best = area;
+                    chosen = i;
+                }
+            }
+            if (chosen != n)
+            {
+                kept.push_back(chosen);
+                previous = chosen;
+            }
+        }
+        kept.push_back(tail);
+        return kept;
+    }
+
+    template <typename T>
+    std::vector<size_t> lttb(const std::vector<T> &x, const std::vector<T> &y, size_t threshold)
+    {
+        if (x.size() != y.size())
+            throw std::invalid_argument("Vectors must be of same length");
+        return lttb(x.data(), y.data(), x.size(), threshold);
+    }
+
+    namespace detail
+    {
+        // Range of the points with both coordinates finite, widened when degenerate
+        struct PlotRange
+        {
+            double xMin, xMax, yMin, yMax;
+        };
+
+        template <typename T>
+        PlotRange plotRange(const T *x, const T *y, size_t n, size_t numThreads)
+        {
+            const double inf = std::numeric_limits<double>::infinity();
+            const size_t blocks = rowBlocks(n, numThreads);
+            std::vector<PlotRange> partial(blocks, PlotRange{inf, -inf, inf, -inf});
+            auto scanBlock = [&](size_t b)
+            {
+                PlotRange r = partial[b];
+                for (size_t i = n * b / blocks; i < n * (b + 1) / blocks; ++i)
+                {
+                    const double xi = static_cast<double>(x[i]), yi = static_cast<double>(y[i]);
+                    const bool finite = std::abs(xi) <= std::numeric_limits<double>::max() &&
+                                        std::abs(yi) <= std::numeric_limits<double>::max();
+                    r.xMin = std::min(r.xMin, finite ? xi : inf);
+                    r.xMax = std::max(r.xMax, finite ? xi : -inf);
+                    r.yMin = std::min(r.yMin, finite ? yi : inf);
+                    r.yMax = std::max(r.yMax, finite ? yi : -inf);
+                }
+                partial[b] = r;
+            };
+            parallelFor(blocks, numThreads, scanBlock);
+            PlotRange range = partial[0];
+            for (const PlotRange &r : partial)
+            {
+                range.xMin = std::min(range.xMin, r.xMin);
+                range.xMax = std::max(range.xMax, r.xMax);
+                range.yMin = std::min(range.yMin, r.yMin);
+                range.yMax = std::max(range.yMax, r.yMax);
+            }
+            if (range.xMin > range.xMax)
+                throw std::invalid_argument("No points with finite coordinates");
+            if (range.xMin == range.xMax)
+            {
+                range.xMin -= 0.5;
+                range.xMax += 0.5;
+            }
+            if (range.yMin == range.yMax)
+            {
+                range.yMin -= 0.5;
+                range.yMax += 0.5;
+            }
+            return range;
+        }
+
+        /**
+         * Count points into cells, in parallel row blocks with private counts merged at the
+         * end. cellOf(x, y, slots) maps a point to a cell, or to slots - 2 (outside) or
+         * slots - 1 (missing); it is called on tiles in a loop without data-dependent
+         * branches so the compiler can vectorize the mapping, and only the increments are
+         * scalar.
+         */
+        template <typename T, typename CellOf>
+        std::vector<uint64_t> countCells(const T *x, const T *y, size_t n, size_t slots, size_t numThreads, CellOf cellOf)
+        {
+            const size_t blocks = rowBlocks(n, numThreads);
+            std::vector<std::vector<uint64_t>> partial(blocks, std::vector<uint64_t>(slots, 0));
+            auto countBlock = [&](size_t b)
+            {
+                const size_t tileRows = 1024;
+                size_t cells[tileRows];
+                uint64_t *counts = partial[b].data();
+                const size_t last = n * (b + 1) / blocks;
+                for (size_t start = n * b / blocks; start < last; start += tileRows)
+                {
+                    const size_t m = std::min(tileRows, last - start);
+                    for (size_t i = 0; i < m; ++i)
+                        cells[i] = cellOf(static_cast<double>(x[start + i]), static_cast<double>(y[start + i]), slots);
+                    for (size_t i = 0; i < m; ++i)
+                        ++counts[cells[i]];
+                }
+            };
+            parallelFor(blocks, numThreads, countBlock);
+            for (size_t b = 1; b < blocks; ++b)
+                for (size_t s = 0; s < slots; ++s)
+                    partial[0][s] += partial[b][s];
+            return partial[0];
+        }
+    }
+
+    /**
+     * Point counts on a regular 2D grid.
+     * Layman: A heatmap of where the points are, which draws 50 million points as a few
+     * thousand cells.
+     * Technical: xBins x yBins cells of equal size over [xMin, xMax] x [yMin, yMax]; cell
+     * (ix, iy) is counts[iy * xBins + ix], with row 0 at yMin. The upper edges belong to
+     * the last cells; cells are found with one multiply per coordinate, so points within
+     * rounding of an inner edge may land in either neighbouring cell. Points outside the
+     * range count as outside, points with a NaN coordinate as missing. Grids with the same
+     * layout merge by adding counts.
+     */
+    struct DensityGrid
+    {
+        size_t xBins, yBins;
+        double xMin, xMax, yMin, yMax;
+        std::vector<uint64_t> counts;
+        uint64_t outside = 0;
+        uint64_t missing = 0;
+
+        DensityGrid(size_t xBins, size_t yBins, double xMin, double xMax, double yMin, double yMax)
+            : xBins(xBins), yBins(yBins), xMin(xMin), xMax(xMax), yMin(yMin), yMax(yMax), counts(xBins * yBins, 0)
+        {
+            if (xBins == 0 || yBins == 0)
+                throw std::invalid_argument("Number of bins must be positive");
+            if (!(xMin < xMax && yMin < yMax))
+                throw std::invalid_argument("Grid range must be non-empty");
+        }
+
+        uint64_t count(size_t ix, size_t iy) const { return counts[iy * xBins + ix]; }
+
+        // Add the points (x[i], y[i]) for i in [0, n), counting on numThreads workers (0 = hardware concurrency)
+        template <typename T>
+        void add(const T *x, const T *y, size_t n, size_t numThreads = 1)
+        {
+            const size_t cells = xBins * yBins;
+            const double xScale = xBins / (xMax - xMin), yScale = yBins / (yMax - yMin);
+            const double x0 = xMin, y0 = yMin, xs = static_cast<double>(xBins), ys = static_cast<double>(yBins);
+            const size_t nx = xBins, ny = yBins;
+            auto cellOf = [=](double xi, double yi, size_t slots) -> size_t
+            {
+                const double fx = (xi - x0) * xScale, fy = (yi - y0) * yScale;
+                const bool inside = fx >= 0.0 && fx <= xs && fy >= 0.0 && fy <= ys;
+                const size_t ix = std::min(static_cast<size_t>(inside ? fx : 0.0), nx - 1);
+                const size_t iy = std::min(static_cast<size_t>(inside ? fy : 0.0), ny - 1);
+                return inside ? iy * nx + ix : (xi == xi && yi == yi ? slots - 2 : slots - 1);
+            };
+            const std::vector<uint64_t> slots = detail::countCells(x, y, n, cells + 2, numThreads, cellOf);
+            for (size_t c = 0; c < cells; ++c)
+                counts[c] += slots[c];
+            outside += slots[cells];
+            missing += slots[cells + 1];
+        }
+
+        void merge(const DensityGrid &other)
+        {
+            if (other.xBins != xBins || other.yBins != yBins || other.xMin != xMin || other.xMax != xMax ||
+                other.yMin != yMin || other.yMax != yMax)
+                throw std::invalid_argument("Density grids must have the same layout");
+            for (size_t c = 0; c < counts.size(); ++c)
+                counts[c] += other.counts[c];
+            outside += other.outside;
+            missing += other.missing;
+        }
+    };
+
+    /**
+     * Density grid over the range of the data.
+     * Layman: Heatmap counts of a scatter of points, sized to fit all of them.
+     * Technical: One parallel pass for the range of the points with finite coordinates,
+     * one for the counts (see DensityGrid).
+     * @param numThreads Worker count (0 = hardware concurrency)
+     */
+    template <typename T>
+    DensityGrid densityGrid(const T *x, const T *y, size_t n, size_t xBins = 64, size_t yBins = 64, size_t numThreads = 0)
+    {
+        const detail::PlotRange r = detail::plotRange(x, y, n, numThreads);
+        DensityGrid grid(xBins, yBins, r.xMin, r.xMax, r.yMin, r.yMax);
+        grid.add(x, y, n, numThreads);
+        return grid;
+    }
+
+    template <typename T>
+    DensityGrid densityGrid(const std::vector<T> &x, const std::vector<T> &y, size_t xBins = 64, size_t yBins = 64,
+                            size_t numThreads = 0)
+    {
+        if (x.size() != y.size())
+            throw std::invalid_argument("Vectors must be of same length");
+        return densityGrid(x.data(), y.data(), x.size(), xBins, yBins, numThreads);
+    }
+
+    // Print a density grid as text, top row at yMax, one shade character per cell (darker = more points)
+    inline void printDensityGrid(const DensityGrid &grid, std::ostream &out = std::cout)
+    {
+        static const char shades[] = " .:-=+*#%@";
+        const uint64_t peak = *std::max_element(grid.counts.begin(), grid.counts.end());
+        BufferedWriter writer(out);
+        writer << "Density (x " << grid.xMin << " .. " << grid.xMax << ", y " << grid.yMin << " .. " << grid.yMax
+               << ", max " << peak << " per cell):\n";
+        for (size_t row = grid.yBins; row-- > 0;)
+        {
+            for (size_t ix = 0; ix < grid.xBins; ++ix)
+            {
+                const uint64_t c = grid.count(ix, row);
+                // Square-root scale so sparse cells stay visible; any point is at least '.'
+                const size_t level = c == 0 ? 0 : 1 + static_cast<size_t>(8.0 * std::sqrt(static_cast<double>(c) / peak) + 0.5);
+                writer << shades[level];
+            }
+            writer << '\n';
+        }
+    }
+
+    // Non-empty hexagonal cells: centres and point counts
+    struct HexBins
+    {
+        std::vector<double> x;
+        std::vector<double> y;
+        std::vector<uint64_t> counts;
+        uint64_t missing = 0;
+    };
+
+    /**
+     * Hexagonal binning.
+     * Layman: Like a density grid, but with hexagons, which follow the shape of a point
+     * cloud more evenly; feed the centres and counts to a plotting backend.
+     * Technical: The layout of matplotlib's hexbin: gridSize hexagons across x and
+     * gridSize / sqrt(3) vertically over the range of the data, as two offset rectangular
+     * lattices; each point goes to the nearer of its nearest centres in the two lattices.
+     * Counting runs in parallel row blocks with private counts. Points with a NaN or
+     * infinite coordinate count as missing.
+     * @param numThreads Worker count (0 = hardware concurrency)
+     */
+    template <typename T>
+    HexBins hexbin(const T *x, const T *y, size_t n, size_t gridSize = 50, size_t numThreads = 0)
+    {
+        if (gridSize == 0)
+            throw std::invalid_argument("Grid size must be positive");
+        const detail::PlotRange r = detail::plotRange(x, y, n, numThreads);
+        const size_t nx = gridSize, ny = std::max<size_t>(1, static_cast<size_t>(std::lround(gridSize / std::sqrt(3.0))));
+        const double sx = (r.xMax - r.xMin) / nx, sy = (r.yMax - r.yMin) / ny;
+        const size_t nx1 = nx + 1, ny1 = ny + 1, cells1 = nx1 * ny1, cells = cells1 + nx * ny;
+        const double x0 = r.xMin, y0 = r.yMin;
+        auto cellOf = [=](double xi, double yi, size_t slots) -> size_t
+        {
+            const bool present = std::abs(xi) <= std::numeric_limits<double>::max() &&
+                                 std::abs(yi) <= std::numeric_limits<double>::max();
+            const double u = present ? (xi - x0) / sx : 0.0, v = present ? (yi - y0) / sy : 0.0;
+            const double i1 = std::floor(u + 0.5), j1 = std::floor(v + 0.5);
+            const double i2 = std::min(std::floor(u), static_cast<double>(nx - 1)), j2 = std::min(std::floor(v), static_cast<double>(ny - 1));
+            const double d1 = (u - i1) * (u - i1) + 3.0 * (v - j1) * (v - j1);
+            const double d2 = (u - i2 - 0.5) * (u - i2 - 0.5) + 3.0 * (v - j2 - 0.5) * (v - j2 - 0.5);
+            const size_t cell = d1 <= d2 ? static_cast<size_t>(j1) * nx1 + static_cast<size_t>(i1)
+                                         : cells1 + static_cast<size_t>(j2) * nx + static_cast<size_t>(i2);
+            return present ? cell : slots - 1;
+        };
+        const std::vector<uint64_t> counts = detail::countCells(x, y, n, cells + 1, numThreads, cellOf);
+        HexBins bins;
+        for (size_t c = 0; c < cells; ++c)
+        {
+            if (counts[c] == 0)
+                continue;
+            const bool first = c < cells1;
+            const size_t k = first ? c : c - cells1, width = first ? nx1 : nx;
+            const double offset = first ? 0.0 : 0.5;
+            bins.x.push_back(r.xMin + (static_cast<double>(k % width) + offset) * sx);
+            bins.y.push_back(r.yMin + (static_cast<double>(k / width) + offset) * sy);
+            bins.counts.push_back(counts[c]);
+        }
+        bins.missing = counts[cells];
+        return bins;
+    }
+
+    template <typename T>
+    HexBins hexbin(const std::vector<T> &x, const std::vector<T> &y, size_t gridSize = 50, size_t numThreads = 0)
+    {
+        if (x.size() != y.size())
+            throw std::invalid_argument("Vectors must be of same length");
+        return hexbin(x.data(), y.data(), x.size(), gridSize, numThreads);
+    }
+}
+
+#endif // EDA_VISUAL_AGGREGATION_H
@@ -1,7 +1,15 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <limits>
 #include "EDA.h"
+#include "Histogram.h"
+#include "LatencyHistogram.h"
+#include "Outliers.h"
+#include "Correlation.h"
+#include "Profile.h"
+#include "Sketches.h"
+#include "VisualAggregation.h"
 #include "../matplotlib-cpp/matplotlibcpp.h"
 #include <numeric>
 #include <algorithm>
@@ -23,12 +31,34 @@ int main()
             std::cout << "[" << binEdges[i] << ", " << binEdges[i + 1] << "): " << counts[i] << std::endl;
         }
 
+        // Histogram engine: log-scale bins for heavy-tailed data, several columns at once
+        std::vector<std::vector<double>> latencies = {
+            {1.2, 3.4, 2.2, 15.0, 180.0, 2.9, 4.1, 950.0},
+            {0.8, 0.9, 1.1, 1.4, 2.0, 35.0, 1.2, 0.7}};
+        std::vector<EDA::Histogram> logHistograms = EDA::histograms(latencies, EDA::HistogramOptions(4, EDA::BinScale::Log));
+        for (size_t c = 0; c < logHistograms.size(); ++c)
+        {
+            std::cout << "Log-scale histogram of column " << c << ":";
+            for (size_t i = 0; i < logHistograms[c].counts.size(); ++i)
+                std::cout << " [" << logHistograms[c].edges[i] << ", " << logHistograms[c].edges[i + 1] << "): " << logHistograms[c].counts[i];
+            std::cout << std::endl;
+        }
+
         // Box plot stats
         double min, q1, median, q3, max;
         EDA::boxPlotStats(data, min, q1, median, q3, max);
         std::cout << "Box Plot Stats - Min: " << min << ", Q1: " << q1 << ", Median: " << median
                   << ", Q3: " << q3 << ", Max: " << max << std::endl;
 
+        // Box plot of live latencies from a mergeable log-linear histogram
+        EDA::LatencyHistogram latencyHistogram;
+        for (const auto &column : latencies)
+            latencyHistogram.record(column);
+        EDA::boxPlotStats(latencyHistogram, min, q1, median, q3, max);
+        std::cout << "Latency box plot - Min: " << min << ", Q1: " << q1 << ", Median: " << median << ", Q3: " << q3
+                  << ", Max: " << max << ", p99: " << latencyHistogram.percentile(99.0)
+                  << ", serialized size: " << latencyHistogram.serialize().size() << " bytes" << std::endl;
+
         // Correlation
         std::vector<double> x = {1, 2, 3, 4, 5};
         std::vector<double> y = {2, 4, 5, 4, 5};
@@ -44,9 +74,35 @@ int main()
         }
         std::cout << std::endl;
 
+        // Outlier rows, and fences from data streamed in two chunks
+        std::vector<size_t> outlierRows = EDA::outlierIndices(data);
+        std::cout << "Outlier row indices: ";
+        for (size_t row : outlierRows)
+            std::cout << row << " ";
+        std::cout << std::endl;
+        EDA::StreamingBoxPlot streamed;
+        streamed.add(data.data(), 4);
+        streamed.add(data.data() + 4, data.size() - 4);
+        EDA::IQRFences fences = EDA::iqrFences(streamed);
+        std::cout << "Streaming IQR fences: [" << fences.lower << ", " << fences.upper << "]" << std::endl;
+        streamed.add(std::numeric_limits<double>::infinity()); // e.g. a sensor overflow
+        std::cout << "Streaming max with an overflow: " << streamed.max() << " (" << streamed.infinite()
+                  << " infinite), median still " << streamed.percentile(50.0) << std::endl;
+
         // Scatter plot
         EDA::scatterPlot(x, y);
 
+        // Large point clouds: aggregate before printing or plotting
+        std::vector<double> cloudX(20000), cloudY(20000);
+        for (size_t i = 0; i < cloudX.size(); ++i)
+        {
+            cloudX[i] = std::sin(0.001 * i) * (1.0 + 0.1 * std::cos(0.37 * i));
+            cloudY[i] = std::cos(0.002 * i) + 0.05 * std::sin(1.3 * i);
+        }
+        EDA::printDensityGrid(EDA::densityGrid(cloudX, cloudY, 40, 12));
+        std::vector<size_t> linePoints = EDA::lttb(cloudX, cloudY, 200);
+        std::cout << "LTTB keeps " << linePoints.size() << " of " << cloudX.size() << " points" << std::endl;
+
         // Correlation heatmap
         std::vector<std::vector<double>> dataset = {
             {1, 2, 3, 4, 5},
@@ -55,6 +111,43 @@ int main()
         std::vector<std::string> labels = {"Var1", "Var2", "Var3"};
         EDA::correlationHeatmap(dataset, labels);
 
+        // Rank correlation matrices
+        std::vector<std::vector<double>> kendall = EDA::correlationMatrix(dataset, EDA::CorrelationMethod::Kendall);
+        EDA::printCorrelationMatrix(kendall, labels);
+        std::cout << "Spearman(Var1, Var2): " << EDA::spearmanCorrelation(dataset[0], dataset[1]) << std::endl;
+
+        // Missing values: pairwise-complete correlations and bitmap-masked histogram rows
+        std::vector<std::vector<double>> gappy = {
+            {1, 2, NAN, 4, 5, 6},
+            {2, 4, 5, NAN, 5, 7},
+            {6, 5, 4, 3, NAN, 1}};
+        EDA::printCorrelationMatrix(EDA::correlationMatrix(gappy), labels);
+        DescriptiveStatistics::ValidityBitmap valid(data.size());
+        valid.set(data.size() - 1, false); // exclude the last reading
+        EDA::HistogramOptions masked(5);
+        masked.validity.push_back(valid.data());
+        EDA::Histogram maskedHistogram = EDA::histogram(data, masked);
+        std::cout << "Masked histogram: " << maskedHistogram.total() << " binned, " << maskedHistogram.missing
+                  << " missing" << std::endl;
+
+        // One-scan profile of every column, as JSON (serialize() gives the binary form); the
+        // extra column has an overflowed reading, which is counted but kept out of the statistics
+        std::vector<std::vector<double>> profiled = gappy;
+        profiled.push_back({3, std::numeric_limits<double>::infinity(), 4, 5, 3, 4});
+        std::vector<std::string> profiledLabels = labels;
+        profiledLabels.push_back("Overflowing");
+        EDA::ProfileOptions profileOptions(5, 3);
+        EDA::ProfileReport report = EDA::profile(profiled, profiledLabels, profileOptions);
+        std::cout << report.toJSON() << std::endl;
+        for (const auto &stage : report.timings)
+            std::cout << stage.stage << ": " << stage.seconds * 1e3 << " ms" << std::endl;
+
+        // Approximate distinct count and most common values of a categorical column
+        std::vector<std::string> colors = {"red", "blue", "red", "green", "red", "blue", "amber"};
+        std::cout << "Distinct colors: " << EDA::distinctCount(colors) << std::endl;
+        for (const auto &hitter : EDA::heavyHitters(colors, 2))
+            std::cout << hitter.value << ": " << hitter.count << " (error <= " << hitter.error << ")" << std::endl;
+
         // Additional: Summary statistics
         std::cout << "Summary Statistics:" << std::endl;
         std::cout << "Mean: " << std::accumulate(data.begin(), data.end(), 0.0) / data.size() << std::endl;
@@ -91,8 +184,14 @@ int main()
         plt::legend();
         plt::show();
 
-        // Plot scatter plot
-        plt::scatter(x, y);
+        // Plot scatter plot (a uniform sample of at most 10,000 points is all Python needs to see)
+        std::vector<double> sampleX, sampleY;
+        for (size_t i : EDA::sampleIndices(x.size(), 10000))
+        {
+            sampleX.push_back(x[i]);
+            sampleY.push_back(y[i]);
+        }
+        plt::scatter(sampleX, sampleY);
         plt::title("Scatter Plot");
         plt::show();
 
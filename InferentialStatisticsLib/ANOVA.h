@@ -0,0 +1,339 @@
+#ifndef INFERENTIAL_ANOVA_H
+#define INFERENTIAL_ANOVA_H
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+#include "InferentialStatistics.h"
+#include "MultipleTesting.h"
+
+namespace InferentialStatistics
+{
+    /**
+     * One row of an ANOVA table.
+     * Layman: How much of the variation one factor (or a combination of factors) explains,
+     * and whether that is more than chance.
+     * Technical: factors lists the factor indices of the term (one for a main effect, more
+     * for an interaction), sumOfSquares its Type III sum of squares, and test the F-test
+     * against the residual mean square (numerator and denominator degrees of freedom).
+     */
+    struct ANOVAEffect
+    {
+        std::vector<size_t> factors;
+        double sumOfSquares;
+        TestResult test;
+    };
+
+    /**
+     * Full ANOVA table of a factorial design.
+     * Layman: The split of the total variation into each factor, each interaction and the
+     * unexplained remainder.
+     * Technical: effects are ordered main effects first, then two-way interactions, and so
+     * on. residualSumOfSquares is the pooled within-cell sum of squares on
+     * residualDegreesOfFreedom = N - cells, and totalSumOfSquares the sum of squares about the
+     * grand mean. For unbalanced designs the Type III effect sums of squares need not add
+     * up to the total.
+     */
+    struct ANOVATable
+    {
+        std::vector<ANOVAEffect> effects;
+        double residualSumOfSquares;
+        double residualDegreesOfFreedom;
+        double totalSumOfSquares;
+    };
+
+    namespace detail
+    {
+        // In-place Cholesky factorization of a symmetric positive definite n x n matrix (lower triangle)
+        inline void choleskyDecompose(std::vector<double> &a, size_t n)
+        {
+            for (size_t j = 0; j < n; ++j)
+            {
+                double d = a[j * n + j];
+                for (size_t k = 0; k < j; ++k)
+                    d -= a[j * n + k] * a[j * n + k];
+                if (!(d > 0))
+                    throw std::runtime_error("ANOVA design matrix is singular");
+                d = std::sqrt(d);
+                a[j * n + j] = d;
+                for (size_t i = j + 1; i < n; ++i)
+                {
+                    double v = a[i * n + j];
+                    for (size_t k = 0; k < j; ++k)
+                        v -= a[i * n + k] * a[j * n + k];
+                    a[i * n + j] = v / d;
+                }
+            }
+        }
+
+        // Solve L L' x = b in place with the factor from choleskyDecompose
+        inline void choleskySolve(const std::vector<double> &l, size_t n, double *b)
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                double v = b[i];
+                for (size_t k = 0; k < i; ++k)
+                    v -= l[i * n + k] * b[k];
+                b[i] = v / l[i * n + i];
+            }
+            for (size_t i = n; i-- > 0;)
+            {
+                double v = b[i];
+                for (size_t k = i + 1; k < n; ++k)
+                    v -= l[k * n + i] * b[k];
+                b[i] = v / l[i * n + i];
+            }
+        }
+
+        /**
+         * Type III ANOVA table from the summaries of every cell of a full factorial design.
+         * Technical: The cell means are regressed, weighted by cell counts, on the full
+         * factorial model in sum-to-zero (effect) coding, which has one parameter per cell.
+         * With beta = (X'WX)^-1 X'W ybar and V = (X'WX)^-1, the Type III sum of squares of a
+         * term S is beta_S' (V_SS)^-1 beta_S. Cost O(cells^3), independent of the row count.
+         * Cell c has level (c / stride_k) % levels[k] of factor k, stride_0 = 1.
+         */
+        inline ANOVATable factorialFromCells(const std::vector<GroupSummary> &cells, const std::vector<size_t> &levels)
+        {
+            const size_t numFactors = levels.size();
+            const size_t p = cells.size();
+            GroupSummary total;
+            double ssWithin = 0.0;
+            for (const auto &cell : cells)
+            {
+                if (cell.count == 0)
+                    throw std::invalid_argument("Every combination of factor levels needs observations");
+                total.merge(cell);
+                ssWithin += cell.m2;
+            }
+            const double dfWithin = static_cast<double>(total.count) - static_cast<double>(p);
+            if (dfWithin <= 0)
+                throw std::invalid_argument("More observations than cells required");
+
+            // Terms as factor bitmasks: intercept, main effects, then higher-order interactions
+            std::vector<size_t> terms;
+            for (size_t order = 0; order <= numFactors; ++order)
+            {
+                for (size_t mask = 0; mask < (size_t(1) << numFactors); ++mask)
+                {
+                    size_t bits = 0;
+                    for (size_t k = 0; k < numFactors; ++k)
+                        bits += (mask >> k) & 1;
+                    if (bits == order)
+                        terms.push_back(mask);
+                }
+            }
+
+            // Effect-coded design: row per cell, one column block per term
+            std::vector<double> x(p * p, 0.0);
+            std::vector<size_t> termStart;
+            size_t column = 0;
+            std::vector<size_t> level(numFactors), contrast(numFactors);
+            for (size_t mask : terms)
+            {
+                termStart.push_back(column);
+                size_t width = 1;
+                for (size_t k = 0; k < numFactors; ++k)
+                {
+                    if ((mask >> k) & 1)
+                        width *= levels[k] - 1;
+                }
+                for (size_t c = 0; c < p; ++c)
+                {
+                    for (size_t k = 0, rest = c; k < numFactors; ++k)
+                    {
+                        level[k] = rest % levels[k];
+                        rest /= levels[k];
+                    }
+                    for (size_t j = 0; j < width; ++j)
+                    {
+                        double v = 1.0;
+                        for (size_t k = 0, rest = j; k < numFactors; ++k)
+                        {
+                            if (!((mask >> k) & 1))
+                                continue;
+                            contrast[k] = rest % (levels[k] - 1);
+                            rest /= levels[k] - 1;
+                            v *= level[k] == contrast[k] ? 1.0 : (level[k] == levels[k] - 1 ? -1.0 : 0.0);
+                        }
+                        x[c * p + column + j] = v;
+                    }
+                }
+                column += width;
+            }
+            termStart.push_back(column);
+
+            // Normal equations X'WX beta = X'W ybar with W = cell counts
+            std::vector<double> a(p * p, 0.0), beta(p, 0.0);
+            for (size_t c = 0; c < p; ++c)
+            {
+                const double w = static_cast<double>(cells[c].count);
+                const double *row = &x[c * p];
+                for (size_t i = 0; i < p; ++i)
+                {
+                    if (row[i] == 0.0)
+                        continue;
+                    beta[i] += w * row[i] * cells[c].mean;
+                    for (size_t j = 0; j <= i; ++j)
+                        a[i * p + j] += w * row[i] * row[j];
+                }
+            }
+            for (size_t i = 0; i < p; ++i)
+            {
+                for (size_t j = 0; j < i; ++j)
+                    a[j * p + i] = a[i * p + j];
+            }
+            choleskyDecompose(a, p);
+            choleskySolve(a, p, beta.data());
+
+            ANOVATable table;
+            table.residualSumOfSquares = ssWithin;
+            table.residualDegreesOfFreedom = dfWithin;
+            table.totalSumOfSquares = 0.0;
+            for (const auto &cell : cells)
+            {
+                const double diff = cell.mean - total.mean;
+                table.totalSumOfSquares += cell.m2 + cell.count * diff * diff;
+            }
+            const double msWithin = ssWithin / dfWithin;
+            std::vector<double> unit(p);
+            for (size_t t = 1; t < terms.size(); ++t)
+            {
+                const size_t begin = termStart[t], width = termStart[t + 1] - begin;
+                // Block V_SS of the inverse, one column at a time
+                std::vector<double> block(width * width);
+                for (size_t j = 0; j < width; ++j)
+                {
+                    std::fill(unit.begin(), unit.end(), 0.0);
+                    unit[begin + j] = 1.0;
+                    choleskySolve(a, p, unit.data());
+                    for (size_t i = 0; i < width; ++i)
+                        block[i * width + j] = unit[begin + i];
+                }
+                std::vector<double> z(beta.begin() + begin, beta.begin() + begin + width);
+                choleskyDecompose(block, width);
+                choleskySolve(block, width, z.data());
+                double ss = 0.0;
+                for (size_t i = 0; i < width; ++i)
+                    ss += beta[begin + i] * z[i];
+                ANOVAEffect effect;
+                for (size_t k = 0; k < numFactors; ++k)
+                {
+                    if ((terms[t] >> k) & 1)
+                        effect.factors.push_back(k);
+                }
+                effect.sumOfSquares = ss;
+                const double df = static_cast<double>(width);
+                const double f = (ss / df) / msWithin;
+                effect.test = TestResult{f, ProbabilityDistributions::fSurvival(f, df, dfWithin), df, dfWithin};
+                table.effects.push_back(effect);
+            }
+            return table;
+        }
+    }
+
+    /**
+     * Perform one-way ANOVA on (group, value) columns.
+     * Layman: Test if several groups share the same average straight from a table of
+     * events, without splitting it into one list per group first.
+     * Technical: One parallel pass of per-group shifted accumulators
+     * (detail::summarizeCells), then oneWayANOVA on the summaries; empty groups are ignored.
+     * @param values Value of every row
+     * @param groups Group id of every row, each below numGroups
+     * @param numThreads Worker count (0 = hardware concurrency)
+     * @return F-statistic, p-value from F(k - 1, N - k)
+     */
+    inline TestResult oneWayANOVA(const double *values, const uint32_t *groups, size_t n, size_t numGroups,
+                                  size_t numThreads = 0)
+    {
+        return oneWayANOVA(summarizeGroups(std::vector<const double *>(1, values), groups, n, numGroups, numThreads));
+    }
+
+    inline TestResult oneWayANOVA(const std::vector<double> &values, const std::vector<uint32_t> &groups,
+                                  size_t numGroups, size_t numThreads = 0)
+    {
+        if (values.size() != groups.size())
+            throw std::invalid_argument("Every value needs a group id");
+        return oneWayANOVA(values.data(), groups.data(), values.size(), numGroups, numThreads);
+    }
+
+    /**
+     * Perform a factorial ANOVA with all interactions on columnar data.
+     * Layman: Test how several categorical factors (and their combinations) affect an
+     * average, e.g. country x device x variant, over a table of any size.
+     * Technical: One parallel pass accumulates count, mean and M2 of every cell (combination
+     * of factor levels) without grouping the rows; the Type III table is then computed from
+     * the cell summaries alone (detail::factorialFromCells), so the cost beyond the pass is
+     * O(cells^3) whatever the row count. Every cell needs at least one observation.
+     * @param values Response of every row
+     * @param factors One level column per factor, each with one level id per row
+     * @param levels Number of levels of each factor (at least 2)
+     * @param numThreads Worker count (0 = hardware concurrency)
+     * @return Main effects and interactions with F-tests, residual and total sums of squares
+     */
+    inline ANOVATable factorialANOVA(const double *values, size_t n, const std::vector<const uint32_t *> &factors,
+                                     const std::vector<size_t> &levels, size_t numThreads = 0)
+    {
+        if (factors.empty() || factors.size() != levels.size())
+            throw std::invalid_argument("One level count per factor required");
+        if (factors.size() > 16)
+            throw std::invalid_argument("Too many factors");
+        size_t cells = 1;
+        for (size_t l : levels)
+        {
+            if (l < 2)
+                throw std::invalid_argument("Every factor needs at least two levels");
+            cells *= l;
+        }
+        auto cellOf = [&](size_t i) -> size_t
+        {
+            size_t cell = 0, stride = 1;
+            for (size_t k = 0; k < factors.size(); ++k)
+            {
+                const size_t level = factors[k][i];
+                if (level >= levels[k])
+                    return cells;
+                cell += level * stride;
+                stride *= levels[k];
+            }
+            return cell;
+        };
+        const std::vector<GroupSummary> summaries =
+            detail::summarizeCells(std::vector<const double *>(1, values), n, cells, cellOf, numThreads);
+        return detail::factorialFromCells(summaries, levels);
+    }
+
+    inline ANOVATable factorialANOVA(const std::vector<double> &values, const std::vector<std::vector<uint32_t>> &factors,
+                                     const std::vector<size_t> &levels, size_t numThreads = 0)
+    {
+        std::vector<const uint32_t *> pointers;
+        for (const auto &factor : factors)
+        {
+            if (factor.size() != values.size())
+                throw std::invalid_argument("Every factor needs one level per row");
+            pointers.push_back(factor.data());
+        }
+        return factorialANOVA(values.data(), values.size(), pointers, levels, numThreads);
+    }
+
+    /**
+     * Perform a two-way ANOVA with interaction on columnar data.
+     * Layman: Test the effect of two factors and of their combination on an average.
+     * Technical: factorialANOVA with two factors; effects are A, B and A x B.
+     * @param a Level of factor A for every row, below levelsA
+     * @param b Level of factor B for every row, below levelsB
+     * @return ANOVA table with rows A, B, A x B
+     */
+    inline ANOVATable twoWayANOVA(const std::vector<double> &values, const std::vector<uint32_t> &a, size_t levelsA,
+                                  const std::vector<uint32_t> &b, size_t levelsB, size_t numThreads = 0)
+    {
+        if (a.size() != values.size() || b.size() != values.size())
+            throw std::invalid_argument("Every factor needs one level per row");
+        return factorialANOVA(values.data(), values.size(), {a.data(), b.data()}, {levelsA, levelsB}, numThreads);
+    }
+}
+
+#endif // INFERENTIAL_ANOVA_H
@@ -0,0 +1,537 @@
+#ifndef INFERENTIAL_BOOTSTRAP_H
+#define INFERENTIAL_BOOTSTRAP_H
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+#include "InferentialStatistics.h"
+#include "../ProbabilityDistributionsLib/Samplers.h"
+
+namespace InferentialStatistics
+{
+    /**
+     * A data set given as distinct values with multiplicities.
+     * Layman: Your data squeezed into "value, how many times" pairs; a resampled data set is
+     * the same values with different counts.
+     * Technical: values ascending, counts[i] copies of values[i] (possibly 0), total the sum
+     * of the counts. Bootstrap and permutation replicates reach statistics in this form, so
+     * no replicate ever copies or reorders the data.
+     */
+    struct WeightedSample
+    {
+        const double *values;
+        const uint32_t *counts;
+        size_t size;
+        uint64_t total;
+    };
+
+    /**
+     * Mean of a weighted sample.
+     * Layman: The average of a resampled data set.
+     * Technical: sum(counts[i] * values[i]) / total in one pass over the distinct values.
+     */
+    struct SampleMean
+    {
+        double operator()(const WeightedSample &s) const
+        {
+            double sum = 0.0;
+            for (size_t i = 0; i < s.size; ++i)
+                sum += s.counts[i] * s.values[i];
+            return sum / s.total;
+        }
+    };
+
+    /**
+     * Sample variance of a weighted sample.
+     * Layman: How spread out a resampled data set is.
+     * Technical: Two passes over the distinct values, divided by total - 1; NaN below two
+     * observations.
+     */
+    struct SampleVariance
+    {
+        double operator()(const WeightedSample &s) const
+        {
+            if (s.total < 2)
+                return std::numeric_limits<double>::quiet_NaN();
+            const double m = SampleMean()(s);
+            double accum = 0.0;
+            for (size_t i = 0; i < s.size; ++i)
+            {
+                const double diff = s.values[i] - m;
+                accum += s.counts[i] * diff * diff;
+            }
+            return accum / (s.total - 1);
+        }
+    };
+
+    /**
+     * Percentile of a weighted sample.
+     * Layman: The value below which a given percentage of a resampled data set falls.
+     * Technical: Same definition as DescriptiveStatistics::percentile (linear interpolation
+     * at rank p / 100 * (total - 1)), found by walking the cumulative counts instead of
+     * sorting the replicate.
+     * @param p Percentile (0-100)
+     */
+    struct SamplePercentile
+    {
+        explicit SamplePercentile(double p)
+            : p(p)
+        {
+            if (p < 0.0 || p > 100.0)
+                throw std::invalid_argument("Percentile must be between 0 and 100");
+        }
+
+        double operator()(const WeightedSample &s) const
+        {
+            const double pos = (p / 100.0) * (s.total - 1);
+            const uint64_t idx = static_cast<uint64_t>(pos);
+            const double frac = pos - idx;
+            size_t i = 0;
+            uint64_t seen = s.counts[0];
+            while (seen <= idx)
+                seen += s.counts[++i];
+            const double lower = s.values[i];
+            if (frac == 0.0 || idx + 1 >= s.total)
+                return lower;
+            if (seen <= idx + 1)
+            {
+                do
+                    ++i;
+                while (s.counts[i] == 0);
+            }
+            return lower * (1 - frac) + s.values[i] * frac;
+        }
+
+        double p;
+    };
+
+    /**
+     * Median of a weighted sample.
+     * Layman: The middle value of a resampled data set.
+     * Technical: The 50th percentile; the average of the two middle values for even totals.
+     */
+    struct SampleMedian : SamplePercentile
+    {
+        SampleMedian() : SamplePercentile(50.0) {}
+    };
+
+    /**
+     * Settings of the bootstrap and permutation engines.
+     * Layman: How many random reshuffles to run and how to make them repeatable.
+     * Technical: replicates resampled data sets are drawn from Xoshiro256 streams of seed, so
+     * results are identical for any numThreads (0 = hardware concurrency). confidenceLevel
+     * sets the percentile interval. resolution > 0 rounds every value to the nearest multiple
+     * of resolution first, which bounds the number of distinct values (and the cost of a
+     * replicate) for continuous data at a rounding error of at most resolution / 2 per value.
+     */
+    struct ResamplingOptions
+    {
+        ResamplingOptions(size_t replicates = 10000, uint64_t seed = 42)
+            : replicates(replicates), seed(seed), confidenceLevel(0.95), resolution(0.0), numThreads(0) {}
+        size_t replicates;
+        uint64_t seed;
+        double confidenceLevel;
+        double resolution;
+        size_t numThreads;
+    };
+
+    /**
+     * Outcome of a bootstrap.
+     * Layman: The estimate, how much it wobbles between resamples, and a range that likely
+     * holds the true value.
+     * Technical: estimate is the statistic of the observed data, standardError the standard
+     * deviation of the replicates, bias their mean minus the estimate, and [lower, upper]
+     * the percentile confidence interval. replicates holds every resampled statistic in
+     * replicate order.
+     */
+    struct BootstrapResult
+    {
+        double estimate;
+        double standardError;
+        double bias;
+        double lower;
+        double upper;
+        std::vector<double> replicates;
+    };
+
+    namespace detail
+    {
+        // Replicates sharing one random stream; the unit of parallel work
+        const size_t replicateBlock = 32;
+
+        // Uniform index in [0, n) from one 64-bit draw
+        inline size_t uniformIndex(uint64_t bits, size_t n)
+        {
+            const size_t i = static_cast<size_t>(ProbabilityDistributions::detail::unitInterval(bits) * n);
+            return std::min(i, n - 1);
+        }
+
+        /**
+         * Sorted distinct values of a data set with their frequencies.
+         * Layman: The compact form of the data that every replicate is drawn from.
+         * Technical: A bootstrap resample is Multinomial(n, f / n) over the u distinct values.
+         * When u is small against n it is drawn as a chain of conditional binomials,
+         * counts[i] ~ Binomial(remaining, f[i] / (f[i] + ... + f[u-1])), costing O(u) per
+         * replicate whatever n is; otherwise as n uniform positions of the sorted data.
+         */
+        class DistinctValues
+        {
+        public:
+            template <typename T>
+            DistinctValues(const T *data, size_t n, double resolution)
+            {
+                if (n == 0)
+                    throw std::invalid_argument("Data vector is empty");
+                if (n > static_cast<size_t>(std::numeric_limits<int>::max()))
+                    throw std::invalid_argument("Too many observations to resample");
+                if (!(resolution >= 0.0))
+                    throw std::invalid_argument("Resolution must be non-negative");
+                std::vector<double> sorted(n);
+                for (size_t i = 0; i < n; ++i)
+                {
+                    double v = static_cast<double>(data[i]);
+                    if (std::isnan(v))
+                        throw std::invalid_argument("Data contains NaN");
+                    if (resolution > 0.0)
+                        v = std::round(v / resolution) * resolution;
+                    sorted[i] = v;
+                }
+                std::sort(sorted.begin(), sorted.end());
+                for (size_t i = 0, j; i < n; i = j)
+                {
+                    for (j = i + 1; j < n && sorted[j] == sorted[i]; ++j)
+                    {
+                    }
+                    values_.push_back(sorted[i]);
+                    frequencies_.push_back(static_cast<uint32_t>(j - i));
+                }
+                total_ = n;
+                const size_t u = values_.size();
+                conditional_.resize(u);
+                logComplement_.resize(u);
+                oddsRatio_.resize(u);
+                uint64_t suffix = 0;
+                for (size_t i = u; i-- > 0;)
+                {
+                    suffix += frequencies_[i];
+                    const double p = static_cast<double>(frequencies_[i]) / suffix;
+                    conditional_[i] = p;
+                    logComplement_[i] = std::log1p(-p);
+                    oddsRatio_[i] = p / (1.0 - p);
+                }
+                // A binomial draw costs about as much as eight uniform positions
+                chained_ = 8 * u < n;
+                if (!chained_ && u < n)
+                    categories(category_);
+            }
+
+            size_t size() const { return values_.size(); }
+            uint64_t total() const { return total_; }
+            const std::vector<double> &values() const { return values_; }
+            const std::vector<uint32_t> &frequencies() const { return frequencies_; }
+
+            WeightedSample weighted(const uint32_t *counts) const
+            {
+                return WeightedSample{values_.data(), counts, values_.size(), total_};
+            }
+
+            WeightedSample observed() const { return weighted(frequencies_.data()); }
+
+            // Distinct-value index of every position of the sorted data
+            void categories(std::vector<uint32_t> &out) const
+            {
+                out.resize(total_);
+                uint32_t *p = out.data();
+                for (size_t i = 0; i < values_.size(); ++i)
+                    p = std::fill_n(p, frequencies_[i], static_cast<uint32_t>(i));
+            }
+
+            // Index of value v (after rounding to the resolution), which must be present
+            size_t find(double v) const
+            {
+                return static_cast<size_t>(std::lower_bound(values_.begin(), values_.end(), v) - values_.begin());
+            }
+
+            // Draw the counts of a bootstrap resample of the data
+            template <typename RNG>
+            void resample(RNG &rng, uint32_t *counts) const
+            {
+                const size_t u = values_.size();
+                if (chained_)
+                {
+                    int remaining = static_cast<int>(total_);
+                    size_t i = 0;
+                    for (; i + 1 < u && remaining > 0; ++i)
+                    {
+                        const double p = conditional_[i];
+                        int c = 0;
+                        if (p <= 0.5 && remaining * p < 10.0)
+                        {
+                            // Inversion with the per-value constants; most values land here
+                            const double v = ProbabilityDistributions::detail::unitInterval(rng());
+                            double prob = std::exp(remaining * logComplement_[i]), cdf = prob;
+                            while (v > cdf && c < remaining)
+                            {
+                                prob *= oddsRatio_[i] * (remaining - c) / (c + 1);
+                                ++c;
+                                cdf += prob;
+                            }
+                        }
+                        else
+                            c = ProbabilityDistributions::BinomialSampler(remaining, p)(rng);
+                        counts[i] = static_cast<uint32_t>(c);
+                        remaining -= c;
+                    }
+                    std::fill(counts + i, counts + u, 0u);
+                    counts[u - 1] += static_cast<uint32_t>(remaining);
+                    return;
+                }
+                std::fill(counts, counts + u, 0u);
+                if (category_.empty())
+                {
+                    for (uint64_t k = 0; k < total_; ++k)
+                        ++counts[uniformIndex(rng(), total_)];
+                }
+                else
+                {
+                    for (uint64_t k = 0; k < total_; ++k)
+                        ++counts[category_[uniformIndex(rng(), total_)]];
+                }
+            }
+
+        private:
+            std::vector<double> values_;
+            std::vector<uint32_t> frequencies_;
+            std::vector<double> conditional_;
+            std::vector<double> logComplement_;
+            std::vector<double> oddsRatio_;
+            std::vector<uint32_t> category_;
+            uint64_t total_ = 0;
+            bool chained_ = false;
+        };
+
+        inline void validateResampling(const ResamplingOptions &options)
+        {
+            if (options.replicates == 0)
+                throw std::invalid_argument("At least one replicate required");
+            if (options.confidenceLevel <= 0 || options.confidenceLevel >= 1)
+                throw std::invalid_argument("Confidence level must be between 0 and 1");
+        }
+
+        // Linear-interpolation quantile of sorted values, q in [0, 1]
+        inline double sortedQuantile(const std::vector<double> &sorted, double q)
+        {
+            const double pos = q * (sorted.size() - 1);
+            const size_t idx = static_cast<size_t>(pos);
+            const double frac = pos - idx;
+            if (idx + 1 < sorted.size())
+                return sorted[idx] * (1 - frac) + sorted[idx + 1] * frac;
+            return sorted[idx];
+        }
+
+        inline BootstrapResult summarizeBootstrap(double estimate, std::vector<double> replicates, double confidenceLevel)
+        {
+            BootstrapResult result;
+            const double n = static_cast<double>(replicates.size());
+            double sum = 0.0;
+            for (double r : replicates)
+                sum += r;
+            const double m = sum / n;
+            double accum = 0.0;
+            for (double r : replicates)
+                accum += (r - m) * (r - m);
+            result.estimate = estimate;
+            result.standardError = replicates.size() > 1 ? std::sqrt(accum / (n - 1)) : 0.0;
+            result.bias = m - estimate;
+            std::vector<double> sorted(replicates);
+            std::sort(sorted.begin(), sorted.end());
+            const double alpha = 1.0 - confidenceLevel;
+            result.lower = sortedQuantile(sorted, alpha / 2);
+            result.upper = sortedQuantile(sorted, 1.0 - alpha / 2);
+            result.replicates = std::move(replicates);
+            return result;
+        }
+    }
+
+    /**
+     * Bootstrap a statistic of one sample.
+     * Layman: Resample your data with replacement thousands of times to see how much a
+     * statistic would vary between samples, and get a confidence interval for it.
+     * Technical: The data is reduced once to sorted distinct values and frequencies; each
+     * replicate draws multinomial counts over them (O(distinct values) with conditional
+     * binomials when values repeat, O(n) uniform positions otherwise) and evaluates the
+     * statistic on the resulting WeightedSample. Blocks of 32 replicates run in parallel,
+     * block b on Xoshiro256 stream b of the seed. Percentile interval.
+     * @param statistic Callable double(const WeightedSample &), e.g. SampleMean, SampleMedian,
+     * SamplePercentile(90); it is called from several threads at once
+     * @return Estimate, standard error, bias, percentile interval and the replicates
+     */
+    template <typename T, typename Statistic>
+    BootstrapResult bootstrap(const T *data, size_t n, Statistic statistic,
+                              const ResamplingOptions &options = ResamplingOptions())
+    {
+        detail::validateResampling(options);
+        const detail::DistinctValues sample(data, n, options.resolution);
+        std::vector<double> replicates(options.replicates);
+        auto runBlock = [&](size_t b, ProbabilityDistributions::Xoshiro256 &rng)
+        {
+            std::vector<uint32_t> counts(sample.size());
+            const size_t last = std::min(replicates.size(), (b + 1) * detail::replicateBlock);
+            for (size_t r = b * detail::replicateBlock; r < last; ++r)
+            {
+                sample.resample(rng, counts.data());
+                replicates[r] = statistic(sample.weighted(counts.data()));
+            }
+        };
+        const size_t blocks = (replicates.size() + detail::replicateBlock - 1) / detail::replicateBlock;
+        ProbabilityDistributions::parallelStreams(blocks, options.seed, options.numThreads, runBlock);
+        return detail::summarizeBootstrap(statistic(sample.observed()), std::move(replicates), options.confidenceLevel);
+    }
+
+    template <typename T, typename Statistic>
+    BootstrapResult bootstrap(const std::vector<T> &data, Statistic statistic,
+                              const ResamplingOptions &options = ResamplingOptions())
+    {
+        return bootstrap(data.data(), data.size(), statistic, options);
+    }
+
+    /**
+     * Bootstrap the difference of a statistic between two independent samples.
+     * Layman: How uncertain is "group x minus group y", e.g. the difference of two means?
+     * Technical: Each replicate resamples x and y independently (as in bootstrap) and
+     * records statistic(x*) - statistic(y*); SampleMean gives the difference of means.
+     * @param statistic Callable double(const WeightedSample &), called from several threads
+     * @return Estimate, standard error, bias, percentile interval and the replicates
+     */
+    template <typename T, typename Statistic>
+    BootstrapResult bootstrapDifference(const T *x, size_t nx, const T *y, size_t ny, Statistic statistic,
+                                        const ResamplingOptions &options = ResamplingOptions())
+    {
+        detail::validateResampling(options);
+        const detail::DistinctValues sx(x, nx, options.resolution);
+        const detail::DistinctValues sy(y, ny, options.resolution);
+        std::vector<double> replicates(options.replicates);
+        auto runBlock = [&](size_t b, ProbabilityDistributions::Xoshiro256 &rng)
+        {
+            std::vector<uint32_t> countsX(sx.size()), countsY(sy.size());
+            const size_t last = std::min(replicates.size(), (b + 1) * detail::replicateBlock);
+            for (size_t r = b * detail::replicateBlock; r < last; ++r)
+            {
+                sx.resample(rng, countsX.data());
+                sy.resample(rng, countsY.data());
+                replicates[r] = statistic(sx.weighted(countsX.data())) - statistic(sy.weighted(countsY.data()));
+            }
+        };
+        const size_t blocks = (replicates.size() + detail::replicateBlock - 1) / detail::replicateBlock;
+        ProbabilityDistributions::parallelStreams(blocks, options.seed, options.numThreads, runBlock);
+        const double estimate = statistic(sx.observed()) - statistic(sy.observed());
+        return detail::summarizeBootstrap(estimate, std::move(replicates), options.confidenceLevel);
+    }
+
+    template <typename T, typename Statistic>
+    BootstrapResult bootstrapDifference(const std::vector<T> &x, const std::vector<T> &y, Statistic statistic,
+                                        const ResamplingOptions &options = ResamplingOptions())
+    {
+        return bootstrapDifference(x.data(), x.size(), y.data(), y.size(), statistic, options);
+    }
+
+    /**
+     * Two-sample permutation test.
+     * Layman: Shuffle the group labels many times; if the observed difference between the
+     * groups is rarely matched by shuffled labels, the groups really differ.
+     * Technical: Statistic statistic(x) - statistic(y). Each replicate relabels a uniformly
+     * random subset of the pooled data as the smaller group by a partial Fisher-Yates
+     * shuffle of distinct-value indices, so it costs O(min(nx, ny) + distinct values) and the
+     * larger group's counts follow by subtraction from the pooled frequencies. p-value
+     * (1 + #{extreme replicates}) / (1 + replicates), where extreme means |T*| >= |T| for
+     * TwoSided, T* <= T for Less and T* >= T for Greater.
+     * @param statistic Callable double(const WeightedSample &), called from several threads
+     * @return Observed difference and permutation p-value (no degrees of freedom)
+     */
+    template <typename T, typename Statistic>
+    TestResult permutationTest(const T *x, size_t nx, const T *y, size_t ny, Statistic statistic,
+                               Alternative alternative = Alternative::TwoSided,
+                               const ResamplingOptions &options = ResamplingOptions())
+    {
+        detail::validateResampling(options);
+        if (nx == 0 || ny == 0)
+            throw std::invalid_argument("Data vector is empty");
+        std::vector<double> pooledData(nx + ny);
+        std::copy(x, x + nx, pooledData.begin());
+        std::copy(y, y + ny, pooledData.begin() + nx);
+        const detail::DistinctValues pooled(pooledData.data(), pooledData.size(), options.resolution);
+        const size_t u = pooled.size();
+        const std::vector<uint32_t> &frequencies = pooled.frequencies();
+
+        // Observed split of the pooled distinct values
+        std::vector<uint32_t> countsX(u, 0), countsY(u);
+        for (size_t i = 0; i < nx; ++i)
+        {
+            const double v = options.resolution > 0.0 ? std::round(pooledData[i] / options.resolution) * options.resolution
+                                                      : pooledData[i];
+            ++countsX[pooled.find(v)];
+        }
+        for (size_t k = 0; k < u; ++k)
+            countsY[k] = frequencies[k] - countsX[k];
+        auto difference = [&](const uint32_t *a, uint64_t na, const uint32_t *b, uint64_t nb) -> double
+        {
+            return statistic(WeightedSample{pooled.values().data(), a, u, na}) -
+                   statistic(WeightedSample{pooled.values().data(), b, u, nb});
+        };
+        const double observed = difference(countsX.data(), nx, countsY.data(), ny);
+
+        const size_t total = nx + ny, m = std::min(nx, ny);
+        const bool drawX = m == nx;
+        std::vector<double> replicates(options.replicates);
+        auto runBlock = [&](size_t b, ProbabilityDistributions::Xoshiro256 &rng)
+        {
+            std::vector<uint32_t> labels, drawn(u), rest(u);
+            pooled.categories(labels);
+            const size_t last = std::min(replicates.size(), (b + 1) * detail::replicateBlock);
+            for (size_t r = b * detail::replicateBlock; r < last; ++r)
+            {
+                std::fill(drawn.begin(), drawn.end(), 0u);
+                for (size_t i = 0; i < m; ++i)
+                {
+                    std::swap(labels[i], labels[i + detail::uniformIndex(rng(), total - i)]);
+                    ++drawn[labels[i]];
+                }
+                for (size_t k = 0; k < u; ++k)
+                    rest[k] = frequencies[k] - drawn[k];
+                replicates[r] = drawX ? difference(drawn.data(), nx, rest.data(), ny)
+                                      : difference(rest.data(), nx, drawn.data(), ny);
+            }
+        };
+        const size_t blocks = (replicates.size() + detail::replicateBlock - 1) / detail::replicateBlock;
+        ProbabilityDistributions::parallelStreams(blocks, options.seed, options.numThreads, runBlock);
+
+        // Relative tolerance so replicates equal to the observed value up to rounding count
+        const double tolerance = 1e-12 * std::abs(observed);
+        size_t extreme = 0;
+        for (double t : replicates)
+        {
+            if (alternative == Alternative::Less)
+                extreme += t <= observed + tolerance;
+            else if (alternative == Alternative::Greater)
+                extreme += t >= observed - tolerance;
+            else
+                extreme += std::abs(t) >= std::abs(observed) - tolerance;
+        }
+        const double p = (1.0 + extreme) / (1.0 + replicates.size());
+        const double none = std::numeric_limits<double>::quiet_NaN();
+        return TestResult{observed, p, none, none};
+    }
+
+    template <typename T, typename Statistic>
+    TestResult permutationTest(const std::vector<T> &x, const std::vector<T> &y, Statistic statistic,
+                               Alternative alternative = Alternative::TwoSided,
+                               const ResamplingOptions &options = ResamplingOptions())
+    {
+        return permutationTest(x.data(), x.size(), y.data(), y.size(), statistic, alternative, options);
+    }
+}
+
+#endif // INFERENTIAL_BOOTSTRAP_H
@@ -0,0 +1,250 @@
+#ifndef INFERENTIAL_CONTINGENCY_TABLES_H
+#define INFERENTIAL_CONTINGENCY_TABLES_H
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+#include <unordered_map>
+#include <thread>
+#include "InferentialStatistics.h"
+#include "../ProbabilityDistributionsLib/Parallel.h"
+
+namespace InferentialStatistics
+{
+    /**
+     * Sparse two-way contingency table.
+     * Layman: Counts of how often each (row category, column category) pair occurs, storing
+     * only the pairs that actually occur.
+     * Technical: Categories of any hashable type get dense indices in order of first
+     * appearance; non-zero cells live in a hash map keyed by (row index, column index), and
+     * row, column and grand totals are kept up to date on every add. Memory is
+     * O(rows + columns + non-zero cells) however large rows x columns is.
+     */
+    template <typename RowT = uint32_t, typename ColT = uint32_t>
+    class ContingencyTable
+    {
+    public:
+        void add(const RowT &row, const ColT &column, uint64_t count = 1)
+        {
+            if (count == 0)
+                return;
+            const uint32_t r = index(row, rowIds_, rowLabels_, rowTotals_);
+            const uint32_t c = index(column, columnIds_, columnLabels_, columnTotals_);
+            cells_[key(r, c)] += count;
+            rowTotals_[r] += count;
+            columnTotals_[c] += count;
+            total_ += count;
+        }
+
+        // Add every cell of another table (e.g. one built on another chunk of rows). Categories
+        // new to this table are appended in the other table's order, so merging tables of
+        // consecutive chunks keeps the order of first appearance.
+        void merge(const ContingencyTable &other)
+        {
+            if (&other == this)
+            {
+                const ContingencyTable copy(other);
+                merge(copy);
+                return;
+            }
+            std::vector<uint32_t> rowMap(other.rowLabels_.size()), columnMap(other.columnLabels_.size());
+            for (size_t r = 0; r < rowMap.size(); ++r)
+            {
+                rowMap[r] = index(other.rowLabels_[r], rowIds_, rowLabels_, rowTotals_);
+                rowTotals_[rowMap[r]] += other.rowTotals_[r];
+            }
+            for (size_t c = 0; c < columnMap.size(); ++c)
+            {
+                columnMap[c] = index(other.columnLabels_[c], columnIds_, columnLabels_, columnTotals_);
+                columnTotals_[columnMap[c]] += other.columnTotals_[c];
+            }
+            cells_.reserve(cells_.size() + other.cells_.size());
+            for (const auto &cell : other.cells_)
+                cells_[key(rowMap[cell.first >> 32], columnMap[cell.first & 0xFFFFFFFFULL])] += cell.second;
+            total_ += other.total_;
+        }
+
+        uint64_t count(const RowT &row, const ColT &column) const
+        {
+            const auto r = rowIds_.find(row);
+            const auto c = columnIds_.find(column);
+            if (r == rowIds_.end() || c == columnIds_.end())
+                return 0;
+            const auto cell = cells_.find(key(r->second, c->second));
+            return cell == cells_.end() ? 0 : cell->second;
+        }
+
+        size_t rows() const { return rowLabels_.size(); }
+        size_t columns() const { return columnLabels_.size(); }
+        size_t nonZeroCells() const { return cells_.size(); }
+        uint64_t total() const { return total_; }
+
+        const std::vector<RowT> &rowLabels() const { return rowLabels_; }
+        const std::vector<ColT> &columnLabels() const { return columnLabels_; }
+        const std::vector<uint64_t> &rowTotals() const { return rowTotals_; }
+        const std::vector<uint64_t> &columnTotals() const { return columnTotals_; }
+
+        // Call fn(row index, column index, count) for every non-zero cell
+        template <typename Func>
+        void forEachCell(Func fn) const
+        {
+            for (const auto &cell : cells_)
+                fn(static_cast<size_t>(cell.first >> 32), static_cast<size_t>(cell.first & 0xFFFFFFFFULL), cell.second);
+        }
+
+    private:
+        static uint64_t key(uint32_t r, uint32_t c) { return (static_cast<uint64_t>(r) << 32) | c; }
+
+        template <typename T>
+        static uint32_t index(const T &label, std::unordered_map<T, uint32_t> &ids, std::vector<T> &labels,
+                              std::vector<uint64_t> &totals)
+        {
+            const auto found = ids.find(label);
+            if (found != ids.end())
+                return found->second;
+            if (labels.size() >= std::numeric_limits<uint32_t>::max())
+                throw std::length_error("Too many categories");
+            const uint32_t id = static_cast<uint32_t>(labels.size());
+            ids.emplace(label, id);
+            labels.push_back(label);
+            totals.push_back(0);
+            return id;
+        }
+
+        std::unordered_map<uint64_t, uint64_t> cells_;
+        std::unordered_map<RowT, uint32_t> rowIds_;
+        std::unordered_map<ColT, uint32_t> columnIds_;
+        std::vector<RowT> rowLabels_;
+        std::vector<ColT> columnLabels_;
+        std::vector<uint64_t> rowTotals_;
+        std::vector<uint64_t> columnTotals_;
+        uint64_t total_ = 0;
+    };
+
+    /**
+     * Build a contingency table from two categorical columns in parallel.
+     * Layman: Cross-tabulate two columns of categories (e.g. country and device) quickly,
+     * even with millions of distinct categories.
+     * Technical: Each thread hashes the (row, column) pairs of a contiguous range of rows
+     * into its own sparse table; the tables are then merged in thread order, so categories
+     * keep their order of first appearance for any thread count. An exception from any
+     * thread (e.g. too many categories) is rethrown once every thread has joined.
+     * @param rows Row category of every observation
+     * @param columns Column category of every observation
+     * @param numThreads Worker count (0 = hardware concurrency)
+     */
+    template <typename RowT, typename ColT>
+    ContingencyTable<RowT, ColT> contingencyTable(const RowT *rows, const ColT *columns, size_t n, size_t numThreads = 0)
+    {
+        const size_t minRowsPerThread = 65536;
+        if (numThreads == 0)
+            numThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+        numThreads = std::max<size_t>(1, std::min(numThreads, n / minRowsPerThread));
+        std::vector<ContingencyTable<RowT, ColT>> partial(numThreads);
+        auto work = [&](size_t w)
+        {
+            const size_t first = w * n / numThreads, last = (w + 1) * n / numThreads;
+            for (size_t i = first; i < last; ++i)
+                partial[w].add(rows[i], columns[i]);
+        };
+        ProbabilityDistributions::detail::parallelFor(numThreads, numThreads, work);
+        for (size_t w = 1; w < numThreads; ++w)
+            partial[0].merge(partial[w]);
+        return std::move(partial[0]);
+    }
+
+    template <typename RowT, typename ColT>
+    ContingencyTable<RowT, ColT> contingencyTable(const std::vector<RowT> &rows, const std::vector<ColT> &columns,
+                                                  size_t numThreads = 0)
+    {
+        if (rows.size() != columns.size())
+            throw std::invalid_argument("Vectors rows and columns must be the same size");
+        return contingencyTable(rows.data(), columns.data(), rows.size(), numThreads);
+    }
+
+    namespace detail
+    {
+        template <typename RowT, typename ColT>
+        void checkIndependenceTable(const ContingencyTable<RowT, ColT> &table)
+        {
+            if (table.rows() < 2 || table.columns() < 2)
+                throw std::invalid_argument("At least two row and two column categories required");
+        }
+    }
+
+    /**
+     * Pearson chi-square test of independence.
+     * Layman: Test whether the row category and the column category are related.
+     * Technical: With expected counts E_ij = R_i C_j / N, chi^2 = sum (O - E)^2 / E over all
+     * r x c cells equals sum O^2 / E - N over the non-zero cells only, so the table is never
+     * densified: O(non-zero cells). Degrees of freedom (r - 1)(c - 1).
+     * @return chi-square statistic, p-value and degrees of freedom
+     */
+    template <typename RowT, typename ColT>
+    TestResult chiSquareIndependence(const ContingencyTable<RowT, ColT> &table)
+    {
+        detail::checkIndependenceTable(table);
+        const double n = static_cast<double>(table.total());
+        const std::vector<uint64_t> &rowTotals = table.rowTotals();
+        const std::vector<uint64_t> &columnTotals = table.columnTotals();
+        double sum = 0.0;
+        auto addCell = [&](size_t r, size_t c, uint64_t count)
+        {
+            const double o = static_cast<double>(count);
+            sum += o * o * n / (static_cast<double>(rowTotals[r]) * columnTotals[c]);
+        };
+        table.forEachCell(addCell);
+        const double chiSquare = std::max(0.0, sum - n);
+        const double df = static_cast<double>(table.rows() - 1) * static_cast<double>(table.columns() - 1);
+        return TestResult{chiSquare, ProbabilityDistributions::chiSquareSurvival(chiSquare, df), df,
+                          std::numeric_limits<double>::quiet_NaN()};
+    }
+
+    /**
+     * G-test (log-likelihood ratio test) of independence.
+     * Layman: Like the chi-square test of independence, but based on likelihoods, which
+     * behaves better when some expected counts are small.
+     * Technical: G = 2 sum O ln(O N / (R_i C_j)) over the non-zero cells (empty cells add
+     * nothing), referred to chi-square with (r - 1)(c - 1) degrees of freedom.
+     * @return G statistic, p-value and degrees of freedom
+     */
+    template <typename RowT, typename ColT>
+    TestResult gTestIndependence(const ContingencyTable<RowT, ColT> &table)
+    {
+        detail::checkIndependenceTable(table);
+        const double n = static_cast<double>(table.total());
+        const std::vector<uint64_t> &rowTotals = table.rowTotals();
+        const std::vector<uint64_t> &columnTotals = table.columnTotals();
+        double sum = 0.0;
+        auto addCell = [&](size_t r, size_t c, uint64_t count)
+        {
+            const double o = static_cast<double>(count);
+            sum += o * std::log(o * n / (static_cast<double>(rowTotals[r]) * columnTotals[c]));
+        };
+        table.forEachCell(addCell);
+        const double g = std::max(0.0, 2.0 * sum);
+        const double df = static_cast<double>(table.rows() - 1) * static_cast<double>(table.columns() - 1);
+        return TestResult{g, ProbabilityDistributions::chiSquareSurvival(g, df), df,
+                          std::numeric_limits<double>::quiet_NaN()};
+    }
+
+    /**
+     * Cramér's V association strength.
+     * Layman: How strongly two categorical variables are related, from 0 (not at all) to 1
+     * (one determines the other).
+     * Technical: sqrt(chi^2 / (N min(r - 1, c - 1))) with the Pearson chi-square of
+     * chiSquareIndependence.
+     */
+    template <typename RowT, typename ColT>
+    double cramersV(const ContingencyTable<RowT, ColT> &table)
+    {
+        const double chiSquare = chiSquareIndependence(table).statistic;
+        const double k = static_cast<double>(std::min(table.rows(), table.columns()) - 1);
+        return std::sqrt(chiSquare / (static_cast<double>(table.total()) * k));
+    }
+}
+
+#endif // INFERENTIAL_CONTINGENCY_TABLES_H
@@ -8,9 +8,130 @@
 #include <algorithm>
 #include <iostream>
 #include <map>
+#include <limits>
+#include <cstdint>
+#include "../ProbabilityDistributionsLib/ProbabilityDistributions.h"
 
 namespace InferentialStatistics
 {
+    /**
+     * Alternative hypothesis of a test.
+     * Layman: Whether you are looking for a difference in either direction or only one.
+     * Technical: TwoSided tests statistic != null value, Less tests statistic < null value,
+     * Greater tests statistic > null value.
+     */
+    enum class Alternative
+    {
+        TwoSided,
+        Less,
+        Greater
+    };
+
+    /**
+     * Outcome of a hypothesis test.
+     * Layman: The test score and how likely a score at least this extreme is by chance alone.
+     * Technical: Test statistic, p-value under the null hypothesis and the degrees of freedom
+     * of the reference distribution (NaN when it has none; the denominator degrees of freedom
+     * are only used by F-tests).
+     */
+    struct TestResult
+    {
+        double statistic;
+        double pValue;
+        double degreesOfFreedom;
+        double denominatorDegreesOfFreedom;
+    };
+
+    namespace detail
+    {
+        /**
+         * Combine the tail probabilities of a statistic into a p-value.
+         * Layman: Turn "how far into the tail" into "how surprising" for the chosen direction.
+         * Technical: lower = P(S <= s), upper = P(S >= s); two-sided is 2 min(lower, upper),
+         * capped at 1.
+         */
+        inline double pValue(double lower, double upper, Alternative alternative)
+        {
+            switch (alternative)
+            {
+            case Alternative::Less:
+                return lower;
+            case Alternative::Greater:
+                return upper;
+            default:
+                return std::min(1.0, 2.0 * std::min(lower, upper));
+            }
+        }
+
+        /**
+         * Welch's unequal-variance t-test from per-group means and variances.
+         * Layman: Compare two group averages without assuming the groups are equally noisy.
+         * Technical: t = (m1 - m2) / sqrt(v1 / n1 + v2 / n2) with Welch-Satterthwaite degrees
+         * of freedom (v1 / n1 + v2 / n2)^2 / ((v1 / n1)^2 / (n1 - 1) + (v2 / n2)^2 / (n2 - 1)).
+         */
+        inline TestResult welch(double mean1, double variance1, double n1, double mean2, double variance2, double n2,
+                                Alternative alternative)
+        {
+            const double a = variance1 / n1, b = variance2 / n2;
+            if (!(a + b > 0))
+                throw std::invalid_argument("Both groups have zero variance");
+            const double t = (mean1 - mean2) / std::sqrt(a + b);
+            const double df = (a + b) * (a + b) / (a * a / (n1 - 1) + b * b / (n2 - 1));
+            const double p = pValue(ProbabilityDistributions::studentTCDF(t, df),
+                                    ProbabilityDistributions::studentTSurvival(t, df), alternative);
+            return TestResult{t, p, df, std::numeric_limits<double>::quiet_NaN()};
+        }
+    }
+
+    /**
+     * Sufficient statistics of one group for mean and variance based tests.
+     * Layman: Everything a t-test or z-test needs to know about a group, in three numbers.
+     * Technical: Observation count, mean and sum of squared deviations from the mean (M2).
+     * Grows one value at a time with add (Welford) and summaries of disjoint parts combine
+     * exactly with merge (Chan et al. update).
+     */
+    struct GroupSummary
+    {
+        explicit GroupSummary(uint64_t count = 0, double mean = 0.0, double m2 = 0.0)
+            : count(count), mean(mean), m2(m2) {}
+        uint64_t count;
+        double mean;
+        double m2;
+
+        // Add one observation (Welford update)
+        void add(double x)
+        {
+            ++count;
+            const double delta = x - mean;
+            mean += delta / count;
+            m2 += delta * (x - mean);
+        }
+
+        void merge(const GroupSummary &other)
+        {
+            if (other.count == 0)
+                return;
+            if (count == 0)
+            {
+                *this = other;
+                return;
+            }
+            const double n = static_cast<double>(count + other.count);
+            const double delta = other.mean - mean;
+            mean += delta * other.count / n;
+            m2 += other.m2 + delta * delta * (static_cast<double>(count) * other.count / n);
+            count += other.count;
+        }
+
+        // Sample variance (n - 1 denominator); NaN below two observations
+        double variance() const
+        {
+            return count < 2 ? std::numeric_limits<double>::quiet_NaN() : m2 / (count - 1);
+        }
+
+        double standardDeviation() const { return std::sqrt(variance()); }
+    };
+
     /**
      * Calculate the mean (average) of the data.
      * Layman: The average value of all numbers in your data.
@@ -62,17 +183,146 @@ namespace InferentialStatistics
      * Technical: Calculate the t-statistic for the sample data against the null hypothesis mean.
      * @param data Sample data
      * @param mu Hypothesized population mean
-     * @return t-statistic
+     * @param alternative Direction of the alternative hypothesis
+     * @return t-statistic, p-value from Student's t with n - 1 degrees of freedom
      */
     template <typename T>
-    double tTest(const std::vector<T> &data, double mu)
+    TestResult tTest(const std::vector<T> &data, double mu, Alternative alternative = Alternative::TwoSided)
     {
         if (data.size() < 2)
             throw std::invalid_argument("At least two data points required");
         double m = mean(data);
         double s = standardDeviation(data);
         double n = static_cast<double>(data.size());
-        return (m - mu) / (s / std::sqrt(n));
+        double t = (m - mu) / (s / std::sqrt(n));
+        double df = n - 1;
+        double p = detail::pValue(ProbabilityDistributions::studentTCDF(t, df),
+                                  ProbabilityDistributions::studentTSurvival(t, df), alternative);
+        return TestResult{t, p, df, std::numeric_limits<double>::quiet_NaN()};
+    }
+
+    /**
+     * Perform Welch's two-sample t-test.
+     * Layman: Test if two independent groups have different means, without assuming they
+     * are equally spread out.
+     * Technical: t = (mean(x) - mean(y)) / sqrt(s_x^2 / n_x + s_y^2 / n_y), referred to
+     * Student's t with Welch-Satterthwaite degrees of freedom.
+     * @param x First sample
+     * @param y Second sample
+     * @param alternative Direction of the alternative hypothesis (Greater: mean(x) > mean(y))
+     * @return t-statistic, p-value and (fractional) degrees of freedom
+     */
+    template <typename T>
+    TestResult welchTTest(const std::vector<T> &x, const std::vector<T> &y, Alternative alternative = Alternative::TwoSided)
+    {
+        if (x.size() < 2 || y.size() < 2)
+            throw std::invalid_argument("At least two data points per group required");
+        return detail::welch(mean(x), variance(x), static_cast<double>(x.size()),
+                             mean(y), variance(y), static_cast<double>(y.size()), alternative);
+    }
+
+    /**
+     * Perform a paired t-test.
+     * Layman: Test if matched before/after measurements differ on average.
+     * Technical: One-sample t-test of the differences x[i] - y[i] against 0, computed in two
+     * passes without materializing the differences; n - 1 degrees of freedom.
+     * @param x First measurement of each pair
+     * @param y Second measurement of each pair
+     * @param alternative Direction of the alternative hypothesis (Greater: x > y on average)
+     * @return t-statistic, p-value and degrees of freedom
+     */
+    template <typename T>
+    TestResult pairedTTest(const std::vector<T> &x, const std::vector<T> &y, Alternative alternative = Alternative::TwoSided)
+    {
+        if (x.size() != y.size())
+            throw std::invalid_argument("Paired samples must be the same size");
+        if (x.size() < 2)
+            throw std::invalid_argument("At least two pairs required");
+        const double n = static_cast<double>(x.size());
+        double sum = 0.0;
+        for (size_t i = 0; i < x.size(); ++i)
+            sum += static_cast<double>(x[i]) - static_cast<double>(y[i]);
+        const double m = sum / n;
+        double accum = 0.0;
+        for (size_t i = 0; i < x.size(); ++i)
+        {
+            const double diff = static_cast<double>(x[i]) - static_cast<double>(y[i]) - m;
+            accum += diff * diff;
+        }
+        const double s = std::sqrt(accum / (n - 1));
+        if (s == 0)
+            throw std::invalid_argument("Differences have zero variance");
+        const double t = m / (s / std::sqrt(n));
+        const double df = n - 1;
+        double p = detail::pValue(ProbabilityDistributions::studentTCDF(t, df),
+                                  ProbabilityDistributions::studentTSurvival(t, df), alternative);
+        return TestResult{t, p, df, std::numeric_limits<double>::quiet_NaN()};
+    }
+
+    /**
+     * Perform the Mann-Whitney U test on samples that are already sorted.
+     * Layman: Test if values from one group tend to be larger than values from the other,
+     * using only their order, so outliers and skew do not matter.
+     * Technical: A single merge of the two sorted samples assigns average ranks to tie
+     * groups, so no pooled sort is needed (O(n_x + n_y)). U = R_x - n_x (n_x + 1) / 2, with
+     * the normal approximation N(n_x n_y / 2, n_x n_y / 12 ((N + 1) - sum(t^3 - t) / (N (N - 1))))
+     * over tie groups of size t, and a continuity correction of 0.5.
+     * @param x First sample, ascending
+     * @param y Second sample, ascending
+     * @param alternative Direction of the alternative hypothesis (Greater: x tends to exceed y)
+     * @return U statistic of x and its p-value
+     */
+    template <typename T>
+    TestResult mannWhitneyUSorted(const T *x, size_t nx, const T *y, size_t ny, Alternative alternative = Alternative::TwoSided)
+    {
+        if (nx == 0 || ny == 0)
+            throw std::invalid_argument("Data vector is empty");
+        if (!std::is_sorted(x, x + nx) || !std::is_sorted(y, y + ny))
+            throw std::invalid_argument("Samples must be sorted in ascending order");
+        double rankSumX = 0.0, tieTerm = 0.0, position = 0.0;
+        size_t i = 0, j = 0;
+        while (i < nx || j < ny)
+        {
+            const T v = (j == ny || (i < nx && x[i] < y[j])) ? x[i] : y[j];
+            size_t cx = 0, cy = 0;
+            for (; i < nx && !(v < x[i]); ++i)
+                ++cx;
+            for (; j < ny && !(v < y[j]); ++j)
+                ++cy;
+            const double t = static_cast<double>(cx + cy);
+            rankSumX += cx * (position + (t + 1) / 2);
+            tieTerm += t * t * t - t;
+            position += t;
+        }
+        const double n1 = static_cast<double>(nx), n2 = static_cast<double>(ny), n = n1 + n2;
+        const double u = rankSumX - n1 * (n1 + 1) / 2;
+        const double meanU = n1 * n2 / 2;
+        const double varU = n1 * n2 / 12 * ((n + 1) - tieTerm / (n * (n - 1)));
+        const double none = std::numeric_limits<double>::quiet_NaN();
+        if (!(varU > 0))
+            return TestResult{u, 1.0, none, none};
+        const double sd = std::sqrt(varU);
+        double p = detail::pValue(ProbabilityDistributions::normalCDF((u + 0.5 - meanU) / sd, 0.0, 1.0),
+                                  ProbabilityDistributions::normalSurvival((u - 0.5 - meanU) / sd, 0.0, 1.0), alternative);
+        return TestResult{u, p, none, none};
+    }
+
+    /**
+     * Perform the Mann-Whitney U (Wilcoxon rank-sum) test.
+     * Layman: Test if values from one group tend to be larger than values from the other.
+     * Technical: Sorts each sample separately and ranks them by merging (mannWhitneyUSorted);
+     * tie-corrected normal approximation.
+     * @param x First sample
+     * @param y Second sample
+     * @param alternative Direction of the alternative hypothesis (Greater: x tends to exceed y)
+     * @return U statistic of x and its p-value
+     */
+    template <typename T>
+    TestResult mannWhitneyU(std::vector<T> x, std::vector<T> y, Alternative alternative = Alternative::TwoSided)
+    {
+        std::sort(x.begin(), x.end());
+        std::sort(y.begin(), y.end());
+        return mannWhitneyUSorted(x.data(), x.size(), y.data(), y.size(), alternative);
     }
 
     /**
@@ -82,16 +332,23 @@ namespace InferentialStatistics
      * @param data Sample data
      * @param mu Hypothesized population mean
      * @param sigma Population standard deviation (known)
-     * @return z-statistic
+     * @param alternative Direction of the alternative hypothesis
+     * @return z-statistic, p-value from the standard normal
      */
     template <typename T>
-    double zTest(const std::vector<T> &data, double mu, double sigma)
+    TestResult zTest(const std::vector<T> &data, double mu, double sigma, Alternative alternative = Alternative::TwoSided)
     {
         if (data.empty())
             throw std::invalid_argument("Data vector is empty");
+        if (sigma <= 0)
+            throw std::invalid_argument("Standard deviation must be positive");
         double m = mean(data);
         double n = static_cast<double>(data.size());
-        return (m - mu) / (sigma / std::sqrt(n));
+        double z = (m - mu) / (sigma / std::sqrt(n));
+        double p = detail::pValue(ProbabilityDistributions::normalCDF(z, 0.0, 1.0),
+                                  ProbabilityDistributions::normalSurvival(z, 0.0, 1.0), alternative);
+        const double none = std::numeric_limits<double>::quiet_NaN();
+        return TestResult{z, p, none, none};
     }
 
     /**
@@ -116,66 +373,99 @@ namespace InferentialStatistics
     }
 
     /**
-     * Perform one-way ANOVA test.
-     * @param groups Vector of groups, each group is a vector of data points
-     * @return F-statistic
+     * Calculate confidence interval for the mean, deriving the critical value.
+     * Layman: Range where the true mean likely falls with a given confidence.
+     * Technical: Uses the Student's t quantile at (1 + confidenceLevel) / 2 with n - 1
+     * degrees of freedom as tCritical.
+     * @param data Sample data
+     * @param confidenceLevel Confidence level (e.g., 0.95 for 95%)
+     * @return pair of lower and upper bounds
      */
     template <typename T>
-    double oneWayANOVA(const std::vector<std::vector<T>> &groups)
+    std::pair<double, double> confidenceInterval(const std::vector<T> &data, double confidenceLevel)
     {
-        size_t k = groups.size();
-        if (k < 2)
-            throw std::invalid_argument("At least two groups required");
+        if (confidenceLevel <= 0 || confidenceLevel >= 1)
+            throw std::invalid_argument("Confidence level must be between 0 and 1");
+        if (data.size() < 2)
+            throw std::invalid_argument("At least two data points required");
+        double df = static_cast<double>(data.size() - 1);
+        double tCritical = ProbabilityDistributions::studentTQuantile(0.5 + confidenceLevel / 2, df);
+        return confidenceInterval(data, confidenceLevel, tCritical);
+    }
 
-        size_t totalN = 0;
-        double grandSum = 0.0;
+    /**
+     * Perform one-way ANOVA from per-group summaries.
+     * Layman: Test if several groups share the same average, given each group's count, mean
+     * and spread.
+     * Technical: SS_between = sum n_g (mean_g - grand mean)^2, SS_within = sum M2_g over the
+     * non-empty groups; F = (SS_between / (k - 1)) / (SS_within / (N - k)).
+     * @param groups Summary of every group; empty groups are ignored
+     * @return F-statistic, p-value from F(k - 1, N - k)
+     */
+    inline TestResult oneWayANOVA(const std::vector<GroupSummary> &groups)
+    {
+        GroupSummary total;
+        size_t k = 0;
+        double ssWithin = 0.0;
         for (const auto &group : groups)
         {
-            totalN += group.size();
-            grandSum += std::accumulate(group.begin(), group.end(), 0.0);
+            if (group.count == 0)
+                continue;
+            total.merge(group);
+            ssWithin += group.m2;
+            ++k;
         }
-        double grandMean = grandSum / totalN;
-
-        // Between-group sum of squares
+        if (k < 2)
+            throw std::invalid_argument("At least two groups required");
+        double dfBetween = static_cast<double>(k - 1);
+        double dfWithin = static_cast<double>(total.count) - static_cast<double>(k);
+        if (dfWithin <= 0)
+            throw std::invalid_argument("More observations than groups required");
         double ssBetween = 0.0;
         for (const auto &group : groups)
         {
-            double groupMean = mean(group);
-            ssBetween += group.size() * (groupMean - grandMean) * (groupMean - grandMean);
+            const double diff = group.mean - total.mean;
+            ssBetween += group.count * diff * diff;
         }
+        double f = (ssBetween / dfBetween) / (ssWithin / dfWithin);
+        return TestResult{f, ProbabilityDistributions::fSurvival(f, dfBetween, dfWithin), dfBetween, dfWithin};
+    }
 
-        // Within-group sum of squares
-        double ssWithin = 0.0;
-        for (const auto &group : groups)
+    /**
+     * Perform one-way ANOVA test.
+     * Technical: One Welford pass per group (GroupSummary), then oneWayANOVA on the summaries.
+     * @param groups Vector of groups, each group is a vector of data points
+     * @return F-statistic, p-value from F(k - 1, N - k)
+     */
+    template <typename T>
+    TestResult oneWayANOVA(const std::vector<std::vector<T>> &groups)
+    {
+        if (groups.size() < 2)
+            throw std::invalid_argument("At least two groups required");
+        std::vector<GroupSummary> summaries(groups.size());
+        for (size_t g = 0; g < groups.size(); ++g)
         {
-            double groupMean = mean(group);
-            for (const auto &val : group)
-            {
-                double diff = val - groupMean;
-                ssWithin += diff * diff;
-            }
+            if (groups[g].empty())
+                throw std::invalid_argument("Data vector is empty");
+            for (const auto &val : groups[g])
+                summaries[g].add(static_cast<double>(val));
         }
-
-        double dfBetween = static_cast<double>(k - 1);
-        double dfWithin = static_cast<double>(totalN - k);
-
-        double msBetween = ssBetween / dfBetween;
-        double msWithin = ssWithin / dfWithin;
-
-        return msBetween / msWithin;
+        return oneWayANOVA(summaries);
     }
 
     /**
      * Perform chi-square test for goodness of fit.
      * @param observed Vector of observed frequencies
      * @param expected Vector of expected frequencies
-     * @return chi-square statistic
+     * @return chi-square statistic, p-value from chi-square with (categories - 1) degrees of freedom
      */
     template <typename T>
-    double chiSquareTest(const std::vector<T> &observed, const std::vector<T> &expected)
+    TestResult chiSquareTest(const std::vector<T> &observed, const std::vector<T> &expected)
     {
         if (observed.size() != expected.size())
             throw std::invalid_argument("Observed and expected vectors must be the same size");
+        if (observed.size() < 2)
+            throw std::invalid_argument("At least two categories required");
         double chiSquare = 0.0;
         for (size_t i = 0; i < observed.size(); ++i)
         {
@@ -184,7 +474,9 @@ namespace InferentialStatistics
             double diff = static_cast<double>(observed[i]) - static_cast<double>(expected[i]);
             chiSquare += (diff * diff) / expected[i];
         }
-        return chiSquare;
+        double df = static_cast<double>(observed.size() - 1);
+        return TestResult{chiSquare, ProbabilityDistributions::chiSquareSurvival(chiSquare, df), df,
+                          std::numeric_limits<double>::quiet_NaN()};
     }
 
     /**
@@ -0,0 +1,346 @@
+#ifndef INFERENTIAL_MULTIPLE_TESTING_H
+#define INFERENTIAL_MULTIPLE_TESTING_H
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+#include <numeric>
+#include <thread>
+#include "InferentialStatistics.h"
+#include "../ProbabilityDistributionsLib/Parallel.h"
+
+namespace InferentialStatistics
+{
+    /**
+     * Multiple-comparison correction of p-values.
+     * Layman: When you run many tests some will look significant by luck; corrections
+     * raise the p-values to account for how many tests were run.
+     * Technical: Holm controls the family-wise error rate (step-down Bonferroni);
+     * BenjaminiHochberg controls the false discovery rate (step-up) for independent or
+     * positively dependent tests.
+     */
+    enum class Correction
+    {
+        None,
+        Holm,
+        BenjaminiHochberg
+    };
+
+    /**
+     * Settings of the batched tests.
+     * Layman: Which correction to apply, the significance level, and the test direction.
+     * Technical: Tests with adjusted p-value <= alpha count as rejected. numThreads = 0 uses
+     * the hardware concurrency for the summarizing pass.
+     */
+    struct MultipleTestingOptions
+    {
+        MultipleTestingOptions(Correction correction = Correction::BenjaminiHochberg, double alpha = 0.05)
+            : correction(correction), alpha(alpha), alternative(Alternative::TwoSided), numThreads(0) {}
+        Correction correction;
+        double alpha;
+        Alternative alternative;
+        size_t numThreads;
+    };
+
+    /**
+     * Outcome of a batch of tests.
+     * Layman: Every test's score and p-value, the p-values corrected for running many tests,
+     * and how many tests remain significant.
+     * Technical: tests[c * numGroups + g] is the test of column c in group g, as is
+     * adjustedPValues. NaN p-values (groups too small to test) stay NaN and are not counted
+     * in the number of tests m used by the correction.
+     */
+    struct MultipleTestResult
+    {
+        std::vector<TestResult> tests;
+        std::vector<double> adjustedPValues;
+        size_t rejected;
+    };
+
+    /**
+     * Adjust p-values for multiple comparisons.
+     * Layman: Make p-values from many simultaneous tests safe to compare against a single
+     * significance level.
+     * Technical: With p(1) <= ... <= p(m) sorted, Holm gives max over j <= i of
+     * min(1, (m - j + 1) p(j)) and Benjamini-Hochberg gives min over j >= i of
+     * min(1, m p(j) / j). NaN entries are skipped and returned as NaN. O(m log m).
+     * @param pValues Unadjusted p-values in any order
+     * @return Adjusted p-values in the same order
+     */
+    inline std::vector<double> adjustPValues(const std::vector<double> &pValues, Correction correction)
+    {
+        std::vector<double> adjusted(pValues);
+        if (correction == Correction::None)
+            return adjusted;
+        std::vector<size_t> order;
+        order.reserve(pValues.size());
+        for (size_t i = 0; i < pValues.size(); ++i)
+        {
+            if (!std::isnan(pValues[i]))
+                order.push_back(i);
+        }
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return pValues[a] < pValues[b]; });
+        const double m = static_cast<double>(order.size());
+        if (correction == Correction::Holm)
+        {
+            double running = 0.0;
+            for (size_t j = 0; j < order.size(); ++j)
+            {
+                running = std::max(running, std::min(1.0, (m - j) * pValues[order[j]]));
+                adjusted[order[j]] = running;
+            }
+        }
+        else
+        {
+            double running = 1.0;
+            for (size_t j = order.size(); j-- > 0;)
+            {
+                running = std::min(running, m * pValues[order[j]] / (j + 1));
+                adjusted[order[j]] = running;
+            }
+        }
+        return adjusted;
+    }
+
+    namespace detail
+    {
+        /**
+         * Summaries of every (column, cell) in one parallel pass over the rows.
+         * Layman: The shared engine behind grouped tests and ANOVA.
+         * Technical: Rows are split into one contiguous range per thread. Each thread walks its
+         * rows in blocks of 4096, resolving cellOf(i) once per row into a block buffer that
+         * stays in cache across the columns, and keeps per-(column, cell) sums shifted by the
+         * first value it saw, which keeps the one-pass variance accurate. Thread summaries
+         * are then merged exactly. cellOf returns numCells or more for an invalid row, which
+         * throws; any exception (from cellOf too) is rethrown once every thread has joined.
+         * @return Summaries indexed column * numCells + cell
+         */
+        template <typename CellOf>
+        std::vector<GroupSummary> summarizeCells(const std::vector<const double *> &columns, size_t rows, size_t numCells,
+                                                 CellOf cellOf, size_t numThreads)
+        {
+            if (numCells == 0)
+                throw std::invalid_argument("At least one group required");
+            struct Accumulator
+            {
+                double shift;
+                double sum;
+                double sumSq;
+                uint64_t count;
+            };
+            const size_t total = columns.size() * numCells;
+            const size_t block = 4096;
+            if (numThreads == 0)
+                numThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+            numThreads = std::max<size_t>(1, std::min(numThreads, (rows + block - 1) / block));
+            std::vector<std::vector<GroupSummary>> partial(numThreads);
+            auto work = [&](size_t w)
+            {
+                std::vector<Accumulator> acc(total, Accumulator{0.0, 0.0, 0.0, 0});
+                std::vector<size_t> cells(block);
+                const size_t first = w * rows / numThreads, last = (w + 1) * rows / numThreads;
+                for (size_t begin = first; begin < last; begin += block)
+                {
+                    const size_t end = std::min(last, begin + block);
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        const size_t cell = static_cast<size_t>(cellOf(i));
+                        if (cell >= numCells)
+                            throw std::invalid_argument("Group id out of range");
+                        cells[i - begin] = cell;
+                    }
+                    for (size_t c = 0; c < columns.size(); ++c)
+                    {
+                        const double *x = columns[c];
+                        Accumulator *column = acc.data() + c * numCells;
+                        for (size_t i = begin; i < end; ++i)
+                        {
+                            Accumulator &a = column[cells[i - begin]];
+                            if (a.count == 0)
+                                a.shift = x[i];
+                            const double d = x[i] - a.shift;
+                            a.sum += d;
+                            a.sumSq += d * d;
+                            ++a.count;
+                        }
+                    }
+                }
+                std::vector<GroupSummary> &out = partial[w];
+                out.resize(total);
+                for (size_t k = 0; k < total; ++k)
+                {
+                    const Accumulator &a = acc[k];
+                    if (a.count == 0)
+                        continue;
+                    const double meanShift = a.sum / a.count;
+                    out[k] = GroupSummary(a.count, a.shift + meanShift, std::max(0.0, a.sumSq - a.sum * meanShift));
+                }
+            };
+            ProbabilityDistributions::detail::parallelFor(numThreads, numThreads, work); // rethrows after the join
+            std::vector<GroupSummary> summaries(total);
+            for (const auto &part : partial)
+            {
+                for (size_t k = 0; k < part.size(); ++k)
+                    summaries[k].merge(part[k]);
+            }
+            return summaries;
+        }
+    }
+
+    /**
+     * Summarize grouped columns in one parallel pass.
+     * Layman: For every metric and every segment, collect the count, mean and spread needed
+     * by t-tests and z-tests, reading the data only once.
+     * Technical: detail::summarizeCells with the group id of each row as its cell.
+     * @param columns Metric columns, each with one value per row
+     * @param groups Group id of every row, each below numGroups
+     * @return Summaries indexed c * numGroups + g
+     */
+    inline std::vector<GroupSummary> summarizeGroups(const std::vector<const double *> &columns, const uint32_t *groups,
+                                                     size_t rows, size_t numGroups, size_t numThreads = 0)
+    {
+        return detail::summarizeCells(columns, rows, numGroups, [groups](size_t i) { return groups[i]; }, numThreads);
+    }
+
+    inline std::vector<GroupSummary> summarizeGroups(const std::vector<std::vector<double>> &columns,
+                                                     const std::vector<uint32_t> &groups, size_t numGroups,
+                                                     size_t numThreads = 0)
+    {
+        std::vector<const double *> pointers;
+        for (const auto &column : columns)
+        {
+            if (column.size() != groups.size())
+                throw std::invalid_argument("Every column needs one value per row");
+            pointers.push_back(column.data());
+        }
+        return summarizeGroups(pointers, groups.data(), groups.size(), numGroups, numThreads);
+    }
+
+    /**
+     * One-sample t-test from a group summary.
+     * Layman: The same t-test as tTest(data, mu), without needing the data again.
+     * Technical: t = (mean - mu) / (s / sqrt(n)) with n - 1 degrees of freedom; NaN
+     * statistic and p-value below two observations or with zero variance.
+     */
+    inline TestResult tTest(const GroupSummary &summary, double mu, Alternative alternative = Alternative::TwoSided)
+    {
+        const double none = std::numeric_limits<double>::quiet_NaN();
+        const double df = static_cast<double>(summary.count) - 1;
+        const double s = summary.standardDeviation();
+        if (summary.count < 2 || !(s > 0))
+            return TestResult{none, none, df, none};
+        const double t = (summary.mean - mu) / (s / std::sqrt(static_cast<double>(summary.count)));
+        const double p = detail::pValue(ProbabilityDistributions::studentTCDF(t, df),
+                                        ProbabilityDistributions::studentTSurvival(t, df), alternative);
+        return TestResult{t, p, df, none};
+    }
+
+    /**
+     * One-sample z-test from a group summary.
+     * Layman: The same z-test as zTest(data, mu, sigma), without needing the data again.
+     * Technical: z = (mean - mu) / (sigma / sqrt(n)); NaN statistic and p-value for an
+     * empty group.
+     */
+    inline TestResult zTest(const GroupSummary &summary, double mu, double sigma,
+                            Alternative alternative = Alternative::TwoSided)
+    {
+        if (sigma <= 0)
+            throw std::invalid_argument("Standard deviation must be positive");
+        const double none = std::numeric_limits<double>::quiet_NaN();
+        if (summary.count == 0)
+            return TestResult{none, none, none, none};
+        const double z = (summary.mean - mu) / (sigma / std::sqrt(static_cast<double>(summary.count)));
+        const double p = detail::pValue(ProbabilityDistributions::normalCDF(z, 0.0, 1.0),
+                                        ProbabilityDistributions::normalSurvival(z, 0.0, 1.0), alternative);
+        return TestResult{z, p, none, none};
+    }
+
+    /**
+     * Welch's two-sample t-test from group summaries.
+     * Layman: The same test as welchTTest(x, y), without needing the data again.
+     * Technical: See welchTTest; NaN statistic and p-value when a group has fewer than two
+     * observations or both variances are zero.
+     */
+    inline TestResult welchTTest(const GroupSummary &x, const GroupSummary &y, Alternative alternative = Alternative::TwoSided)
+    {
+        const double none = std::numeric_limits<double>::quiet_NaN();
+        if (x.count < 2 || y.count < 2 || !(x.m2 + y.m2 > 0))
+            return TestResult{none, none, none, none};
+        return detail::welch(x.mean, x.variance(), static_cast<double>(x.count),
+                             y.mean, y.variance(), static_cast<double>(y.count), alternative);
+    }
+
+    namespace detail
+    {
+        inline MultipleTestResult correctTests(std::vector<TestResult> tests, const MultipleTestingOptions &options)
+        {
+            if (!(options.alpha > 0 && options.alpha < 1))
+                throw std::invalid_argument("Significance level must be between 0 and 1");
+            std::vector<double> pValues(tests.size());
+            for (size_t i = 0; i < tests.size(); ++i)
+                pValues[i] = tests[i].pValue;
+            MultipleTestResult result;
+            result.adjustedPValues = adjustPValues(pValues, options.correction);
+            result.rejected = 0;
+            for (double p : result.adjustedPValues)
+                result.rejected += p <= options.alpha;
+            result.tests = std::move(tests);
+            return result;
+        }
+
+        inline void checkPerColumn(const std::vector<double> &values, size_t columns)
+        {
+            if (values.size() != columns)
+                throw std::invalid_argument("One hypothesized value per column required");
+        }
+    }
+
+    /**
+     * One-sample t-tests of every column in every group, with multiple-testing correction.
+     * Layman: Test thousands of metric-by-segment means against their targets at once and
+     * find out which differences survive correcting for the number of tests.
+     * Technical: One summarizeGroups pass, then tTest(summary, mu[c]) per cell and
+     * adjustPValues over all cells.
+     * @param columns Metric columns, each with one value per row
+     * @param groups Group (segment) id of every row
+     * @param mu Hypothesized mean of every column
+     * @return Tests and adjusted p-values indexed c * numGroups + g
+     */
+    inline MultipleTestResult batchTTest(const std::vector<std::vector<double>> &columns, const std::vector<uint32_t> &groups,
+                                         size_t numGroups, const std::vector<double> &mu,
+                                         const MultipleTestingOptions &options = MultipleTestingOptions())
+    {
+        detail::checkPerColumn(mu, columns.size());
+        const std::vector<GroupSummary> summaries = summarizeGroups(columns, groups, numGroups, options.numThreads);
+        std::vector<TestResult> tests(summaries.size());
+        for (size_t k = 0; k < summaries.size(); ++k)
+            tests[k] = tTest(summaries[k], mu[k / numGroups], options.alternative);
+        return detail::correctTests(std::move(tests), options);
+    }
+
+    /**
+     * One-sample z-tests of every column in every group, with multiple-testing correction.
+     * Layman: Like batchTTest when each metric's population standard deviation is known.
+     * Technical: One summarizeGroups pass, then zTest(summary, mu[c], sigma[c]) per cell and
+     * adjustPValues over all cells.
+     * @param sigma Known population standard deviation of every column
+     * @return Tests and adjusted p-values indexed c * numGroups + g
+     */
+    inline MultipleTestResult batchZTest(const std::vector<std::vector<double>> &columns, const std::vector<uint32_t> &groups,
+                                         size_t numGroups, const std::vector<double> &mu, const std::vector<double> &sigma,
+                                         const MultipleTestingOptions &options = MultipleTestingOptions())
+    {
+        detail::checkPerColumn(mu, columns.size());
+        detail::checkPerColumn(sigma, columns.size());
+        const std::vector<GroupSummary> summaries = summarizeGroups(columns, groups, numGroups, options.numThreads);
+        std::vector<TestResult> tests(summaries.size());
+        for (size_t k = 0; k < summaries.size(); ++k)
+            tests[k] = zTest(summaries[k], mu[k / numGroups], sigma[k / numGroups], options.alternative);
+        return detail::correctTests(std::move(tests), options);
+    }
+}
+
+#endif // INFERENTIAL_MULTIPLE_TESTING_H
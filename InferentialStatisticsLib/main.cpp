@@ -1,6 +1,12 @@
 #include <iostream>
 #include <vector>
+#include <string>
 #include "InferentialStatistics.h"
+#include "Bootstrap.h"
+#include "MultipleTesting.h"
+#include "SequentialTesting.h"
+#include "ANOVA.h"
+#include "ContingencyTables.h"
 #include "../matplotlib-cpp/matplotlibcpp.h"
 #include <iostream>
 #include <vector>
@@ -24,23 +30,34 @@ int main()
 
     try
     {
-        double t_stat = InferentialStatistics::tTest(sampleData, hypothesizedMean);
-        std::cout << "One-sample t-test statistic: " << t_stat << std::endl;
+        auto t_test = InferentialStatistics::tTest(sampleData, hypothesizedMean);
+        std::cout << "One-sample t-test statistic: " << t_test.statistic << ", p-value: " << t_test.pValue << std::endl;
 
         double sigma = 0.5; // assumed known population std dev for z-test
-        double z_stat = InferentialStatistics::zTest(sampleData, hypothesizedMean, sigma);
-        std::cout << "One-sample z-test statistic: " << z_stat << std::endl;
+        auto z_test = InferentialStatistics::zTest(sampleData, hypothesizedMean, sigma);
+        std::cout << "One-sample z-test statistic: " << z_test.statistic << ", p-value: " << z_test.pValue << std::endl;
 
-        double tCritical = 2.447; // example critical t-value for 95% confidence, df=6
-        auto ci = InferentialStatistics::confidenceInterval(sampleData, 0.95, tCritical);
+        std::vector<double> otherData = {2.9, 3.1, 2.8, 3.3, 3.0, 2.7};
+        auto welch = InferentialStatistics::welchTTest(sampleData, otherData);
+        std::cout << "Welch two-sample t-test statistic: " << welch.statistic << ", df: " << welch.degreesOfFreedom
+                  << ", p-value: " << welch.pValue << std::endl;
+
+        std::vector<double> after = {2.5, 2.6, 2.4, 2.9, 2.5, 3.0, 2.3};
+        auto paired = InferentialStatistics::pairedTTest(after, sampleData);
+        std::cout << "Paired t-test statistic: " << paired.statistic << ", p-value: " << paired.pValue << std::endl;
+
+        auto mannWhitney = InferentialStatistics::mannWhitneyU(sampleData, otherData);
+        std::cout << "Mann-Whitney U: " << mannWhitney.statistic << ", p-value: " << mannWhitney.pValue << std::endl;
+
+        auto ci = InferentialStatistics::confidenceInterval(sampleData, 0.95); // t critical value derived internally
         std::cout << "95% Confidence Interval for mean: [" << ci.first << ", " << ci.second << "]" << std::endl;
 
         std::vector<std::vector<double>> groups = {
             {2.3, 2.5, 2.1},
             {2.6, 2.4, 2.7},
             {2.2, 2.8, 2.9}};
-        double f_stat = InferentialStatistics::oneWayANOVA(groups);
-        std::cout << "One-way ANOVA F-statistic: " << f_stat << std::endl;
+        auto anova = InferentialStatistics::oneWayANOVA(groups);
+        std::cout << "One-way ANOVA F-statistic: " << anova.statistic << ", p-value: " << anova.pValue << std::endl;
     }
     catch (const std::exception &ex)
     {
@@ -52,8 +69,8 @@ int main()
         // Chi-square test example
         std::vector<int> observed = {50, 30, 20};
         std::vector<int> expected = {40, 40, 20};
-        double chiSquare = InferentialStatistics::chiSquareTest(observed, expected);
-        std::cout << "Chi-square test statistic: " << chiSquare << std::endl;
+        auto chiSquare = InferentialStatistics::chiSquareTest(observed, expected);
+        std::cout << "Chi-square test statistic: " << chiSquare.statistic << ", p-value: " << chiSquare.pValue << std::endl;
 
         // Linear regression example
         std::vector<double> x = {1, 2, 3, 4, 5};
@@ -71,9 +88,94 @@ int main()
         std::cerr << "Error: " << ex.what() << std::endl;
     }
 
+    try
+    {
+        // Bootstrap and permutation test examples
+        InferentialStatistics::ResamplingOptions options(10000, 42);
+        auto medianCI = InferentialStatistics::bootstrap(sampleData, InferentialStatistics::SampleMedian(), options);
+        std::cout << "Bootstrap median: " << medianCI.estimate << ", standard error: " << medianCI.standardError
+                  << ", 95% CI: [" << medianCI.lower << ", " << medianCI.upper << "]" << std::endl;
+
+        std::vector<double> control = {2.3, 2.5, 2.1, 2.4, 2.2};
+        std::vector<double> treatment = {2.6, 2.8, 2.7, 2.9, 2.5};
+        auto permutation = InferentialStatistics::permutationTest(treatment, control, InferentialStatistics::SampleMean(),
+                                                                  InferentialStatistics::Alternative::TwoSided, options);
+        std::cout << "Permutation test difference of means: " << permutation.statistic << ", p-value: " << permutation.pValue << std::endl;
+    }
+    catch (const std::exception &ex)
+    {
+        std::cerr << "Error: " << ex.what() << std::endl;
+    }
+
+    try
+    {
+        // Batched one-sample t-tests: two metrics across three segments, Benjamini-Hochberg corrected
+        std::vector<std::vector<double>> metrics = {
+            {0.2, 0.4, 0.1, 0.3, 0.5, 0.2, 1.1, 0.9, 1.3},
+            {-0.1, 0.1, 0.0, 0.2, -0.2, 0.1, 0.0, 0.1, -0.1}};
+        std::vector<uint32_t> segments = {0, 0, 0, 1, 1, 1, 2, 2, 2};
+        auto batch = InferentialStatistics::batchTTest(metrics, segments, 3, {0.0, 0.0});
+        for (size_t k = 0; k < batch.tests.size(); ++k)
+        {
+            std::cout << "Metric " << k / 3 << ", segment " << k % 3 << ": t = " << batch.tests[k].statistic
+                      << ", p-value: " << batch.tests[k].pValue << ", BH-adjusted: " << batch.adjustedPValues[k] << std::endl;
+        }
+        std::cout << "Significant after correction: " << batch.rejected << " of " << batch.tests.size() << std::endl;
+    }
+    catch (const std::exception &ex)
+    {
+        std::cerr << "Error: " << ex.what() << std::endl;
+    }
+
+    try
+    {
+        // Two-way ANOVA straight from (factor, factor, value) columns
+        std::vector<double> yield = {4.1, 4.3, 5.0, 5.2, 4.4, 4.6, 6.1, 6.3, 4.0, 4.2, 5.5, 5.9};
+        std::vector<uint32_t> fertilizer = {0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1};
+        std::vector<uint32_t> field = {0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2};
+        auto table = InferentialStatistics::twoWayANOVA(yield, fertilizer, 2, field, 3);
+        const char *names[] = {"Fertilizer", "Field", "Fertilizer x Field"};
+        for (size_t e = 0; e < table.effects.size(); ++e)
+        {
+            std::cout << names[e] << ": SS = " << table.effects[e].sumOfSquares << ", F = " << table.effects[e].test.statistic
+                      << ", p-value: " << table.effects[e].test.pValue << std::endl;
+        }
+    }
+    catch (const std::exception &ex)
+    {
+        std::cerr << "Error: " << ex.what() << std::endl;
+    }
+
+    try
+    {
+        // Independence of two categorical columns via a sparse contingency table
+        std::vector<std::string> device = {"mobile", "desktop", "mobile", "tablet", "desktop", "mobile",
+                                           "mobile", "desktop", "tablet", "mobile", "desktop", "mobile"};
+        std::vector<int> converted = {0, 1, 0, 0, 1, 1, 0, 1, 0, 0, 1, 0};
+        auto crossTab = InferentialStatistics::contingencyTable(device, converted);
+        auto chi = InferentialStatistics::chiSquareIndependence(crossTab);
+        auto g = InferentialStatistics::gTestIndependence(crossTab);
+        std::cout << "Chi-square: " << chi.statistic << ", p-value: " << chi.pValue << "; G: " << g.statistic
+                  << ", p-value: " << g.pValue << "; Cramer's V: " << InferentialStatistics::cramersV(crossTab) << std::endl;
+    }
+    catch (const std::exception &ex)
+    {
+        std::cerr << "Error: " << ex.what() << std::endl;
+    }
+
+    // Always-valid A/B test fed one event at a time
+    {
+        InferentialStatistics::MixtureSPRT abTest(0.5);
+        for (int i = 0; i < 200; ++i)
+        {
+            abTest.addControl(2.0 + 0.3 * std::sin(i * 0.7));
+            abTest.addTreatment(2.4 + 0.3 * std::cos(i * 1.3));
+        }
+        std::cout << "mSPRT difference: " << abTest.difference() << ", always-valid p-value: " << abTest.pValue() << std::endl;
+    }
+
     // Calculate confidence interval for plotting
-    double tCritical = 2.447; // example critical t-value for 95% confidence, df=6
-    auto ci = InferentialStatistics::confidenceInterval(sampleData, 0.95, tCritical);
+    auto ci = InferentialStatistics::confidenceInterval(sampleData, 0.95);
 
     // Visualization using matplotlib-cpp
     namespace plt = matplotlibcpp;
@@ -0,0 +1,65 @@
+#ifndef PROBABILITY_PARALLEL_H
+#define PROBABILITY_PARALLEL_H
+
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <exception>
+
+namespace ProbabilityDistributions
+{
+    namespace detail
+    {
+        // Run fn(i) for i in [0, count) on up to numThreads workers (0 = hardware concurrency).
+        // Work is handed out through an atomic counter so uneven items balance themselves. If fn
+        // throws, no further items are started and the first exception is rethrown after the join.
+        // Shared by every library that runs work on threads.
+        template <typename Func>
+        void parallelFor(size_t count, size_t numThreads, Func fn)
+        {
+            if (numThreads == 0)
+                numThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+            numThreads = std::min(numThreads, count);
+            if (numThreads <= 1)
+            {
+                for (size_t i = 0; i < count; ++i)
+                    fn(i);
+                return;
+            }
+            std::atomic<size_t> next(0);
+            std::vector<std::exception_ptr> errors(numThreads);
+            auto work = [&](size_t t)
+            {
+                try
+                {
+                    for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1))
+                        fn(i);
+                }
+                catch (...)
+                {
+                    errors[t] = std::current_exception();
+                    next.store(count); // hand out no more items
+                }
+            };
+            std::vector<std::thread> workers;
+            try
+            {
+                for (size_t t = 1; t < numThreads; ++t)
+                    workers.emplace_back(work, t);
+            }
+            catch (...)
+            {
+                // A thread could not be started: the caller's thread does the rest
+            }
+            work(0);
+            for (auto &w : workers)
+                w.join();
+            for (const auto &e : errors)
+                if (e)
+                    std::rethrow_exception(e);
+        }
+    }
+}
+
+#endif // PROBABILITY_PARALLEL_H
@@ -0,0 +1,612 @@
+#ifndef PROBABILITY_SAMPLERS_H
+#define PROBABILITY_SAMPLERS_H
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+#include <thread>
+#include "ProbabilityDistributions.h"
+#include "Parallel.h"
+
+namespace ProbabilityDistributions
+{
+    /**
+     * xoshiro256++ pseudo-random number generator.
+     * Layman: A very fast source of random bits that can be split into independent streams.
+     * Technical: 256-bit state, period 2^256 - 1, seeded through SplitMix64. Meets the
+     * UniformRandomBitGenerator requirements, so it also drives <random> distributions.
+     * jump() advances the state by 2^128 draws and longJump() by 2^192, so stream k of a
+     * seed (k jumps) never overlaps any other stream in practice.
+     */
+    class Xoshiro256
+    {
+    public:
+        typedef uint64_t result_type;
+
+        explicit Xoshiro256(uint64_t seed = 0x9E3779B97F4A7C15ULL) { this->seed(seed); }
+
+        // Stream `stream` of `seed`: the seeded state advanced by `stream` jumps
+        Xoshiro256(uint64_t seed, uint64_t stream)
+        {
+            this->seed(seed);
+            for (uint64_t i = 0; i < stream; ++i)
+                jump();
+        }
+
+        void seed(uint64_t seed)
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+                s_[i] = z ^ (z >> 31);
+            }
+        }
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<uint64_t>::max(); }
+
+        result_type operator()()
+        {
+            const uint64_t result = rotl(s_[0] + s_[3], 23) + s_[0];
+            const uint64_t t = s_[1] << 17;
+            s_[2] ^= s_[0];
+            s_[3] ^= s_[1];
+            s_[1] ^= s_[2];
+            s_[0] ^= s_[3];
+            s_[2] ^= t;
+            s_[3] = rotl(s_[3], 45);
+            return result;
+        }
+
+        void jump()
+        {
+            static const uint64_t poly[4] = {0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL,
+                                             0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL};
+            advance(poly);
+        }
+
+        void longJump()
+        {
+            static const uint64_t poly[4] = {0x76E15D3EFEFDCBBFULL, 0xC5004E441C522FB3ULL,
+                                             0x77710069854EE241ULL, 0x39109BB02ACBE635ULL};
+            advance(poly);
+        }
+
+    private:
+        static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+        void advance(const uint64_t poly[4])
+        {
+            uint64_t s[4] = {0, 0, 0, 0};
+            for (int i = 0; i < 4; ++i)
+                for (int b = 0; b < 64; ++b)
+                {
+                    if (poly[i] & (1ULL << b))
+                        for (int j = 0; j < 4; ++j)
+                            s[j] ^= s_[j];
+                    (*this)();
+                }
+            for (int j = 0; j < 4; ++j)
+                s_[j] = s[j];
+        }
+
+        uint64_t s_[4];
+    };
+
+    namespace detail
+    {
+        template <typename RNG>
+        void requireFullWidth()
+        {
+            static_assert(RNG::min() == 0 && RNG::max() == std::numeric_limits<uint64_t>::max(),
+                          "Samplers need a generator producing 64 uniform bits (e.g. Xoshiro256, std::mt19937_64)");
+        }
+
+        // Uniform double in [0, 1) from the top 53 bits of a draw
+        inline double unitInterval(uint64_t bits) { return static_cast<double>(bits >> 11) * (1.0 / 9007199254740992.0); }
+
+        // Uniform double in (0, 1], safe to take the log of
+        inline double unitIntervalOpen(uint64_t bits) { return static_cast<double>((bits >> 11) + 1) * (1.0 / 9007199254740992.0); }
+
+        /**
+         * Ziggurat tables for a monotone density f on [0, inf).
+         * Layman: Precomputed stacked rectangles covering the density curve.
+         * Technical: 256 layers of equal area v; x[0] = v / f(r) is the virtual width of the
+         * base layer (rectangle plus tail), x[1] = r, x[256] = 0 and f[i] = f(x[i]).
+         */
+        struct ZigguratTables
+        {
+            double x[257];
+            double f[257];
+        };
+
+        inline const ZigguratTables &normalZiggurat()
+        {
+            static const ZigguratTables tables = []()
+            {
+                ZigguratTables z;
+                const double r = 3.6541528853610088, v = 0.00492867323399;
+                z.x[0] = v / std::exp(-0.5 * r * r);
+                z.x[1] = r;
+                for (int i = 2; i < 256; ++i)
+                    z.x[i] = std::sqrt(-2.0 * std::log(v / z.x[i - 1] + std::exp(-0.5 * z.x[i - 1] * z.x[i - 1])));
+                z.x[256] = 0.0;
+                for (int i = 0; i <= 256; ++i)
+                    z.f[i] = std::exp(-0.5 * z.x[i] * z.x[i]);
+                return z;
+            }();
+            return tables;
+        }
+
+        inline const ZigguratTables &exponentialZiggurat()
+        {
+            static const ZigguratTables tables = []()
+            {
+                ZigguratTables z;
+                const double r = 7.69711747013104972, v = 0.0039496598225815571993;
+                z.x[0] = v / std::exp(-r);
+                z.x[1] = r;
+                for (int i = 2; i < 256; ++i)
+                    z.x[i] = -std::log(v / z.x[i - 1] + std::exp(-z.x[i - 1]));
+                z.x[256] = 0.0;
+                for (int i = 0; i <= 256; ++i)
+                    z.f[i] = std::exp(-z.x[i]);
+                return z;
+            }();
+            return tables;
+        }
+
+        /**
+         * Standard normal variate by the ziggurat method (Marsaglia and Tsang).
+         * Layman: Draw a bell-curve value using mostly one random number and one comparison.
+         * Technical: One 64-bit draw supplies the layer (low 8 bits) and a signed 53-bit
+         * abscissa; about 99% of draws return from the rectangle test, the rest go through
+         * the wedge test or Marsaglia's tail algorithm beyond r.
+         */
+        template <typename RNG>
+        double standardNormal(RNG &rng)
+        {
+            const ZigguratTables &z = normalZiggurat();
+            for (;;)
+            {
+                const uint64_t bits = rng();
+                const int i = static_cast<int>(bits & 0xFF);
+                const double u = static_cast<double>(static_cast<int64_t>(bits) >> 11) * (1.0 / 4503599627370496.0);
+                const double x = u * z.x[i];
+                if (std::abs(x) < z.x[i + 1])
+                    return x;
+                if (i == 0)
+                {
+                    const double r = z.x[1];
+                    double a, b;
+                    do
+                    {
+                        a = -std::log(unitIntervalOpen(rng())) / r;
+                        b = -std::log(unitIntervalOpen(rng()));
+                    } while (b + b < a * a);
+                    return u < 0 ? -(r + a) : r + a;
+                }
+                if (z.f[i] + (z.f[i + 1] - z.f[i]) * unitInterval(rng()) < std::exp(-0.5 * x * x))
+                    return x;
+            }
+        }
+
+        /**
+         * Standard exponential variate by the ziggurat method.
+         * Layman: Draw a waiting time using mostly one random number and one comparison.
+         * Technical: As standardNormal with f(x) = exp(-x); the tail beyond r is r plus a
+         * fresh exponential variate (memorylessness).
+         */
+        template <typename RNG>
+        double standardExponential(RNG &rng)
+        {
+            const ZigguratTables &z = exponentialZiggurat();
+            double offset = 0.0;
+            for (;;)
+            {
+                const uint64_t bits = rng();
+                const int i = static_cast<int>(bits & 0xFF);
+                const double x = unitInterval(bits) * z.x[i];
+                if (x < z.x[i + 1])
+                    return offset + x;
+                if (i == 0)
+                {
+                    offset += z.x[1];
+                    continue;
+                }
+                if (z.f[i] + (z.f[i + 1] - z.f[i]) * unitInterval(rng()) < std::exp(-x))
+                    return offset + x;
+            }
+        }
+    }
+
+    /**
+     * Normal random variates.
+     * Layman: Generate bell-curve distributed random numbers.
+     * Technical: mean + stddev * ziggurat standard normal; works with any 64-bit generator.
+     */
+    class NormalSampler
+    {
+    public:
+        NormalSampler(double mean = 0.0, double stddev = 1.0)
+            : mean_(mean), stddev_(stddev)
+        {
+            if (stddev <= 0)
+                throw std::invalid_argument("Standard deviation must be positive");
+        }
+
+        template <typename RNG>
+        double operator()(RNG &rng) const
+        {
+            detail::requireFullWidth<RNG>();
+            return mean_ + stddev_ * detail::standardNormal(rng);
+        }
+
+        template <typename RNG>
+        void fill(RNG &rng, double *out, size_t n) const
+        {
+            detail::requireFullWidth<RNG>();
+            for (size_t i = 0; i < n; ++i)
+                out[i] = mean_ + stddev_ * detail::standardNormal(rng);
+        }
+
+    private:
+        double mean_;
+        double stddev_;
+    };
+
+    /**
+     * Exponential random variates.
+     * Layman: Generate random waiting times for events occurring at a given rate.
+     * Technical: Ziggurat standard exponential divided by lambda.
+     */
+    class ExponentialSampler
+    {
+    public:
+        explicit ExponentialSampler(double lambda)
+            : invLambda_(1.0 / lambda)
+        {
+            if (lambda <= 0)
+                throw std::invalid_argument("Lambda must be positive");
+        }
+
+        template <typename RNG>
+        double operator()(RNG &rng) const
+        {
+            detail::requireFullWidth<RNG>();
+            return invLambda_ * detail::standardExponential(rng);
+        }
+
+        template <typename RNG>
+        void fill(RNG &rng, double *out, size_t n) const
+        {
+            detail::requireFullWidth<RNG>();
+            for (size_t i = 0; i < n; ++i)
+                out[i] = invLambda_ * detail::standardExponential(rng);
+        }
+
+    private:
+        double invLambda_;
+    };
+
+    /**
+     * Poisson random variates.
+     * Layman: Generate random event counts for a given average rate.
+     * Technical: Inversion by sequential search for lambda < 10 (one uniform per draw);
+     * Hormann's PTRS transformed rejection with squeeze otherwise, which needs about 1.1
+     * uniform pairs per draw independent of lambda.
+     */
+    class PoissonSampler
+    {
+    public:
+        explicit PoissonSampler(double lambda)
+            : lambda_(lambda)
+        {
+            if (lambda <= 0)
+                throw std::invalid_argument("Lambda must be positive");
+            expNegLambda_ = std::exp(-lambda);
+            logLambda_ = std::log(lambda);
+            b_ = 0.931 + 2.53 * std::sqrt(lambda);
+            a_ = -0.059 + 0.02483 * b_;
+            logInvAlpha_ = std::log(1.1239 + 1.1328 / (b_ - 3.4));
+            vr_ = 0.9277 - 3.6224 / (b_ - 2.0);
+        }
+
+        template <typename RNG>
+        int operator()(RNG &rng) const
+        {
+            detail::requireFullWidth<RNG>();
+            if (lambda_ < 10.0)
+            {
+                const double u = detail::unitInterval(rng());
+                int k = 0;
+                double p = expNegLambda_, cdf = p;
+                while (u > cdf && p > 0.0)
+                {
+                    ++k;
+                    p *= lambda_ / k;
+                    cdf += p;
+                }
+                return k;
+            }
+            for (;;)
+            {
+                const double u = detail::unitInterval(rng()) - 0.5;
+                const double v = detail::unitIntervalOpen(rng());
+                const double us = 0.5 - std::abs(u);
+                const double k = std::floor((2.0 * a_ / us + b_) * u + lambda_ + 0.43);
+                if (us >= 0.07 && v <= vr_)
+                    return static_cast<int>(k);
+                if (k < 0 || (us < 0.013 && v > us))
+                    continue;
+                if (std::log(v) + logInvAlpha_ - std::log(a_ / (us * us) + b_) <=
+                    -lambda_ + k * logLambda_ - detail::logFactorial(static_cast<long long>(k)))
+                    return static_cast<int>(k);
+            }
+        }
+
+        template <typename RNG>
+        void fill(RNG &rng, int *out, size_t n) const
+        {
+            for (size_t i = 0; i < n; ++i)
+                out[i] = (*this)(rng);
+        }
+
+    private:
+        double lambda_;
+        double expNegLambda_;
+        double logLambda_;
+        double a_;
+        double b_;
+        double logInvAlpha_;
+        double vr_;
+    };
+
+    /**
+     * Binomial random variates.
+     * Layman: Generate random success counts out of n trials.
+     * Technical: Works with p' = min(p, 1 - p) and reflects. Inversion by sequential
+     * search when n p' < 10; otherwise Hormann's BTRS transformed rejection with squeeze,
+     * whose cost per draw does not grow with n.
+     */
+    class BinomialSampler
+    {
+    public:
+        BinomialSampler(int n, double p)
+            : n_(n)
+        {
+            if (n < 0)
+                throw std::invalid_argument("Number of trials must be non-negative");
+            if (p < 0 || p > 1)
+                throw std::invalid_argument("Probability p must be between 0 and 1");
+            flip_ = p > 0.5;
+            p_ = flip_ ? 1.0 - p : p;
+            const double q = 1.0 - p_;
+            inversion_ = n * p_ < 10.0;
+            ratio_ = p_ / q;
+            if (inversion_)
+            {
+                q0_ = std::pow(q, n);
+                return;
+            }
+            const double spq = std::sqrt(n * p_ * q);
+            b_ = 1.15 + 2.53 * spq;
+            a_ = -0.0873 + 0.0248 * b_ + 0.01 * p_;
+            c_ = n * p_ + 0.5;
+            alpha_ = (2.83 + 5.1 / b_) * spq;
+            vr_ = 0.92 - 4.2 / b_;
+            mode_ = std::floor((n + 1) * p_);
+            logRatio_ = std::log(ratio_);
+            logModeWeight_ = detail::logFactorial(static_cast<long long>(mode_)) +
+                             detail::logFactorial(static_cast<long long>(n - mode_));
+        }
+
+        template <typename RNG>
+        int operator()(RNG &rng) const
+        {
+            detail::requireFullWidth<RNG>();
+            if (p_ == 0.0)
+                return flip_ ? n_ : 0;
+            const int k = inversion_ ? invert(rng) : rejection(rng);
+            return flip_ ? n_ - k : k;
+        }
+
+        template <typename RNG>
+        void fill(RNG &rng, int *out, size_t count) const
+        {
+            for (size_t i = 0; i < count; ++i)
+                out[i] = (*this)(rng);
+        }
+
+    private:
+        template <typename RNG>
+        int invert(RNG &rng) const
+        {
+            const double u = detail::unitInterval(rng());
+            int k = 0;
+            double p = q0_, cdf = p;
+            while (u > cdf && k < n_)
+            {
+                p *= ratio_ * (n_ - k) / (k + 1);
+                ++k;
+                cdf += p;
+            }
+            return k;
+        }
+
+        template <typename RNG>
+        int rejection(RNG &rng) const
+        {
+            for (;;)
+            {
+                const double u = detail::unitInterval(rng()) - 0.5;
+                double v = detail::unitIntervalOpen(rng());
+                const double us = 0.5 - std::abs(u);
+                const double k = std::floor((2.0 * a_ / us + b_) * u + c_);
+                if (us >= 0.07 && v <= vr_)
+                    return static_cast<int>(k);
+                if (k < 0 || k > n_)
+                    continue;
+                // Accept if v * alpha / (a / us^2 + b) <= f(k) / f(mode)
+                v = std::log(v * alpha_ / (a_ / (us * us) + b_));
+                const long long ki = static_cast<long long>(k);
+                const double logRatioToMode = logModeWeight_ - detail::logFactorial(ki) -
+                                              detail::logFactorial(n_ - ki) + (k - mode_) * logRatio_;
+                if (v <= logRatioToMode)
+                    return static_cast<int>(k);
+            }
+        }
+
+        int n_;
+        double p_;
+        bool flip_;
+        bool inversion_;
+        double q0_ = 0.0;
+        double ratio_;
+        double a_ = 0.0;
+        double b_ = 0.0;
+        double c_ = 0.0;
+        double alpha_ = 0.0;
+        double vr_ = 0.0;
+        double mode_ = 0.0;
+        double logRatio_ = 0.0;
+        double logModeWeight_ = 0.0;
+    };
+
+    /**
+     * Discrete sampling from arbitrary weights.
+     * Layman: Pick category i with probability proportional to weights[i], in constant time.
+     * Technical: Vose's alias method; O(k) setup, then one 64-bit draw per sample (the high
+     * 32 bits pick a column, the low 32 bits the coin), so it supports up to 2^32 categories.
+     */
+    class AliasTable
+    {
+    public:
+        explicit AliasTable(const std::vector<double> &weights)
+        {
+            const size_t k = weights.size();
+            if (k == 0 || k > 0xFFFFFFFFULL)
+                throw std::invalid_argument("Weights must have between 1 and 2^32 entries");
+            double total = 0.0;
+            for (double w : weights)
+            {
+                if (!(w >= 0) || std::isinf(w))
+                    throw std::invalid_argument("Weights must be finite and non-negative");
+                total += w;
+            }
+            if (total <= 0)
+                throw std::invalid_argument("At least one weight must be positive");
+
+            prob_.assign(k, 0.0);
+            alias_.assign(k, 0);
+            std::vector<double> scaled(k);
+            std::vector<uint32_t> small, large;
+            for (size_t i = 0; i < k; ++i)
+            {
+                scaled[i] = weights[i] * k / total;
+                (scaled[i] < 1.0 ? small : large).push_back(static_cast<uint32_t>(i));
+            }
+            while (!small.empty() && !large.empty())
+            {
+                const uint32_t s = small.back(), l = large.back();
+                small.pop_back();
+                prob_[s] = scaled[s];
+                alias_[s] = l;
+                scaled[l] -= 1.0 - scaled[s];
+                if (scaled[l] < 1.0)
+                {
+                    large.pop_back();
+                    small.push_back(l);
+                }
+            }
+            // Leftovers are 1 up to rounding
+            for (uint32_t i : large)
+                prob_[i] = 1.0;
+            for (uint32_t i : small)
+                prob_[i] = 1.0;
+        }
+
+        template <typename RNG>
+        size_t operator()(RNG &rng) const
+        {
+            detail::requireFullWidth<RNG>();
+            const uint64_t bits = rng();
+            const size_t column = static_cast<size_t>(((bits >> 32) * prob_.size()) >> 32);
+            const double coin = static_cast<double>(bits & 0xFFFFFFFFULL) * (1.0 / 4294967296.0);
+            return coin < prob_[column] ? column : alias_[column];
+        }
+
+        template <typename RNG, typename OutT>
+        void fill(RNG &rng, OutT *out, size_t n) const
+        {
+            for (size_t i = 0; i < n; ++i)
+                out[i] = static_cast<OutT>((*this)(rng));
+        }
+
+        size_t size() const { return prob_.size(); }
+
+    private:
+        std::vector<double> prob_;
+        std::vector<uint32_t> alias_;
+    };
+
+    /**
+     * Run numbered blocks of random work on several threads, reproducibly.
+     * Layman: Split a random job into pieces that give the same answer for the same seed no
+     * matter how many threads share the work.
+     * Technical: fn(b, rng) is called once for every block b in [0, blocks) with rng set to
+     * Xoshiro256 stream b of the seed (b jumps of 2^128). Each thread owns a contiguous range
+     * of blocks and jumps incrementally between them. An exception from fn is rethrown once
+     * every thread has joined.
+     * @param numThreads Worker count (0 = hardware concurrency)
+     */
+    template <typename Func>
+    void parallelStreams(size_t blocks, uint64_t seed, size_t numThreads, Func fn)
+    {
+        if (blocks == 0)
+            return;
+        if (numThreads == 0)
+            numThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+        numThreads = std::max<size_t>(1, std::min(numThreads, blocks));
+        auto work = [&](size_t w)
+        {
+            const size_t first = w * blocks / numThreads, last = (w + 1) * blocks / numThreads;
+            Xoshiro256 stream(seed, first);
+            for (size_t b = first; b < last; ++b)
+            {
+                Xoshiro256 rng = stream;
+                fn(b, rng);
+                stream.jump();
+            }
+        };
+        detail::parallelFor(numThreads, numThreads, work);
+    }
+
+    /**
+     * Fill a buffer with draws from a sampler on several threads, reproducibly.
+     * Layman: Generate lots of random numbers in parallel and get the same numbers for the
+     * same seed no matter how many threads are used.
+     * Technical: The output is cut into blocks of 65536 values; block b is filled from
+     * Xoshiro256 stream b of the seed by parallelStreams.
+     * @param sampler Any sampler with fill(rng, out, n) (NormalSampler, PoissonSampler, ...)
+     * @param numThreads Worker count (0 = hardware concurrency)
+     */
+    template <typename Sampler, typename OutT>
+    void parallelSample(const Sampler &sampler, OutT *out, size_t n, uint64_t seed, size_t numThreads = 0)
+    {
+        const size_t block = 65536;
+        auto fillBlock = [&](size_t b, Xoshiro256 &rng)
+        {
+            const size_t begin = b * block;
+            sampler.fill(rng, out + begin, std::min(block, n - begin));
+        };
+        parallelStreams((n + block - 1) / block, seed, numThreads, fillBlock);
+    }
+}
+
+#endif // PROBABILITY_SAMPLERS_H
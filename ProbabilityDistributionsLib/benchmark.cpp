@@ -0,0 +1,156 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include "ProbabilityDistributions.h"
+#include "Samplers.h"
+
+// Throughput of the scalar distribution functions against the batch APIs.
+// Build: g++ -std=c++11 -O3 -march=native benchmark.cpp -o benchmark -lpthread
+
+double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Evaluations per second of fn, which fills out[0, n)
+template <typename Func>
+double evaluationsPerSecond(size_t n, std::vector<double> &out, Func fn)
+{
+    size_t evaluations = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (secondsSince(start) < 0.5)
+    {
+        fn();
+        evaluations += n;
+    }
+    double rate = evaluations / secondsSince(start);
+    volatile double sink = out[n / 2];
+    (void)sink;
+    return rate;
+}
+
+void report(const char *name, double scalarRate, double batchRate)
+{
+    std::cout << name << ": scalar " << scalarRate / 1e6 << "M/s, batch " << batchRate / 1e6
+              << "M/s (" << batchRate / scalarRate << "x)" << std::endl;
+}
+
+// Draws per second of a sampler filling a buffer, against the matching <random> distribution
+template <typename Sampler, typename StdDistribution, typename OutT>
+void benchmarkSampler(const char *name, const Sampler &sampler, StdDistribution reference, std::vector<OutT> &buffer)
+{
+    ProbabilityDistributions::Xoshiro256 rng(1);
+    std::mt19937_64 mt(1);
+    size_t draws = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (secondsSince(start) < 0.5)
+    {
+        sampler.fill(rng, buffer.data(), buffer.size());
+        draws += buffer.size();
+    }
+    double fast = draws / secondsSince(start);
+    draws = 0;
+    start = std::chrono::steady_clock::now();
+    while (secondsSince(start) < 0.5)
+    {
+        for (auto &v : buffer)
+            v = reference(mt);
+        draws += buffer.size();
+    }
+    double standard = draws / secondsSince(start);
+    std::cout << name << ": " << fast / 1e6 << "M draws/s (std::mt19937_64 + <random>: " << standard / 1e6
+              << "M/s)" << std::endl;
+}
+
+int main()
+{
+    using namespace ProbabilityDistributions;
+    const size_t n = 4096;
+    std::mt19937 gen(1);
+    std::normal_distribution<double> normal(0.0, 2.0);
+    std::poisson_distribution<int> poisson(40.0);
+    std::binomial_distribution<int> binomial(1000, 0.3);
+    std::vector<double> x(n), out(n);
+    std::vector<int> counts(n), successes(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        x[i] = normal(gen);
+        counts[i] = poisson(gen);
+        successes[i] = binomial(gen);
+    }
+
+    report("normalPDF",
+           evaluationsPerSecond(n, out, [&]() { for (size_t i = 0; i < n; ++i) out[i] = normalPDF(x[i], 0.0, 2.0); }),
+           evaluationsPerSecond(n, out, [&]() { normalPDF(x.data(), n, 0.0, 2.0, out.data()); }));
+    report("poissonPMF (lambda 40)",
+           evaluationsPerSecond(n, out, [&]() { for (size_t i = 0; i < n; ++i) out[i] = poissonPMF(counts[i], 40.0); }),
+           evaluationsPerSecond(n, out, [&]() { poissonPMF(counts.data(), n, 40.0, out.data()); }));
+    report("binomialPMF (n 1000)",
+           evaluationsPerSecond(n, out, [&]() { for (size_t i = 0; i < n; ++i) out[i] = binomialPMF(1000, successes[i], 0.3); }),
+           evaluationsPerSecond(n, out, [&]() { binomialPMF(1000, successes.data(), n, 0.3, out.data()); }));
+    report("exponentialPDF",
+           evaluationsPerSecond(n, out, [&]() { for (size_t i = 0; i < n; ++i) out[i] = exponentialPDF(x[i], 1.5); }),
+           evaluationsPerSecond(n, out, [&]() { exponentialPDF(x.data(), n, 1.5, out.data()); }));
+
+    // Fused log-likelihood against summing the log of each scalar density
+    double total = 0.0;
+    report("normal log-likelihood",
+           evaluationsPerSecond(n, out, [&]() { for (size_t i = 0; i < n; ++i) total += std::log(normalPDF(x[i], 0.0, 2.0)); }),
+           evaluationsPerSecond(n, out, [&]() { total += normalLogLikelihood(x.data(), n, 0.0, 2.0); }));
+    report("Poisson log-likelihood (lambda 40)",
+           evaluationsPerSecond(n, out, [&]() { for (size_t i = 0; i < n; ++i) total += std::log(poissonPMF(counts[i], 40.0)); }),
+           evaluationsPerSecond(n, out, [&]() { total += poissonLogLikelihood(counts.data(), n, 40.0); }));
+    report("binomial log-likelihood (n 1000)",
+           evaluationsPerSecond(n, out, [&]() { for (size_t i = 0; i < n; ++i) total += std::log(binomialPMF(1000, successes[i], 0.3)); }),
+           evaluationsPerSecond(n, out, [&]() { total += binomialLogLikelihood(1000, successes.data(), n, 0.3); }));
+
+    // Tail probabilities and quantiles as used for p-values and critical values
+    std::vector<double> stats(n), probs(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        stats[i] = std::abs(x[i]) + 0.1;
+        probs[i] = (i + 0.5) / n;
+    }
+    auto rate = [&](const char *name, double (*fn)(double))
+    {
+        double r = evaluationsPerSecond(n, out, [&]() { for (size_t i = 0; i < n; ++i) out[i] = fn(stats[i]); });
+        std::cout << name << ": " << r / 1e6 << "M/s" << std::endl;
+    };
+    rate("studentTSurvival (df 20)", [](double t) { return studentTSurvival(t, 20.0); });
+    rate("chiSquareSurvival (df 5)", [](double c) { return chiSquareSurvival(4.0 * c, 5.0); });
+    rate("fSurvival (df 3, 96)", [](double f) { return fSurvival(f, 3.0, 96.0); });
+    auto quantileRate = [&](const char *name, double (*fn)(double))
+    {
+        double r = evaluationsPerSecond(n, out, [&]() { for (size_t i = 0; i < n; ++i) out[i] = fn(probs[i]); });
+        std::cout << name << ": " << r / 1e6 << "M/s" << std::endl;
+    };
+    quantileRate("normalQuantile", [](double p) { return normalQuantile(p, 0.0, 1.0); });
+    quantileRate("studentTQuantile (df 20)", [](double p) { return studentTQuantile(p, 20.0); });
+
+    // Random variate generation
+    std::vector<double> draws(1 << 16);
+    std::vector<int> countDraws(1 << 16);
+    benchmarkSampler("NormalSampler", NormalSampler(0.0, 1.0), std::normal_distribution<double>(0.0, 1.0), draws);
+    benchmarkSampler("ExponentialSampler", ExponentialSampler(1.0), std::exponential_distribution<double>(1.0), draws);
+    benchmarkSampler("PoissonSampler (lambda 4)", PoissonSampler(4.0), std::poisson_distribution<int>(4.0), countDraws);
+    benchmarkSampler("PoissonSampler (lambda 1000)", PoissonSampler(1000.0), std::poisson_distribution<int>(1000.0), countDraws);
+    benchmarkSampler("BinomialSampler (n 1000, p 0.3)", BinomialSampler(1000, 0.3), std::binomial_distribution<int>(1000, 0.3), countDraws);
+    std::vector<double> weights(1000);
+    for (size_t i = 0; i < weights.size(); ++i)
+        weights[i] = 1.0 + i % 17;
+    benchmarkSampler("AliasTable (1000 categories)", AliasTable(weights),
+                     std::discrete_distribution<int>(weights.begin(), weights.end()), countDraws);
+
+    std::vector<double> big(1 << 26);
+    auto start = std::chrono::steady_clock::now();
+    parallelSample(NormalSampler(), big.data(), big.size(), 42);
+    std::cout << "parallelSample normal (" << std::thread::hardware_concurrency() << " threads): "
+              << big.size() / secondsSince(start) / 1e6 << "M draws/s" << std::endl;
+    total += big[12345] + draws[7] + countDraws[7];
+
+    volatile double sink = total;
+    (void)sink;
+    return 0;
+}
@@ -1,5 +1,7 @@
 #include <iostream>
+#include <vector>
 #include "ProbabilityDistributions.h"
+#include "Samplers.h"
 
 int main()
 {
@@ -30,6 +32,25 @@ int main()
         double exp_lambda = 1.0;
         double exponential_pdf = ProbabilityDistributions::exponentialPDF(exp_x, exp_lambda);
         std::cout << "Exponential PDF at x=" << exp_x << ": " << exponential_pdf << std::endl;
+
+        // Batch evaluation with precomputed constants
+        std::vector<double> xs = {-1.0, 0.0, 1.0, 2.0};
+        std::vector<double> densities(xs.size());
+        ProbabilityDistributions::NormalDistribution standardNormal(0.0, 1.0);
+        standardNormal.pdf(xs.data(), xs.size(), densities.data());
+        std::cout << "Normal PDF batch:";
+        for (double d : densities)
+            std::cout << " " << d;
+        std::cout << std::endl;
+
+        // Reproducible random draws
+        ProbabilityDistributions::Xoshiro256 rng(2024);
+        std::vector<int> arrivals(5);
+        ProbabilityDistributions::PoissonSampler(lambda).fill(rng, arrivals.data(), arrivals.size());
+        std::cout << "Poisson draws:";
+        for (int a : arrivals)
+            std::cout << " " << a;
+        std::cout << std::endl;
     }
     catch (const std::exception &ex)
     {
@@ -0,0 +1,442 @@
+#ifndef TIME_SERIES_ANOMALY_DETECTION_H
+#define TIME_SERIES_ANOMALY_DETECTION_H
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <algorithm>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace TimeSeriesAnalysis
+{
+    namespace detail
+    {
+        // Number of the n values a[] below x (cx) and below y (cy) in one pass; NaN is below nothing
+        inline void countBelow(const double *a, size_t n, double x, double y, size_t &cx, size_t &cy)
+        {
+            size_t k = 0;
+            cx = cy = 0;
+#if defined(__AVX2__)
+            const __m256d vx = _mm256_set1_pd(x), vy = _mm256_set1_pd(y);
+            __m256i ax = _mm256_setzero_si256(), ay = _mm256_setzero_si256();
+            __m256i bx = _mm256_setzero_si256(), by = _mm256_setzero_si256();
+            for (; k + 8 <= n; k += 8) // compare masks are -1, so the sums count down
+            {
+                const __m256d u = _mm256_loadu_pd(a + k), v = _mm256_loadu_pd(a + k + 4);
+                ax = _mm256_add_epi64(ax, _mm256_castpd_si256(_mm256_cmp_pd(u, vx, _CMP_LT_OQ)));
+                ay = _mm256_add_epi64(ay, _mm256_castpd_si256(_mm256_cmp_pd(u, vy, _CMP_LT_OQ)));
+                bx = _mm256_add_epi64(bx, _mm256_castpd_si256(_mm256_cmp_pd(v, vx, _CMP_LT_OQ)));
+                by = _mm256_add_epi64(by, _mm256_castpd_si256(_mm256_cmp_pd(v, vy, _CMP_LT_OQ)));
+            }
+            alignas(32) int64_t sx[4], sy[4];
+            _mm256_store_si256(reinterpret_cast<__m256i *>(sx), _mm256_add_epi64(ax, bx));
+            _mm256_store_si256(reinterpret_cast<__m256i *>(sy), _mm256_add_epi64(ay, by));
+            cx = static_cast<size_t>(-(sx[0] + sx[1] + sx[2] + sx[3]));
+            cy = static_cast<size_t>(-(sy[0] + sy[1] + sy[2] + sy[3]));
+#elif defined(__SSE2__)
+            const __m128d vx = _mm_set1_pd(x), vy = _mm_set1_pd(y);
+            __m128i ax = _mm_setzero_si128(), ay = _mm_setzero_si128();
+            __m128i bx = _mm_setzero_si128(), by = _mm_setzero_si128();
+            for (; k + 4 <= n; k += 4)
+            {
+                const __m128d u = _mm_loadu_pd(a + k), v = _mm_loadu_pd(a + k + 2);
+                ax = _mm_add_epi64(ax, _mm_castpd_si128(_mm_cmplt_pd(u, vx)));
+                ay = _mm_add_epi64(ay, _mm_castpd_si128(_mm_cmplt_pd(u, vy)));
+                bx = _mm_add_epi64(bx, _mm_castpd_si128(_mm_cmplt_pd(v, vx)));
+                by = _mm_add_epi64(by, _mm_castpd_si128(_mm_cmplt_pd(v, vy)));
+            }
+            alignas(16) int64_t sx[2], sy[2];
+            _mm_store_si128(reinterpret_cast<__m128i *>(sx), _mm_add_epi64(ax, bx));
+            _mm_store_si128(reinterpret_cast<__m128i *>(sy), _mm_add_epi64(ay, by));
+            cx = static_cast<size_t>(-(sx[0] + sx[1]));
+            cy = static_cast<size_t>(-(sy[0] + sy[1]));
+#endif
+            for (; k < n; ++k)
+            {
+                cx += a[k] < x;
+                cy += a[k] < y;
+            }
+        }
+    }
+
+    // Exact median over a sliding window of the last `window` values in O(window) memory.
+    // Values live in a circular buffer. Windows up to sortedWindowLimit also keep the
+    // window sorted: an update ranks the leaving and arriving values in one SIMD counting
+    // pass over the window (branch-free, unlike a binary search on unpredictable data) and
+    // shifts the slots between them, a short memmove that stays in L1; the median is read
+    // in O(1). Larger windows use O(log window) updates: a single index
+    // array holds a max-heap (negative positions) and a min-heap (positive positions)
+    // around the median at position 0, and every slot tracks its heap position so the
+    // value leaving the window is replaced in place rather than searched for. NaN sorts
+    // above every number.
+    class RollingMedian
+    {
+    public:
+        static const size_t sortedWindowLimit = 128;
+
+        explicit RollingMedian(size_t window)
+        {
+            if (window == 0)
+                throw std::invalid_argument("Window size must be positive");
+            N_ = static_cast<int>(window);
+            data_.assign(window, 0.0);
+            if (window <= sortedWindowLimit)
+            {
+                sorted_.assign(window, 0.0);
+                return;
+            }
+            pos_.assign(window, 0);
+            heapStorage_.assign(window, 0);
+            heap_ = heapStorage_.data() + window / 2;
+            // Initial fill pattern: median, max, min, max, min, ...
+            for (int k = N_ - 1; k >= 0; --k)
+            {
+                pos_[k] = ((k + 1) / 2) * ((k & 1) ? -1 : 1);
+                heap_[pos_[k]] = k;
+            }
+        }
+
+        RollingMedian(const RollingMedian &other) { *this = other; }
+
+        RollingMedian &operator=(const RollingMedian &other)
+        {
+            N_ = other.N_;
+            idx_ = other.idx_;
+            minCt_ = other.minCt_;
+            maxCt_ = other.maxCt_;
+            count_ = other.count_;
+            data_ = other.data_;
+            sorted_ = other.sorted_;
+            pos_ = other.pos_;
+            heapStorage_ = other.heapStorage_;
+            heap_ = heapStorage_.empty() ? nullptr : heapStorage_.data() + N_ / 2;
+            return *this;
+        }
+
+        void push(double v)
+        {
+            if (!sorted_.empty())
+            {
+                pushSorted(v);
+                return;
+            }
+            const int p = pos_[idx_];
+            const double old = data_[idx_];
+            data_[idx_] = v;
+            idx_ = (idx_ + 1 == N_) ? 0 : idx_ + 1;
+            if (count_ < static_cast<size_t>(N_))
+                ++count_;
+            if (p > 0) // slot is in the min-heap
+            {
+                if (minCt_ < (N_ - 1) / 2)
+                    ++minCt_;
+                else if (before(old, v))
+                {
+                    minSortDown(p);
+                    return;
+                }
+                if (minSortUp(p) && compareExchange(0, -1))
+                    maxSortDown(-1);
+            }
+            else if (p < 0) // slot is in the max-heap
+            {
+                if (maxCt_ < N_ / 2)
+                    ++maxCt_;
+                else if (before(v, old))
+                {
+                    maxSortDown(p);
+                    return;
+                }
+                if (maxSortUp(p) && minCt_ && compareExchange(1, 0))
+                    minSortDown(1);
+            }
+            else // slot is the median itself
+            {
+                if (maxCt_ && maxSortUp(-1))
+                    maxSortDown(-1);
+                if (minCt_ && minSortUp(1))
+                    minSortDown(1);
+            }
+        }
+
+        double median() const
+        {
+            if (count_ == 0)
+                throw std::logic_error("Rolling window is empty");
+            if (!sorted_.empty())
+            {
+                const size_t mid = count_ / 2;
+                return (count_ & 1) ? sorted_[mid] : 0.5 * (sorted_[mid - 1] + sorted_[mid]);
+            }
+            double v = data_[heap_[0]];
+            if (minCt_ < maxCt_)
+                v = 0.5 * (v + data_[heap_[-1]]);
+            return v;
+        }
+
+        size_t size() const { return count_; }
+        size_t window() const { return static_cast<size_t>(N_); }
+
+    private:
+        // Replace the oldest value by v, keeping sorted_[0, count_) in order with NaNs last
+        void pushSorted(double v)
+        {
+            double *a = sorted_.data();
+            const bool full = count_ == static_cast<size_t>(N_);
+            const double old = data_[idx_];
+            data_[idx_] = v;
+            idx_ = (idx_ + 1 == N_) ? 0 : idx_ + 1;
+            size_t i, j; // slot of the leaving value (the end while filling), rank of v
+            detail::countBelow(a, count_, old, v, i, j);
+            if (!full)
+                i = count_++;
+            else if (old != old)
+                i = count_ - 1;
+            if (v != v)
+                j = count_;
+            if (j <= i)
+            {
+                std::memmove(a + j + 1, a + j, (i - j) * sizeof(double));
+                a[j] = v;
+            }
+            else
+            {
+                std::memmove(a + i, a + i + 1, (j - 1 - i) * sizeof(double));
+                a[j - 1] = v;
+            }
+        }
+
+        // Total order with NaN above every number (and equal to other NaNs); a plain < would
+        // leave the heaps inconsistent once a NaN entered the window
+        static bool before(double a, double b) { return a < b || (b != b && a == a); }
+
+        bool less(int i, int j) const { return before(data_[heap_[i]], data_[heap_[j]]); }
+
+        bool exchange(int i, int j)
+        {
+            std::swap(heap_[i], heap_[j]);
+            pos_[heap_[i]] = i;
+            pos_[heap_[j]] = j;
+            return true;
+        }
+
+        bool compareExchange(int i, int j) { return less(i, j) && exchange(i, j); }
+
+        // Restore the min-heap below position i
+        void minSortDown(int i)
+        {
+            for (i *= 2; i <= minCt_; i *= 2)
+            {
+                if (i < minCt_ && less(i + 1, i))
+                    ++i;
+                if (!compareExchange(i, i / 2))
+                    break;
+            }
+        }
+
+        // Restore the max-heap below position i (negative positions)
+        void maxSortDown(int i)
+        {
+            for (i *= 2; i >= -maxCt_; i *= 2)
+            {
+                if (i > -maxCt_ && less(i, i - 1))
+                    --i;
+                if (!compareExchange(i / 2, i))
+                    break;
+            }
+        }
+
+        // Sift up towards the median; true if the item reached position 0
+        bool minSortUp(int i)
+        {
+            while (i > 0 && compareExchange(i, i / 2))
+                i /= 2;
+            return i == 0;
+        }
+
+        bool maxSortUp(int i)
+        {
+            while (i < 0 && compareExchange(i / 2, i))
+                i /= 2;
+            return i == 0;
+        }
+
+        int N_ = 0;
+        int idx_ = 0;
+        int minCt_ = 0;
+        int maxCt_ = 0;
+        size_t count_ = 0;
+        std::vector<double> data_;
+        std::vector<double> sorted_; // small windows: the window in order (empty for the heap layout)
+        std::vector<int> pos_;
+        std::vector<int> heapStorage_;
+        int *heap_ = nullptr;
+    };
+
+    // Configuration for StreamingAnomalyDetector. Thresholds are in standard-deviation
+    // units; period = 0 disables the seasonal stage.
+    struct StreamingAnomalyOptions
+    {
+        StreamingAnomalyOptions(size_t window = 64, size_t period = 0)
+            : window(window), robustThreshold(3.5), period(period), levelAlpha(0.05),
+              seasonalGamma(0.1), seasonalThreshold(4.0), ewmaLambda(0.2), ewmaLimit(3.0),
+              residualAlpha(0.01), warmup(0) {}
+        size_t window;            // rolling median/MAD window
+        double robustThreshold;   // |x - median| / (1.4826 * MAD)
+        size_t period;            // seasonal period in samples
+        double levelAlpha;        // smoothing of the deseasonalised level
+        double seasonalGamma;     // smoothing of the per-phase seasonal profile
+        double seasonalThreshold; // |residual| / residual std
+        double ewmaLambda;        // EWMA control chart weight
+        double ewmaLimit;         // control limit multiplier L
+        double residualAlpha;     // smoothing of the residual (in-control) variance
+        size_t warmup;            // samples before flags are raised (0 = max(window, 2 * period))
+    };
+
+    // Per-sample scores and flags produced by StreamingAnomalyDetector
+    struct AnomalyScore
+    {
+        enum Flag : uint8_t
+        {
+            RobustOutlier = 1,   // far from the rolling median in MAD units
+            SeasonalOutlier = 2, // large residual after level + seasonal profile
+            EWMAShift = 4,       // EWMA statistic outside its control limits (level shift)
+            NonFinite = 8        // NaN or infinite sample; skipped without updating any state
+        };
+        double robustZ;
+        double seasonalZ;
+        double ewmaZ;
+        uint8_t flags;
+        bool isAnomaly() const { return flags != 0; }
+    };
+
+    // Streaming anomaly detector combining three O(1)/O(log w) stages per sample:
+    //  1. Robust z-score against a rolling median and MAD. The MAD is tracked as the
+    //     rolling median of |x - median| at arrival time, a standard streaming
+    //     approximation that avoids re-centring the whole window.
+    //  2. Seasonal residual z-score from an online additive level + per-phase profile
+    //     (Holt-Winters style) with an exponentially weighted residual variance.
+    //  3. EWMA control chart on the same residuals, with asymptotic limits
+    //     L * sigma * sqrt(lambda / (2 - lambda)); flags the onset of level shifts
+    //     before the adaptive level absorbs them.
+    // Each sample is scored against state built from previous samples only, and point
+    // outliers do not update the level, seasonal profile or residual variance. NaN and
+    // infinite samples are flagged NonFinite and leave every stage untouched (they still
+    // advance the seasonal phase).
+    class StreamingAnomalyDetector
+    {
+    public:
+        explicit StreamingAnomalyDetector(const StreamingAnomalyOptions &options = StreamingAnomalyOptions())
+            : options_(options), values_(std::max<size_t>(1, options.window)),
+              deviations_(std::max<size_t>(1, options.window)), seasonal_(options.period, 0.0)
+        {
+            if (options.window == 0)
+                throw std::invalid_argument("Window size must be positive");
+            if (options.ewmaLambda <= 0.0 || options.ewmaLambda > 1.0)
+                throw std::invalid_argument("EWMA lambda must be in (0, 1]");
+            warmup_ = options.warmup ? options.warmup : std::max(options.window, 2 * options.period);
+            ewmaWidth_ = std::sqrt(options.ewmaLambda / (2.0 - options.ewmaLambda));
+        }
+
+        AnomalyScore process(double x)
+        {
+            AnomalyScore score;
+            score.robustZ = score.seasonalZ = score.ewmaZ = 0.0;
+            score.flags = 0;
+            if (!std::isfinite(x))
+            {
+                score.flags = AnomalyScore::NonFinite;
+                if (++phase_ == options_.period)
+                    phase_ = 0;
+                return score;
+            }
+            const bool armed = seen_ >= warmup_;
+
+            // 1. Rolling median / MAD
+            double med = x;
+            if (values_.size() > 0)
+            {
+                med = values_.median();
+                double mad = deviations_.median();
+                if (mad > 0.0)
+                    score.robustZ = (x - med) / (1.4826 * mad);
+                if (armed && std::abs(score.robustZ) > options_.robustThreshold)
+                    score.flags |= AnomalyScore::RobustOutlier;
+            }
+            values_.push(x);
+            deviations_.push(std::abs(x - med));
+
+            // 2. Seasonal residual
+            const size_t phase = phase_;
+            const double seasonalPart = options_.period > 0 ? seasonal_[phase] : 0.0;
+            const double residual = x - (level_ + seasonalPart);
+            const double invStd = residualVar_ > 0.0 ? 1.0 / std::sqrt(residualVar_) : 0.0;
+            if (seen_ > 0)
+                score.seasonalZ = residual * invStd;
+            if (armed && std::abs(score.seasonalZ) > options_.seasonalThreshold)
+                score.flags |= AnomalyScore::SeasonalOutlier;
+
+            // 3. EWMA control chart on the residuals (in-control mean 0)
+            if (seen_ > 0)
+                ewma_ = options_.ewmaLambda * residual + (1.0 - options_.ewmaLambda) * ewma_;
+            score.ewmaZ = ewma_ * invStd / ewmaWidth_;
+            if (armed && std::abs(score.ewmaZ) > options_.ewmaLimit)
+                score.flags |= AnomalyScore::EWMAShift;
+
+            // The baseline only learns from samples that are not point outliers
+            if (seen_ == 0)
+                level_ = x;
+            else if (!(score.flags & (AnomalyScore::RobustOutlier | AnomalyScore::SeasonalOutlier)))
+            {
+                const double la = options_.levelAlpha;
+                level_ = la * (x - seasonalPart) + (1.0 - la) * level_;
+                if (options_.period > 0)
+                    seasonal_[phase] += options_.seasonalGamma * (x - level_ - seasonal_[phase]);
+                const double ra = armed ? options_.residualAlpha : 1.0 / seen_;
+                residualVar_ = (1.0 - ra) * residualVar_ + ra * residual * residual;
+            }
+            ++seen_;
+            if (++phase_ == options_.period)
+                phase_ = 0;
+            return score;
+        }
+
+        // Score a block of samples; returns the number of anomalous samples
+        size_t process(const double *x, size_t n, AnomalyScore *out)
+        {
+            size_t anomalies = 0;
+            for (size_t i = 0; i < n; ++i)
+            {
+                out[i] = process(x[i]);
+                anomalies += out[i].isAnomaly();
+            }
+            return anomalies;
+        }
+
+        size_t samplesSeen() const { return seen_; }
+        double rollingMedian() const { return values_.median(); }
+        double rollingMAD() const { return deviations_.median(); }
+
+    private:
+        StreamingAnomalyOptions options_;
+        RollingMedian values_;
+        RollingMedian deviations_;
+        std::vector<double> seasonal_;
+        size_t warmup_;
+        size_t seen_ = 0;
+        size_t phase_ = 0;
+        double level_ = 0.0;
+        double residualVar_ = 0.0;
+        double ewma_ = 0.0;
+        double ewmaWidth_;
+    };
+}
+
+#endif // TIME_SERIES_ANOMALY_DETECTION_H
@@ -0,0 +1,498 @@
+#ifndef TIME_SERIES_RESAMPLING_H
+#define TIME_SERIES_RESAMPLING_H
+
+#include <vector>
+#include <deque>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+#include <thread>
+#include "TimeSeriesAnalysis.h"
+
+namespace TimeSeriesAnalysis
+{
+    // Mergeable quantile sketch with a relative-error guarantee (DDSketch layout).
+    // Values are counted in logarithmic bins (gamma^(i-1), gamma^i] with
+    // gamma = (1 + a) / (1 - a), so every estimate lies within a factor (1 +/- a) of
+    // the sample of that rank. Memory grows with the log of the dynamic range of |x|
+    // (roughly 1150 bins per 10 decades at a = 0.01), not with the number of values,
+    // and sketches with the same accuracy merge without further loss. NaN is skipped;
+    // -inf and +inf are counted apart from the bins and rank below and above every
+    // finite value.
+    class QuantileSketch
+    {
+    public:
+        explicit QuantileSketch(double relativeAccuracy = 0.01)
+        {
+            if (!(relativeAccuracy > 0.0 && relativeAccuracy < 1.0))
+                throw std::invalid_argument("Relative accuracy must be in (0, 1)");
+            accuracy_ = relativeAccuracy;
+            gamma_ = (1.0 + relativeAccuracy) / (1.0 - relativeAccuracy);
+            invLogGamma_ = 1.0 / std::log(gamma_);
+        }
+
+        void add(double x)
+        {
+            const double tiny = std::numeric_limits<double>::min();
+            const double huge = std::numeric_limits<double>::max();
+            if (x != x)
+                return;
+            if (x > huge)
+                ++positiveInfinite_;
+            else if (x < -huge)
+                ++negativeInfinite_;
+            else if (x > tiny)
+                positive_.add(index(x), 1);
+            else if (x < -tiny)
+                negative_.add(index(-x), 1);
+            else
+                ++zeroCount_;
+            ++count_;
+        }
+
+        void merge(const QuantileSketch &other)
+        {
+            if (other.gamma_ != gamma_)
+                throw std::invalid_argument("Sketches must share the same relative accuracy");
+            positive_.merge(other.positive_);
+            negative_.merge(other.negative_);
+            zeroCount_ += other.zeroCount_;
+            negativeInfinite_ += other.negativeInfinite_;
+            positiveInfinite_ += other.positiveInfinite_;
+            count_ += other.count_;
+        }
+
+        // Value of rank floor(q * (count - 1)) to within the relative accuracy
+        double quantile(double q) const
+        {
+            if (count_ == 0)
+                throw std::logic_error("Sketch is empty");
+            if (q < 0.0 || q > 1.0)
+                throw std::invalid_argument("Quantile must be in [0, 1]");
+            const double rank = q * static_cast<double>(count_ - 1);
+            uint64_t seen = negativeInfinite_;
+            if (seen > rank)
+                return -std::numeric_limits<double>::infinity();
+            for (size_t k = negative_.counts.size(); k-- > 0;)
+            {
+                seen += negative_.counts[k];
+                if (seen > rank)
+                    return -value(negative_.offset + static_cast<int>(k));
+            }
+            seen += zeroCount_;
+            if (seen > rank)
+                return 0.0;
+            for (size_t k = 0; k < positive_.counts.size(); ++k)
+            {
+                seen += positive_.counts[k];
+                if (seen > rank)
+                    return value(positive_.offset + static_cast<int>(k));
+            }
+            return std::numeric_limits<double>::infinity(); // only +inf is left
+        }
+
+        uint64_t count() const { return count_; } // values added, infinities included
+        uint64_t infinite() const { return negativeInfinite_ + positiveInfinite_; }
+        double relativeAccuracy() const { return accuracy_; }
+
+        void clear()
+        {
+            positive_.counts.clear();
+            negative_.counts.clear();
+            zeroCount_ = negativeInfinite_ = positiveInfinite_ = count_ = 0;
+        }
+
+    private:
+        // Dense bin counts for indices [offset, offset + counts.size())
+        struct Store
+        {
+            std::vector<uint64_t> counts;
+            int offset = 0;
+
+            void cover(int lo, int hi)
+            {
+                if (counts.empty())
+                {
+                    counts.assign(static_cast<size_t>(hi - lo + 1), 0);
+                    offset = lo;
+                    return;
+                }
+                if (lo < offset)
+                {
+                    counts.insert(counts.begin(), static_cast<size_t>(offset - lo), 0);
+                    offset = lo;
+                }
+                if (hi >= offset + static_cast<int>(counts.size()))
+                    counts.resize(static_cast<size_t>(hi - offset + 1), 0);
+            }
+
+            void add(int i, uint64_t c)
+            {
+                if (counts.empty() || i < offset || i >= offset + static_cast<int>(counts.size()))
+                    cover(i, i);
+                counts[static_cast<size_t>(i - offset)] += c;
+            }
+
+            void merge(const Store &other)
+            {
+                if (other.counts.empty())
+                    return;
+                cover(other.offset, other.offset + static_cast<int>(other.counts.size()) - 1);
+                uint64_t *dst = counts.data() + (other.offset - offset);
+                for (size_t k = 0; k < other.counts.size(); ++k)
+                    dst[k] += other.counts[k];
+            }
+        };
+
+        int index(double x) const { return static_cast<int>(std::ceil(std::log(x) * invLogGamma_)); }
+        double value(int i) const { return 2.0 * std::pow(gamma_, i) / (gamma_ + 1.0); }
+
+        double accuracy_;
+        double gamma_;
+        double invLogGamma_;
+        Store positive_;
+        Store negative_;
+        uint64_t zeroCount_ = 0;
+        uint64_t negativeInfinite_ = 0;
+        uint64_t positiveInfinite_ = 0;
+        uint64_t count_ = 0;
+    };
+
+    // Window layout for Resampler. Window j covers [origin + j * hop, origin + j * hop + width)
+    // in timestamp units; hop = 0 (or hop = width) gives tumbling windows.
+    struct ResampleOptions
+    {
+        ResampleOptions(int64_t width = 1000, int64_t hop = 0)
+            : width(width), hop(hop ? hop : width), origin(0), relativeAccuracy(0.01), numThreads(0) {}
+        int64_t width;
+        int64_t hop;
+        int64_t origin;
+        std::vector<double> quantiles; // quantile levels to estimate per window (empty = no sketch)
+        double relativeAccuracy;       // QuantileSketch accuracy
+        size_t numThreads;             // 0 = hardware concurrency
+    };
+
+    // Columnar per-window aggregates. Windows form a regular grid from the first window
+    // containing data to the last; empty windows have count 0 and NaN statistics.
+    struct ResampledSeries
+    {
+        std::vector<int64_t> start;
+        std::vector<uint64_t> count;
+        std::vector<double> mean;
+        std::vector<double> min;
+        std::vector<double> max;
+        std::vector<double> variance;  // sample variance (n - 1), NaN below two values
+        std::vector<double> quantiles; // row-major [window][quantile level]
+
+        size_t size() const { return start.size(); }
+
+        void clear()
+        {
+            start.clear();
+            count.clear();
+            mean.clear();
+            min.clear();
+            max.clear();
+            variance.clear();
+            quantiles.clear();
+        }
+    };
+
+    namespace detail
+    {
+        inline int64_t floorDiv(int64_t a, int64_t b)
+        {
+            int64_t q = a / b;
+            if ((a % b != 0) && ((a < 0) != (b < 0)))
+                --q;
+            return q;
+        }
+
+        inline int64_t gcd(int64_t a, int64_t b)
+        {
+            while (b != 0)
+            {
+                int64_t t = a % b;
+                a = b;
+                b = t;
+            }
+            return a;
+        }
+
+        // Aggregates of the points in one pane (a gcd(width, hop) slice shared by every
+        // window that covers it)
+        struct PaneStats
+        {
+            PaneStats(int64_t index, double accuracy)
+                : index(index), count(0), mean(0.0), m2(0.0),
+                  min(std::numeric_limits<double>::infinity()),
+                  max(-std::numeric_limits<double>::infinity()), sketch(accuracy) {}
+            int64_t index;
+            uint64_t count;
+            double mean;
+            double m2;
+            double min;
+            double max;
+            QuantileSketch sketch;
+
+            // Chan et al. pairwise update of count/mean/M2
+            void merge(const PaneStats &other, bool withSketch)
+            {
+                if (other.count == 0)
+                    return;
+                const double na = static_cast<double>(count), nb = static_cast<double>(other.count);
+                const double delta = other.mean - mean;
+                const double n = na + nb;
+                mean += delta * nb / n;
+                m2 += other.m2 + delta * delta * na * nb / n;
+                count += other.count;
+                min = std::min(min, other.min);
+                max = std::max(max, other.max);
+                if (withSketch)
+                    sketch.merge(other.sketch);
+            }
+        };
+    }
+
+    // One-pass resampler over (timestamp, value) columns. Points arrive in chunks with
+    // non-decreasing timestamps; each chunk is split at pane boundaries and the panes
+    // are aggregated in parallel, then every window that can no longer receive points
+    // is assembled from its panes (also in parallel) and appended to windows().
+    // Hopping windows reuse pane aggregates instead of revisiting points, so the cost
+    // per point is independent of width / hop. Memory is bounded by the panes of the
+    // windows still open, plus the emitted output until it is taken.
+    class Resampler
+    {
+    public:
+        explicit Resampler(const ResampleOptions &options)
+            : options_(options)
+        {
+            if (options.width <= 0 || options.hop <= 0)
+                throw std::invalid_argument("Window width and hop must be positive");
+            for (double q : options.quantiles)
+                if (q < 0.0 || q > 1.0)
+                    throw std::invalid_argument("Quantile must be in [0, 1]");
+            if (!(options.relativeAccuracy > 0.0 && options.relativeAccuracy < 1.0))
+                throw std::invalid_argument("Relative accuracy must be in (0, 1)");
+            pane_ = detail::gcd(options.width, options.hop);
+            panesPerHop_ = options.hop / pane_;
+            panesPerWindow_ = options.width / pane_;
+            withSketch_ = !options.quantiles.empty();
+        }
+
+        void push(const int64_t *timestamps, const double *values, size_t n)
+        {
+            if (n == 0)
+                return;
+            if (finished_)
+                throw std::logic_error("Resampler has already been finished");
+            if (started_ && timestamps[0] < lastTimestamp_)
+                throw std::invalid_argument("Timestamps must be non-decreasing");
+
+            // Split the chunk into contiguous parts that start on pane boundaries
+            const size_t minPart = 1 << 16;
+            size_t parts = options_.numThreads ? options_.numThreads
+                                               : std::max<size_t>(1, std::thread::hardware_concurrency());
+            parts = std::max<size_t>(1, std::min(parts, n / minPart));
+            std::vector<size_t> bounds(parts + 1, n);
+            bounds[0] = 0;
+            for (size_t p = 1; p < parts; ++p)
+            {
+                size_t b = std::max(bounds[p - 1], p * n / parts);
+                while (b > 0 && b < n && paneIndex(timestamps[b]) == paneIndex(timestamps[b - 1]))
+                    ++b;
+                bounds[p] = b;
+            }
+
+            std::vector<std::vector<detail::PaneStats>> partial(parts);
+            std::vector<char> ordered(parts, 1);
+            detail::parallelFor(parts, options_.numThreads, [&](size_t p)
+            {
+                ordered[p] = accumulate(timestamps + bounds[p], values + bounds[p],
+                                        bounds[p + 1] - bounds[p], partial[p]);
+            });
+            for (size_t p = 0; p < parts; ++p)
+                if (!ordered[p] || (bounds[p] > 0 && bounds[p] < n && timestamps[bounds[p]] < timestamps[bounds[p] - 1]))
+                    throw std::invalid_argument("Timestamps must be non-decreasing");
+
+            if (!started_)
+            {
+                nextWindow_ = detail::floorDiv(timestamps[0] - options_.origin - options_.width, options_.hop) + 1;
+                started_ = true;
+            }
+            for (auto &panes : partial)
+                for (auto &pane : panes)
+                {
+                    if (!panes_.empty() && panes_.back().index == pane.index)
+                        panes_.back().merge(pane, withSketch_);
+                    else
+                        panes_.push_back(std::move(pane));
+                }
+            lastTimestamp_ = timestamps[n - 1];
+
+            // Windows whose last pane precedes the pane of the newest point are complete
+            const int64_t openPane = paneIndex(lastTimestamp_);
+            emit(detail::floorDiv(openPane - panesPerWindow_, panesPerHop_) + 1);
+        }
+
+        void push(const std::vector<int64_t> &timestamps, const std::vector<double> &values)
+        {
+            if (timestamps.size() != values.size())
+                throw std::invalid_argument("Timestamp and value columns must have the same length");
+            push(timestamps.data(), values.data(), timestamps.size());
+        }
+
+        // Flush every remaining window that contains data; no further pushes are accepted
+        void finish()
+        {
+            if (finished_)
+                return;
+            finished_ = true;
+            if (started_)
+                emit(detail::floorDiv(lastTimestamp_ - options_.origin, options_.hop) + 1);
+            panes_.clear();
+        }
+
+        const ResampledSeries &windows() const { return windows_; }
+
+        // Move the windows emitted so far out of the resampler (for streaming consumers)
+        ResampledSeries takeWindows()
+        {
+            ResampledSeries out;
+            std::swap(out, windows_);
+            return out;
+        }
+
+    private:
+        int64_t paneIndex(int64_t t) const { return detail::floorDiv(t - options_.origin, pane_); }
+
+        // Aggregate a run of points into panes; false if timestamps go backwards
+        bool accumulate(const int64_t *t, const double *v, size_t n, std::vector<detail::PaneStats> &out) const
+        {
+            size_t i = 0;
+            while (i < n)
+            {
+                const int64_t index = paneIndex(t[i]);
+                const int64_t paneEnd = options_.origin + (index + 1) * pane_;
+                detail::PaneStats pane(index, options_.relativeAccuracy);
+                // Moments are summed around the pane's first value to avoid cancellation
+                const double shift = v[i];
+                double sum = 0.0, sumSq = 0.0, lo = v[i], hi = v[i];
+                size_t j = i;
+                for (; j < n && t[j] < paneEnd; ++j)
+                {
+                    if (j > i && t[j] < t[j - 1])
+                        return false;
+                    const double d = v[j] - shift;
+                    sum += d;
+                    sumSq += d * d;
+                    lo = std::min(lo, v[j]);
+                    hi = std::max(hi, v[j]);
+                }
+                if (withSketch_)
+                    for (size_t k = i; k < j; ++k)
+                        pane.sketch.add(v[k]);
+                const double count = static_cast<double>(j - i);
+                pane.count = j - i;
+                pane.mean = shift + sum / count;
+                pane.m2 = std::max(0.0, sumSq - sum * sum / count);
+                pane.min = lo;
+                pane.max = hi;
+                out.push_back(std::move(pane));
+                i = j;
+            }
+            return true;
+        }
+
+        // Assemble windows [nextWindow_, end) from the buffered panes
+        void emit(int64_t end)
+        {
+            if (end <= nextWindow_)
+                return;
+            const size_t first = windows_.size();
+            const size_t count = static_cast<size_t>(end - nextWindow_);
+            const size_t nq = options_.quantiles.size();
+            const double nan = std::numeric_limits<double>::quiet_NaN();
+            windows_.start.resize(first + count);
+            windows_.count.resize(first + count);
+            windows_.mean.resize(first + count);
+            windows_.min.resize(first + count);
+            windows_.max.resize(first + count);
+            windows_.variance.resize(first + count);
+            windows_.quantiles.resize((first + count) * nq);
+
+            const size_t block = 256;
+            const size_t numBlocks = (count + block - 1) / block;
+            const int64_t base = nextWindow_;
+            detail::parallelFor(numBlocks, options_.numThreads, [&](size_t b)
+            {
+                detail::PaneStats acc(0, options_.relativeAccuracy);
+                auto byIndex = [](const detail::PaneStats &p, int64_t index) { return p.index < index; };
+                for (size_t w = b * block; w < std::min(count, (b + 1) * block); ++w)
+                {
+                    const int64_t j = base + static_cast<int64_t>(w);
+                    const int64_t lo = j * panesPerHop_, hi = lo + panesPerWindow_;
+                    acc.count = 0;
+                    acc.mean = acc.m2 = 0.0;
+                    acc.min = std::numeric_limits<double>::infinity();
+                    acc.max = -std::numeric_limits<double>::infinity();
+                    if (withSketch_)
+                        acc.sketch.clear();
+                    for (auto it = std::lower_bound(panes_.begin(), panes_.end(), lo, byIndex);
+                         it != panes_.end() && it->index < hi; ++it)
+                        acc.merge(*it, withSketch_);
+
+                    const size_t r = first + w;
+                    windows_.start[r] = options_.origin + j * options_.hop;
+                    windows_.count[r] = acc.count;
+                    windows_.mean[r] = acc.count ? acc.mean : nan;
+                    windows_.min[r] = acc.count ? acc.min : nan;
+                    windows_.max[r] = acc.count ? acc.max : nan;
+                    windows_.variance[r] = acc.count > 1 ? acc.m2 / static_cast<double>(acc.count - 1) : nan;
+                    for (size_t k = 0; k < nq; ++k)
+                        windows_.quantiles[r * nq + k] =
+                            acc.sketch.count() ? std::min(acc.max, std::max(acc.min, acc.sketch.quantile(options_.quantiles[k]))) : nan;
+                }
+            });
+
+            nextWindow_ = end;
+            const int64_t keepFrom = nextWindow_ * panesPerHop_;
+            while (!panes_.empty() && panes_.front().index < keepFrom)
+                panes_.pop_front();
+        }
+
+        ResampleOptions options_;
+        int64_t pane_;
+        int64_t panesPerHop_;
+        int64_t panesPerWindow_;
+        bool withSketch_;
+        bool started_ = false;
+        bool finished_ = false;
+        int64_t lastTimestamp_ = 0;
+        int64_t nextWindow_ = 0;
+        std::deque<detail::PaneStats> panes_;
+        ResampledSeries windows_;
+    };
+
+    // Resample an in-memory series in one call
+    inline ResampledSeries resample(const int64_t *timestamps, const double *values, size_t n,
+                                    const ResampleOptions &options)
+    {
+        Resampler resampler(options);
+        resampler.push(timestamps, values, n);
+        resampler.finish();
+        return resampler.takeWindows();
+    }
+
+    inline ResampledSeries resample(const std::vector<int64_t> &timestamps, const std::vector<double> &values,
+                                    const ResampleOptions &options)
+    {
+        if (timestamps.size() != values.size())
+            throw std::invalid_argument("Timestamp and value columns must have the same length");
+        return resample(timestamps.data(), values.data(), timestamps.size(), options);
+    }
+}
+
+#endif // TIME_SERIES_RESAMPLING_H
@@ -5,8 +5,11 @@
 #include <cmath>
 #include <stdexcept>
 #include <numeric>
-#include <iostream>
+#include <random>
 #include <complex>
+#include <algorithm>
+#include "../ProbabilityDistributionsLib/ProbabilityDistributions.h"
+#include "../ProbabilityDistributionsLib/Parallel.h"
 
 namespace TimeSeriesAnalysis
 {
@@ -47,153 +50,1774 @@ namespace TimeSeriesAnalysis
         return result;
     }
 
-    // ARIMA Model (basic placeholder)
+    namespace detail
+    {
+        using ProbabilityDistributions::detail::parallelFor; // rethrows the first exception from fn
+
+        // Durbin-Levinson recursion: AR(order) coefficients (phi) and partial
+        // autocorrelations (pacf, optional) from autocovariances acov[0..order].
+        // Returns the one-step prediction error variance.
+        inline double durbinLevinson(const double *acov, size_t order, double *phi, double *pacf)
+        {
+            std::fill(phi, phi + order, 0.0);
+            if (pacf)
+                std::fill(pacf, pacf + order, 0.0);
+            double v = acov[0];
+            if (v <= 0.0)
+                return 0.0;
+            std::vector<double> prev(order);
+            for (size_t k = 1; k <= order; ++k)
+            {
+                double num = acov[k];
+                for (size_t j = 1; j < k; ++j)
+                    num -= phi[j - 1] * acov[k - j];
+                double a = num / v;
+                std::copy(phi, phi + k - 1, prev.begin());
+                for (size_t j = 1; j < k; ++j)
+                    phi[j - 1] = prev[j - 1] - a * prev[k - 1 - j];
+                phi[k - 1] = a;
+                if (pacf)
+                    pacf[k - 1] = a;
+                v *= (1.0 - a * a);
+                if (v <= 0.0)
+                    return 0.0;
+            }
+            return v;
+        }
+
+        // True if 1 - phi_1 B - ... - phi_p B^p has all roots outside the unit circle
+        // (step-down recursion: every implied partial autocorrelation is inside (-1, 1)).
+        inline bool isStationary(const std::vector<double> &phi)
+        {
+            std::vector<double> a(phi), b;
+            for (size_t k = a.size(); k > 0; --k)
+            {
+                double r = a[k - 1];
+                if (!(std::abs(r) < 1.0))
+                    return false;
+                double denom = 1.0 - r * r;
+                b.resize(k - 1);
+                for (size_t j = 0; j + 1 < k; ++j)
+                    b[j] = (a[j] + r * a[k - 2 - j]) / denom;
+                a.swap(b);
+            }
+            return true;
+        }
+
+        // Multiply two polynomials in B given by their coefficients (index = power).
+        inline std::vector<double> polyMultiply(const std::vector<double> &a, const std::vector<double> &b)
+        {
+            std::vector<double> c(a.size() + b.size() - 1, 0.0);
+            for (size_t i = 0; i < a.size(); ++i)
+                for (size_t j = 0; j < b.size(); ++j)
+                    c[i + j] += a[i] * b[j];
+            return c;
+        }
+
+        // Nelder-Mead simplex minimisation of f starting at x0.
+        template <typename F>
+        std::vector<double> nelderMead(F f, const std::vector<double> &x0, double step,
+                                       size_t maxIter, double tol, double &fmin)
+        {
+            size_t dim = x0.size();
+            if (dim == 0)
+            {
+                fmin = f(x0);
+                return x0;
+            }
+            std::vector<std::vector<double>> simplex(dim + 1, x0);
+            std::vector<double> values(dim + 1);
+            for (size_t i = 0; i < dim; ++i)
+                simplex[i + 1][i] += (x0[i] != 0.0 ? step * std::max(1.0, std::abs(x0[i])) : step);
+            for (size_t i = 0; i <= dim; ++i)
+                values[i] = f(simplex[i]);
+
+            std::vector<size_t> order(dim + 1);
+            std::vector<double> centroid(dim), xr(dim), xe(dim), xc(dim);
+            for (size_t iter = 0; iter < maxIter; ++iter)
+            {
+                std::iota(order.begin(), order.end(), 0);
+                std::sort(order.begin(), order.end(), [&](size_t a, size_t b)
+                          { return values[a] < values[b]; });
+                size_t best = order.front(), worst = order.back(), second = order[dim - 1];
+                if (std::abs(values[worst] - values[best]) <= tol * (std::abs(values[best]) + tol))
+                    break;
+
+                std::fill(centroid.begin(), centroid.end(), 0.0);
+                for (size_t i = 0; i <= dim; ++i)
+                    if (i != worst)
+                        for (size_t j = 0; j < dim; ++j)
+                            centroid[j] += simplex[i][j] / dim;
+
+                for (size_t j = 0; j < dim; ++j)
+                    xr[j] = centroid[j] + (centroid[j] - simplex[worst][j]);
+                double fr = f(xr);
+                if (fr < values[best])
+                {
+                    for (size_t j = 0; j < dim; ++j)
+                        xe[j] = centroid[j] + 2.0 * (centroid[j] - simplex[worst][j]);
+                    double fe = f(xe);
+                    if (fe < fr)
+                    {
+                        simplex[worst] = xe;
+                        values[worst] = fe;
+                    }
+                    else
+                    {
+                        simplex[worst] = xr;
+                        values[worst] = fr;
+                    }
+                    continue;
+                }
+                if (fr < values[second])
+                {
+                    simplex[worst] = xr;
+                    values[worst] = fr;
+                    continue;
+                }
+                bool outside = fr < values[worst];
+                for (size_t j = 0; j < dim; ++j)
+                    xc[j] = outside ? centroid[j] + 0.5 * (xr[j] - centroid[j])
+                                    : centroid[j] + 0.5 * (simplex[worst][j] - centroid[j]);
+                double fc = f(xc);
+                if (fc < std::min(fr, values[worst]))
+                {
+                    simplex[worst] = xc;
+                    values[worst] = fc;
+                    continue;
+                }
+                // Shrink towards the best vertex
+                for (size_t i = 0; i <= dim; ++i)
+                {
+                    if (i == best)
+                        continue;
+                    for (size_t j = 0; j < dim; ++j)
+                        simplex[i][j] = simplex[best][j] + 0.5 * (simplex[i][j] - simplex[best][j]);
+                    values[i] = f(simplex[i]);
+                }
+            }
+            size_t best = static_cast<size_t>(std::min_element(values.begin(), values.end()) - values.begin());
+            fmin = values[best];
+            return simplex[best];
+        }
+
+        // Conditional-sum-of-squares residuals of a zero-mean ARMA process; the first
+        // ncond residuals are taken as zero. Returns the residual sum of squares.
+        inline double armaCSS(const double *w, size_t n, const std::vector<double> &phi,
+                              const std::vector<double> &theta, size_t ncond, double *resid)
+        {
+            double ssq = 0.0;
+            size_t p = phi.size(), q = theta.size();
+            for (size_t t = 0; t < n; ++t)
+            {
+                if (t < ncond)
+                {
+                    resid[t] = 0.0;
+                    continue;
+                }
+                double e = w[t];
+                for (size_t i = 0; i < p; ++i)
+                    e -= phi[i] * w[t - 1 - i];
+                for (size_t j = 0; j < q && j < t; ++j)
+                    e -= theta[j] * resid[t - 1 - j];
+                resid[t] = e;
+                ssq += e * e;
+            }
+            return ssq;
+        }
+
+        // Exact Gaussian likelihood of a zero-mean ARMA process via the Kalman filter on
+        // Harvey's state-space form, with sigma^2 concentrated out. The state covariance is
+        // initialised at the stationary solution of P = T P T' + R R' (doubling algorithm),
+        // and the covariance recursion is dropped once the filter reaches steady state.
+        // Returns false if the AR part is not stationary.
+        inline bool armaKalman(const double *w, size_t n, const std::vector<double> &phi,
+                               const std::vector<double> &theta, double &sigma2, double &sumLogF,
+                               double *innovations)
+        {
+            if (!isStationary(phi))
+                return false;
+            size_t r = std::max(phi.size(), theta.size() + 1);
+            std::vector<double> Tphi(r, 0.0), R(r, 0.0);
+            std::copy(phi.begin(), phi.end(), Tphi.begin());
+            R[0] = 1.0;
+            std::copy(theta.begin(), theta.end(), R.begin() + 1);
+
+            // Stationary covariance: P = sum_k T^k R R' T'^k by repeated squaring
+            std::vector<double> P(r * r), A(r * r, 0.0), tmp(r * r), tmp2(r * r);
+            for (size_t i = 0; i < r; ++i)
+            {
+                for (size_t j = 0; j < r; ++j)
+                    P[i * r + j] = R[i] * R[j];
+                A[i * r] = Tphi[i];
+                if (i + 1 < r)
+                    A[i * r + i + 1] = 1.0;
+            }
+            for (int it = 0; it < 64; ++it)
+            {
+                // tmp = A P A'
+                for (size_t i = 0; i < r; ++i)
+                    for (size_t j = 0; j < r; ++j)
+                    {
+                        double s = 0.0;
+                        for (size_t k = 0; k < r; ++k)
+                            s += A[i * r + k] * P[k * r + j];
+                        tmp2[i * r + j] = s;
+                    }
+                double change = 0.0;
+                for (size_t i = 0; i < r; ++i)
+                    for (size_t j = 0; j < r; ++j)
+                    {
+                        double s = 0.0;
+                        for (size_t k = 0; k < r; ++k)
+                            s += tmp2[i * r + k] * A[j * r + k];
+                        tmp[i * r + j] = s;
+                        change = std::max(change, std::abs(s));
+                    }
+                for (size_t i = 0; i < r * r; ++i)
+                    P[i] += tmp[i];
+                if (change <= 1e-14 * std::abs(P[0]))
+                    break;
+                // A = A * A
+                for (size_t i = 0; i < r; ++i)
+                    for (size_t j = 0; j < r; ++j)
+                    {
+                        double s = 0.0;
+                        for (size_t k = 0; k < r; ++k)
+                            s += A[i * r + k] * A[k * r + j];
+                        tmp[i * r + j] = s;
+                    }
+                A.swap(tmp);
+            }
+
+            std::vector<double> a(r, 0.0), ap(r), K(r), TP(r * r);
+            double ssq = 0.0, prevF = -1.0;
+            bool steady = false;
+            sumLogF = 0.0;
+            for (size_t t = 0; t < n; ++t)
+            {
+                // Prediction step (the first observation uses the stationary prior as is)
+                if (t > 0)
+                {
+                    for (size_t i = 0; i < r; ++i)
+                        ap[i] = Tphi[i] * a[0] + (i + 1 < r ? a[i + 1] : 0.0);
+                    a.swap(ap);
+                    if (!steady)
+                    {
+                        // TP = T P, then P = TP T' + R R'
+                        for (size_t i = 0; i < r; ++i)
+                            for (size_t j = 0; j < r; ++j)
+                                TP[i * r + j] = Tphi[i] * P[j] + (i + 1 < r ? P[(i + 1) * r + j] : 0.0);
+                        for (size_t i = 0; i < r; ++i)
+                            for (size_t j = 0; j < r; ++j)
+                                P[i * r + j] = TP[i * r] * Tphi[j] + (j + 1 < r ? TP[i * r + j + 1] : 0.0) + R[i] * R[j];
+                    }
+                }
+                double F = P[0];
+                if (!(F > 0.0))
+                    return false;
+                double v = w[t] - a[0];
+                if (innovations)
+                    innovations[t] = v;
+                ssq += v * v / F;
+                sumLogF += std::log(F);
+                if (!steady)
+                {
+                    for (size_t i = 0; i < r; ++i)
+                        K[i] = P[i] / F;
+                    steady = t > 0 && std::abs(F - prevF) <= 1e-12 * F;
+                    prevF = F;
+                }
+                for (size_t i = 0; i < r; ++i)
+                    a[i] += K[i] * v;
+                if (!steady)
+                {
+                    // P -= K P[0,:], walking rows bottom-up so row 0 is overwritten last
+                    for (size_t i = r; i-- > 0;)
+                        for (size_t j = 0; j < r; ++j)
+                            P[i * r + j] -= K[i] * P[j];
+                }
+            }
+            sigma2 = ssq / n;
+            return std::isfinite(sigma2);
+        }
+    }
+
+    // Estimation method for ARIMA models:
+    // CSS    - conditional sum of squares (fast, conditions on the first p + sP values)
+    // ML     - exact Gaussian maximum likelihood via the Kalman filter
+    // CSS_ML - CSS estimates used as starting values for exact ML (default)
+    enum class ARIMAMethod
+    {
+        CSS,
+        ML,
+        CSS_ML
+    };
+
+    // Order of a seasonal ARIMA(p,d,q)(P,D,Q)_s model; s = 0 means non-seasonal.
+    struct ARIMAOrder
+    {
+        ARIMAOrder(int p = 0, int d = 0, int q = 0, int P = 0, int D = 0, int Q = 0, size_t s = 0)
+            : p(p), d(d), q(q), P(P), D(D), Q(Q), s(s) {}
+        int p, d, q;
+        int P, D, Q;
+        size_t s;
+    };
+
+    // Point forecasts with lower/upper prediction interval bounds
+    struct ARIMAForecast
+    {
+        std::vector<double> mean;
+        std::vector<double> lower;
+        std::vector<double> upper;
+    };
+
+    // Seasonal ARIMA(p,d,q)(P,D,Q)_s model:
+    //   phi(B) Phi(B^s) (1-B)^d (1-B^s)^D (y_t - mu) = theta(B) Theta(B^s) e_t
+    // The mean mu is only estimated for undifferenced models.
+    class ARIMAModel
+    {
+    public:
+        ARIMAModel() {}
+
+        ARIMAModel(int p, int d, int q) : ARIMAModel(ARIMAOrder(p, d, q)) {}
+
+        explicit ARIMAModel(const ARIMAOrder &order) : order_(order)
+        {
+            if (order.p < 0 || order.d < 0 || order.q < 0 || order.P < 0 || order.D < 0 || order.Q < 0)
+                throw std::invalid_argument("ARIMA orders must be non-negative");
+            if (order.s == 0 && (order.P > 0 || order.D > 0 || order.Q > 0))
+                throw std::invalid_argument("Seasonal orders require a seasonal period");
+        }
+
+        template <typename T>
+        void fit(const std::vector<T> &data, ARIMAMethod method = ARIMAMethod::CSS_ML)
+        {
+            std::vector<double> y(data.begin(), data.end());
+            fit(y.data(), y.size(), method);
+        }
+
+        void fit(const double *y, size_t n, ARIMAMethod method = ARIMAMethod::CSS_ML)
+        {
+            fitted_ = false;
+            const size_t s = order_.s;
+            const size_t ndiff = order_.d + s * order_.D;
+            const size_t ncond = order_.p + s * order_.P;
+            const size_t nparams = order_.p + order_.q + order_.P + order_.Q;
+            if (n <= ndiff + ncond + nparams + 1)
+                throw std::invalid_argument("Series too short for ARIMA order");
+
+            // Differencing polynomial (1-B)^d (1-B^s)^D
+            std::vector<double> diffPoly(1, 1.0);
+            for (int i = 0; i < order_.d; ++i)
+                diffPoly = detail::polyMultiply(diffPoly, {1.0, -1.0});
+            for (int i = 0; i < order_.D; ++i)
+            {
+                std::vector<double> seas(s + 1, 0.0);
+                seas[0] = 1.0;
+                seas[s] = -1.0;
+                diffPoly = detail::polyMultiply(diffPoly, seas);
+            }
+
+            const size_t m = n - ndiff;
+            std::vector<double> w(m);
+            for (size_t t = 0; t < m; ++t)
+            {
+                double v = 0.0;
+                for (size_t k = 0; k < diffPoly.size(); ++k)
+                    v += diffPoly[k] * y[t + ndiff - k];
+                w[t] = v;
+            }
+            mean_ = 0.0;
+            if (ndiff == 0)
+            {
+                mean_ = std::accumulate(w.begin(), w.end(), 0.0) / m;
+                for (double &v : w)
+                    v -= mean_;
+            }
+
+            // Starting values: Yule-Walker (Durbin-Levinson) for the non-seasonal AR part
+            std::vector<double> x0(nparams, 0.0);
+            if (order_.p > 0)
+            {
+                std::vector<double> acov(order_.p + 1, 0.0);
+                for (size_t k = 0; k <= static_cast<size_t>(order_.p); ++k)
+                {
+                    for (size_t t = k; t < m; ++t)
+                        acov[k] += w[t] * w[t - k];
+                    acov[k] /= m;
+                }
+                detail::durbinLevinson(acov.data(), order_.p, x0.data(), nullptr);
+            }
+
+            std::vector<double> phi, theta, resid(m);
+            auto cssObjective = [&](const std::vector<double> &x) -> double
+            {
+                expand(x, phi, theta);
+                double ssq = detail::armaCSS(w.data(), m, phi, theta, ncond, resid.data());
+                if (!std::isfinite(ssq) || ssq <= 0.0)
+                    return 1e10;
+                return 0.5 * std::log(ssq / (m - ncond));
+            };
+            auto mlObjective = [&](const std::vector<double> &x) -> double
+            {
+                expand(x, phi, theta);
+                double sigma2, sumLogF;
+                if (!detail::armaKalman(w.data(), m, phi, theta, sigma2, sumLogF, nullptr) || sigma2 <= 0.0)
+                    return 1e10;
+                return 0.5 * (std::log(sigma2) + sumLogF / m);
+            };
+
+            const size_t maxIter = 200 * (nparams + 1);
+            double fmin;
+            params_ = x0;
+            if (method != ARIMAMethod::ML)
+                params_ = detail::nelderMead(cssObjective, x0, 0.1, maxIter, 1e-10, fmin);
+            if (method != ARIMAMethod::CSS)
+            {
+                expand(params_, phi, theta);
+                std::vector<double> start = detail::isStationary(phi) ? params_ : x0;
+                params_ = detail::nelderMead(mlObjective, start, 0.1, maxIter, 1e-10, fmin);
+            }
+            expand(params_, phi_, theta_);
+
+            // Final residuals, innovation variance and log-likelihood
+            double sumLogF = 0.0;
+            if (method == ARIMAMethod::CSS)
+            {
+                double ssq = detail::armaCSS(w.data(), m, phi_, theta_, ncond, resid.data());
+                nUsed_ = m - ncond;
+                sigma2_ = ssq / nUsed_;
+            }
+            else
+            {
+                if (!detail::armaKalman(w.data(), m, phi_, theta_, sigma2_, sumLogF, resid.data()))
+                    throw std::runtime_error("ARIMA likelihood evaluation failed");
+                nUsed_ = m;
+            }
+            const double twoPi = 2.0 * std::acos(-1.0);
+            logLikelihood_ = -0.5 * (nUsed_ * (std::log(twoPi * sigma2_) + 1.0) + sumLogF);
+
+            residuals_.assign(n, 0.0);
+            std::copy(resid.begin(), resid.end(), residuals_.begin() + ndiff);
+
+            // Combined AR polynomial phi(B) Phi(B^s) (1-B)^d (1-B^s)^D used for forecasting
+            std::vector<double> arPoly(phi_.size() + 1, 1.0);
+            for (size_t i = 0; i < phi_.size(); ++i)
+                arPoly[i + 1] = -phi_[i];
+            arPoly = detail::polyMultiply(arPoly, diffPoly);
+            arAll_.assign(arPoly.size() - 1, 0.0);
+            for (size_t i = 1; i < arPoly.size(); ++i)
+                arAll_[i - 1] = -arPoly[i];
+
+            yTail_.assign(y + n - std::min(n, arAll_.size()), y + n);
+            eTail_.assign(residuals_.end() - std::min(n, theta_.size()), residuals_.end());
+            fitted_ = true;
+        }
+
+        // Multi-step forecasts with prediction intervals at the given confidence level.
+        // Interval widths use the psi-weights of the full (integrated) model.
+        ARIMAForecast forecast(size_t horizon, double level = 0.95) const
+        {
+            if (!fitted_)
+                throw std::logic_error("ARIMA model has not been fitted");
+            if (level <= 0.0 || level >= 1.0)
+                throw std::invalid_argument("Confidence level must be in (0, 1)");
+
+            const size_t pa = arAll_.size(), q = theta_.size();
+            std::vector<double> ys(yTail_), es(eTail_);
+            for (double &v : ys)
+                v -= mean_;
+            ys.insert(ys.begin(), pa - ys.size(), 0.0);
+            es.insert(es.begin(), q - es.size(), 0.0);
+
+            ARIMAForecast fc;
+            fc.mean.resize(horizon);
+            for (size_t h = 0; h < horizon; ++h)
+            {
+                size_t t = ys.size();
+                double v = 0.0;
+                for (size_t i = 0; i < pa; ++i)
+                    v += arAll_[i] * ys[t - 1 - i];
+                // Future shocks have zero expectation; only known residuals contribute
+                for (size_t j = h; j < q; ++j)
+                    v += theta_[j] * es[es.size() - 1 - (j - h)];
+                ys.push_back(v);
+                fc.mean[h] = v + mean_;
+            }
+
+            std::vector<double> psi(horizon, 0.0);
+            double z = ProbabilityDistributions::detail::standardNormalQuantile(0.5 + level / 2.0), cum = 0.0;
+            fc.lower.resize(horizon);
+            fc.upper.resize(horizon);
+            for (size_t j = 0; j < horizon; ++j)
+            {
+                psi[j] = (j == 0) ? 1.0 : (j - 1 < q ? theta_[j - 1] : 0.0);
+                for (size_t k = 1; k <= std::min(j, pa); ++k)
+                    psi[j] += arAll_[k - 1] * psi[j - k];
+                cum += psi[j] * psi[j];
+                double half = z * std::sqrt(sigma2_ * cum);
+                fc.lower[j] = fc.mean[j] - half;
+                fc.upper[j] = fc.mean[j] + half;
+            }
+            return fc;
+        }
+
+        bool isFitted() const { return fitted_; }
+        const ARIMAOrder &order() const { return order_; }
+        double mean() const { return mean_; }
+        double sigma2() const { return sigma2_; }
+        double logLikelihood() const { return logLikelihood_; }
+        double aic() const { return -2.0 * logLikelihood_ + 2.0 * (params_.size() + 1 + (order_.d + order_.D == 0)); }
+        // One-step-ahead residuals; zero for the first d + sD observations
+        const std::vector<double> &residuals() const { return residuals_; }
+        // Estimated coefficients in the order phi(p), theta(q), Phi(P), Theta(Q)
+        const std::vector<double> &coefficients() const { return params_; }
+        // Expanded AR/MA polynomials phi(B)Phi(B^s) and theta(B)Theta(B^s)
+        const std::vector<double> &arPolynomial() const { return phi_; }
+        const std::vector<double> &maPolynomial() const { return theta_; }
+
+    private:
+        // Expand [phi, theta, Phi, Theta] into the multiplicative AR and MA lag polynomials
+        void expand(const std::vector<double> &x, std::vector<double> &phi, std::vector<double> &theta) const
+        {
+            const size_t p = order_.p, q = order_.q, P = order_.P, Q = order_.Q, s = order_.s;
+            phi.assign(p + s * P, 0.0);
+            theta.assign(q + s * Q, 0.0);
+            for (size_t i = 0; i < p; ++i)
+                phi[i] = x[i];
+            for (size_t j = 0; j < q; ++j)
+                theta[j] = x[p + j];
+            for (size_t I = 0; I < P; ++I)
+            {
+                double sp = x[p + q + I];
+                size_t lag = s * (I + 1);
+                phi[lag - 1] += sp;
+                for (size_t i = 0; i < p; ++i)
+                    phi[lag + i] -= sp * x[i];
+            }
+            for (size_t J = 0; J < Q; ++J)
+            {
+                double sq = x[p + q + P + J];
+                size_t lag = s * (J + 1);
+                theta[lag - 1] += sq;
+                for (size_t j = 0; j < q; ++j)
+                    theta[lag + j] += sq * x[p + j];
+            }
+        }
+
+        ARIMAOrder order_;
+        bool fitted_ = false;
+        double mean_ = 0.0;
+        double sigma2_ = 0.0;
+        double logLikelihood_ = 0.0;
+        size_t nUsed_ = 0;
+        std::vector<double> params_;
+        std::vector<double> phi_, theta_, arAll_;
+        std::vector<double> yTail_, eTail_;
+        std::vector<double> residuals_;
+    };
+
+    // ARIMA(p,d,q) fitted values (one-step-ahead in-sample predictions)
     template <typename T>
     std::vector<double> ARIMA(const std::vector<T> &data, int p, int d, int q)
     {
-        // Placeholder: Implementing full ARIMA is complex
-        // For now, return input data as is
-        return std::vector<double>(data.begin(), data.end());
+        ARIMAModel model(p, d, q);
+        model.fit(data);
+        std::vector<double> fitted(data.begin(), data.end());
+        const std::vector<double> &resid = model.residuals();
+        for (size_t i = 0; i < fitted.size(); ++i)
+            fitted[i] -= resid[i];
+        return fitted;
+    }
+
+    // Fit the same ARIMA order to many independent series across threads
+    // (numThreads = 0 uses all hardware threads). Series that cannot be fitted
+    // (too short, degenerate) are returned unfitted; check isFitted().
+    template <typename T>
+    std::vector<ARIMAModel> fitARIMABatch(const std::vector<std::vector<T>> &series, const ARIMAOrder &order,
+                                          ARIMAMethod method = ARIMAMethod::CSS_ML, size_t numThreads = 0)
+    {
+        std::vector<ARIMAModel> models(series.size(), ARIMAModel(order));
+        detail::parallelFor(series.size(), numThreads, [&](size_t i)
+                            {
+            try
+            {
+                models[i].fit(series[i], method);
+            }
+            catch (const std::exception &)
+            {
+            } });
+        return models;
+    }
+
+    namespace detail
+    {
+        inline size_t nextPowerOfTwo(size_t n)
+        {
+            size_t p = 1;
+            while (p < n)
+                p <<= 1;
+            return p;
+        }
+
+        // In-place iterative radix-2 FFT (unnormalised); a.size() must be a power of two
+        inline void fftRadix2(std::vector<std::complex<double>> &a, bool inverse)
+        {
+            const size_t n = a.size();
+            if (n <= 1)
+                return;
+            for (size_t i = 1, j = 0; i < n; ++i)
+            {
+                size_t bit = n >> 1;
+                for (; j & bit; bit >>= 1)
+                    j ^= bit;
+                j ^= bit;
+                if (i < j)
+                    std::swap(a[i], a[j]);
+            }
+            const double PI = std::acos(-1);
+            std::vector<std::complex<double>> roots(n / 2);
+            for (size_t k = 0; k < n / 2; ++k)
+                roots[k] = std::polar(1.0, (inverse ? 2.0 : -2.0) * PI * k / n);
+            for (size_t len = 2; len <= n; len <<= 1)
+            {
+                const size_t half = len / 2, stride = n / len;
+                for (size_t i = 0; i < n; i += len)
+                {
+                    for (size_t k = 0; k < half; ++k)
+                    {
+                        std::complex<double> u = a[i + k];
+                        std::complex<double> v = a[i + k + half] * roots[k * stride];
+                        a[i + k] = u + v;
+                        a[i + k + half] = u - v;
+                    }
+                }
+            }
+        }
+
+        // DFT of any length (unnormalised): radix-2 directly, otherwise Bluestein's
+        // chirp-z algorithm on power-of-two FFTs. O(N log N) either way.
+        inline std::vector<std::complex<double>> dft(std::vector<std::complex<double>> a, bool inverse)
+        {
+            const size_t n = a.size();
+            if ((n & (n - 1)) == 0)
+            {
+                fftRadix2(a, inverse);
+                return a;
+            }
+            const double PI = std::acos(-1);
+            std::vector<std::complex<double>> chirp(n);
+            for (size_t k = 0; k < n; ++k)
+                chirp[k] = std::polar(1.0, (inverse ? PI : -PI) * static_cast<double>((k * k) % (2 * n)) / n);
+
+            const size_t m = nextPowerOfTwo(2 * n - 1);
+            std::vector<std::complex<double>> A(m), B(m);
+            for (size_t k = 0; k < n; ++k)
+                A[k] = a[k] * chirp[k];
+            B[0] = std::conj(chirp[0]);
+            for (size_t k = 1; k < n; ++k)
+                B[k] = B[m - k] = std::conj(chirp[k]);
+            fftRadix2(A, false);
+            fftRadix2(B, false);
+            for (size_t k = 0; k < m; ++k)
+                A[k] *= B[k];
+            fftRadix2(A, true);
+            for (size_t k = 0; k < n; ++k)
+                a[k] = A[k] * chirp[k] / static_cast<double>(m);
+            return a;
+        }
+
+        // Spectra of two real sequences with a single complex FFT: transform x + i*y,
+        // then split using the Hermitian symmetry of real-input spectra.
+        inline void realPairFFT(const std::vector<double> &x, const std::vector<double> &y, size_t nfft,
+                                std::vector<std::complex<double>> &X, std::vector<std::complex<double>> &Y)
+        {
+            std::vector<std::complex<double>> z(nfft);
+            for (size_t i = 0; i < x.size(); ++i)
+                z[i].real(x[i]);
+            for (size_t i = 0; i < y.size(); ++i)
+                z[i].imag(y[i]);
+            fftRadix2(z, false);
+            X.resize(nfft);
+            Y.resize(nfft);
+            for (size_t k = 0; k < nfft; ++k)
+            {
+                std::complex<double> zk = z[k], zc = std::conj(z[(nfft - k) & (nfft - 1)]);
+                X[k] = 0.5 * (zk + zc);
+                Y[k] = std::complex<double>(0.0, -0.5) * (zk - zc);
+            }
+        }
+
+        // sum_i a[i] * b[i] with four independent accumulators so the loop pipelines/vectorises
+        inline double dotProduct(const double *a, const double *b, size_t len)
+        {
+            double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+            size_t i = 0;
+            for (; i + 4 <= len; i += 4)
+            {
+                s0 += a[i] * b[i];
+                s1 += a[i + 1] * b[i + 1];
+                s2 += a[i + 2] * b[i + 2];
+                s3 += a[i + 3] * b[i + 3];
+            }
+            for (; i < len; ++i)
+                s0 += a[i] * b[i];
+            return (s0 + s1) + (s2 + s3);
+        }
+
+        // Cost model for choosing between direct O(n * lags) sums and an FFT of size nfft
+        inline bool preferDirect(size_t n, size_t lags, size_t nfft)
+        {
+            double fftCost = 8.0 * nfft * std::log2(static_cast<double>(nfft));
+            return static_cast<double>(n) * lags <= fftCost;
+        }
+
+        // Lagged cross-products of centred series: pos[k] = sum_t x[t+k] y[t] and
+        // neg[k] = sum_t x[t] y[t+k] for k = 0..maxLag (neg may be null for autocovariance).
+        inline void laggedProducts(const std::vector<double> &x, const std::vector<double> &y, size_t maxLag,
+                                   double *pos, double *neg)
+        {
+            const size_t n = x.size();
+            const bool same = (neg == nullptr);
+            const size_t nfft = nextPowerOfTwo(n + maxLag);
+            if (preferDirect(n, (maxLag + 1) * (same ? 1 : 2), nfft))
+            {
+                for (size_t k = 0; k <= maxLag; ++k)
+                {
+                    pos[k] = dotProduct(x.data() + k, y.data(), n - k);
+                    if (neg)
+                        neg[k] = dotProduct(x.data(), y.data() + k, n - k);
+                }
+                return;
+            }
+            std::vector<std::complex<double>> X(nfft);
+            if (same)
+            {
+                for (size_t i = 0; i < n; ++i)
+                    X[i].real(x[i]);
+                fftRadix2(X, false);
+                for (auto &v : X)
+                    v = std::norm(v);
+            }
+            else
+            {
+                std::vector<std::complex<double>> Y;
+                realPairFFT(x, y, nfft, X, Y);
+                for (size_t k = 0; k < nfft; ++k)
+                    X[k] *= std::conj(Y[k]);
+            }
+            fftRadix2(X, true);
+            for (size_t k = 0; k <= maxLag; ++k)
+            {
+                pos[k] = X[k].real() / nfft;
+                if (neg)
+                    neg[k] = X[(nfft - k) & (nfft - 1)].real() / nfft;
+            }
+        }
+
+        template <typename T>
+        std::vector<double> centred(const std::vector<T> &data, double &sumSquares)
+        {
+            std::vector<double> out(data.begin(), data.end());
+            double m = std::accumulate(out.begin(), out.end(), 0.0) / out.size();
+            sumSquares = 0.0;
+            for (double &v : out)
+            {
+                v -= m;
+                sumSquares += v * v;
+            }
+            return out;
+        }
     }
 
-    // Fourier Transform (Discrete Fourier Transform)
+    // Fourier Transform (Discrete Fourier Transform computed with an FFT)
     template <typename T>
     std::vector<std::complex<double>> fourierTransform(const std::vector<T> &data)
     {
-        size_t N = data.size();
-        std::vector<std::complex<double>> result(N);
-        const double PI = std::acos(-1);
-        for (size_t k = 0; k < N; ++k)
+        std::vector<std::complex<double>> a(data.size());
+        for (size_t i = 0; i < data.size(); ++i)
+            a[i] = static_cast<double>(data[i]);
+        return detail::dft(std::move(a), false);
+    }
+
+    // Inverse Discrete Fourier Transform (normalised by 1/N)
+    inline std::vector<std::complex<double>> inverseFourierTransform(const std::vector<std::complex<double>> &spectrum)
+    {
+        std::vector<std::complex<double>> result = detail::dft(spectrum, true);
+        for (auto &v : result)
+            v /= static_cast<double>(result.size());
+        return result;
+    }
+
+    // Sample autocorrelation for lags 0..maxLag (biased estimator, normalised by the lag-0 term).
+    // Short lag ranges use direct sums; long ones use an FFT of the zero-padded series.
+    template <typename T>
+    std::vector<double> autocorrelation(const std::vector<T> &data, size_t maxLag)
+    {
+        if (data.empty() || maxLag >= data.size())
+            throw std::invalid_argument("Invalid data or maximum lag");
+        double c0;
+        std::vector<double> x = detail::centred(data, c0);
+        if (c0 == 0.0)
+            throw std::invalid_argument("Data has zero variance");
+        std::vector<double> acf(maxLag + 1);
+        detail::laggedProducts(x, x, maxLag, acf.data(), nullptr);
+        for (double &v : acf)
+            v /= c0;
+        acf[0] = 1.0;
+        return acf;
+    }
+
+    // Partial autocorrelation for lags 0..maxLag (element 0 is 1), from the sample
+    // autocorrelation via the Durbin-Levinson recursion.
+    template <typename T>
+    std::vector<double> partialAutocorrelation(const std::vector<T> &data, size_t maxLag)
+    {
+        std::vector<double> acf = autocorrelation(data, maxLag);
+        std::vector<double> pacf(maxLag + 1, 1.0), phi(maxLag);
+        detail::durbinLevinson(acf.data(), maxLag, phi.data(), pacf.data() + 1);
+        return pacf;
+    }
+
+    // Sample cross-correlation of x[t+k] with y[t] for k = -maxLag..maxLag;
+    // element maxLag + k holds lag k.
+    template <typename T>
+    std::vector<double> crossCorrelation(const std::vector<T> &x, const std::vector<T> &y, size_t maxLag)
+    {
+        if (x.empty() || x.size() != y.size() || maxLag >= x.size())
+            throw std::invalid_argument("Series must be non-empty, of equal length and longer than the maximum lag");
+        double sxx, syy;
+        std::vector<double> xc = detail::centred(x, sxx), yc = detail::centred(y, syy);
+        if (sxx == 0.0 || syy == 0.0)
+            throw std::invalid_argument("Data has zero variance");
+        std::vector<double> pos(maxLag + 1), neg(maxLag + 1), ccf(2 * maxLag + 1);
+        detail::laggedProducts(xc, yc, maxLag, pos.data(), neg.data());
+        double norm = std::sqrt(sxx * syy);
+        for (size_t k = 0; k <= maxLag; ++k)
+        {
+            ccf[maxLag + k] = pos[k] / norm;
+            ccf[maxLag - k] = neg[k] / norm;
+        }
+        return ccf;
+    }
+
+    // Full linear convolution of a and b (length a.size() + b.size() - 1)
+    template <typename T>
+    std::vector<double> convolve(const std::vector<T> &a, const std::vector<T> &b)
+    {
+        if (a.empty() || b.empty())
+            throw std::invalid_argument("Input vectors must be non-empty");
+        const size_t outSize = a.size() + b.size() - 1;
+        const size_t nfft = detail::nextPowerOfTwo(outSize);
+        std::vector<double> x(a.begin(), a.end()), y(b.begin(), b.end());
+        std::vector<double> result(outSize, 0.0);
+        if (detail::preferDirect(std::max(x.size(), y.size()), std::min(x.size(), y.size()), nfft))
         {
-            std::complex<double> sum(0.0, 0.0);
-            for (size_t n = 0; n < N; ++n)
+            // Scatter the shorter sequence so the inner loop runs over contiguous memory
+            const std::vector<double> &shortSeq = x.size() <= y.size() ? x : y;
+            const std::vector<double> &longSeq = x.size() <= y.size() ? y : x;
+            for (size_t j = 0; j < shortSeq.size(); ++j)
             {
-                double angle = 2 * PI * k * n / N;
-                sum += std::polar(static_cast<double>(data[n]), -angle);
+                const double s = shortSeq[j];
+                double *out = result.data() + j;
+                for (size_t i = 0; i < longSeq.size(); ++i)
+                    out[i] += s * longSeq[i];
             }
-            result[k] = sum;
+            return result;
         }
+        std::vector<std::complex<double>> X, Y;
+        detail::realPairFFT(x, y, nfft, X, Y);
+        for (size_t k = 0; k < nfft; ++k)
+            X[k] *= Y[k];
+        detail::fftRadix2(X, true);
+        for (size_t i = 0; i < outSize; ++i)
+            result[i] = X[i].real() / nfft;
         return result;
     }
-    // Seasonal Decomposition of Time Series (simplified STL placeholder)
+
+    // Options for STL seasonal-trend decomposition by LOESS (Cleveland et al., 1990).
+    // Window lengths are forced odd; zero means the usual default derived from the period.
+    // Jumps > 1 fit LOESS only every jump-th point and interpolate linearly in between.
+    struct STLOptions
+    {
+        explicit STLOptions(size_t period = 2, bool robust = false)
+            : period(period), seasonalWindow(7), trendWindow(0), lowPassWindow(0),
+              seasonalDegree(0), trendDegree(1), lowPassDegree(1),
+              seasonalJump(0), trendJump(0), lowPassJump(0),
+              innerIterations(0), outerIterations(0), robust(robust) {}
+        size_t period;
+        size_t seasonalWindow; // span (in cycles) of the cycle-subseries smoother
+        size_t trendWindow;    // default: next odd >= 1.5 * period / (1 - 1.5 / seasonalWindow)
+        size_t lowPassWindow;  // default: next odd >= period
+        int seasonalDegree, trendDegree, lowPassDegree;
+        size_t seasonalJump, trendJump, lowPassJump; // default: ceil(window / 10)
+        size_t innerIterations; // default: 2, or 1 when robust
+        size_t outerIterations; // default: 0, or 15 when robust
+        bool robust;
+    };
+
+    // Scratch space for STL. Reusing one workspace across calls avoids all allocation
+    // after the first decomposition of a given length; memory is O(n + period).
+    struct STLWorkspace
+    {
+        std::vector<double> work;    // 5 columns of n + 2 * period
+        std::vector<double> weights; // robustness weights, n
+        std::vector<double> kernel;  // tricube weights for the current half-width
+        double kernelHalfWidth = -1.0;
+    };
+
+    namespace detail
+    {
+        // Tricube weight for integer distance r from the fit point with half-width h; the
+        // table is rebuilt only when h changes, which happens only near series edges.
+        inline const std::vector<double> &stlKernel(STLWorkspace &ws, double h)
+        {
+            if (h != ws.kernelHalfWidth)
+            {
+                const double h9 = 0.999 * h, h1 = 0.001 * h;
+                ws.kernel.resize(static_cast<size_t>(h) + 1);
+                for (size_t r = 0; r < ws.kernel.size(); ++r)
+                {
+                    double u = r / h;
+                    double t = 1.0 - u * u * u;
+                    ws.kernel[r] = (r <= h1) ? 1.0 : (r <= h9 ? t * t * t : 0.0);
+                }
+                ws.kernelHalfWidth = h;
+            }
+            return ws.kernel;
+        }
+
+        // Local (degree 0 or 1) weighted regression of y[nleft..nright] evaluated at xs
+        inline bool stlEst(const double *y, size_t n, size_t len, int ideg, double xs, double &ys,
+                           size_t nleft, size_t nright, double *w, bool userw, const double *rw, STLWorkspace &ws)
+        {
+            const double range = static_cast<double>(n) - 1.0;
+            double h = std::max(xs - nleft, nright - xs);
+            if (len > n)
+                h += static_cast<double>((len - n) / 2);
+            const std::vector<double> &kernel = stlKernel(ws, h);
+
+            double a = 0.0;
+            for (size_t j = nleft; j <= nright; ++j)
+            {
+                size_t r = static_cast<size_t>(std::abs(j - xs) + 0.5);
+                w[j] = r < kernel.size() ? kernel[r] : 0.0;
+                if (userw)
+                    w[j] *= rw[j];
+                a += w[j];
+            }
+            if (a <= 0.0)
+                return false;
+            for (size_t j = nleft; j <= nright; ++j)
+                w[j] /= a;
+            if (h > 0.0 && ideg > 0)
+            {
+                a = 0.0;
+                for (size_t j = nleft; j <= nright; ++j)
+                    a += w[j] * j;
+                double b = xs - a, c = 0.0;
+                for (size_t j = nleft; j <= nright; ++j)
+                    c += w[j] * (j - a) * (j - a);
+                if (std::sqrt(c) > 0.001 * range)
+                {
+                    b /= c;
+                    for (size_t j = nleft; j <= nright; ++j)
+                        w[j] *= b * (j - a) + 1.0;
+                }
+            }
+            double sum = 0.0;
+            for (size_t j = nleft; j <= nright; ++j)
+                sum += w[j] * y[j];
+            ys = sum;
+            return true;
+        }
+
+        // LOESS smooth of y into ys, fitting every njump-th point and interpolating
+        inline void stlEss(const double *y, size_t n, size_t len, int ideg, size_t njump, bool userw,
+                           const double *rw, double *ys, double *res, STLWorkspace &ws)
+        {
+            if (n < 2)
+            {
+                ys[0] = y[0];
+                return;
+            }
+            const size_t jump = std::min(njump, n - 1);
+            size_t nleft = 0, nright = 0;
+            if (len >= n)
+            {
+                nright = n - 1;
+                for (size_t i = 0; i < n; i += jump)
+                    if (!stlEst(y, n, len, ideg, static_cast<double>(i), ys[i], nleft, nright, res, userw, rw, ws))
+                        ys[i] = y[i];
+            }
+            else if (jump == 1)
+            {
+                const size_t nsh = (len + 1) / 2;
+                nright = len - 1;
+                for (size_t i = 0; i < n; ++i)
+                {
+                    if (i >= nsh && nright != n - 1)
+                    {
+                        ++nleft;
+                        ++nright;
+                    }
+                    if (!stlEst(y, n, len, ideg, static_cast<double>(i), ys[i], nleft, nright, res, userw, rw, ws))
+                        ys[i] = y[i];
+                }
+            }
+            else
+            {
+                const size_t nsh = (len + 1) / 2;
+                for (size_t i = 0; i < n; i += jump)
+                {
+                    if (i + 1 < nsh)
+                    {
+                        nleft = 0;
+                        nright = len - 1;
+                    }
+                    else if (i >= n - nsh)
+                    {
+                        nleft = n - len;
+                        nright = n - 1;
+                    }
+                    else
+                    {
+                        nleft = i + 1 - nsh;
+                        nright = len + i - nsh;
+                    }
+                    if (!stlEst(y, n, len, ideg, static_cast<double>(i), ys[i], nleft, nright, res, userw, rw, ws))
+                        ys[i] = y[i];
+                }
+            }
+            if (jump != 1)
+            {
+                for (size_t i = 0; i + jump < n; i += jump)
+                {
+                    double delta = (ys[i + jump] - ys[i]) / jump;
+                    for (size_t j = i + 1; j < i + jump; ++j)
+                        ys[j] = ys[i] + delta * (j - i);
+                }
+                size_t k = ((n - 1) / jump) * jump;
+                if (k != n - 1)
+                {
+                    if (!stlEst(y, n, len, ideg, static_cast<double>(n - 1), ys[n - 1], nleft, nright, res, userw, rw, ws))
+                        ys[n - 1] = y[n - 1];
+                    if (k != n - 2)
+                    {
+                        double delta = (ys[n - 1] - ys[k]) / (n - 1 - k);
+                        for (size_t j = k + 1; j < n - 1; ++j)
+                            ys[j] = ys[k] + delta * (j - k);
+                    }
+                }
+            }
+        }
+
+        // Smooth each cycle-subseries and extend it by one period at both ends;
+        // season receives n + 2 * np values.
+        inline void stlSubseries(const double *y, size_t n, size_t np, size_t ns, int isdeg, size_t nsjump, bool userw,
+                                 const double *rw, double *season, double *work1, double *work2, double *work3,
+                                 double *work4, STLWorkspace &ws)
+        {
+            for (size_t j = 0; j < np; ++j)
+            {
+                const size_t k = (n - 1 - j) / np + 1;
+                for (size_t i = 0; i < k; ++i)
+                    work1[i] = y[i * np + j];
+                if (userw)
+                    for (size_t i = 0; i < k; ++i)
+                        work3[i] = rw[i * np + j];
+                stlEss(work1, k, ns, isdeg, nsjump, userw, work3, work2 + 1, work4, ws);
+                size_t nright = std::min(ns, k) - 1;
+                if (!stlEst(work1, k, ns, isdeg, -1.0, work2[0], 0, nright, work4, userw, work3, ws))
+                    work2[0] = work2[1];
+                size_t nleft = k > ns ? k - ns : 0;
+                if (!stlEst(work1, k, ns, isdeg, static_cast<double>(k), work2[k + 1], nleft, k - 1, work4, userw, work3, ws))
+                    work2[k + 1] = work2[k];
+                for (size_t m = 0; m < k + 2; ++m)
+                    season[m * np + j] = work2[m];
+            }
+        }
+
+        // Running mean of width len: out has n - len + 1 values
+        inline void stlMovingAverage(const double *x, size_t n, size_t len, double *out)
+        {
+            double sum = 0.0;
+            for (size_t i = 0; i < len; ++i)
+                sum += x[i];
+            out[0] = sum / len;
+            for (size_t i = len; i < n; ++i)
+            {
+                sum += x[i] - x[i - len];
+                out[i - len + 1] = sum / len;
+            }
+        }
+
+        // One pass of the STL inner loop (ni iterations)
+        inline void stlInner(const double *y, size_t n, const STLOptions &o, bool userw, STLWorkspace &ws,
+                             double *season, double *trend)
+        {
+            const size_t np = o.period, m = n + 2 * np;
+            double *w0 = ws.work.data(), *w1 = w0 + m, *w2 = w1 + m, *w3 = w2 + m, *w4 = w3 + m;
+            const double *rw = ws.weights.data();
+            for (size_t iter = 0; iter < o.innerIterations; ++iter)
+            {
+                for (size_t i = 0; i < n; ++i)
+                    w0[i] = y[i] - trend[i];
+                stlSubseries(w0, n, np, o.seasonalWindow, o.seasonalDegree, o.seasonalJump, userw, rw,
+                             w1, w2, w3, w4, season, ws);
+                // Low-pass filter of the cycle-subseries: MA(np), MA(np), MA(3), then LOESS
+                stlMovingAverage(w1, m, np, w2);
+                stlMovingAverage(w2, n + np + 1, np, w0);
+                stlMovingAverage(w0, n + 2, 3, w2);
+                stlEss(w2, n, o.lowPassWindow, o.lowPassDegree, o.lowPassJump, false, rw, w0, w4, ws);
+                for (size_t i = 0; i < n; ++i)
+                    season[i] = w1[np + i] - w0[i];
+                for (size_t i = 0; i < n; ++i)
+                    w0[i] = y[i] - season[i];
+                stlEss(w0, n, o.trendWindow, o.trendDegree, o.trendJump, userw, rw, trend, w2, ws);
+            }
+        }
+
+        // Bisquare robustness weights from the residuals y - fit (6 * MAD scale)
+        inline void stlRobustnessWeights(const double *y, size_t n, const double *fit, double *rw, double *scratch)
+        {
+            for (size_t i = 0; i < n; ++i)
+                scratch[i] = std::abs(y[i] - fit[i]);
+            size_t m1 = n / 2, m2 = n - 1 - n / 2;
+            std::nth_element(scratch, scratch + m1, scratch + n);
+            double r1 = scratch[m1];
+            std::nth_element(scratch, scratch + m2, scratch + n);
+            double cmad = 3.0 * (r1 + scratch[m2]);
+            double c9 = 0.999 * cmad, c1 = 0.001 * cmad;
+            for (size_t i = 0; i < n; ++i)
+            {
+                double r = std::abs(y[i] - fit[i]);
+                if (r <= c1)
+                    rw[i] = 1.0;
+                else if (r <= c9)
+                {
+                    double u = r / cmad;
+                    rw[i] = (1.0 - u * u) * (1.0 - u * u);
+                }
+                else
+                    rw[i] = 0.0;
+            }
+        }
+
+        inline size_t nextOdd(double x)
+        {
+            size_t v = static_cast<size_t>(std::ceil(x));
+            return v % 2 == 0 ? v + 1 : v;
+        }
+
+        // Fill in defaults and force windows odd and >= 3
+        inline STLOptions stlResolve(STLOptions o)
+        {
+            o.period = std::max<size_t>(2, o.period);
+            o.seasonalWindow = nextOdd(static_cast<double>(std::max<size_t>(3, o.seasonalWindow)));
+            if (o.trendWindow == 0)
+                o.trendWindow = nextOdd(1.5 * o.period / (1.0 - 1.5 / o.seasonalWindow));
+            o.trendWindow = nextOdd(static_cast<double>(std::max<size_t>(3, o.trendWindow)));
+            if (o.lowPassWindow == 0)
+                o.lowPassWindow = o.period;
+            o.lowPassWindow = nextOdd(static_cast<double>(std::max<size_t>(3, o.lowPassWindow)));
+            if (o.seasonalJump == 0)
+                o.seasonalJump = static_cast<size_t>(std::ceil(o.seasonalWindow / 10.0));
+            if (o.trendJump == 0)
+                o.trendJump = static_cast<size_t>(std::ceil(o.trendWindow / 10.0));
+            if (o.lowPassJump == 0)
+                o.lowPassJump = static_cast<size_t>(std::ceil(o.lowPassWindow / 10.0));
+            if (o.innerIterations == 0)
+                o.innerIterations = o.robust ? 1 : 2;
+            if (o.outerIterations == 0 && o.robust)
+                o.outerIterations = 15;
+            return o;
+        }
+    }
+
+    // STL decomposition of y[0..n) into caller-supplied trend, seasonal and residual buffers
+    // (each of length n). With robust options the outer loop downweights outliers using
+    // bisquare weights; the final weights remain in ws.weights.
+    inline void stl(const double *y, size_t n, const STLOptions &options,
+                    double *trend, double *seasonal, double *residual, STLWorkspace &ws)
+    {
+        if (options.period < 2 || n < 2 * options.period)
+            throw std::invalid_argument("STL requires a period >= 2 and at least two full periods of data");
+        const STLOptions o = detail::stlResolve(options);
+        ws.work.resize(5 * (n + 2 * o.period));
+        ws.weights.assign(n, 1.0);
+        std::fill(trend, trend + n, 0.0);
+
+        bool userw = false;
+        for (size_t outer = 0;; ++outer)
+        {
+            detail::stlInner(y, n, o, userw, ws, seasonal, trend);
+            if (outer >= o.outerIterations)
+                break;
+            double *fit = ws.work.data(), *scratch = fit + n;
+            for (size_t i = 0; i < n; ++i)
+                fit[i] = trend[i] + seasonal[i];
+            detail::stlRobustnessWeights(y, n, fit, ws.weights.data(), scratch);
+            userw = true;
+        }
+        for (size_t i = 0; i < n; ++i)
+            residual[i] = y[i] - trend[i] - seasonal[i];
+    }
+
+    template <typename T>
+    void stl(const std::vector<T> &data, const STLOptions &options,
+             std::vector<double> &trend, std::vector<double> &seasonal, std::vector<double> &residual)
+    {
+        std::vector<double> y(data.begin(), data.end());
+        trend.resize(y.size());
+        seasonal.resize(y.size());
+        residual.resize(y.size());
+        STLWorkspace ws;
+        stl(y.data(), y.size(), options, trend.data(), seasonal.data(), residual.data(), ws);
+    }
+
+    // Decompose numSeries equal-length series stored row-major in data (numSeries x length)
+    // into row-major output buffers of the same shape, in parallel. Each worker reuses one
+    // workspace for all of its series.
+    inline void stlBatch(const double *data, size_t numSeries, size_t length, const STLOptions &options,
+                         double *trend, double *seasonal, double *residual, size_t numThreads = 0)
+    {
+        if (options.period < 2 || length < 2 * options.period)
+            throw std::invalid_argument("STL requires a period >= 2 and at least two full periods of data");
+        const size_t blockSize = 64;
+        const size_t numBlocks = (numSeries + blockSize - 1) / blockSize;
+        detail::parallelFor(numBlocks, numThreads, [&](size_t b)
+                            {
+            STLWorkspace ws;
+            const size_t end = std::min(numSeries, (b + 1) * blockSize);
+            for (size_t i = b * blockSize; i < end; ++i)
+            {
+                const size_t off = i * length;
+                stl(data + off, length, options, trend + off, seasonal + off, residual + off, ws);
+            } });
+    }
+
+    // Seasonal Decomposition of Time Series by LOESS (STL with default windows). Needs a
+    // period of at least 2 and at least two full periods of data, as stl does.
     template <typename T>
     void seasonalDecomposition(const std::vector<T> &data,
                                std::vector<double> &trend,
                                std::vector<double> &seasonal,
                                std::vector<double> &residual,
-                               size_t period)
-    {
-        if (data.empty() || period == 0 || period > data.size())
-            throw std::invalid_argument("Invalid data or period");
-
-        size_t n = data.size();
-        trend.resize(n);
-        seasonal.resize(n);
-        residual.resize(n);
-
-        // Simple moving average for trend estimation
-        std::vector<double> ma = movingAverage(data, period);
-        // Extend moving average to full length by padding start and end
-        size_t pad = (period - 1) / 2;
-        for (size_t i = 0; i < pad; ++i)
-            trend[i] = ma[0];
-        for (size_t i = pad; i < n - pad; ++i)
-            trend[i] = ma[i - pad];
-        for (size_t i = n - pad; i < n; ++i)
-            trend[i] = ma.back();
-
-        // Estimate seasonal component by averaging detrended values per period
-        std::vector<double> seasonalSum(period, 0.0);
-        std::vector<int> seasonalCount(period, 0);
-        for (size_t i = 0; i < n; ++i)
-        {
-            double detrended = static_cast<double>(data[i]) - trend[i];
-            seasonalSum[i % period] += detrended;
-            seasonalCount[i % period]++;
-        }
-        for (size_t i = 0; i < period; ++i)
+                               size_t period,
+                               bool robust = false)
+    {
+        if (period < 2)
+            throw std::invalid_argument("Seasonal decomposition requires a period of at least 2");
+        if (data.size() < 2 * period)
+            throw std::invalid_argument("Seasonal decomposition requires at least two full periods of data");
+        stl(data, STLOptions(period, robust), trend, seasonal, residual);
+    }
+
+    namespace detail
+    {
+        // Blocked row-major GEMM kernels. All accumulate into C.
+        // C[M x N] += A[M x K] * B[N x K]^T  (inner loop is a contiguous dot product)
+        inline void gemmNT(size_t M, size_t N, size_t K, const double *A, const double *B, double *C)
         {
-            seasonal[i] = seasonalSum[i] / seasonalCount[i];
+            const size_t MB = 32, NB = 64, KB = 256;
+            for (size_t k0 = 0; k0 < K; k0 += KB)
+            {
+                const size_t kLen = std::min(K, k0 + KB) - k0;
+                for (size_t i0 = 0; i0 < M; i0 += MB)
+                {
+                    const size_t i1 = std::min(M, i0 + MB);
+                    for (size_t j0 = 0; j0 < N; j0 += NB)
+                    {
+                        const size_t j1 = std::min(N, j0 + NB);
+                        for (size_t i = i0; i < i1; ++i)
+                        {
+                            const double *a = A + i * K + k0;
+                            double *c = C + i * N;
+                            for (size_t j = j0; j < j1; ++j)
+                                c[j] += dotProduct(a, B + j * K + k0, kLen);
+                        }
+                    }
+                }
+            }
         }
-        // Extend seasonal component to full length
-        for (size_t i = period; i < n; ++i)
+
+        // C[M x N] += A[M x K] * B[K x N]  (inner loop is a contiguous axpy over a row of B)
+        inline void gemmNN(size_t M, size_t N, size_t K, const double *A, const double *B, double *C)
         {
-            seasonal[i] = seasonal[i % period];
+            const size_t KB = 128, NB = 512;
+            for (size_t j0 = 0; j0 < N; j0 += NB)
+            {
+                const size_t j1 = std::min(N, j0 + NB);
+                for (size_t k0 = 0; k0 < K; k0 += KB)
+                {
+                    const size_t k1 = std::min(K, k0 + KB);
+                    for (size_t i = 0; i < M; ++i)
+                    {
+                        double *c = C + i * N;
+                        for (size_t k = k0; k < k1; ++k)
+                        {
+                            const double a = A[i * K + k];
+                            const double *b = B + k * N;
+                            for (size_t j = j0; j < j1; ++j)
+                                c[j] += a * b[j];
+                        }
+                    }
+                }
+            }
         }
 
-        // Calculate residual
-        for (size_t i = 0; i < n; ++i)
+        // C[M x N] += A[K x M]^T * B[K x N]  (used for weight gradients summed over batch/time)
+        inline void gemmTN(size_t M, size_t N, size_t K, const double *A, const double *B, double *C)
         {
-            residual[i] = static_cast<double>(data[i]) - trend[i] - seasonal[i];
+            const size_t MB = 64, KB = 128;
+            for (size_t i0 = 0; i0 < M; i0 += MB)
+            {
+                const size_t i1 = std::min(M, i0 + MB);
+                for (size_t k0 = 0; k0 < K; k0 += KB)
+                {
+                    const size_t k1 = std::min(K, k0 + KB);
+                    for (size_t k = k0; k < k1; ++k)
+                    {
+                        const double *b = B + k * N;
+                        for (size_t i = i0; i < i1; ++i)
+                        {
+                            const double a = A[k * M + i];
+                            double *c = C + i * N;
+                            for (size_t j = 0; j < N; ++j)
+                                c[j] += a * b[j];
+                        }
+                    }
+                }
+            }
         }
+
+        inline double sigmoid(double x) { return 1.0 / (1.0 + std::exp(-x)); }
     }
 
-    // Placeholder for LSTM / RNN deep learning models
-    // Full implementation requires specialized libraries (e.g., TensorFlow, PyTorch)
+    // Recurrent cell used by LSTMModel
+    enum class RecurrentCell
+    {
+        LSTM,
+        GRU
+    };
+
+    // Training hyper-parameters: Adam learning rate, truncated-BPTT window length and
+    // global gradient-norm clipping threshold (0 disables clipping).
+    struct RecurrentTrainingOptions
+    {
+        RecurrentTrainingOptions(double learningRate = 0.01, size_t bpttSteps = 32, double gradientClip = 5.0)
+            : learningRate(learningRate), bpttSteps(bpttSteps), gradientClip(gradientClip) {}
+        double learningRate;
+        size_t bpttSteps;
+        double gradientClip;
+    };
+
+    // Single-layer LSTM or GRU network with a linear output layer, trained on CPU with
+    // truncated backpropagation through time and Adam.
+    //
+    // Gate weights are fused and stored contiguously: Wx is (G*H x I) and Wh is (G*H x H)
+    // with gate blocks [i f g o] for the LSTM and [r z n] for the GRU (PyTorch layout).
+    // A batch of sequences is processed time step by time step with blocked GEMMs; input
+    // projections for a whole window of steps are computed in one GEMM up front.
     class LSTMModel
     {
     public:
-        LSTMModel(size_t inputSize, size_t hiddenSize, size_t outputSize)
-            : inputSize(inputSize), hiddenSize(hiddenSize), outputSize(outputSize)
+        LSTMModel(size_t inputSize, size_t hiddenSize, size_t outputSize,
+                  RecurrentCell cell = RecurrentCell::LSTM, unsigned seed = 42)
+            : inputSize_(inputSize), hiddenSize_(hiddenSize), outputSize_(outputSize), cell_(cell)
+        {
+            if (inputSize == 0 || hiddenSize == 0 || outputSize == 0)
+                throw std::invalid_argument("Layer sizes must be positive");
+            const size_t GH = gates() * hiddenSize;
+            offWh_ = GH * inputSize;
+            offBx_ = offWh_ + GH * hiddenSize;
+            offBh_ = offBx_ + GH;
+            offWy_ = offBh_ + GH;
+            offBy_ = offWy_ + outputSize * hiddenSize;
+            params_.resize(offBy_ + outputSize);
+
+            std::mt19937 gen(seed);
+            double bound = 1.0 / std::sqrt(static_cast<double>(hiddenSize));
+            std::uniform_real_distribution<double> dist(-bound, bound);
+            for (double &w : params_)
+                w = dist(gen);
+            if (cell_ == RecurrentCell::LSTM)
+            {
+                // Start with the forget gate open so gradients flow through long sequences
+                for (size_t k = 0; k < hiddenSize; ++k)
+                    params_[offBx_ + hiddenSize + k] = 1.0;
+            }
+            adamM_.assign(params_.size(), 0.0);
+            adamV_.assign(params_.size(), 0.0);
+        }
+
+        // Train on one sequence: inputs[t] (inputSize) -> targets[t] (outputSize) with
+        // mean squared error. Returns the mean loss of the last epoch.
+        double train(const std::vector<std::vector<double>> &inputs,
+                     const std::vector<std::vector<double>> &targets,
+                     size_t epochs,
+                     const RecurrentTrainingOptions &options = RecurrentTrainingOptions())
         {
-            // Initialize weights and biases with random values for demonstration
-            weights.resize(hiddenSize, std::vector<double>(inputSize, 0.1));
-            biases.resize(hiddenSize, 0.1);
+            if (inputs.empty() || inputs.size() != targets.size())
+                throw std::invalid_argument("Inputs and targets must be non-empty and of equal length");
+            std::vector<double> x, y;
+            x.reserve(inputs.size() * inputSize_);
+            y.reserve(targets.size() * outputSize_);
+            for (size_t t = 0; t < inputs.size(); ++t)
+            {
+                if (inputs[t].size() != inputSize_ || targets[t].size() != outputSize_)
+                    throw std::invalid_argument("Input or target size does not match the model");
+                x.insert(x.end(), inputs[t].begin(), inputs[t].end());
+                y.insert(y.end(), targets[t].begin(), targets[t].end());
+            }
+            return trainBatch(x.data(), y.data(), 1, inputs.size(), epochs, options);
         }
 
-        // Simple mock train function that adjusts weights slightly
-        void train(const std::vector<std::vector<double>> & /*inputs*/,
-                   const std::vector<std::vector<double>> & /*targets*/,
-                   size_t epochs)
+        // Train on a batch of equal-length sequences. inputs is [batch][seqLen][inputSize]
+        // and targets is [batch][seqLen][outputSize], both row-major. All buffers are sized
+        // once up front; the per-step forward/backward passes do not allocate.
+        double trainBatch(const double *inputs, const double *targets, size_t batch, size_t seqLen,
+                          size_t epochs, const RecurrentTrainingOptions &options = RecurrentTrainingOptions())
         {
-            std::cout << "Training LSTM model for " << epochs << " epochs (mock implementation)." << std::endl;
+            if (batch == 0 || seqLen == 0)
+                throw std::invalid_argument("Batch and sequence length must be positive");
+            const size_t K = std::max<size_t>(1, std::min(options.bpttSteps, seqLen));
+            Workspace ws;
+            ws.reserve(*this, batch, K, true);
+            const size_t B = batch, I = inputSize_, O = outputSize_, BH = batch * hiddenSize_;
+
+            double epochLoss = 0.0;
             for (size_t epoch = 0; epoch < epochs; ++epoch)
             {
-                // Mock training: increment weights by a small value
-                for (auto &row : weights)
+                std::fill(ws.h.begin(), ws.h.begin() + BH, 0.0);
+                std::fill(ws.c.begin(), ws.c.begin() + BH, 0.0);
+                double lossSum = 0.0;
+                for (size_t start = 0; start < seqLen; start += K)
                 {
-                    for (auto &w : row)
-                    {
-                        w += 0.01;
-                    }
+                    const size_t steps = std::min(K, seqLen - start);
+                    for (size_t t = 0; t < steps; ++t)
+                        for (size_t b = 0; b < B; ++b)
+                            std::copy(inputs + (b * seqLen + start + t) * I, inputs + (b * seqLen + start + t + 1) * I,
+                                      ws.x.begin() + (t * B + b) * I);
+                    forwardWindow(ws, B, steps, true);
+
+                    // Mean squared error gradient over the whole sequence batch
+                    const double scale = 2.0 / static_cast<double>(B * seqLen * O);
+                    for (size_t t = 0; t < steps; ++t)
+                        for (size_t b = 0; b < B; ++b)
+                        {
+                            const double *target = targets + (b * seqLen + start + t) * O;
+                            const double *pred = ws.y.data() + (t * B + b) * O;
+                            double *dy = ws.dy.data() + (t * B + b) * O;
+                            for (size_t k = 0; k < O; ++k)
+                            {
+                                double diff = pred[k] - target[k];
+                                lossSum += diff * diff;
+                                dy[k] = scale * diff;
+                            }
+                        }
+                    backwardWindow(ws, B, steps);
+                    adamStep(ws.grad, options);
+
+                    // Carry the state into the next window without gradient (truncation)
+                    carryState(ws, BH, steps);
                 }
-                for (auto &b : biases)
+                epochLoss = lossSum / static_cast<double>(B * seqLen * O);
+            }
+            return epochLoss;
+        }
+
+        // Output for a single input vector, starting from a zero state
+        std::vector<double> predict(const std::vector<double> &input) const
+        {
+            if (input.size() != inputSize_)
+                throw std::invalid_argument("Input size does not match the model");
+            std::vector<double> output(outputSize_);
+            predictBatch(input.data(), 1, 1, output.data());
+            return output;
+        }
+
+        // Output after feeding a whole sequence of input vectors
+        std::vector<double> predictSequence(const std::vector<std::vector<double>> &sequence) const
+        {
+            if (sequence.empty())
+                throw std::invalid_argument("Sequence is empty");
+            std::vector<double> x;
+            x.reserve(sequence.size() * inputSize_);
+            for (const auto &step : sequence)
+            {
+                if (step.size() != inputSize_)
+                    throw std::invalid_argument("Input size does not match the model");
+                x.insert(x.end(), step.begin(), step.end());
+            }
+            std::vector<double> output(outputSize_);
+            predictBatch(x.data(), 1, sequence.size(), output.data());
+            return output;
+        }
+
+        // Batched inference: inputs is [batch][seqLen][inputSize]; outputs receives the
+        // network output after the last step of each sequence, [batch][outputSize].
+        void predictBatch(const double *inputs, size_t batch, size_t seqLen, double *outputs) const
+        {
+            if (batch == 0 || seqLen == 0)
+                throw std::invalid_argument("Batch and sequence length must be positive");
+            const size_t K = std::min<size_t>(seqLen, 16);
+            const size_t B = batch, I = inputSize_, BH = batch * hiddenSize_;
+            Workspace ws;
+            ws.reserve(*this, batch, K, false);
+            for (size_t start = 0; start < seqLen; start += K)
+            {
+                const size_t steps = std::min(K, seqLen - start);
+                for (size_t t = 0; t < steps; ++t)
+                    for (size_t b = 0; b < B; ++b)
+                        std::copy(inputs + (b * seqLen + start + t) * I, inputs + (b * seqLen + start + t + 1) * I,
+                                  ws.x.begin() + (t * B + b) * I);
+                forwardWindow(ws, B, steps, false);
+                carryState(ws, BH, steps);
+            }
+            for (size_t b = 0; b < B; ++b)
+                std::copy(params_.begin() + offBy_, params_.end(), outputs + b * outputSize_);
+            detail::gemmNT(B, outputSize_, hiddenSize_, ws.h.data(), params_.data() + offWy_, outputs);
+        }
+
+        size_t inputSize() const { return inputSize_; }
+        size_t hiddenSize() const { return hiddenSize_; }
+        size_t outputSize() const { return outputSize_; }
+        RecurrentCell cell() const { return cell_; }
+        // All weights and biases, laid out as [Wx | Wh | bx | bh | Wy | by]
+        const std::vector<double> &parameters() const { return params_; }
+        std::vector<double> &parameters() { return params_; }
+
+    private:
+        // Per-window buffers, time-major ([t][b][...]); sized once by reserve()
+        struct Workspace
+        {
+            std::vector<double> x, gx, act, ghn, h, c, gh, y;
+            std::vector<double> dy, dhAll, dhNext, dcNext, dGx, dGh, grad;
+
+            void reserve(const LSTMModel &m, size_t B, size_t K, bool training)
+            {
+                const size_t H = m.hiddenSize_, GH = m.gates() * H;
+                x.assign(K * B * m.inputSize_, 0.0);
+                gx.assign(K * B * GH, 0.0);
+                act.assign(K * B * GH, 0.0);
+                ghn.assign(m.cell_ == RecurrentCell::GRU ? K * B * H : 0, 0.0);
+                h.assign((K + 1) * B * H, 0.0);
+                c.assign(m.cell_ == RecurrentCell::LSTM ? (K + 1) * B * H : B * H, 0.0);
+                gh.assign(B * GH, 0.0);
+                if (!training)
+                    return;
+                y.assign(K * B * m.outputSize_, 0.0);
+                dy.assign(K * B * m.outputSize_, 0.0);
+                dhAll.assign(K * B * H, 0.0);
+                dhNext.assign(B * H, 0.0);
+                dcNext.assign(B * H, 0.0);
+                dGx.assign(K * B * GH, 0.0);
+                dGh.assign(m.cell_ == RecurrentCell::GRU ? K * B * GH : 0, 0.0);
+                grad.assign(m.params_.size(), 0.0);
+            }
+        };
+
+        size_t gates() const { return cell_ == RecurrentCell::LSTM ? 4 : 3; }
+
+        // Move the state after `steps` steps into slot 0 for the next window
+        void carryState(Workspace &ws, size_t BH, size_t steps) const
+        {
+            std::copy(ws.h.begin() + steps * BH, ws.h.begin() + (steps + 1) * BH, ws.h.begin());
+            if (cell_ == RecurrentCell::LSTM)
+                std::copy(ws.c.begin() + steps * BH, ws.c.begin() + (steps + 1) * BH, ws.c.begin());
+        }
+
+        // Run `steps` time steps from state h[0]/c[0] over inputs already in ws.x
+        void forwardWindow(Workspace &ws, size_t B, size_t steps, bool outputs) const
+        {
+            const size_t H = hiddenSize_, GH = gates() * H, BH = B * H;
+            const double *Wx = params_.data(), *Wh = params_.data() + offWh_;
+            const double *bx = params_.data() + offBx_, *bh = params_.data() + offBh_;
+
+            // Input projections for every step of the window in one GEMM
+            for (size_t r = 0; r < steps * B; ++r)
+                std::copy(bx, bx + GH, ws.gx.begin() + r * GH);
+            detail::gemmNT(steps * B, GH, inputSize_, ws.x.data(), Wx, ws.gx.data());
+
+            for (size_t t = 0; t < steps; ++t)
+            {
+                const double *hPrev = ws.h.data() + t * BH;
+                double *hNext = ws.h.data() + (t + 1) * BH;
+                for (size_t b = 0; b < B; ++b)
+                    std::copy(bh, bh + GH, ws.gh.begin() + b * GH);
+                detail::gemmNT(B, GH, H, hPrev, Wh, ws.gh.data());
+
+                for (size_t b = 0; b < B; ++b)
                 {
-                    b += 0.005;
+                    const double *gx = ws.gx.data() + (t * B + b) * GH;
+                    const double *gh = ws.gh.data() + b * GH;
+                    double *act = ws.act.data() + (t * B + b) * GH;
+                    const double *hp = hPrev + b * H;
+                    double *hn = hNext + b * H;
+                    if (cell_ == RecurrentCell::LSTM)
+                    {
+                        const double *cp = ws.c.data() + t * BH + b * H;
+                        double *cn = ws.c.data() + (t + 1) * BH + b * H;
+                        for (size_t k = 0; k < H; ++k)
+                        {
+                            double ig = detail::sigmoid(gx[k] + gh[k]);
+                            double fg = detail::sigmoid(gx[H + k] + gh[H + k]);
+                            double gg = std::tanh(gx[2 * H + k] + gh[2 * H + k]);
+                            double og = detail::sigmoid(gx[3 * H + k] + gh[3 * H + k]);
+                            act[k] = ig;
+                            act[H + k] = fg;
+                            act[2 * H + k] = gg;
+                            act[3 * H + k] = og;
+                            cn[k] = fg * cp[k] + ig * gg;
+                            hn[k] = og * std::tanh(cn[k]);
+                        }
+                    }
+                    else
+                    {
+                        double *ghn = ws.ghn.empty() ? nullptr : ws.ghn.data() + (t * B + b) * H;
+                        for (size_t k = 0; k < H; ++k)
+                        {
+                            double rg = detail::sigmoid(gx[k] + gh[k]);
+                            double zg = detail::sigmoid(gx[H + k] + gh[H + k]);
+                            double ng = std::tanh(gx[2 * H + k] + rg * gh[2 * H + k]);
+                            act[k] = rg;
+                            act[H + k] = zg;
+                            act[2 * H + k] = ng;
+                            if (ghn)
+                                ghn[k] = gh[2 * H + k];
+                            hn[k] = (1.0 - zg) * ng + zg * hp[k];
+                        }
+                    }
                 }
             }
+            if (outputs)
+            {
+                const double *by = params_.data() + offBy_;
+                for (size_t r = 0; r < steps * B; ++r)
+                    std::copy(by, by + outputSize_, ws.y.begin() + r * outputSize_);
+                detail::gemmNT(steps * B, outputSize_, H, ws.h.data() + BH, params_.data() + offWy_, ws.y.data());
+            }
         }
 
-        // Simple mock predict function that returns weighted sum + bias
-        std::vector<double> predict(const std::vector<double> &input)
+        // Backpropagate ws.dy through the window, writing parameter gradients to ws.grad
+        void backwardWindow(Workspace &ws, size_t B, size_t steps) const
         {
-            std::cout << "Predicting with LSTM model (mock implementation)." << std::endl;
-            std::vector<double> output(outputSize, 0.0);
-            for (size_t i = 0; i < outputSize; ++i)
+            const size_t H = hiddenSize_, GH = gates() * H, BH = B * H, O = outputSize_;
+            const double *Wh = params_.data() + offWh_, *Wy = params_.data() + offWy_;
+            std::fill(ws.grad.begin(), ws.grad.end(), 0.0);
+            double *dWx = ws.grad.data(), *dWh = dWx + offWh_, *dbx = dWx + offBx_;
+            double *dbh = dWx + offBh_, *dWy = dWx + offWy_, *dby = dWx + offBy_;
+
+            // Output layer
+            detail::gemmTN(O, H, steps * B, ws.dy.data(), ws.h.data() + BH, dWy);
+            for (size_t r = 0; r < steps * B; ++r)
+                for (size_t k = 0; k < O; ++k)
+                    dby[k] += ws.dy[r * O + k];
+            std::fill(ws.dhAll.begin(), ws.dhAll.begin() + steps * BH, 0.0);
+            detail::gemmNN(steps * B, H, O, ws.dy.data(), Wy, ws.dhAll.data());
+
+            std::fill(ws.dhNext.begin(), ws.dhNext.end(), 0.0);
+            std::fill(ws.dcNext.begin(), ws.dcNext.end(), 0.0);
+            const bool gru = cell_ == RecurrentCell::GRU;
+            for (size_t t = steps; t-- > 0;)
             {
-                double sum = 0.0;
-                for (size_t j = 0; j < inputSize && j < input.size(); ++j)
+                double *dGx = ws.dGx.data() + t * B * GH;
+                double *dGh = gru ? ws.dGh.data() + t * B * GH : dGx;
+                for (size_t b = 0; b < B; ++b)
                 {
-                    for (size_t k = 0; k < hiddenSize; ++k)
+                    const double *act = ws.act.data() + (t * B + b) * GH;
+                    double *dh = ws.dhAll.data() + t * BH + b * H;
+                    const double *dhN = ws.dhNext.data() + b * H;
+                    double *dgx = dGx + b * GH, *dgh = dGh + b * GH;
+                    if (!gru)
                     {
-                        sum += input[j] * weights[k][j];
+                        const double *cp = ws.c.data() + t * BH + b * H;
+                        const double *cn = ws.c.data() + (t + 1) * BH + b * H;
+                        double *dcN = ws.dcNext.data() + b * H;
+                        for (size_t k = 0; k < H; ++k)
+                        {
+                            double ig = act[k], fg = act[H + k], gg = act[2 * H + k], og = act[3 * H + k];
+                            double dhk = dh[k] + dhN[k];
+                            double tc = std::tanh(cn[k]);
+                            double dc = dcN[k] + dhk * og * (1.0 - tc * tc);
+                            dgx[k] = dc * gg * ig * (1.0 - ig);
+                            dgx[H + k] = dc * cp[k] * fg * (1.0 - fg);
+                            dgx[2 * H + k] = dc * ig * (1.0 - gg * gg);
+                            dgx[3 * H + k] = dhk * tc * og * (1.0 - og);
+                            dcN[k] = dc * fg;
+                        }
+                    }
+                    else
+                    {
+                        const double *hp = ws.h.data() + t * BH + b * H;
+                        const double *ghn = ws.ghn.data() + (t * B + b) * H;
+                        for (size_t k = 0; k < H; ++k)
+                        {
+                            double rg = act[k], zg = act[H + k], ng = act[2 * H + k];
+                            double dhk = dh[k] + dhN[k];
+                            double dn = dhk * (1.0 - zg) * (1.0 - ng * ng);
+                            double dz = dhk * (hp[k] - ng) * zg * (1.0 - zg);
+                            double dr = dn * ghn[k] * rg * (1.0 - rg);
+                            dgx[k] = dgh[k] = dr;
+                            dgx[H + k] = dgh[H + k] = dz;
+                            dgx[2 * H + k] = dn;
+                            dgh[2 * H + k] = dn * rg;
+                            dh[k] = dhk * zg; // direct path to h[t-1], reused below
+                        }
                     }
                 }
-                for (size_t k = 0; k < hiddenSize; ++k)
+                // dh[t-1] = dGh * Wh (+ z * dh for the GRU)
+                if (gru)
+                    std::copy(ws.dhAll.begin() + t * BH, ws.dhAll.begin() + (t + 1) * BH, ws.dhNext.begin());
+                else
+                    std::fill(ws.dhNext.begin(), ws.dhNext.end(), 0.0);
+                detail::gemmNN(B, H, GH, dGh, Wh, ws.dhNext.data());
+            }
+
+            // Weight gradients for the whole window in single GEMMs
+            const double *dGhAll = gru ? ws.dGh.data() : ws.dGx.data();
+            detail::gemmTN(GH, inputSize_, steps * B, ws.dGx.data(), ws.x.data(), dWx);
+            detail::gemmTN(GH, H, steps * B, dGhAll, ws.h.data(), dWh);
+            for (size_t r = 0; r < steps * B; ++r)
+                for (size_t k = 0; k < GH; ++k)
                 {
-                    sum += biases[k];
+                    dbx[k] += ws.dGx[r * GH + k];
+                    dbh[k] += dGhAll[r * GH + k];
                 }
-                output[i] = sum;
+        }
+
+        void adamStep(std::vector<double> &grad, const RecurrentTrainingOptions &options)
+        {
+            const double beta1 = 0.9, beta2 = 0.999, eps = 1e-8;
+            if (options.gradientClip > 0.0)
+            {
+                double norm = std::sqrt(detail::dotProduct(grad.data(), grad.data(), grad.size()));
+                if (norm > options.gradientClip)
+                    for (double &g : grad)
+                        g *= options.gradientClip / norm;
+            }
+            ++adamStep_;
+            const double c1 = 1.0 - std::pow(beta1, static_cast<double>(adamStep_));
+            const double c2 = 1.0 - std::pow(beta2, static_cast<double>(adamStep_));
+            for (size_t i = 0; i < params_.size(); ++i)
+            {
+                adamM_[i] = beta1 * adamM_[i] + (1.0 - beta1) * grad[i];
+                adamV_[i] = beta2 * adamV_[i] + (1.0 - beta2) * grad[i] * grad[i];
+                params_[i] -= options.learningRate * (adamM_[i] / c1) / (std::sqrt(adamV_[i] / c2) + eps);
             }
-            return output;
         }
 
-    private:
-        size_t inputSize;
-        size_t hiddenSize;
-        size_t outputSize;
-        std::vector<std::vector<double>> weights;
-        std::vector<double> biases;
+        size_t inputSize_;
+        size_t hiddenSize_;
+        size_t outputSize_;
+        RecurrentCell cell_;
+        size_t offWh_, offBx_, offBh_, offWy_, offBy_;
+        std::vector<double> params_;
+        std::vector<double> adamM_, adamV_;
+        size_t adamStep_ = 0;
     };
 
 } // namespace TimeSeriesAnalysis
@@ -0,0 +1,116 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <algorithm>
+#include "TimeSeriesAnalysis.h"
+#include "AnomalyDetection.h"
+#include "Resampling.h"
+
+// Throughput benchmarks for TimeSeriesAnalysis.
+// Build: g++ -std=c++11 -O3 -march=native benchmark.cpp -o benchmark -lpthread
+
+double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void benchmarkRecurrent(TimeSeriesAnalysis::RecurrentCell cell, const char *name)
+{
+    const size_t inputSize = 8, hiddenSize = 64, outputSize = 1;
+    const size_t batch = 64, seqLen = 50;
+    TimeSeriesAnalysis::LSTMModel model(inputSize, hiddenSize, outputSize, cell);
+
+    std::vector<double> inputs(batch * seqLen * inputSize), targets(batch * seqLen * outputSize), outputs(batch * outputSize);
+    for (size_t i = 0; i < inputs.size(); ++i)
+        inputs[i] = std::sin(0.01 * i);
+    for (size_t i = 0; i < targets.size(); ++i)
+        targets[i] = std::cos(0.01 * i);
+
+    size_t sequences = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (secondsSince(start) < 1.0)
+    {
+        model.predictBatch(inputs.data(), batch, seqLen, outputs.data());
+        sequences += batch;
+    }
+    double inferenceRate = sequences / secondsSince(start);
+
+    sequences = 0;
+    start = std::chrono::steady_clock::now();
+    while (secondsSince(start) < 1.0)
+    {
+        model.trainBatch(inputs.data(), targets.data(), batch, seqLen, 1);
+        sequences += batch;
+    }
+    double trainingRate = sequences / secondsSince(start);
+
+    std::cout << name << " (input " << inputSize << ", hidden " << hiddenSize << ", batch " << batch
+              << ", length " << seqLen << "): inference " << inferenceRate << " seq/s, training "
+              << trainingRate << " seq/s" << std::endl;
+}
+
+void benchmarkAnomalyDetection()
+{
+    const size_t n = 10000000, period = 24;
+    std::vector<double> x(n);
+    for (size_t i = 0; i < n; ++i)
+        x[i] = 100.0 + 10.0 * std::sin(0.2617993877991494 * (i % period)) + std::sin(1.7 * i);
+    std::vector<TimeSeriesAnalysis::AnomalyScore> scores(n);
+    TimeSeriesAnalysis::StreamingAnomalyDetector detector(TimeSeriesAnalysis::StreamingAnomalyOptions(64, period));
+
+    auto start = std::chrono::steady_clock::now();
+    size_t anomalies = detector.process(x.data(), n, scores.data());
+    double seconds = secondsSince(start);
+    std::cout << "Streaming anomaly detection (window 64, period " << period << "): " << n / seconds / 1e6
+              << "M points/s (" << anomalies << " flagged)" << std::endl;
+}
+
+// Roll 1 kHz data (millisecond timestamps) up to 1 s windows, streaming the series in
+// chunks so the full 1B points never have to be resident
+void benchmarkResampling(const TimeSeriesAnalysis::ResampleOptions &options, const char *name)
+{
+    const size_t total = 1000000000, chunk = 1 << 24;
+    std::vector<int64_t> t(chunk);
+    std::vector<double> v(chunk);
+    std::mt19937 gen(3);
+    std::normal_distribution<double> noise(20.0, 2.0);
+    for (size_t i = 0; i < chunk; ++i)
+        v[i] = noise(gen);
+
+    TimeSeriesAnalysis::Resampler resampler(options);
+    size_t windows = 0;
+    double seconds = 0.0;
+    for (size_t done = 0; done < total; done += chunk)
+    {
+        const size_t len = std::min(chunk, total - done);
+        for (size_t i = 0; i < len; ++i)
+            t[i] = static_cast<int64_t>(done + i);
+        auto start = std::chrono::steady_clock::now();
+        resampler.push(t.data(), v.data(), len);
+        windows += resampler.takeWindows().size();
+        seconds += secondsSince(start);
+    }
+    auto start = std::chrono::steady_clock::now();
+    resampler.finish();
+    windows += resampler.takeWindows().size();
+    seconds += secondsSince(start);
+    std::cout << "Resampling 1B points, " << name << ": " << total / seconds / 1e6 << "M points/s ("
+              << windows << " windows)" << std::endl;
+}
+
+int main()
+{
+    benchmarkRecurrent(TimeSeriesAnalysis::RecurrentCell::LSTM, "LSTM");
+    benchmarkRecurrent(TimeSeriesAnalysis::RecurrentCell::GRU, "GRU");
+    benchmarkAnomalyDetection();
+
+    TimeSeriesAnalysis::ResampleOptions tumbling(1000);
+    benchmarkResampling(tumbling, "1 s tumbling, count/mean/min/max/var");
+    TimeSeriesAnalysis::ResampleOptions hopping(60000, 1000);
+    benchmarkResampling(hopping, "1 min windows every 1 s");
+    tumbling.quantiles = {0.5, 0.99};
+    benchmarkResampling(tumbling, "1 s tumbling with p50/p99 sketch");
+    return 0;
+}
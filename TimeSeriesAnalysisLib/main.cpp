@@ -29,14 +29,22 @@ int main()
             std::cout << val << " ";
         std::cout << std::endl;
 
-        // ARIMA (placeholder)
+        // ARIMA fitted values and forecasts
         int p = 1, d = 0, q = 1;
         std::vector<double> arima = TimeSeriesAnalysis::ARIMA(data, p, d, q);
-        std::cout << "ARIMA output (placeholder): ";
+        std::cout << "ARIMA(1,0,1) fitted values: ";
         for (double val : arima)
             std::cout << val << " ";
         std::cout << std::endl;
 
+        TimeSeriesAnalysis::ARIMAModel arimaModel(p, d, q);
+        arimaModel.fit(data);
+        TimeSeriesAnalysis::ARIMAForecast forecast = arimaModel.forecast(3);
+        std::cout << "ARIMA(1,0,1) 3-step forecast (95% interval): ";
+        for (size_t h = 0; h < forecast.mean.size(); ++h)
+            std::cout << forecast.mean[h] << " [" << forecast.lower[h] << ", " << forecast.upper[h] << "] ";
+        std::cout << std::endl;
+
         // Fourier Transform
         std::vector<std::complex<double>> ft = TimeSeriesAnalysis::fourierTransform(data);
         std::cout << "Fourier Transform magnitudes: ";
@@ -64,14 +72,19 @@ int main()
             std::cout << std::endl;
         }
 
-        // LSTM Model example (placeholder)
+        // LSTM Model example: learn to predict the next value of the series
         {
             TimeSeriesAnalysis::LSTMModel lstm(1, 10, 1);
-            std::vector<std::vector<double>> inputs = {{1.0}, {2.0}, {3.0}};
-            std::vector<std::vector<double>> targets = {{2.0}, {3.0}, {4.0}};
-            lstm.train(inputs, targets, 5);
-            std::vector<double> prediction = lstm.predict({5.0});
-            std::cout << "LSTM Model prediction (placeholder): ";
+            std::vector<std::vector<double>> inputs, targets;
+            for (size_t i = 0; i + 1 < data.size(); ++i)
+            {
+                inputs.push_back({data[i]});
+                targets.push_back({data[i + 1]});
+            }
+            double loss = lstm.train(inputs, targets, 200);
+            std::cout << "LSTM training loss (MSE): " << loss << std::endl;
+            std::vector<double> prediction = lstm.predictSequence(inputs);
+            std::cout << "LSTM Model next-value prediction: ";
             for (double val : prediction)
                 std::cout << val << " ";
             std::cout << std::endl;
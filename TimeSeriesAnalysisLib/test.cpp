@@ -1,7 +1,15 @@
 #include <iostream>
 #include <vector>
 #include <cassert>
+#include <random>
+#include <numeric>
+#include <complex>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include "TimeSeriesAnalysis.h"
+#include "AnomalyDetection.h"
+#include "Resampling.h"
 
 void testMovingAverage()
 {
@@ -67,11 +75,85 @@ void testExponentialSmoothing()
     }
 }
 
+// Simulate an ARMA(1,1) series with deterministic Gaussian noise
+std::vector<double> simulateARMA(size_t n, double phi, double theta, unsigned seed)
+{
+    std::mt19937 gen(seed);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    std::vector<double> y(n);
+    double prevY = 0.0, prevE = 0.0;
+    for (size_t t = 0; t < n + 100; ++t)
+    {
+        double e = noise(gen);
+        double v = phi * prevY + e + theta * prevE;
+        prevY = v;
+        prevE = e;
+        if (t >= 100)
+            y[t - 100] = v;
+    }
+    return y;
+}
+
 void testARIMA()
 {
-    std::vector<double> data = {1, 2, 3};
-    auto arima = TimeSeriesAnalysis::ARIMA(data, 1, 0, 1);
-    assert(arima == data); // Placeholder returns input
+    // AR(1) recovered by every estimation method
+    std::vector<double> ar = simulateARMA(2000, 0.6, 0.0, 1);
+    for (auto method : {TimeSeriesAnalysis::ARIMAMethod::CSS, TimeSeriesAnalysis::ARIMAMethod::ML,
+                        TimeSeriesAnalysis::ARIMAMethod::CSS_ML})
+    {
+        TimeSeriesAnalysis::ARIMAModel model(1, 0, 0);
+        model.fit(ar, method);
+        assert(std::abs(model.coefficients()[0] - 0.6) < 0.05);
+        assert(std::abs(model.sigma2() - 1.0) < 0.1);
+    }
+
+    // ARMA(1,1) via exact likelihood
+    std::vector<double> arma = simulateARMA(3000, 0.5, 0.4, 2);
+    TimeSeriesAnalysis::ARIMAModel armaModel(1, 0, 1);
+    armaModel.fit(arma, TimeSeriesAnalysis::ARIMAMethod::ML);
+    assert(std::abs(armaModel.coefficients()[0] - 0.5) < 0.08);
+    assert(std::abs(armaModel.coefficients()[1] - 0.4) < 0.08);
+
+    // Integrated model: forecasts continue the level and intervals widen
+    std::vector<double> walk(ar.size());
+    std::partial_sum(ar.begin(), ar.end(), walk.begin());
+    TimeSeriesAnalysis::ARIMAModel integrated(1, 1, 0);
+    integrated.fit(walk);
+    auto fc = integrated.forecast(10);
+    assert(fc.mean.size() == 10 && fc.lower.size() == 10 && fc.upper.size() == 10);
+    assert(std::abs(fc.mean[0] - (walk.back() + integrated.coefficients()[0] * (walk.back() - walk[walk.size() - 2]))) < 1e-9);
+    for (size_t h = 1; h < 10; ++h)
+        assert(fc.upper[h] - fc.lower[h] > fc.upper[h - 1] - fc.lower[h - 1]);
+
+    // Seasonal model on a periodic signal
+    std::vector<double> seasonal(240);
+    for (size_t t = 0; t < seasonal.size(); ++t)
+        seasonal[t] = 10.0 * std::sin(2 * std::acos(-1.0) * t / 12.0) + 0.5 * ar[t];
+    TimeSeriesAnalysis::ARIMAModel sarima(TimeSeriesAnalysis::ARIMAOrder(1, 0, 0, 0, 1, 1, 12));
+    sarima.fit(seasonal);
+    auto sfc = sarima.forecast(12);
+    for (size_t h = 0; h < 12; ++h)
+        assert(std::abs(sfc.mean[h] - 10.0 * std::sin(2 * std::acos(-1.0) * (240 + h) / 12.0)) < 2.0);
+
+    // Fitted values from the convenience wrapper
+    auto fitted = TimeSeriesAnalysis::ARIMA(ar, 1, 0, 0);
+    assert(fitted.size() == ar.size());
+
+    // Batch fitting; too-short series are left unfitted
+    std::vector<std::vector<double>> batch = {ar, arma, {1.0, 2.0, 3.0}};
+    auto models = TimeSeriesAnalysis::fitARIMABatch(batch, TimeSeriesAnalysis::ARIMAOrder(1, 0, 0), TimeSeriesAnalysis::ARIMAMethod::CSS_ML, 2);
+    assert(models.size() == 3);
+    assert(models[0].isFitted() && models[1].isFitted() && !models[2].isFitted());
+    assert(std::abs(models[0].coefficients()[0] - 0.6) < 0.05);
+
+    try
+    {
+        TimeSeriesAnalysis::ARIMA(std::vector<double>{1, 2, 3}, 1, 0, 1);
+        assert(false);
+    }
+    catch (const std::invalid_argument &)
+    {
+    }
 }
 
 void testFourierTransform()
@@ -84,6 +166,105 @@ void testFourierTransform()
     assert(mag0 > 1e-10);
 }
 
+void testFourierTransformMatchesDFT()
+{
+    // Power-of-two (radix-2) and arbitrary (Bluestein) lengths against the O(N^2) definition
+    const double PI = std::acos(-1);
+    for (size_t n : {16u, 12u, 37u})
+    {
+        std::vector<double> data(n);
+        for (size_t i = 0; i < n; ++i)
+            data[i] = std::sin(0.3 * i) + 0.1 * i;
+        auto ft = TimeSeriesAnalysis::fourierTransform(data);
+        for (size_t k = 0; k < n; ++k)
+        {
+            std::complex<double> sum(0.0, 0.0);
+            for (size_t t = 0; t < n; ++t)
+                sum += std::polar(data[t], -2 * PI * k * t / n);
+            assert(std::abs(ft[k] - sum) < 1e-9);
+        }
+        auto back = TimeSeriesAnalysis::inverseFourierTransform(ft);
+        for (size_t t = 0; t < n; ++t)
+            assert(std::abs(back[t].real() - data[t]) < 1e-9 && std::abs(back[t].imag()) < 1e-9);
+    }
+}
+
+void testCorrelationFunctions()
+{
+    std::vector<double> x = simulateARMA(4000, 0.6, 0.0, 3);
+    std::vector<double> y(x.size());
+    for (size_t t = 0; t < y.size(); ++t)
+        y[t] = (t >= 2 ? x[t - 2] : 0.0) + 0.1 * std::cos(0.5 * t);
+
+    // Brute-force reference for a given lag
+    auto reference = [](const std::vector<double> &a, const std::vector<double> &b, long lag)
+    {
+        double ma = std::accumulate(a.begin(), a.end(), 0.0) / a.size();
+        double mb = std::accumulate(b.begin(), b.end(), 0.0) / b.size();
+        double saa = 0.0, sbb = 0.0, sab = 0.0;
+        for (size_t t = 0; t < a.size(); ++t)
+        {
+            saa += (a[t] - ma) * (a[t] - ma);
+            sbb += (b[t] - mb) * (b[t] - mb);
+        }
+        for (long t = 0; t < static_cast<long>(a.size()); ++t)
+            if (t + lag >= 0 && t + lag < static_cast<long>(a.size()))
+                sab += (a[t + lag] - ma) * (b[t] - mb);
+        return sab / std::sqrt(saa * sbb);
+    };
+
+    // Short lag range (direct kernel) and long lag range (FFT path)
+    for (size_t maxLag : {5u, 1500u})
+    {
+        auto acf = TimeSeriesAnalysis::autocorrelation(x, maxLag);
+        assert(acf.size() == maxLag + 1 && acf[0] == 1.0);
+        for (size_t k = 0; k <= maxLag; k += (maxLag / 5))
+            assert(std::abs(acf[k] - reference(x, x, static_cast<long>(k))) < 1e-9);
+
+        auto ccf = TimeSeriesAnalysis::crossCorrelation(x, y, maxLag);
+        assert(ccf.size() == 2 * maxLag + 1);
+        for (long k = -static_cast<long>(maxLag); k <= static_cast<long>(maxLag); k += static_cast<long>(maxLag / 5))
+            assert(std::abs(ccf[maxLag + k] - reference(x, y, k)) < 1e-9);
+    }
+    assert(std::abs(TimeSeriesAnalysis::autocorrelation(x, 1)[1] - 0.6) < 0.05);
+    auto ccf = TimeSeriesAnalysis::crossCorrelation(x, y, 4);
+    assert(std::max_element(ccf.begin(), ccf.end()) - ccf.begin() == 4 - 2);
+
+    // PACF of an AR(1) cuts off after lag 1
+    auto pacf = TimeSeriesAnalysis::partialAutocorrelation(x, 5);
+    assert(pacf.size() == 6 && pacf[0] == 1.0);
+    assert(std::abs(pacf[1] - 0.6) < 0.05);
+    for (size_t k = 2; k <= 5; ++k)
+        assert(std::abs(pacf[k]) < 0.1);
+
+    // Convolution, direct and FFT paths
+    for (size_t len : {3u, 800u})
+    {
+        std::vector<double> kernel(len);
+        for (size_t i = 0; i < len; ++i)
+            kernel[i] = 1.0 / (i + 1);
+        auto conv = TimeSeriesAnalysis::convolve(x, kernel);
+        assert(conv.size() == x.size() + len - 1);
+        for (size_t i = 0; i < conv.size(); i += 97)
+        {
+            double expected = 0.0;
+            for (size_t j = 0; j < len; ++j)
+                if (i >= j && i - j < x.size())
+                    expected += kernel[j] * x[i - j];
+            assert(std::abs(conv[i] - expected) < 1e-9);
+        }
+    }
+
+    try
+    {
+        TimeSeriesAnalysis::autocorrelation(x, x.size());
+        assert(false);
+    }
+    catch (const std::invalid_argument &)
+    {
+    }
+}
+
 void testSeasonalDecomposition()
 {
     std::vector<double> data = {1, 2, 3, 4, 5, 6};
@@ -92,6 +273,83 @@ void testSeasonalDecomposition()
     assert(trend.size() == data.size());
     assert(seasonal.size() == data.size());
     assert(residual.size() == data.size());
+    for (size_t period : {1u, 4u}) // STL needs period >= 2 and two full periods
+    {
+        try
+        {
+            TimeSeriesAnalysis::seasonalDecomposition(data, trend, seasonal, residual, period);
+            assert(false);
+        }
+        catch (const std::invalid_argument &)
+        {
+        }
+    }
+}
+
+void testSTL()
+{
+    // Linear trend + period-12 seasonal + noise, with a few gross outliers
+    const size_t n = 288, period = 12;
+    const double PI = std::acos(-1);
+    std::vector<double> noise = simulateARMA(n, 0.0, 0.0, 4);
+    std::vector<double> y(n), trueSeasonal(n);
+    for (size_t t = 0; t < n; ++t)
+    {
+        trueSeasonal[t] = 5.0 * std::sin(2 * PI * t / period);
+        y[t] = 0.05 * t + trueSeasonal[t] + 0.2 * noise[t];
+    }
+    for (size_t t = 30; t < n; t += 50)
+        y[t] += 40.0;
+
+    auto maxSeasonalError = [&](const std::vector<double> &seasonal)
+    {
+        double err = 0.0;
+        for (size_t t = period; t + period < n; ++t)
+            err = std::max(err, std::abs(seasonal[t] - trueSeasonal[t]));
+        return err;
+    };
+
+    std::vector<double> trend, seasonal, residual;
+    TimeSeriesAnalysis::STLOptions options(period);
+    options.seasonalWindow = 13;
+    TimeSeriesAnalysis::stl(y, options, trend, seasonal, residual);
+    for (size_t t = 0; t < n; ++t)
+        assert(std::abs(trend[t] + seasonal[t] + residual[t] - y[t]) < 1e-9);
+
+    // Robust fitting ignores the outliers, which then show up in the residual
+    TimeSeriesAnalysis::STLOptions robustOptions = options;
+    robustOptions.robust = true;
+    std::vector<double> rTrend, rSeasonal, rResidual;
+    TimeSeriesAnalysis::stl(y, robustOptions, rTrend, rSeasonal, rResidual);
+    assert(maxSeasonalError(rSeasonal) < 0.5);
+    assert(maxSeasonalError(rSeasonal) < maxSeasonalError(seasonal));
+    for (size_t t = 30; t < n; t += 50)
+        assert(rResidual[t] > 35.0);
+
+    // Caller-supplied buffers with a reused workspace and the parallel batch form agree
+    const size_t numSeries = 100;
+    std::vector<double> batch(numSeries * n), bTrend(batch.size()), bSeasonal(batch.size()), bResidual(batch.size());
+    for (size_t i = 0; i < numSeries; ++i)
+        for (size_t t = 0; t < n; ++t)
+            batch[i * n + t] = y[t] * (1.0 + 0.01 * i);
+    TimeSeriesAnalysis::stlBatch(batch.data(), numSeries, n, robustOptions, bTrend.data(), bSeasonal.data(), bResidual.data(), 3);
+    TimeSeriesAnalysis::STLWorkspace ws;
+    std::vector<double> sTrend(n), sSeasonal(n), sResidual(n);
+    for (size_t i : {0u, 37u, 99u})
+    {
+        TimeSeriesAnalysis::stl(batch.data() + i * n, n, robustOptions, sTrend.data(), sSeasonal.data(), sResidual.data(), ws);
+        for (size_t t = 0; t < n; ++t)
+            assert(sTrend[t] == bTrend[i * n + t] && sSeasonal[t] == bSeasonal[i * n + t]);
+    }
+
+    try
+    {
+        TimeSeriesAnalysis::stl(std::vector<double>(20, 1.0), options, trend, seasonal, residual);
+        assert(false);
+    }
+    catch (const std::invalid_argument &)
+    {
+    }
 }
 
 void testLSTMModel()
@@ -102,6 +360,307 @@ void testLSTMModel()
     lstm.train(inputs, targets, 3);
     auto pred = lstm.predict({1.5});
     assert(pred.size() == 1);
+
+    // Both cells learn one-step-ahead prediction of a sine wave
+    std::vector<std::vector<double>> wave, next;
+    for (size_t t = 0; t < 200; ++t)
+    {
+        wave.push_back({std::sin(0.2 * t)});
+        next.push_back({std::sin(0.2 * (t + 1))});
+    }
+    for (auto cell : {TimeSeriesAnalysis::RecurrentCell::LSTM, TimeSeriesAnalysis::RecurrentCell::GRU})
+    {
+        TimeSeriesAnalysis::LSTMModel model(1, 8, 1, cell);
+        TimeSeriesAnalysis::RecurrentTrainingOptions options(0.02, 20);
+        double first = model.train(wave, next, 1, options);
+        double last = model.train(wave, next, 150, options);
+        assert(last < 0.01 && last < first / 10.0);
+    }
+
+    // Batched inference matches sequence-at-a-time inference
+    TimeSeriesAnalysis::LSTMModel gru(3, 5, 2, TimeSeriesAnalysis::RecurrentCell::GRU, 11);
+    const size_t batch = 4, seqLen = 37;
+    std::vector<double> x(batch * seqLen * 3), out(batch * 2);
+    for (size_t i = 0; i < x.size(); ++i)
+        x[i] = std::cos(0.37 * i);
+    gru.predictBatch(x.data(), batch, seqLen, out.data());
+    for (size_t b = 0; b < batch; ++b)
+    {
+        std::vector<std::vector<double>> seq;
+        for (size_t t = 0; t < seqLen; ++t)
+            seq.push_back(std::vector<double>(x.begin() + (b * seqLen + t) * 3, x.begin() + (b * seqLen + t + 1) * 3));
+        auto single = gru.predictSequence(seq);
+        assert(std::abs(single[0] - out[b * 2]) < 1e-12 && std::abs(single[1] - out[b * 2 + 1]) < 1e-12);
+    }
+
+    try
+    {
+        lstm.predict({1.0, 2.0});
+        assert(false);
+    }
+    catch (const std::invalid_argument &)
+    {
+    }
+}
+
+void testRollingMedian()
+{
+    std::mt19937 gen(5);
+    std::uniform_int_distribution<int> dist(0, 20); // many ties
+    for (size_t window : {1u, 2u, 5u, 8u, 33u, 128u, 129u, 200u}) // sorted and heap layouts
+    {
+        TimeSeriesAnalysis::RollingMedian rolling(window);
+        std::vector<double> history;
+        for (size_t t = 0; t < 500; ++t)
+        {
+            double v = dist(gen);
+            rolling.push(v);
+            history.push_back(v);
+            std::vector<double> win(history.end() - std::min(window, history.size()), history.end());
+            std::sort(win.begin(), win.end());
+            size_t m = win.size();
+            double expected = (m % 2) ? win[m / 2] : 0.5 * (win[m / 2 - 1] + win[m / 2]);
+            assert(rolling.median() == expected);
+        }
+    }
+
+    // A NaN sorts above every number while in the window and leaves no trace afterwards
+    for (size_t window : {33u, 129u, 200u})
+    {
+        TimeSeriesAnalysis::RollingMedian rolling(window);
+        std::vector<double> history;
+        for (size_t t = 0; t < 800; ++t)
+        {
+            double v = t == 300 ? std::numeric_limits<double>::quiet_NaN() : dist(gen);
+            rolling.push(v);
+            history.push_back(v);
+            std::vector<double> win(history.end() - std::min(window, history.size()), history.end());
+            std::sort(win.begin(), win.end(), [](double a, double b) { return a < b || (b != b && a == a); });
+            size_t m = win.size();
+            double expected = (m % 2) ? win[m / 2] : 0.5 * (win[m / 2 - 1] + win[m / 2]);
+            double median = rolling.median();
+            assert(median == expected || (std::isnan(median) && std::isnan(expected)));
+            if (t >= 300 + window)
+                assert(median == expected);
+        }
+    }
+}
+
+void testStreamingAnomalyDetector()
+{
+    const size_t n = 20000, period = 24;
+    const double PI = std::acos(-1);
+    std::vector<double> noise = simulateARMA(n, 0.0, 0.0, 6);
+    std::vector<double> x(n);
+    for (size_t t = 0; t < n; ++t)
+        x[t] = 100.0 + 10.0 * std::sin(2 * PI * t / period) + noise[t];
+    const size_t spikes[] = {5000, 9001, 12345};
+    for (size_t t : spikes)
+        x[t] += 15.0;
+    for (size_t t = 17000; t < n; ++t)
+        x[t] += 3.0; // sustained level shift
+
+    TimeSeriesAnalysis::StreamingAnomalyOptions options(64, period);
+    TimeSeriesAnalysis::StreamingAnomalyDetector detector(options);
+    std::vector<TimeSeriesAnalysis::AnomalyScore> scores(n);
+    detector.process(x.data(), n, scores.data());
+
+    for (size_t t : spikes)
+        assert(scores[t].flags & TimeSeriesAnalysis::AnomalyScore::SeasonalOutlier);
+    size_t falseSeasonal = 0, shiftFlags = 0, earlyShift = 0;
+    for (size_t t = 0; t < 17000; ++t)
+    {
+        if ((scores[t].flags & TimeSeriesAnalysis::AnomalyScore::SeasonalOutlier) &&
+            std::find(std::begin(spikes), std::end(spikes), t) == std::end(spikes))
+            ++falseSeasonal;
+        earlyShift += (scores[t].flags & TimeSeriesAnalysis::AnomalyScore::EWMAShift) != 0;
+    }
+    for (size_t t = 17000; t < 17050; ++t)
+        shiftFlags += (scores[t].flags & TimeSeriesAnalysis::AnomalyScore::EWMAShift) != 0;
+    assert(falseSeasonal < 20);
+    assert(shiftFlags > 10);
+    assert(earlyShift < 170);
+
+    // Non-finite samples are flagged and skipped, so every stage stays finite afterwards
+    TimeSeriesAnalysis::StreamingAnomalyDetector gappy(options);
+    for (size_t t = 0; t < 2000; ++t)
+    {
+        double v = x[t];
+        if (t == 1000)
+            v = std::numeric_limits<double>::quiet_NaN();
+        else if (t == 1001)
+            v = std::numeric_limits<double>::infinity();
+        auto s = gappy.process(v);
+        if (t == 1000 || t == 1001)
+            assert(s.flags == TimeSeriesAnalysis::AnomalyScore::NonFinite);
+        else
+            assert(std::isfinite(s.robustZ) && std::isfinite(s.seasonalZ) && std::isfinite(s.ewmaZ));
+    }
+    assert(gappy.samplesSeen() == 1998 && std::isfinite(gappy.rollingMedian()));
+
+    // The rolling median sees the seasonal swing, so a spike at a trough is caught robustly too
+    TimeSeriesAnalysis::StreamingAnomalyDetector robust(TimeSeriesAnalysis::StreamingAnomalyOptions(15));
+    std::vector<double> flat = simulateARMA(2000, 0.0, 0.0, 7);
+    flat[1500] += 25.0;
+    size_t robustFlags = 0;
+    for (size_t t = 0; t < flat.size(); ++t)
+    {
+        auto s = robust.process(flat[t]);
+        if (t == 1500)
+            assert(s.flags & TimeSeriesAnalysis::AnomalyScore::RobustOutlier);
+        robustFlags += (s.flags & TimeSeriesAnalysis::AnomalyScore::RobustOutlier) != 0;
+    }
+    assert(robustFlags < 40);
+}
+
+void testQuantileSketch()
+{
+    std::mt19937 gen(11);
+    std::lognormal_distribution<double> dist(0.0, 2.0);
+    std::vector<double> x(20000);
+    for (size_t i = 0; i < x.size(); ++i)
+        x[i] = (i % 3 == 0 ? -1.0 : 1.0) * dist(gen);
+    x[7] = 0.0;
+
+    const double accuracy = 0.01;
+    TimeSeriesAnalysis::QuantileSketch whole(accuracy), left(accuracy), right(accuracy);
+    for (size_t i = 0; i < x.size(); ++i)
+    {
+        whole.add(x[i]);
+        (i < 5000 ? left : right).add(x[i]);
+    }
+    left.merge(right);
+    std::vector<double> sorted = x;
+    std::sort(sorted.begin(), sorted.end());
+    const double levels[] = {0.0, 0.01, 0.25, 0.5, 0.9, 0.999, 1.0};
+    for (double q : levels)
+    {
+        double exact = sorted[static_cast<size_t>(q * (x.size() - 1))];
+        assert(std::abs(whole.quantile(q) - exact) <= accuracy * std::abs(exact) + 1e-12);
+        assert(left.quantile(q) == whole.quantile(q));
+    }
+    assert(left.count() == x.size());
+
+    // NaN is skipped and infinities take the extreme ranks without moving the others
+    const double inf = std::numeric_limits<double>::infinity();
+    TimeSeriesAnalysis::QuantileSketch gappy(accuracy);
+    gappy.add(-inf);
+    for (size_t i = 0; i < x.size(); ++i)
+        gappy.add(i % 100 == 0 ? std::numeric_limits<double>::quiet_NaN() : x[i]);
+    gappy.add(inf);
+    std::vector<double> present;
+    for (size_t i = 0; i < x.size(); ++i)
+        if (i % 100 != 0)
+            present.push_back(x[i]);
+    std::sort(present.begin(), present.end());
+    assert(gappy.count() == present.size() + 2 && gappy.infinite() == 2);
+    assert(gappy.quantile(0.0) == -inf && gappy.quantile(1.0) == inf);
+    for (double q : {0.01, 0.25, 0.5, 0.9})
+    {
+        double exact = present[static_cast<size_t>(q * (present.size() + 1)) - 1];
+        assert(std::abs(gappy.quantile(q) - exact) <= accuracy * std::abs(exact) + 1e-12);
+    }
+}
+
+void testResampling()
+{
+    // Irregular timestamps with gaps, including one longer than a window
+    std::mt19937 gen(5);
+    std::uniform_int_distribution<int> step(0, 7);
+    std::normal_distribution<double> noise(50.0, 10.0);
+    const size_t n = 300000;
+    std::vector<int64_t> t(n);
+    std::vector<double> v(n);
+    int64_t now = -1234;
+    for (size_t i = 0; i < n; ++i)
+    {
+        now += step(gen) + (i == n / 2 ? 5000 : 0);
+        t[i] = now;
+        v[i] = noise(gen);
+    }
+
+    const int64_t layouts[][2] = {{1000, 0}, {1000, 250}, {600, 400}};
+    for (const auto &layout : layouts)
+    {
+        TimeSeriesAnalysis::ResampleOptions options(layout[0], layout[1]);
+        options.origin = 17;
+        options.quantiles = {0.5, 0.95};
+        auto r = TimeSeriesAnalysis::resample(t, v, options);
+
+        // Brute force over every window on the grid
+        assert(r.size() > 0);
+        assert(r.start.front() <= t.front() && r.start.front() + options.width > t.front());
+        assert(r.start.back() <= t.back() && r.start.back() + options.hop > t.back());
+        size_t empty = 0;
+        for (size_t w = 0; w < r.size(); ++w)
+        {
+            assert(w == 0 || r.start[w] == r.start[w - 1] + options.hop);
+            auto lo = std::lower_bound(t.begin(), t.end(), r.start[w]);
+            auto hi = std::lower_bound(t.begin(), t.end(), r.start[w] + options.width);
+            std::vector<double> window(v.begin() + (lo - t.begin()), v.begin() + (hi - t.begin()));
+            assert(r.count[w] == window.size());
+            if (window.empty())
+            {
+                ++empty;
+                assert(std::isnan(r.mean[w]) && std::isnan(r.quantiles[2 * w]));
+                continue;
+            }
+            double m = std::accumulate(window.begin(), window.end(), 0.0) / window.size();
+            assert(std::abs(r.mean[w] - m) < 1e-9);
+            assert(r.min[w] == *std::min_element(window.begin(), window.end()));
+            assert(r.max[w] == *std::max_element(window.begin(), window.end()));
+            if (window.size() > 1)
+            {
+                double ss = 0.0;
+                for (double y : window)
+                    ss += (y - m) * (y - m);
+                assert(std::abs(r.variance[w] - ss / (window.size() - 1)) < 1e-8 * (1.0 + ss));
+            }
+            std::sort(window.begin(), window.end());
+            for (size_t k = 0; k < 2; ++k)
+            {
+                double exact = window[static_cast<size_t>(options.quantiles[k] * (window.size() - 1))];
+                assert(std::abs(r.quantiles[2 * w + k] - exact) <= 0.01 * std::abs(exact) + 1e-12);
+            }
+        }
+        assert(empty > 0);
+
+        // Chunked, multithreaded streaming gives the same windows
+        options.numThreads = 3;
+        TimeSeriesAnalysis::Resampler streaming(options);
+        TimeSeriesAnalysis::ResampledSeries collected;
+        for (size_t i = 0; i < n; i += 77777)
+        {
+            size_t len = std::min<size_t>(77777, n - i);
+            streaming.push(t.data() + i, v.data() + i, len);
+            auto part = streaming.takeWindows();
+            collected.start.insert(collected.start.end(), part.start.begin(), part.start.end());
+            collected.count.insert(collected.count.end(), part.count.begin(), part.count.end());
+            collected.mean.insert(collected.mean.end(), part.mean.begin(), part.mean.end());
+        }
+        streaming.finish();
+        auto tail = streaming.takeWindows();
+        collected.start.insert(collected.start.end(), tail.start.begin(), tail.start.end());
+        collected.count.insert(collected.count.end(), tail.count.begin(), tail.count.end());
+        collected.mean.insert(collected.mean.end(), tail.mean.begin(), tail.mean.end());
+        assert(collected.start == r.start);
+        assert(collected.count == r.count);
+        for (size_t w = 0; w < r.size(); ++w)
+            assert(r.count[w] == 0 || std::abs(collected.mean[w] - r.mean[w]) < 1e-9);
+    }
+
+    // Out-of-order input is rejected
+    TimeSeriesAnalysis::Resampler resampler(TimeSeriesAnalysis::ResampleOptions(10));
+    std::vector<int64_t> badT = {1, 5, 3};
+    std::vector<double> badV = {1, 2, 3};
+    try
+    {
+        resampler.push(badT, badV);
+        assert(false);
+    }
+    catch (const std::invalid_argument &)
+    {
+    }
 }
 
 int main()
@@ -110,8 +669,15 @@ int main()
     testExponentialSmoothing();
     testARIMA();
     testFourierTransform();
+    testFourierTransformMatchesDFT();
+    testCorrelationFunctions();
     testSeasonalDecomposition();
+    testSTL();
     testLSTMModel();
+    testRollingMedian();
+    testStreamingAnomalyDetector();
+    testQuantileSketch();
+    testResampling();
 
     std::cout << "All tests passed successfully." << std::endl;
     return 0;